@@ -38,6 +38,9 @@ typedef struct TinyKtx_Callbacks {
 	TinyKtx_ReadFunc readFn;
 	TinyKtx_SeekFunc seekFn;
 	TinyKtx_TellFunc tellFn;
+	// 0 is unlimited. No single readFn or level allocFn call is larger than this,
+	// bigger levels have to be read with TinyKtx_ReadLevelChunks
+	size_t maxChunkSize;
 } TinyKtx_Callbacks;
 
 TinyKtx_ContextHandle TinyKtx_CreateContext(TinyKtx_Callbacks const *callbacks, void *user);
@@ -70,7 +73,9 @@ bool TinyKtx_NeedsGenerationOfMipmaps(TinyKtx_ContextHandle handle);
 bool TinyKtx_NeedsEndianCorrecting(TinyKtx_ContextHandle handle);
 
 uint32_t TinyKtx_NumberOfMipmaps(TinyKtx_ContextHandle handle);
+// 0 (with an error) if the level is 4GB or more, use TinyKtx_ImageSize64 for those
 uint32_t TinyKtx_ImageSize(TinyKtx_ContextHandle handle, uint32_t mipmaplevel);
+uint64_t TinyKtx_ImageSize64(TinyKtx_ContextHandle handle, uint32_t mipmaplevel);
 
 bool TinyKtx_IsMipMapLevelUnpacked(TinyKtx_ContextHandle handle, uint32_t mipmaplevel);
 // this is required to read Unpacked data correctly
@@ -78,14 +83,40 @@ uint32_t TinyKtx_UnpackedRowStride(TinyKtx_ContextHandle handle, uint32_t mipmap
 
 // data return by ImageRawData is owned by the context. Don't free it!
 void const *TinyKtx_ImageRawData(TinyKtx_ContextHandle handle, uint32_t mipmaplevel);
+// releases the context's copy of a level early (rather than at reset/destroy), handy when
+// streaming one level at a time. Pointers previously returned for the level are invalid afterwards
+void TinyKtx_ReleaseImageRawData(TinyKtx_ContextHandle handle, uint32_t mipmaplevel);
+
+// called with each piece of a level in order, byteOffset is from the start of the level.
+// data is only valid during the call, return false to stop reading
+typedef bool (*TinyKtx_LevelChunkFunc)(void *user, uint32_t mipmaplevel, uint64_t byteOffset, void const *data, size_t byteCount);
+// reads a level a piece at a time through a single buffer of at most maxChunkSize bytes (64KB if
+// that is unlimited), so levels of any size can be copied to their destination without ever
+// being in memory at once. The data is exactly what TinyKtx_ImageRawData would return
+bool TinyKtx_ReadLevelChunks(TinyKtx_ContextHandle handle, uint32_t mipmaplevel, TinyKtx_LevelChunkFunc chunkFn, void *chunkUser);
+
+// bytes of one depth slice of a level of a 3D texture, including any row padding. 0 on error
+uint64_t TinyKtx_DepthSliceSize(TinyKtx_ContextHandle handle, uint32_t mipmaplevel);
+// reads depth slices [z0, z1) of a level of a 3D texture into dst ((z1 - z0) * TinyKtx_DepthSliceSize
+// bytes, padded exactly as in the file) with one seek and read, the rest of the level isn't touched
+bool TinyKtx_ReadDepthSlices(TinyKtx_ContextHandle handle,
+														 uint32_t mipmaplevel,
+														 uint32_t z0,
+														 uint32_t z1,
+														 void *dst,
+														 size_t dstSize);
 
 typedef void (*TinyKtx_WriteFunc)(void *user, void const *buffer, size_t byteCount);
+// positional (pwrite style) write, used by the positional writer. If levels are written from
+// multiple threads this will be called from all of them at the same time
+typedef void (*TinyKtx_PositionalWriteFunc)(void *user, uint64_t offset, void const *buffer, size_t byteCount);
 
 typedef struct TinyKtx_WriteCallbacks {
 	TinyKtx_ErrorFunc errorFn;
 	TinyKtx_AllocFunc allocFn;
 	TinyKtx_FreeFunc freeFn;
 	TinyKtx_WriteFunc writeFn;
+	TinyKtx_PositionalWriteFunc pwriteFn; // only required by the positional writer
 } TinyKtx_WriteCallbacks;
 
 
@@ -519,7 +550,70 @@ TinyKtx_Format TinyImageFormat_ToTinyKtxFormat(TinyImageFormat format);
 #endif
 
 TinyKtx_Format TinyKtx_GetFormat(TinyKtx_ContextHandle handle);
+
+// size of a level once read by TinyKtx_ReadLevelAs into format, 0 if the level can't be read as it
+uint64_t TinyKtx_LevelSizeAs(TinyKtx_ContextHandle handle, uint32_t mipmaplevel, TinyKtx_Format format);
+// reads a level converted to format, tightly packed (no KTX row or face padding) in one pass
+// through a small buffer so the data is only touched once. format can be the file's own format
+// (just drops the padding) or R8G8B8A8 of the same numeric type for 8 bit R, RG, RGB, BGR, BGRA
+// and luminance/alpha/intensity files (missing colour is 0, missing alpha is 1, luminance is
+// copied to RGB), or 32 bit float with the same channels for the formats TinyKtx_FormatToFloat
+// takes. Uses SSSE3, AVX2 or NEON shuffles when the compiler targets them
+bool TinyKtx_ReadLevelAs(TinyKtx_ContextHandle handle,
+												 uint32_t mipmaplevel,
+												 TinyKtx_Format format,
+												 void *dst,
+												 size_t dstSize);
+
+// colour pass flags, they describe the float side of the conversion
+typedef enum TinyKtx_ColorFlags {
+	TKTX_COLOR_LINEAR = 0x1,					// *_SRGB formats are decoded to linear on read and encoded on write
+	TKTX_COLOR_PREMULTIPLIED = 0x2,		// colour is multiplied by alpha on read and divided on write
+} TinyKtx_ColorFlags;
+
+// 8 bit UNORM/SRGB pixels (R, RG, RGB, BGR, RGBA, BGRA, ABGR) to RGBA 32 bit floats and back.
+// sRGB uses lookup tables (AVX2 gathers when targeted), missing channels are 0 and alpha 1
+bool TinyKtx_DecodeColor(TinyKtx_Format format, uint32_t colorFlags, void const *src, float *dst, size_t pixelCount);
+bool TinyKtx_EncodeColor(TinyKtx_Format format, uint32_t colorFlags, float const *src, void *dst, size_t pixelCount);
+// TinyKtx_ReadLevelAs with the colour pass run on each row as it is read, for 8 bit UNORM/SRGB
+// levels read as R32G32B32A32_SFLOAT or R16G16B16A16_SFLOAT (TinyKtx_ReadLevelAs is colorFlags 0)
+bool TinyKtx_ReadLevelAsColor(TinyKtx_ContextHandle handle,
+															uint32_t mipmaplevel,
+															TinyKtx_Format format,
+															uint32_t colorFlags,
+															void *dst,
+															size_t dstSize);
+
+// which way up the rows of an image are, the T of the KTXorientation key (S is always r)
+typedef enum TinyKtx_Origin {
+	TKTX_ORIGIN_FILE,					// as the file stores them, no flip
+	TKTX_ORIGIN_TOP_LEFT,			// first row is the top of the image (T=d)
+	TKTX_ORIGIN_BOTTOM_LEFT,	// first row is the bottom, GL's convention (T=u)
+	TKTX_ORIGIN_UNKNOWN,			// only from TinyKtx_GetOrigin, the file doesn't say
+} TinyKtx_Origin;
+
+// the file's origin from KTXorientation. The key is optional and KTX v1 has no default (writers
+// differ, GL tools are usually bottom left) so without it the origin is unknown
+TinyKtx_Origin TinyKtx_GetOrigin(TinyKtx_ContextHandle handle);
+// the origin TinyKtx_ReadLevelAs and TinyKtx_ReadLevelAsColor produce until the context is reset.
+// Rows (of each depth slice) are written straight to their flipped place as they are read, so it
+// costs no extra pass. Block compressed levels are flipped a block row at a time and inside each
+// block, which only BC1 to BC5 can do and only for heights that are a multiple of 4 or below 4.
+// Anything but TKTX_ORIGIN_FILE fails for files whose origin is unknown
+void TinyKtx_SetReadOrigin(TinyKtx_ContextHandle handle, TinyKtx_Origin origin);
+
+// converts pixelCount pixels of a float format to or from 32 bit floats, one per channel in the
+// format's channel order (B10G11R11 and E5B9G9R9 are R, G, B). Supports the 16 and 32 bit SFLOAT
+// formats, B10G11R11_UFLOAT_PACK32 and E5B9G9R9_UFLOAT_PACK32. Halfs overflow to inf as IEEE does,
+// the unsigned packed formats clamp negatives to 0 and large values to their largest finite value.
+// Uses F16C or NEON when the compiler targets them, SSE2 or scalar bit tricks otherwise
+bool TinyKtx_FormatToFloat(TinyKtx_Format format, void const *src, float *dst, size_t pixelCount);
+bool TinyKtx_FormatFromFloat(TinyKtx_Format format, float const *src, void *dst, size_t pixelCount);
+
 bool TinyKtx_CrackFormatToGL(TinyKtx_Format format, uint32_t *glformat, uint32_t *gltype, uint32_t *glinternalformat, uint32_t* typesize);
+// mipmapsizes can be NULL for any TinyKtx_Format (or GL format TinyKtx_CrackFormatFromGL knows),
+// the writer then computes them from the dimensions assuming tightly packed data.
+// Provided sizes are checked against the format before anything is written
 bool TinyKtx_WriteImage(TinyKtx_WriteCallbacks const *callbacks,
 												void *user,
 												uint32_t width,
@@ -531,6 +625,224 @@ bool TinyKtx_WriteImage(TinyKtx_WriteCallbacks const *callbacks,
 												bool cubemap,
 												uint32_t const *mipmapsizes,
 												void const **mipmaps);
+
+// same as TinyKtx_WriteImage(GL) but takes a pointer per slice/face instead of per level, so
+// separate cubemap faces or array slices don't have to be copied into one buffer first.
+// faces is a [mipmaplevel][slice][face] table, faces[(mipmaplevel * slices + slice) * faceCount + face]
+// with faceCount 6 for cubemaps else 1 (slices of 0 counts as 1).
+// mipmapsizes are still the size of the whole level (all slices and faces) or NULL
+bool TinyKtx_WriteImageFacesGL(TinyKtx_WriteCallbacks const *callbacks,
+															 void *user,
+															 uint32_t width,
+															 uint32_t height,
+															 uint32_t depth,
+															 uint32_t slices,
+															 uint32_t mipmaplevels,
+															 uint32_t format,
+															 uint32_t internalFormat,
+															 uint32_t baseFormat,
+															 uint32_t type,
+															 uint32_t typeSize,
+															 bool cubemap,
+															 uint32_t const *mipmapsizes,
+															 void const **faces);
+bool TinyKtx_WriteImageFaces(TinyKtx_WriteCallbacks const *callbacks,
+														 void *user,
+														 uint32_t width,
+														 uint32_t height,
+														 uint32_t depth,
+														 uint32_t slices,
+														 uint32_t mipmaplevels,
+														 TinyKtx_Format format,
+														 bool cubemap,
+														 uint32_t const *mipmapsizes,
+														 void const **faces);
+
+// The layout of a KTX file is known before any image data is written, so the file offset of
+// every mipmap level and face can be computed up front. The positional writer uses this to
+// let multiple threads write different levels (or faces) at the same time via pwriteFn.
+// TinyKtx_WriteHeaderPositional fills in the header, image size fields and padding between faces
+// and levels, the level/face writers add any row padding (GL_UNPACK_ALIGNMENT = 4) as they go.
+// mipmapsizes are the same as TinyKtx_WriteImage (all slices/faces of a level either packed or
+// already row padded). Like TinyKtx_WriteImage no key/value data is written, the first level
+// directly follows the header
+typedef struct TinyKtx_WriteLevelLayout {
+	uint64_t sizeOffset;						// file offset of this levels imageSize field
+	uint64_t dataOffset;						// file offset of this levels first face/slice
+	uint32_t imageSize;							// value stored in the imageSize field
+	uint32_t faceByteLength;				// bytes of one face/slice in the file (inc. row padding)
+	uint32_t faceStride;						// file distance between faces/slices (inc. cube padding)
+	uint32_t sourceFaceByteLength;	// bytes of one face/slice in the data passed to the writer
+	uint32_t rowByteLength;					// bytes per row without padding (0 if compressed)
+	uint32_t rowStride;							// bytes per row in the file (0 if compressed)
+	uint32_t rowCount;							// rows per face/slice (height * depth)
+} TinyKtx_WriteLevelLayout;
+
+typedef struct TinyKtx_WriteLayout {
+	uint32_t width;
+	uint32_t height;
+	uint32_t depth;
+	uint32_t slices;
+	uint32_t faces;
+	uint32_t mipmaplevels;
+	uint32_t glFormat;
+	uint32_t glInternalFormat;
+	uint32_t glBaseInternalFormat;
+	uint32_t glType;
+	uint32_t glTypeSize;
+	uint64_t totalByteLength;
+	TinyKtx_WriteLevelLayout levels[TINYKTX_MAX_MIPMAPLEVELS];
+} TinyKtx_WriteLayout;
+
+bool TinyKtx_ComputeWriteLayoutGL(TinyKtx_WriteCallbacks const *callbacks,
+																	void *user,
+																	uint32_t width,
+																	uint32_t height,
+																	uint32_t depth,
+																	uint32_t slices,
+																	uint32_t mipmaplevels,
+																	uint32_t format,
+																	uint32_t internalFormat,
+																	uint32_t baseFormat,
+																	uint32_t type,
+																	uint32_t typeSize,
+																	bool cubemap,
+																	uint32_t const *mipmapsizes,
+																	TinyKtx_WriteLayout *layout);
+
+bool TinyKtx_ComputeWriteLayout(TinyKtx_WriteCallbacks const *callbacks,
+																void *user,
+																uint32_t width,
+																uint32_t height,
+																uint32_t depth,
+																uint32_t slices,
+																uint32_t mipmaplevels,
+																TinyKtx_Format format,
+																bool cubemap,
+																uint32_t const *mipmapsizes,
+																TinyKtx_WriteLayout *layout);
+
+// writes everything except the image data itself
+bool TinyKtx_WriteHeaderPositional(TinyKtx_WriteCallbacks const *callbacks,
+																	 void *user,
+																	 TinyKtx_WriteLayout const *layout);
+// writes all slices/faces of a level, thread safe as long as pwriteFn is
+bool TinyKtx_WriteLevelPositional(TinyKtx_WriteCallbacks const *callbacks,
+																	void *user,
+																	TinyKtx_WriteLayout const *layout,
+																	uint32_t mipmaplevel,
+																	void const *data);
+// writes a single slice/face of a level, data is sourceFaceByteLength bytes
+bool TinyKtx_WriteFacePositional(TinyKtx_WriteCallbacks const *callbacks,
+																 void *user,
+																 TinyKtx_WriteLayout const *layout,
+																 uint32_t mipmaplevel,
+																 uint32_t slice,
+																 uint32_t face,
+																 void const *data);
+
+// Rewrite a single level or slice/face of an existing file in place. handle must have read the
+// header of the file being updated and pwriteFn must write to that same file (same offsets as
+// the read callbacks). Only that levels or slice/faces bytes are written, data is packed or row
+// padded like the writer takes. A KTX v1 level size is fixed by the header, so data of a different
+// size is an error (stream a new file with TinyKtx_WriteImage instead).
+// Any data previously returned by TinyKtx_ImageRawData for the level is released
+bool TinyKtx_UpdateLevel(TinyKtx_ContextHandle handle,
+												 TinyKtx_WriteCallbacks const *callbacks,
+												 void *user,
+												 uint32_t mipmaplevel,
+												 void const *data,
+												 uint32_t dataSize);
+bool TinyKtx_UpdateFace(TinyKtx_ContextHandle handle,
+												TinyKtx_WriteCallbacks const *callbacks,
+												void *user,
+												uint32_t mipmaplevel,
+												uint32_t slice,
+												uint32_t face,
+												void const *data,
+												uint32_t dataSize);
+
+// per format traits from the master format table (TINYKTX_FORMAT_TABLE below)
+// uncompressed formats are 1x1x1 blocks of a single pixel
+typedef struct TinyKtx_FormatTraits {
+	uint8_t blockWidth;
+	uint8_t blockHeight;
+	uint8_t blockDepth;
+	uint8_t blockByteSize;
+	uint8_t channelCount;
+	bool compressed;
+} TinyKtx_FormatTraits;
+
+// returns false for TKTX_UNDEFINED or unknown formats
+bool TinyKtx_GetFormatTraits(TinyKtx_Format format, TinyKtx_FormatTraits *traits);
+// block footprint of a format, uncompressed formats are 1x1x1 blocks of a single pixel
+bool TinyKtx_FormatBlockInfo(TinyKtx_Format format, uint32_t *blockWidth, uint32_t *blockHeight, uint32_t *blockDepth, uint32_t *blockByteSize);
+// tightly packed byte size of each mipmap level (all slices and faces), what the writers
+// expect in mipmapsizes. Returns false for unknown formats or levels over 4GB
+bool TinyKtx_ComputeMipmapSizes(uint32_t width,
+																uint32_t height,
+																uint32_t depth,
+																uint32_t slices,
+																uint32_t mipmaplevels,
+																TinyKtx_Format format,
+																bool cubemap,
+																uint32_t *mipmapsizes);
+// same without the 4GB limit, for large volume and array textures
+bool TinyKtx_ComputeMipmapSizes64(uint32_t width,
+																	uint32_t height,
+																	uint32_t depth,
+																	uint32_t slices,
+																	uint32_t mipmaplevels,
+																	TinyKtx_Format format,
+																	bool cubemap,
+																	uint64_t *mipmapsizes);
+
+// Exact file layout of a texture without needing a file or any callbacks, what the TinyKtx
+// (KTX v1) or TinyKtx2 (KTX v2) writers produce (no key/value data). So memory can be budgeted
+// and allocated before any I/O. Offsets are from the start of the file
+typedef enum TinyKtx_Container {
+	TKTX_CONTAINER_KTX1,
+	TKTX_CONTAINER_KTX2,
+} TinyKtx_Container;
+
+typedef struct TinyKtx_LevelLayout {
+	uint32_t width;
+	uint32_t height;
+	uint32_t depth;
+	uint32_t rowStride;					// bytes per row of blocks in the file (inc. KTX1 row padding)
+	uint64_t byteOffset;				// file offset of the first slice/face
+	uint64_t byteLength;				// file bytes of all slices/faces (inc. padding, not the KTX1 imageSize)
+	uint64_t faceByteLength;		// file bytes of one slice/face (inc. KTX1 row padding)
+	uint64_t faceStride;				// distance between slices/faces (inc. KTX1 cubemap padding)
+	uint64_t packedByteLength;	// tightly packed bytes of all slices/faces, the size once loaded
+} TinyKtx_LevelLayout;
+
+typedef struct TinyKtx_Layout {
+	TinyKtx_Container container;
+	TinyKtx_Format format;
+	uint32_t layers;						// at least 1
+	uint32_t faces;							// 1 or 6
+	uint32_t levels;
+	uint64_t totalByteLength;		// size of the whole file
+	TinyKtx_LevelLayout level[TINYKTX_MAX_MIPMAPLEVELS];
+} TinyKtx_Layout;
+
+// width, height, depth and layers of 0 count as 1. Returns false for unknown formats, invalid
+// face or level counts, or sizes the container can't represent (KTX v1 levels over 4GB)
+bool TinyKtx_ComputeLayout(TinyKtx_Format format,
+													 uint32_t width,
+													 uint32_t height,
+													 uint32_t depth,
+													 uint32_t layers,
+													 uint32_t faces,
+													 uint32_t levels,
+													 TinyKtx_Container container,
+													 TinyKtx_Layout *layout);
+// file offset of a single slice/face image, 0 if out of range
+uint64_t TinyKtx_LayoutImageOffset(TinyKtx_Layout const *layout, uint32_t level, uint32_t layer, uint32_t face);
+
+TinyKtx_Format TinyKtx_CrackFormatFromGL(uint32_t const glformat, uint32_t const gltype, uint32_t const glinternalformat, uint32_t const typesize);
+
 // GL types
 #define TINYKTX_GL_TYPE_COMPRESSED                      0x0
 #define TINYKTX_GL_TYPE_BYTE                            0x1400
@@ -773,8 +1085,185 @@ bool TinyKtx_WriteImage(TinyKtx_WriteCallbacks const *callbacks,
 #define TINYKTX_GL_COMPRESSED_SRGB8_ALPHA8_ASTC_12x10     		0x93DC
 #define TINYKTX_GL_COMPRESSED_SRGB8_ALPHA8_ASTC_12x12     		0x93DD
 
+// Master format table, every TinyKtx_Format has exactly one row. The format traits, GL and
+// TinyImageFormat conversions are all generated from it and as its just macros it can also be
+// expanded into compile time (constexpr) tables of your own.
+// FT(format, pixelbytes, channels, glformat, gltype, glinternalformat, typesize, TinyImageFormat, reverse)
+// FTC(format, blockwidth, blockheight, blockbytes, channels, glformat, glcompressedformat, TinyImageFormat, reverse)
+// FT rows are uncompressed 1x1 blocks. reverse is 0 when the TinyImageFormat shouldn't map
+// back to this row
+#define TINYKTX_FORMAT_TABLE(FT, FTC) \
+	FT(R4G4_UNORM_PACK8, 1, 2, RG, UNSIGNED_SHORT_4_4_4_4, RGB4, 1, R4G4_UNORM, 1) \
+	FT(R4G4B4A4_UNORM_PACK16, 2, 4, RGBA, UNSIGNED_SHORT_4_4_4_4, RGBA4, 2, R4G4B4A4_UNORM, 1) \
+	FT(B4G4R4A4_UNORM_PACK16, 2, 4, BGRA, UNSIGNED_SHORT_4_4_4_4_REV, RGBA4, 2, B4G4R4A4_UNORM, 1) \
+	FT(R5G6B5_UNORM_PACK16, 2, 3, RGB, UNSIGNED_SHORT_5_6_5_REV, RGB565, 2, R5G6B5_UNORM, 1) \
+	FT(B5G6R5_UNORM_PACK16, 2, 3, BGR, UNSIGNED_SHORT_5_6_5, RGB565, 2, B5G6R5_UNORM, 1) \
+	FT(R5G5B5A1_UNORM_PACK16, 2, 4, RGBA, UNSIGNED_SHORT_5_5_5_1, RGB5_A1, 2, R5G5B5A1_UNORM, 1) \
+	FT(A1R5G5B5_UNORM_PACK16, 2, 4, RGBA, UNSIGNED_SHORT_1_5_5_5_REV, RGB5_A1, 2, A1R5G5B5_UNORM, 1) \
+	FT(B5G5R5A1_UNORM_PACK16, 2, 4, BGRA, UNSIGNED_SHORT_5_5_5_1, RGB5_A1, 2, B5G5R5A1_UNORM, 1) \
+	FT(A2R10G10B10_UNORM_PACK32, 4, 4, BGRA, UNSIGNED_INT_2_10_10_10_REV, RGB10_A2, 4, B10G10R10A2_UNORM, 1) \
+	FT(A2R10G10B10_UINT_PACK32, 4, 4, BGRA_INTEGER, UNSIGNED_INT_2_10_10_10_REV, RGB10_A2, 4, B10G10R10A2_UINT, 1) \
+	FT(A2B10G10R10_UNORM_PACK32, 4, 4, RGBA, UNSIGNED_INT_2_10_10_10_REV, RGB10_A2, 4, R10G10B10A2_UNORM, 1) \
+	FT(A2B10G10R10_UINT_PACK32, 4, 4, RGBA_INTEGER, UNSIGNED_INT_2_10_10_10_REV, RGB10_A2, 4, R10G10B10A2_UINT, 1) \
+	FT(R8_UNORM, 1, 1, RED, UNSIGNED_BYTE, R8, 1, R8_UNORM, 1) \
+	FT(R8_SNORM, 1, 1, RED, BYTE, R8_SNORM, 1, R8_SNORM, 1) \
+	FT(R8_UINT, 1, 1, RED_INTEGER, UNSIGNED_BYTE, R8UI, 1, R8_UINT, 1) \
+	FT(R8_SINT, 1, 1, RED_INTEGER, BYTE, R8I, 1, R8_SINT, 1) \
+	FT(R8_SRGB, 1, 1, SLUMINANCE, UNSIGNED_BYTE, SLUMINANCE8, 1, R8_SRGB, 1) \
+	FT(R8G8_UNORM, 2, 2, RG, UNSIGNED_BYTE, RG8, 1, R8G8_UNORM, 1) \
+	FT(R8G8_SNORM, 2, 2, RG, BYTE, RG8_SNORM, 1, R8G8_SNORM, 1) \
+	FT(R8G8_UINT, 2, 2, RG_INTEGER, UNSIGNED_BYTE, RG8UI, 1, R8G8_UINT, 1) \
+	FT(R8G8_SINT, 2, 2, RG_INTEGER, BYTE, RG8I, 1, R8G8_SINT, 1) \
+	FT(R8G8_SRGB, 2, 2, SLUMINANCE_ALPHA, UNSIGNED_BYTE, SLUMINANCE8_ALPHA8, 1, R8G8_SRGB, 1) \
+	FT(R8G8B8_UNORM, 3, 3, RGB, UNSIGNED_BYTE, RGB8, 1, R8G8B8_UNORM, 1) \
+	FT(R8G8B8_SNORM, 3, 3, RGB, BYTE, RGB8_SNORM, 1, R8G8B8_SNORM, 1) \
+	FT(R8G8B8_UINT, 3, 3, RGB_INTEGER, UNSIGNED_BYTE, RGB8UI, 1, R8G8B8_UINT, 1) \
+	FT(R8G8B8_SINT, 3, 3, RGB_INTEGER, BYTE, RGB8I, 1, R8G8B8_SINT, 1) \
+	FT(R8G8B8_SRGB, 3, 3, SRGB, UNSIGNED_BYTE, SRGB8, 1, R8G8B8_SRGB, 1) \
+	FT(B8G8R8_UNORM, 3, 3, BGR, UNSIGNED_BYTE, RGB8, 1, B8G8R8_UNORM, 1) \
+	FT(B8G8R8_SNORM, 3, 3, BGR, BYTE, RGB8_SNORM, 1, B8G8R8_SNORM, 1) \
+	FT(B8G8R8_UINT, 3, 3, BGR_INTEGER, UNSIGNED_BYTE, RGB8UI, 1, B8G8R8_UINT, 1) \
+	FT(B8G8R8_SINT, 3, 3, BGR_INTEGER, BYTE, RGB8I, 1, B8G8R8_SINT, 1) \
+	FT(B8G8R8_SRGB, 3, 3, BGR, UNSIGNED_BYTE, SRGB8, 1, B8G8R8_SRGB, 1) \
+	FT(R8G8B8A8_UNORM, 4, 4, RGBA, UNSIGNED_BYTE, RGBA8, 1, R8G8B8A8_UNORM, 1) \
+	FT(R8G8B8A8_SNORM, 4, 4, RGBA, BYTE, RGBA8_SNORM, 1, R8G8B8A8_SNORM, 1) \
+	FT(R8G8B8A8_UINT, 4, 4, RGBA_INTEGER, UNSIGNED_BYTE, RGBA8UI, 1, R8G8B8A8_UINT, 1) \
+	FT(R8G8B8A8_SINT, 4, 4, RGBA_INTEGER, BYTE, RGBA8I, 1, R8G8B8A8_SINT, 1) \
+	FT(R8G8B8A8_SRGB, 4, 4, SRGB_ALPHA, UNSIGNED_BYTE, SRGB8_ALPHA8, 1, R8G8B8A8_SRGB, 1) \
+	FT(B8G8R8A8_UNORM, 4, 4, BGRA, UNSIGNED_BYTE, RGBA8, 1, B8G8R8A8_UNORM, 1) \
+	FT(B8G8R8A8_SNORM, 4, 4, BGRA, BYTE, RGBA8_SNORM, 1, B8G8R8A8_SNORM, 1) \
+	FT(B8G8R8A8_UINT, 4, 4, BGRA_INTEGER, UNSIGNED_BYTE, RGBA8UI, 1, B8G8R8A8_UINT, 1) \
+	FT(B8G8R8A8_SINT, 4, 4, BGRA_INTEGER, BYTE, RGBA8I, 1, B8G8R8A8_SINT, 1) \
+	FT(B8G8R8A8_SRGB, 4, 4, BGRA, UNSIGNED_BYTE, SRGB8_ALPHA8, 1, B8G8R8A8_SRGB, 1) \
+	FT(E5B9G9R9_UFLOAT_PACK32, 4, 3, RGB, UNSIGNED_INT_5_9_9_9_REV, RGB9_E5, 4, E5B9G9R9_UFLOAT, 1) \
+	FT(A8B8G8R8_UNORM_PACK32, 4, 4, ABGR, UNSIGNED_BYTE, RGBA8, 1, UNDEFINED, 0) \
+	FT(A8B8G8R8_SNORM_PACK32, 4, 4, ABGR, BYTE, RGBA8_SNORM, 1, UNDEFINED, 0) \
+	FT(A8B8G8R8_UINT_PACK32, 4, 4, ABGR, UNSIGNED_BYTE, RGBA8UI, 1, UNDEFINED, 0) \
+	FT(A8B8G8R8_SINT_PACK32, 4, 4, ABGR, BYTE, RGBA8I, 1, UNDEFINED, 0) \
+	FT(A8B8G8R8_SRGB_PACK32, 4, 4, ABGR, UNSIGNED_BYTE, SRGB8_ALPHA8, 1, UNDEFINED, 0) \
+	FT(B10G11R11_UFLOAT_PACK32, 4, 3, RGB, UNSIGNED_INT_10F_11F_11F_REV, R11F_G11F_B10F, 4, B10G11R11_UFLOAT, 1) \
+	FT(R16_UNORM, 2, 1, RED, UNSIGNED_SHORT, R16, 2, R16_UNORM, 1) \
+	FT(R16_SNORM, 2, 1, RED, SHORT, R16_SNORM, 2, R16_SNORM, 1) \
+	FT(R16_UINT, 2, 1, RED_INTEGER, UNSIGNED_SHORT, R16UI, 2, R16_UINT, 1) \
+	FT(R16_SINT, 2, 1, RED_INTEGER, SHORT, R16I, 2, R16_SINT, 1) \
+	FT(R16_SFLOAT, 2, 1, RED, HALF_FLOAT, R16F, 2, R16_SFLOAT, 1) \
+	FT(R16G16_UNORM, 4, 2, RG, UNSIGNED_SHORT, RG16, 2, R16G16_UNORM, 1) \
+	FT(R16G16_SNORM, 4, 2, RG, SHORT, RG16_SNORM, 2, R16G16_SNORM, 1) \
+	FT(R16G16_UINT, 4, 2, RG_INTEGER, UNSIGNED_SHORT, RG16UI, 2, R16G16_UINT, 1) \
+	FT(R16G16_SINT, 4, 2, RG_INTEGER, SHORT, RG16I, 2, R16G16_SINT, 1) \
+	FT(R16G16_SFLOAT, 4, 2, RG, HALF_FLOAT, RG16F, 2, R16G16_SFLOAT, 1) \
+	FT(R16G16B16_UNORM, 6, 3, RGB, UNSIGNED_SHORT, RGB16, 2, R16G16B16_UNORM, 1) \
+	FT(R16G16B16_SNORM, 6, 3, RGB, SHORT, RGB16_SNORM, 2, R16G16B16_SNORM, 1) \
+	FT(R16G16B16_UINT, 6, 3, RGB_INTEGER, UNSIGNED_SHORT, RGB16UI, 2, R16G16B16_UINT, 1) \
+	FT(R16G16B16_SINT, 6, 3, RGB_INTEGER, SHORT, RGB16I, 2, R16G16B16_SINT, 1) \
+	FT(R16G16B16_SFLOAT, 6, 3, RGB, HALF_FLOAT, RGB16F, 2, R16G16B16_SFLOAT, 1) \
+	FT(R16G16B16A16_UNORM, 8, 4, RGBA, UNSIGNED_SHORT, RGBA16, 2, R16G16B16A16_UNORM, 1) \
+	FT(R16G16B16A16_SNORM, 8, 4, RGBA, SHORT, RGBA16_SNORM, 2, R16G16B16A16_SNORM, 1) \
+	FT(R16G16B16A16_UINT, 8, 4, RGBA_INTEGER, UNSIGNED_SHORT, RGBA16UI, 2, R16G16B16A16_UINT, 1) \
+	FT(R16G16B16A16_SINT, 8, 4, RGBA_INTEGER, SHORT, RGBA16I, 2, R16G16B16A16_SINT, 1) \
+	FT(R16G16B16A16_SFLOAT, 8, 4, RGBA, HALF_FLOAT, RGBA16F, 2, R16G16B16A16_SFLOAT, 1) \
+	FT(R32_UINT, 4, 1, RED_INTEGER, UNSIGNED_INT, R32UI, 4, R32_UINT, 1) \
+	FT(R32_SINT, 4, 1, RED_INTEGER, INT, R32I, 4, R32_SINT, 1) \
+	FT(R32_SFLOAT, 4, 1, RED, FLOAT, R32F, 4, R32_SFLOAT, 1) \
+	FT(R32G32_UINT, 8, 2, RG_INTEGER, UNSIGNED_INT, RG32UI, 4, R32G32_UINT, 1) \
+	FT(R32G32_SINT, 8, 2, RG_INTEGER, INT, RG32I, 4, R32G32_SINT, 1) \
+	FT(R32G32_SFLOAT, 8, 2, RG, FLOAT, RG32F, 4, R32G32_SFLOAT, 1) \
+	FT(R32G32B32_UINT, 12, 3, RGB_INTEGER, UNSIGNED_INT, RGB32UI, 4, R32G32B32_UINT, 1) \
+	FT(R32G32B32_SINT, 12, 3, RGB_INTEGER, INT, RGB32I, 4, R32G32B32_SINT, 1) \
+	FT(R32G32B32_SFLOAT, 12, 3, RGB, FLOAT, RGB32F, 4, R32G32B32_SFLOAT, 1) \
+	FT(R32G32B32A32_UINT, 16, 4, RGBA_INTEGER, UNSIGNED_INT, RGBA32UI, 4, R32G32B32A32_UINT, 1) \
+	FT(R32G32B32A32_SINT, 16, 4, RGBA_INTEGER, INT, RGBA32I, 4, R32G32B32A32_SINT, 1) \
+	FT(R32G32B32A32_SFLOAT, 16, 4, RGBA, FLOAT, RGBA32F, 4, R32G32B32A32_SFLOAT, 1) \
+	FTC(BC1_RGB_UNORM_BLOCK, 4, 4, 8, 3, RGB, RGB_S3TC_DXT1, DXBC1_RGB_UNORM, 1) \
+	FTC(BC1_RGB_SRGB_BLOCK, 4, 4, 8, 3, RGB, SRGB_S3TC_DXT1, DXBC1_RGB_SRGB, 1) \
+	FTC(BC1_RGBA_UNORM_BLOCK, 4, 4, 8, 4, RGBA, RGBA_S3TC_DXT1, DXBC1_RGBA_UNORM, 1) \
+	FTC(BC1_RGBA_SRGB_BLOCK, 4, 4, 8, 4, RGBA, SRGB_ALPHA_S3TC_DXT1, DXBC1_RGBA_SRGB, 1) \
+	FTC(BC2_UNORM_BLOCK, 4, 4, 16, 4, RGBA, RGBA_S3TC_DXT3, DXBC2_UNORM, 1) \
+	FTC(BC2_SRGB_BLOCK, 4, 4, 16, 4, RGBA, SRGB_ALPHA_S3TC_DXT3, DXBC2_SRGB, 1) \
+	FTC(BC3_UNORM_BLOCK, 4, 4, 16, 4, RGBA, RGBA_S3TC_DXT5, DXBC3_UNORM, 1) \
+	FTC(BC3_SRGB_BLOCK, 4, 4, 16, 4, RGBA, SRGB_ALPHA_S3TC_DXT5, DXBC3_SRGB, 1) \
+	FTC(BC4_UNORM_BLOCK, 4, 4, 8, 1, RED, RED_RGTC1, DXBC4_UNORM, 1) \
+	FTC(BC4_SNORM_BLOCK, 4, 4, 8, 1, RED, SIGNED_RED_RGTC1, DXBC4_SNORM, 1) \
+	FTC(BC5_UNORM_BLOCK, 4, 4, 16, 2, RG, RED_GREEN_RGTC2, DXBC5_UNORM, 1) \
+	FTC(BC5_SNORM_BLOCK, 4, 4, 16, 2, RG, SIGNED_RED_GREEN_RGTC2, DXBC5_SNORM, 1) \
+	FTC(BC6H_UFLOAT_BLOCK, 4, 4, 16, 3, RGB, RGB_BPTC_UNSIGNED_FLOAT, DXBC6H_UFLOAT, 1) \
+	FTC(BC6H_SFLOAT_BLOCK, 4, 4, 16, 3, RGB, RGB_BPTC_SIGNED_FLOAT, DXBC6H_SFLOAT, 1) \
+	FTC(BC7_UNORM_BLOCK, 4, 4, 16, 4, RGBA, RGBA_BPTC_UNORM, DXBC7_UNORM, 1) \
+	FTC(BC7_SRGB_BLOCK, 4, 4, 16, 4, RGBA, SRGB_ALPHA_BPTC_UNORM, DXBC7_SRGB, 1) \
+	FTC(ETC2_R8G8B8_UNORM_BLOCK, 4, 4, 8, 3, RGB, RGB8_ETC2, ETC2_R8G8B8_UNORM, 1) \
+	FTC(ETC2_R8G8B8A1_UNORM_BLOCK, 4, 4, 8, 4, RGBA, RGB8_PUNCHTHROUGH_ALPHA1_ETC2, ETC2_R8G8B8A1_UNORM, 1) \
+	FTC(ETC2_R8G8B8A8_UNORM_BLOCK, 4, 4, 16, 4, RGBA, RGBA8_ETC2_EAC, ETC2_R8G8B8A8_UNORM, 1) \
+	FTC(ETC2_R8G8B8_SRGB_BLOCK, 4, 4, 8, 3, SRGB, SRGB8_ETC2, ETC2_R8G8B8_SRGB, 1) \
+	FTC(ETC2_R8G8B8A1_SRGB_BLOCK, 4, 4, 8, 4, SRGB_ALPHA, SRGB8_PUNCHTHROUGH_ALPHA1_ETC2, ETC2_R8G8B8A1_SRGB, 1) \
+	FTC(ETC2_R8G8B8A8_SRGB_BLOCK, 4, 4, 16, 4, SRGB_ALPHA, SRGB8_ALPHA8_ETC2_EAC, ETC2_R8G8B8A8_SRGB, 1) \
+	FTC(EAC_R11_UNORM_BLOCK, 4, 4, 8, 1, RED, R11_EAC, ETC2_EAC_R11_UNORM, 1) \
+	FTC(EAC_R11G11_UNORM_BLOCK, 4, 4, 16, 2, RG, RG11_EAC, ETC2_EAC_R11G11_UNORM, 1) \
+	FTC(EAC_R11_SNORM_BLOCK, 4, 4, 8, 1, RED, SIGNED_R11_EAC, ETC2_EAC_R11_SNORM, 1) \
+	FTC(EAC_R11G11_SNORM_BLOCK, 4, 4, 16, 2, RG, SIGNED_RG11_EAC, ETC2_EAC_R11G11_SNORM, 1) \
+	FTC(PVR_2BPP_UNORM_BLOCK, 8, 4, 8, 3, RGB, RGB_PVRTC_2BPPV1, PVRTC1_2BPP_UNORM, 0) \
+	FTC(PVR_2BPPA_UNORM_BLOCK, 8, 4, 8, 4, RGBA, RGBA_PVRTC_2BPPV1, PVRTC1_2BPP_UNORM, 1) \
+	FTC(PVR_4BPP_UNORM_BLOCK, 4, 4, 8, 3, RGB, RGB_PVRTC_4BPPV1, PVRTC1_4BPP_UNORM, 0) \
+	FTC(PVR_4BPPA_UNORM_BLOCK, 4, 4, 8, 4, RGBA, RGBA_PVRTC_4BPPV1, PVRTC1_4BPP_UNORM, 1) \
+	FTC(PVR_2BPP_SRGB_BLOCK, 8, 4, 8, 3, SRGB, SRGB_PVRTC_2BPPV1, PVRTC1_2BPP_SRGB, 0) \
+	FTC(PVR_2BPPA_SRGB_BLOCK, 8, 4, 8, 4, SRGB_ALPHA, SRGB_ALPHA_PVRTC_2BPPV1, PVRTC1_2BPP_SRGB, 1) \
+	FTC(PVR_4BPP_SRGB_BLOCK, 4, 4, 8, 3, SRGB, SRGB_PVRTC_4BPPV1, PVRTC1_4BPP_SRGB, 0) \
+	FTC(PVR_4BPPA_SRGB_BLOCK, 4, 4, 8, 4, SRGB_ALPHA, SRGB_ALPHA_PVRTC_4BPPV1, PVRTC1_4BPP_SRGB, 1) \
+	FTC(ASTC_4x4_UNORM_BLOCK, 4, 4, 16, 4, RGBA, RGBA_ASTC_4x4, ASTC_4x4_UNORM, 1) \
+	FTC(ASTC_4x4_SRGB_BLOCK, 4, 4, 16, 4, SRGB_ALPHA, SRGB8_ALPHA8_ASTC_4x4, ASTC_4x4_SRGB, 1) \
+	FTC(ASTC_5x4_UNORM_BLOCK, 5, 4, 16, 4, RGBA, RGBA_ASTC_5x4, ASTC_5x4_UNORM, 1) \
+	FTC(ASTC_5x4_SRGB_BLOCK, 5, 4, 16, 4, SRGB_ALPHA, SRGB8_ALPHA8_ASTC_5x4, ASTC_5x4_SRGB, 1) \
+	FTC(ASTC_5x5_UNORM_BLOCK, 5, 5, 16, 4, RGBA, RGBA_ASTC_5x5, ASTC_5x5_UNORM, 1) \
+	FTC(ASTC_5x5_SRGB_BLOCK, 5, 5, 16, 4, SRGB_ALPHA, SRGB8_ALPHA8_ASTC_5x5, ASTC_5x5_SRGB, 1) \
+	FTC(ASTC_6x5_UNORM_BLOCK, 6, 5, 16, 4, RGBA, RGBA_ASTC_6x5, ASTC_6x5_UNORM, 1) \
+	FTC(ASTC_6x5_SRGB_BLOCK, 6, 5, 16, 4, SRGB_ALPHA, SRGB8_ALPHA8_ASTC_6x5, ASTC_6x5_SRGB, 1) \
+	FTC(ASTC_6x6_UNORM_BLOCK, 6, 6, 16, 4, RGBA, RGBA_ASTC_6x6, ASTC_6x6_UNORM, 1) \
+	FTC(ASTC_6x6_SRGB_BLOCK, 6, 6, 16, 4, SRGB_ALPHA, SRGB8_ALPHA8_ASTC_6x6, ASTC_6x6_SRGB, 1) \
+	FTC(ASTC_8x5_UNORM_BLOCK, 8, 5, 16, 4, RGBA, RGBA_ASTC_8x5, ASTC_8x5_UNORM, 1) \
+	FTC(ASTC_8x5_SRGB_BLOCK, 8, 5, 16, 4, SRGB_ALPHA, SRGB8_ALPHA8_ASTC_8x5, ASTC_8x5_SRGB, 1) \
+	FTC(ASTC_8x6_UNORM_BLOCK, 8, 6, 16, 4, RGBA, RGBA_ASTC_8x6, ASTC_8x6_UNORM, 1) \
+	FTC(ASTC_8x6_SRGB_BLOCK, 8, 6, 16, 4, SRGB_ALPHA, SRGB8_ALPHA8_ASTC_8x6, ASTC_8x6_SRGB, 1) \
+	FTC(ASTC_8x8_UNORM_BLOCK, 8, 8, 16, 4, RGBA, RGBA_ASTC_8x8, ASTC_8x8_UNORM, 1) \
+	FTC(ASTC_8x8_SRGB_BLOCK, 8, 8, 16, 4, SRGB_ALPHA, SRGB8_ALPHA8_ASTC_8x8, ASTC_8x8_SRGB, 1) \
+	FTC(ASTC_10x5_UNORM_BLOCK, 10, 5, 16, 4, RGBA, RGBA_ASTC_10x5, ASTC_10x5_UNORM, 1) \
+	FTC(ASTC_10x5_SRGB_BLOCK, 10, 5, 16, 4, SRGB_ALPHA, SRGB8_ALPHA8_ASTC_10x5, ASTC_10x5_SRGB, 1) \
+	FTC(ASTC_10x6_UNORM_BLOCK, 10, 6, 16, 4, RGBA, RGBA_ASTC_10x6, ASTC_10x6_UNORM, 1) \
+	FTC(ASTC_10x6_SRGB_BLOCK, 10, 6, 16, 4, SRGB_ALPHA, SRGB8_ALPHA8_ASTC_10x6, ASTC_10x6_SRGB, 1) \
+	FTC(ASTC_10x8_UNORM_BLOCK, 10, 8, 16, 4, RGBA, RGBA_ASTC_10x8, ASTC_10x8_UNORM, 1) \
+	FTC(ASTC_10x8_SRGB_BLOCK, 10, 8, 16, 4, SRGB_ALPHA, SRGB8_ALPHA8_ASTC_10x8, ASTC_10x8_SRGB, 1) \
+	FTC(ASTC_10x10_UNORM_BLOCK, 10, 10, 16, 4, RGBA, RGBA_ASTC_10x10, ASTC_10x10_UNORM, 1) \
+	FTC(ASTC_10x10_SRGB_BLOCK, 10, 10, 16, 4, SRGB_ALPHA, SRGB8_ALPHA8_ASTC_10x10, ASTC_10x10_SRGB, 1) \
+	FTC(ASTC_12x10_UNORM_BLOCK, 12, 10, 16, 4, RGBA, RGBA_ASTC_12x10, ASTC_12x10_UNORM, 1) \
+	FTC(ASTC_12x10_SRGB_BLOCK, 12, 10, 16, 4, SRGB_ALPHA, SRGB8_ALPHA8_ASTC_12x10, ASTC_12x10_SRGB, 1) \
+	FTC(ASTC_12x12_UNORM_BLOCK, 12, 12, 16, 4, RGBA, RGBA_ASTC_12x12, ASTC_12x12_UNORM, 1) \
+	FTC(ASTC_12x12_SRGB_BLOCK, 12, 12, 16, 4, SRGB_ALPHA, SRGB8_ALPHA8_ASTC_12x12, ASTC_12x12_SRGB, 1)
+
 #ifdef TINYKTX_IMPLEMENTATION
 
+// SIMD kernels are picked at compile time from what the compiler targets (-mssse3, -mavx2,
+// /arch:AVX2, aarch64), define TINYKTX_NO_SIMD to always use the scalar code
+#ifndef TINYKTX_NO_SIMD
+#if defined(__AVX2__)
+#define TINYKTX_AVX2 1
+#include <immintrin.h>
+#endif
+#if defined(__SSSE3__) || defined(__AVX__)
+#define TINYKTX_SSSE3 1
+#include <tmmintrin.h>
+#endif
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define TINYKTX_SSE2 1
+#include <emmintrin.h>
+#endif
+#if defined(__F16C__) || (defined(_MSC_VER) && defined(__AVX2__))
+#define TINYKTX_F16C 1
+#include <immintrin.h>
+#endif
+#if defined(__ARM_NEON) && defined(__aarch64__)
+#define TINYKTX_NEON 1
+#include <arm_neon.h>
+#endif
+#endif
+
 typedef struct TinyKtx_Header {
 	uint8_t identifier[12];
 	uint32_t endianness;
@@ -809,8 +1298,10 @@ typedef struct TinyKtx_Context {
 	TinyKtx_KeyValuePair const *keyData;
 	bool headerValid;
 	bool sameEndian;
+	TinyKtx_Format format; // resolved once at ReadHeader
+	TinyKtx_Origin readOrigin;
 
-	uint32_t mipMapSizes[TINYKTX_MAX_MIPMAPLEVELS];
+	uint64_t mipMapSizes[TINYKTX_MAX_MIPMAPLEVELS];
 	uint8_t const *mipmaps[TINYKTX_MAX_MIPMAPLEVELS];
 
 } TinyKtx_Context;
@@ -819,7 +1310,10 @@ static uint8_t TinyKtx_fileIdentifier[12] = {
 		0xAB, 0x4B, 0x54, 0x58, 0x20, 0x31, 0x31, 0xBB, 0x0D, 0x0A, 0x1A, 0x0A
 };
 
-static void TinyKtx_NullErrorFunc(void *user, char const *msg) {}
+static void TinyKtx_NullErrorFunc(void *user, char const *msg) {
+	(void) user;
+	(void) msg;
+}
 
 TinyKtx_ContextHandle TinyKtx_CreateContext(TinyKtx_Callbacks const *callbacks, void *user) {
 	TinyKtx_Context *ctx = (TinyKtx_Context *) callbacks->allocFn(user, sizeof(TinyKtx_Context));
@@ -934,6 +1428,10 @@ bool TinyKtx_ReadHeader(TinyKtx_ContextHandle handle) {
 
 	ctx->firstImagePos = ctx->callbacks.tellFn(ctx->user);
 
+	ctx->format = TinyKtx_CrackFormatFromGL(ctx->header.glFormat,
+																					ctx->header.glType,
+																					ctx->header.glInternalFormat,
+																					ctx->header.glTypeSize);
 	ctx->headerValid = true;
 	return true;
 }
@@ -952,20 +1450,50 @@ bool TinyKtx_GetValue(TinyKtx_ContextHandle handle, char const *key, void const
 		return false;
 	}
 
-	TinyKtx_KeyValuePair const *curKey = ctx->keyData;
-	while (((uint8_t *) curKey - (uint8_t *) ctx->keyData) < ctx->header.bytesOfKeyValueData) {
-		char const *kvp = (char const *) curKey;
-
-		if (strcmp(kvp, key) == 0) {
-			size_t sl = strlen(kvp);
-			*value = (void const *) (kvp + sl);
+	// each entry is a uint32_t size then a null terminated key and the value, padded to 4
+	uint8_t const *cur = (uint8_t const *) ctx->keyData;
+	uint8_t const *const end = cur + ctx->header.bytesOfKeyValueData;
+	size_t const keyLength = strlen(key);
+	while (cur < end && (size_t) (end - cur) >= sizeof(TinyKtx_KeyValuePair)) {
+		TinyKtx_KeyValuePair kvp;
+		memcpy(&kvp, cur, sizeof(TinyKtx_KeyValuePair));
+		char const *keyValue = (char const *) (cur + sizeof(TinyKtx_KeyValuePair));
+		if (kvp.size > (size_t) (end - (uint8_t const *) keyValue))
+			break;
+
+		if (keyLength < kvp.size && memcmp(keyValue, key, keyLength + 1) == 0) {
+			*value = (void const *) (keyValue + keyLength + 1);
 			return true;
 		}
-		curKey = curKey + ((curKey->size + 3u) & ~3u);
+		cur = (uint8_t const *) keyValue + ((kvp.size + 3u) & ~3u);
 	}
 	return false;
 }
 
+TinyKtx_Origin TinyKtx_GetOrigin(TinyKtx_ContextHandle handle) {
+	TinyKtx_Context *ctx = (TinyKtx_Context *) handle;
+	if (ctx == NULL || ctx->headerValid == false || ctx->keyData == NULL || ctx->header.bytesOfKeyValueData == 0)
+		return TKTX_ORIGIN_UNKNOWN;
+
+	// "S=r,T=d" with R=i/o after it for volumes, the value is null terminated
+	void const *value;
+	if (!TinyKtx_GetValue(handle, "KTXorientation", &value))
+		return TKTX_ORIGIN_UNKNOWN;
+	uint8_t const *const end = (uint8_t const *) ctx->keyData + ctx->header.bytesOfKeyValueData;
+	for (char const *c = (char const *) value; (uint8_t const *) c + 2 < end && *c; ++c) {
+		if (c[0] == 'T' && c[1] == '=')
+			return (c[2] == 'u') ? TKTX_ORIGIN_BOTTOM_LEFT : (c[2] == 'd') ? TKTX_ORIGIN_TOP_LEFT : TKTX_ORIGIN_UNKNOWN;
+	}
+	return TKTX_ORIGIN_UNKNOWN;
+}
+
+void TinyKtx_SetReadOrigin(TinyKtx_ContextHandle handle, TinyKtx_Origin origin) {
+	TinyKtx_Context *ctx = (TinyKtx_Context *) handle;
+	if (ctx == NULL)
+		return;
+	ctx->readOrigin = (origin == TKTX_ORIGIN_UNKNOWN) ? TKTX_ORIGIN_FILE : origin;
+}
+
 bool TinyKtx_Is1D(TinyKtx_ContextHandle handle) {
 	TinyKtx_Context *ctx = (TinyKtx_Context *) handle;
 	if (ctx == NULL)
@@ -1038,7 +1566,7 @@ bool TinyKtx_Dimensions(TinyKtx_ContextHandle handle,
 	if (width)
 		*width = ctx->header.pixelWidth;
 	if (height)
-		*height = ctx->header.pixelWidth;
+		*height = ctx->header.pixelHeight;
 	if (depth)
 		*depth = ctx->header.pixelDepth;
 	if (slices)
@@ -1147,7 +1675,7 @@ bool TinyKtx_GetFormatGL(TinyKtx_ContextHandle handle, uint32_t *glformat, uint3
 	return true;
 }
 
-static uint32_t TinyKtx_imageSize(TinyKtx_ContextHandle handle, uint32_t mipmaplevel, bool seekLast) {
+static uint64_t TinyKtx_imageSize(TinyKtx_ContextHandle handle, uint32_t mipmaplevel, bool seekLast) {
 	TinyKtx_Context *ctx = (TinyKtx_Context *) handle;
 
 	if (mipmaplevel >= ctx->header.numberOfMipmapLevels) {
@@ -1163,7 +1691,7 @@ static uint32_t TinyKtx_imageSize(TinyKtx_ContextHandle handle, uint32_t mipmapl
 
 	uint64_t currentOffset = ctx->firstImagePos;
 	for (uint32_t i = 0; i <= mipmaplevel; ++i) {
-		uint32_t size;
+		uint64_t size;
 		// if we have already read this mipmaps size use it
 		if (ctx->mipMapSizes[i] != 0) {
 			size = ctx->mipMapSizes[i];
@@ -1173,11 +1701,13 @@ static uint32_t TinyKtx_imageSize(TinyKtx_ContextHandle handle, uint32_t mipmapl
 		} else {
 			// otherwise seek and read it
 			ctx->callbacks.seekFn(ctx->user, currentOffset);
-			size_t readchk = ctx->callbacks.readFn(ctx->user, &size, sizeof(uint32_t));
+			uint32_t imageSize;
+			size_t readchk = ctx->callbacks.readFn(ctx->user, &imageSize, sizeof(uint32_t));
 			if(readchk != 4) {
 				ctx->callbacks.errorFn(ctx->user, "Reading image size error");
 				return 0;
 			}
+			size = imageSize;
 			// so in the really small print KTX v1 states GL_UNPACK_ALIGNMENT = 4
 			// which PVR Texture Tool and I missed. It means pad to 1, 2, 4, 8
 			// note 3 or 6 bytes are rounded up.
@@ -1185,18 +1715,18 @@ static uint32_t TinyKtx_imageSize(TinyKtx_ContextHandle handle, uint32_t mipmapl
 			// it not to standard but its really the level up that has to do this
 
 			if (ctx->header.numberOfFaces == 6 && ctx->header.numberOfArrayElements == 0) {
-				size = ((size + 3u) & ~3u) * 6; // face padding and 6 faces
+				size = ((size + 3u) & ~(uint64_t) 3u) * 6; // face padding and 6 faces
 			}
 
 			ctx->mipMapSizes[i] = size;
 		}
-		currentOffset += (size + sizeof(uint32_t) + 3u) & ~3u; // size + mip padding
+		currentOffset += (size + sizeof(uint32_t) + 3u) & ~(uint64_t) 3u; // size + mip padding
 	}
 
 	return ctx->mipMapSizes[mipmaplevel];
 }
 
-uint32_t TinyKtx_ImageSize(TinyKtx_ContextHandle handle, uint32_t mipmaplevel) {
+uint64_t TinyKtx_ImageSize64(TinyKtx_ContextHandle handle, uint32_t mipmaplevel) {
 	TinyKtx_Context *ctx = (TinyKtx_Context *) handle;
 	if (ctx == NULL) return 0;
 
@@ -1207,6 +1737,30 @@ uint32_t TinyKtx_ImageSize(TinyKtx_ContextHandle handle, uint32_t mipmaplevel) {
 	return TinyKtx_imageSize(handle, mipmaplevel, false);
 }
 
+uint32_t TinyKtx_ImageSize(TinyKtx_ContextHandle handle, uint32_t mipmaplevel) {
+	uint64_t const size = TinyKtx_ImageSize64(handle, mipmaplevel);
+	if (size > 0xFFFFFFFFu) {
+		TinyKtx_Context *ctx = (TinyKtx_Context *) handle;
+		ctx->callbacks.errorFn(ctx->user, "Mipmap level is 4GB or more, use TinyKtx_ImageSize64");
+		return 0;
+	}
+	return (uint32_t) size;
+}
+
+// reads are split so no single readFn call is larger than maxChunkSize (or size_t)
+static bool TinyKtx_read(TinyKtx_Context *ctx, void *buffer, uint64_t byteCount) {
+	size_t const maxChunk = ctx->callbacks.maxChunkSize ? ctx->callbacks.maxChunkSize : (size_t) -1;
+	uint8_t *dst = (uint8_t *) buffer;
+	while (byteCount) {
+		size_t const size = (byteCount < maxChunk) ? (size_t) byteCount : maxChunk;
+		if (ctx->callbacks.readFn(ctx->user, dst, size) != size)
+			return false;
+		dst += size;
+		byteCount -= size;
+	}
+	return true;
+}
+
 void const *TinyKtx_ImageRawData(TinyKtx_ContextHandle handle, uint32_t mipmaplevel) {
 	TinyKtx_Context *ctx = (TinyKtx_Context *) handle;
 	if (ctx == NULL)
@@ -1230,28 +1784,129 @@ void const *TinyKtx_ImageRawData(TinyKtx_ContextHandle handle, uint32_t mipmaple
 	if (ctx->mipmaps[mipmaplevel] != NULL)
 		return ctx->mipmaps[mipmaplevel];
 
-	uint32_t size = TinyKtx_imageSize(handle, mipmaplevel, true);
+	uint64_t size = TinyKtx_imageSize(handle, mipmaplevel, true);
 	if (size == 0)
 		return NULL;
+	if (size > (size_t) -1 || (ctx->callbacks.maxChunkSize && size > ctx->callbacks.maxChunkSize)) {
+		ctx->callbacks.errorFn(ctx->user, "Mipmap level is larger than maxChunkSize, use TinyKtx_ReadLevelChunks");
+		return NULL;
+	}
 
-	ctx->mipmaps[mipmaplevel] = (uint8_t const*) ctx->callbacks.allocFn(ctx->user, size);
+	ctx->mipmaps[mipmaplevel] = (uint8_t const*) ctx->callbacks.allocFn(ctx->user, (size_t) size);
 	if (ctx->mipmaps[mipmaplevel]) {
-		ctx->callbacks.readFn(ctx->user, (void *) ctx->mipmaps[mipmaplevel], size);
+		TinyKtx_read(ctx, (void *) ctx->mipmaps[mipmaplevel], size);
 	}
 
 	return ctx->mipmaps[mipmaplevel];
 }
 
-#define FT(fmt, type, intfmt, size) *glformat = TINYKTX_GL_FORMAT_##fmt; \
-                                    *gltype = TINYKTX_GL_TYPE_##type; \
-                                    *glinternalformat = TINYKTX_GL_INTFORMAT_##intfmt; \
-                                    *typesize = size; \
-                                    return true;
-#define FTC(fmt, intfmt) *glformat = TINYKTX_GL_FORMAT_##fmt; \
-                                    *gltype = TINYKTX_GL_TYPE_COMPRESSED; \
-                                    *glinternalformat = TINYKTX_GL_COMPRESSED_##intfmt; \
-                                    *typesize = 1; \
-                                    return true;
+bool TinyKtx_ReadLevelChunks(TinyKtx_ContextHandle handle, uint32_t mipmaplevel, TinyKtx_LevelChunkFunc chunkFn, void *chunkUser) {
+	TinyKtx_Context *ctx = (TinyKtx_Context *) handle;
+	if (ctx == NULL || chunkFn == NULL)
+		return false;
+
+	if (ctx->headerValid == false) {
+		ctx->callbacks.errorFn(ctx->user, "Header data hasn't been read yet or its invalid");
+		return false;
+	}
+
+	uint64_t const size = TinyKtx_imageSize(handle, mipmaplevel, true);
+	if (size == 0)
+		return false;
+
+	size_t const maxChunk = ctx->callbacks.maxChunkSize ? ctx->callbacks.maxChunkSize : 64 * 1024;
+	size_t const bufferSize = (size < maxChunk) ? (size_t) size : maxChunk;
+	uint8_t *buffer = (uint8_t *) ctx->callbacks.allocFn(ctx->user, bufferSize);
+	if (buffer == NULL)
+		return false;
+
+	bool okay = true;
+	for (uint64_t offset = 0; offset < size && okay;) {
+		size_t const chunk = (size - offset < bufferSize) ? (size_t) (size - offset) : bufferSize;
+		if (ctx->callbacks.readFn(ctx->user, buffer, chunk) != chunk) {
+			ctx->callbacks.errorFn(ctx->user, "Truncated mipmap level");
+			okay = false;
+			break;
+		}
+		okay = chunkFn(chunkUser, mipmaplevel, offset, buffer, chunk);
+		offset += chunk;
+	}
+	ctx->callbacks.freeFn(ctx->user, buffer);
+	return okay;
+}
+
+void TinyKtx_ReleaseImageRawData(TinyKtx_ContextHandle handle, uint32_t mipmaplevel) {
+	TinyKtx_Context *ctx = (TinyKtx_Context *) handle;
+	if (ctx == NULL || mipmaplevel >= TINYKTX_MAX_MIPMAPLEVELS)
+		return;
+
+	if (ctx->mipmaps[mipmaplevel] != NULL) {
+		ctx->callbacks.freeFn(ctx->user, (void *) ctx->mipmaps[mipmaplevel]);
+		ctx->mipmaps[mipmaplevel] = NULL;
+	}
+}
+
+
+// extra GL descriptions CrackFormatFromGL accepts but CrackFormatToGL never
+// writes. Legacy (LATC, 3DC, luminance etc.) and older TinyKtx encodings
+// FA(format, glformat, gltype, glinternalformat)
+// FAC(format, glformat, glcompressedformat)
+#define TINYKTX_FORMAT_ALIASES(FA, FAC) \
+	FAC(BC4_UNORM_BLOCK, RED, 3DC_X_AMD) \
+	FAC(BC5_UNORM_BLOCK, RG, 3DC_XY_AMD) \
+	FAC(BC4_UNORM_BLOCK, LUMINANCE, LUMINANCE_LATC1) \
+	FAC(BC4_SNORM_BLOCK, LUMINANCE, SIGNED_LUMINANCE_LATC1) \
+	FAC(BC5_UNORM_BLOCK, LUMINANCE_ALPHA, LUMINANCE_ALPHA_LATC2) \
+	FAC(BC5_SNORM_BLOCK, LUMINANCE_ALPHA, SIGNED_LUMINANCE_ALPHA_LATC2) \
+	FAC(ETC2_R8G8B8_UNORM_BLOCK, RGB, ETC1_RGB8_OES) \
+	FA(B5G6R5_UNORM_PACK16, RGB, UNSIGNED_SHORT_5_6_5, RGB565) \
+	FA(A1R5G5B5_UNORM_PACK16, BGRA, UNSIGNED_SHORT_1_5_5_5_REV, RGB5_A1) \
+	FA(R8_SNORM, RED, BYTE, R8) \
+	FA(R8G8_SNORM, RG, BYTE, RG8) \
+	FA(R8G8B8_SNORM, RGB, BYTE, RGB8) \
+	FA(B8G8R8_SNORM, BGR, BYTE, RGB8) \
+	FA(R8G8B8A8_SNORM, RGBA, BYTE, RGBA8) \
+	FA(B8G8R8A8_SNORM, BGRA, BYTE, RGBA8) \
+	FA(A8B8G8R8_SNORM_PACK32, ABGR, BYTE, RGBA8) \
+	FA(B10G11R11_UFLOAT_PACK32, RGB, UNSIGNED_INT_10F_11F_11F_REV, UNSIGNED_INT_10F_11F_11F_REV) \
+	FA(R8_SRGB, SLUMINANCE, UNSIGNED_BYTE, SRGB8) \
+	FA(R8G8_SRGB, SLUMINANCE_ALPHA, UNSIGNED_BYTE, SRGB8) \
+	FA(R8G8B8A8_SRGB, SRGB_ALPHA, UNSIGNED_BYTE, SRGB8) \
+	FA(B8G8R8A8_SRGB, BGRA, UNSIGNED_BYTE, SRGB8) \
+	FA(A8B8G8R8_SRGB_PACK32, ABGR, UNSIGNED_BYTE, SRGB8) \
+	FA(R8_SRGB, SLUMINANCE, UNSIGNED_BYTE, SRGB8_ALPHA8) \
+	FA(R8G8_SRGB, SLUMINANCE_ALPHA, UNSIGNED_BYTE, SRGB8_ALPHA8) \
+	FA(R8G8B8_SRGB, SRGB, UNSIGNED_BYTE, SRGB8_ALPHA8) \
+	FA(B8G8R8_SRGB, BGR, UNSIGNED_BYTE, SRGB8_ALPHA8) \
+	FA(R8_UNORM, ALPHA, UNSIGNED_BYTE, ALPHA8) \
+	FA(R8_UNORM, LUMINANCE, UNSIGNED_BYTE, LUMINANCE8) \
+	FA(R8_UNORM, INTENSITY, UNSIGNED_BYTE, INTENSITY8) \
+	FA(R8G8_UNORM, LUMINANCE_ALPHA, UNSIGNED_BYTE, LUMINANCE8_ALPHA8) \
+	FA(R16_UNORM, ALPHA, UNSIGNED_SHORT, ALPHA16) \
+	FA(R16_UNORM, LUMINANCE, UNSIGNED_SHORT, LUMINANCE16) \
+	FA(R16_UNORM, INTENSITY, UNSIGNED_SHORT, INTENSITY16) \
+	FA(R16G16_UNORM, LUMINANCE_ALPHA, UNSIGNED_SHORT, LUMINANCE16_ALPHA16) \
+	FA(R8_SNORM, ALPHA, BYTE, ALPHA8_SNORM) \
+	FA(R8_SNORM, LUMINANCE, BYTE, LUMINANCE8_SNORM) \
+	FA(R8_SNORM, INTENSITY, BYTE, INTENSITY8_SNORM) \
+	FA(R8G8_SNORM, LUMINANCE_ALPHA, BYTE, LUMINANCE8_ALPHA8_SNORM) \
+	FA(R16_SNORM, ALPHA, SHORT, ALPHA16_SNORM) \
+	FA(R16_SNORM, LUMINANCE, SHORT, LUMINANCE16_SNORM) \
+	FA(R16_SNORM, INTENSITY, SHORT, INTENSITY16_SNORM) \
+	FA(R16G16_SNORM, LUMINANCE_ALPHA, SHORT, LUMINANCE16_ALPHA16_SNORM)
+
+#define TINYKTX_TOGL_FT(ktx, bytes, ch, fmt, type, intfmt, size, tif, rev) \
+	case TKTX_##ktx: *glformat = TINYKTX_GL_FORMAT_##fmt; \
+									*gltype = TINYKTX_GL_TYPE_##type; \
+									*glinternalformat = TINYKTX_GL_INTFORMAT_##intfmt; \
+									*typesize = size; \
+									return true;
+#define TINYKTX_TOGL_FTC(ktx, bw, bh, bytes, ch, fmt, intfmt, tif, rev) \
+	case TKTX_##ktx: *glformat = TINYKTX_GL_FORMAT_##fmt; \
+									*gltype = TINYKTX_GL_TYPE_COMPRESSED; \
+									*glinternalformat = TINYKTX_GL_COMPRESSED_##intfmt; \
+									*typesize = 1; \
+									return true;
 
 bool TinyKtx_CrackFormatToGL(TinyKtx_Format format,
 														 uint32_t *glformat,
@@ -1259,568 +1914,170 @@ bool TinyKtx_CrackFormatToGL(TinyKtx_Format format,
 														 uint32_t *glinternalformat,
 														 uint32_t *typesize) {
 	switch (format) {
-	case TKTX_R4G4_UNORM_PACK8: FT(RG, UNSIGNED_SHORT_4_4_4_4, RGB4, 1)
-	case TKTX_R4G4B4A4_UNORM_PACK16: FT(RGBA, UNSIGNED_SHORT_4_4_4_4, RGBA4, 2)
-
-	case TKTX_B4G4R4A4_UNORM_PACK16: FT(BGRA, UNSIGNED_SHORT_4_4_4_4_REV, RGBA4, 2)
-
-	case TKTX_R5G6B5_UNORM_PACK16: FT(RGB, UNSIGNED_SHORT_5_6_5_REV, RGB565, 2)
-	case TKTX_B5G6R5_UNORM_PACK16: FT(BGR, UNSIGNED_SHORT_5_6_5, RGB565, 2)
-
-	case TKTX_R5G5B5A1_UNORM_PACK16: FT(RGBA, UNSIGNED_SHORT_5_5_5_1, RGB5_A1, 2)
-	case TKTX_A1R5G5B5_UNORM_PACK16: FT(RGBA, UNSIGNED_SHORT_1_5_5_5_REV, RGB5_A1, 2)
-	case TKTX_B5G5R5A1_UNORM_PACK16: FT(BGRA, UNSIGNED_SHORT_5_5_5_1, RGB5_A1, 2)
-
-	case TKTX_A2R10G10B10_UNORM_PACK32: FT(BGRA, UNSIGNED_INT_2_10_10_10_REV, RGB10_A2, 4)
-	case TKTX_A2R10G10B10_UINT_PACK32: FT(BGRA_INTEGER, UNSIGNED_INT_2_10_10_10_REV, RGB10_A2, 4)
-	case TKTX_A2B10G10R10_UNORM_PACK32: FT(RGBA, UNSIGNED_INT_2_10_10_10_REV, RGB10_A2, 4)
-	case TKTX_A2B10G10R10_UINT_PACK32: FT(RGBA_INTEGER, UNSIGNED_INT_2_10_10_10_REV, RGB10_A2, 4)
-
-	case TKTX_R8_UNORM: FT(RED, UNSIGNED_BYTE, R8, 1)
-	case TKTX_R8_SNORM: FT(RED, BYTE, R8_SNORM, 1)
-	case TKTX_R8_UINT: FT(RED_INTEGER, UNSIGNED_BYTE, R8UI, 1)
-	case TKTX_R8_SINT: FT(RED_INTEGER, BYTE, R8I, 1)
-	case TKTX_R8_SRGB: FT(SLUMINANCE, UNSIGNED_BYTE, SRGB8, 1)
-
-	case TKTX_R8G8_UNORM: FT(RG, UNSIGNED_BYTE, RG8, 1)
-	case TKTX_R8G8_SNORM: FT(RG, BYTE, RG8_SNORM, 1)
-	case TKTX_R8G8_UINT: FT(RG_INTEGER, UNSIGNED_BYTE, RG8UI, 1)
-	case TKTX_R8G8_SINT: FT(RG_INTEGER, BYTE, RG8I, 1)
-	case TKTX_R8G8_SRGB: FT(SLUMINANCE_ALPHA, UNSIGNED_BYTE, SRGB8, 1)
-
-	case TKTX_R8G8B8_UNORM: FT(RGB, UNSIGNED_BYTE, RGB8, 1)
-	case TKTX_R8G8B8_SNORM: FT(RGB, BYTE, RGB8_SNORM, 1)
-	case TKTX_R8G8B8_UINT: FT(RGB_INTEGER, UNSIGNED_BYTE, RGB8UI, 1)
-	case TKTX_R8G8B8_SINT: FT(RGB_INTEGER, BYTE, RGB8I, 1)
-	case TKTX_R8G8B8_SRGB: FT(SRGB, UNSIGNED_BYTE, SRGB8, 1)
-
-	case TKTX_B8G8R8_UNORM: FT(BGR, UNSIGNED_BYTE, RGB8, 1)
-	case TKTX_B8G8R8_SNORM: FT(BGR, BYTE, RGB8_SNORM, 1)
-	case TKTX_B8G8R8_UINT: FT(BGR_INTEGER, UNSIGNED_BYTE, RGB8UI, 1)
-	case TKTX_B8G8R8_SINT: FT(BGR_INTEGER, BYTE, RGB8I, 1)
-	case TKTX_B8G8R8_SRGB: FT(BGR, UNSIGNED_BYTE, SRGB8, 1)
-
-	case TKTX_R8G8B8A8_UNORM:FT(RGBA, UNSIGNED_BYTE, RGBA8, 1)
-	case TKTX_R8G8B8A8_SNORM:FT(RGBA, BYTE, RGBA8_SNORM, 1)
-	case TKTX_R8G8B8A8_UINT: FT(RGBA_INTEGER, UNSIGNED_BYTE, RGBA8UI, 1)
-	case TKTX_R8G8B8A8_SINT: FT(RGBA_INTEGER, BYTE, RGBA8I, 1)
-	case TKTX_R8G8B8A8_SRGB: FT(SRGB_ALPHA, UNSIGNED_BYTE, SRGB8, 1)
-
-	case TKTX_B8G8R8A8_UNORM: FT(BGRA, UNSIGNED_BYTE, RGBA8, 1)
-	case TKTX_B8G8R8A8_SNORM: FT(BGRA, BYTE, RGBA8_SNORM, 1)
-	case TKTX_B8G8R8A8_UINT: FT(BGRA_INTEGER, UNSIGNED_BYTE, RGBA8UI, 1)
-	case TKTX_B8G8R8A8_SINT: FT(BGRA_INTEGER, BYTE, RGBA8I, 1)
-	case TKTX_B8G8R8A8_SRGB: FT(BGRA, UNSIGNED_BYTE, SRGB8, 1)
-
-	case TKTX_E5B9G9R9_UFLOAT_PACK32: FT(BGR, UNSIGNED_INT_5_9_9_9_REV, RGB9_E5, 4);
-	case TKTX_A8B8G8R8_UNORM_PACK32: FT(ABGR, UNSIGNED_BYTE, RGBA8, 1)
-	case TKTX_A8B8G8R8_SNORM_PACK32: FT(ABGR, BYTE, RGBA8, 1)
-	case TKTX_A8B8G8R8_UINT_PACK32: FT(ABGR, UNSIGNED_BYTE, RGBA8UI, 1)
-	case TKTX_A8B8G8R8_SINT_PACK32: FT(ABGR, BYTE, RGBA8I, 1)
-	case TKTX_A8B8G8R8_SRGB_PACK32: FT(ABGR, UNSIGNED_BYTE, SRGB8, 1)
-	case TKTX_B10G11R11_UFLOAT_PACK32: FT(BGR, UNSIGNED_INT_10F_11F_11F_REV, R11F_G11F_B10F, 4)
-
-	case TKTX_R16_UNORM: FT(RED, UNSIGNED_SHORT, R16, 2)
-	case TKTX_R16_SNORM: FT(RED, SHORT, R16_SNORM, 2)
-	case TKTX_R16_UINT: FT(RED_INTEGER, UNSIGNED_SHORT, R16UI, 2)
-	case TKTX_R16_SINT: FT(RED_INTEGER, SHORT, R16I, 2)
-	case TKTX_R16_SFLOAT:FT(RED, HALF_FLOAT, R16F, 2)
-
-	case TKTX_R16G16_UNORM: FT(RG, UNSIGNED_SHORT, RG16, 2)
-	case TKTX_R16G16_SNORM: FT(RG, SHORT, RG16_SNORM, 2)
-	case TKTX_R16G16_UINT: FT(RG_INTEGER, UNSIGNED_SHORT, RG16UI, 2)
-	case TKTX_R16G16_SINT: FT(RG_INTEGER, SHORT, RG16I, 2)
-	case TKTX_R16G16_SFLOAT:FT(RG, HALF_FLOAT, RG16F, 2)
-
-	case TKTX_R16G16B16_UNORM: FT(RGB, UNSIGNED_SHORT, RGB16, 2)
-	case TKTX_R16G16B16_SNORM: FT(RGB, SHORT, RGB16_SNORM, 2)
-	case TKTX_R16G16B16_UINT: FT(RGB_INTEGER, UNSIGNED_SHORT, RGB16UI, 2)
-	case TKTX_R16G16B16_SINT: FT(RGB_INTEGER, SHORT, RGB16I, 2)
-	case TKTX_R16G16B16_SFLOAT: FT(RGB, HALF_FLOAT, RGB16F, 2)
-
-	case TKTX_R16G16B16A16_UNORM: FT(RGBA, UNSIGNED_SHORT, RGBA16, 2)
-	case TKTX_R16G16B16A16_SNORM: FT(RGBA, SHORT, RGBA16_SNORM, 2)
-	case TKTX_R16G16B16A16_UINT: FT(RGBA_INTEGER, UNSIGNED_SHORT, RGBA16UI, 2)
-	case TKTX_R16G16B16A16_SINT: FT(RGBA_INTEGER, SHORT, RGBA16I, 2)
-	case TKTX_R16G16B16A16_SFLOAT:FT(RGBA, HALF_FLOAT, RGBA16F, 2)
-
-	case TKTX_R32_UINT: FT(RED_INTEGER, UNSIGNED_INT, R32UI, 4)
-	case TKTX_R32_SINT: FT(RED_INTEGER, INT, R32I, 4)
-	case TKTX_R32_SFLOAT: FT(RED, FLOAT, R32F, 4)
-
-	case TKTX_R32G32_UINT: FT(RG_INTEGER, UNSIGNED_INT, RG32UI, 4)
-	case TKTX_R32G32_SINT: FT(RG_INTEGER, INT, RG32I, 4)
-	case TKTX_R32G32_SFLOAT: FT(RG, FLOAT, RG32F, 4)
-
-	case TKTX_R32G32B32_UINT: FT(RGB_INTEGER, UNSIGNED_INT, RGB32UI, 4)
-	case TKTX_R32G32B32_SINT: FT(RGB_INTEGER, INT, RGB32I, 4)
-	case TKTX_R32G32B32_SFLOAT: FT(RGB_INTEGER, FLOAT, RGB32F, 4)
-
-	case TKTX_R32G32B32A32_UINT: FT(RGBA_INTEGER, UNSIGNED_INT, RGBA32UI, 4)
-	case TKTX_R32G32B32A32_SINT: FT(RGBA_INTEGER, INT, RGBA32I, 4)
-	case TKTX_R32G32B32A32_SFLOAT:FT(RGBA, FLOAT, RGBA32F, 4)
-
-	case TKTX_BC1_RGB_UNORM_BLOCK: FTC(RGB, RGB_S3TC_DXT1)
-	case TKTX_BC1_RGB_SRGB_BLOCK: FTC(RGB, SRGB_S3TC_DXT1)
-	case TKTX_BC1_RGBA_UNORM_BLOCK: FTC(RGBA, RGBA_S3TC_DXT1)
-	case TKTX_BC1_RGBA_SRGB_BLOCK: FTC(RGBA, SRGB_ALPHA_S3TC_DXT1)
-	case TKTX_BC2_UNORM_BLOCK: FTC(RGBA, RGBA_S3TC_DXT3)
-	case TKTX_BC2_SRGB_BLOCK: FTC(RGBA, SRGB_ALPHA_S3TC_DXT3)
-	case TKTX_BC3_UNORM_BLOCK: FTC(RGBA, RGBA_S3TC_DXT5)
-	case TKTX_BC3_SRGB_BLOCK: FTC(RGBA, SRGB_ALPHA_S3TC_DXT5)
-	case TKTX_BC4_UNORM_BLOCK: FTC(RED, RED_RGTC1)
-	case TKTX_BC4_SNORM_BLOCK: FTC(RED, SIGNED_RED_RGTC1)
-	case TKTX_BC5_UNORM_BLOCK: FTC(RG, RED_GREEN_RGTC2)
-	case TKTX_BC5_SNORM_BLOCK: FTC(RG, SIGNED_RED_GREEN_RGTC2)
-	case TKTX_BC6H_UFLOAT_BLOCK: FTC(RGB, RGB_BPTC_UNSIGNED_FLOAT)
-	case TKTX_BC6H_SFLOAT_BLOCK: FTC(RGB, RGB_BPTC_SIGNED_FLOAT)
-	case TKTX_BC7_UNORM_BLOCK: FTC(RGBA, RGBA_BPTC_UNORM)
-	case TKTX_BC7_SRGB_BLOCK: FTC(RGBA, SRGB_ALPHA_BPTC_UNORM)
-
-	case TKTX_ETC2_R8G8B8_UNORM_BLOCK: FTC(RGB, RGB8_ETC2)
-	case TKTX_ETC2_R8G8B8A1_UNORM_BLOCK: FTC(RGBA, RGB8_PUNCHTHROUGH_ALPHA1_ETC2)
-	case TKTX_ETC2_R8G8B8A8_UNORM_BLOCK: FTC(RGBA, RGBA8_ETC2_EAC)
-	case TKTX_ETC2_R8G8B8_SRGB_BLOCK: FTC(SRGB, SRGB8_ETC2)
-	case TKTX_ETC2_R8G8B8A1_SRGB_BLOCK: FTC(SRGB_ALPHA, SRGB8_PUNCHTHROUGH_ALPHA1_ETC2)
-	case TKTX_ETC2_R8G8B8A8_SRGB_BLOCK: FTC(SRGB_ALPHA, SRGB8_ALPHA8_ETC2_EAC)
-	case TKTX_EAC_R11_UNORM_BLOCK: FTC(RED, R11_EAC)
-	case TKTX_EAC_R11G11_UNORM_BLOCK: FTC(RG, RG11_EAC)
-	case TKTX_EAC_R11_SNORM_BLOCK: FTC(RED, SIGNED_R11_EAC)
-	case TKTX_EAC_R11G11_SNORM_BLOCK: FTC(RG, SIGNED_RG11_EAC)
-
-	case TKTX_PVR_2BPP_UNORM_BLOCK: FTC(RGB, RGB_PVRTC_2BPPV1)
-	case TKTX_PVR_2BPPA_UNORM_BLOCK: FTC(RGBA, RGBA_PVRTC_2BPPV1);
-	case TKTX_PVR_4BPP_UNORM_BLOCK: FTC(RGB, RGB_PVRTC_4BPPV1)
-	case TKTX_PVR_4BPPA_UNORM_BLOCK: FTC(RGB, RGB_PVRTC_4BPPV1)
-	case TKTX_PVR_2BPP_SRGB_BLOCK: FTC(SRGB, SRGB_PVRTC_2BPPV1)
-	case TKTX_PVR_2BPPA_SRGB_BLOCK: FTC(SRGB_ALPHA, SRGB_ALPHA_PVRTC_2BPPV1);
-	case TKTX_PVR_4BPP_SRGB_BLOCK: FTC(SRGB, SRGB_PVRTC_2BPPV1)
-	case TKTX_PVR_4BPPA_SRGB_BLOCK: FTC(SRGB_ALPHA, SRGB_ALPHA_PVRTC_2BPPV1);
-
-	case TKTX_ASTC_4x4_UNORM_BLOCK: FTC(RGBA, RGBA_ASTC_4x4)
-	case TKTX_ASTC_4x4_SRGB_BLOCK: FTC(SRGB_ALPHA, SRGB8_ALPHA8_ASTC_4x4)
-	case TKTX_ASTC_5x4_UNORM_BLOCK: FTC(RGBA, RGBA_ASTC_5x4)
-	case TKTX_ASTC_5x4_SRGB_BLOCK: FTC(SRGB_ALPHA, SRGB8_ALPHA8_ASTC_5x4)
-	case TKTX_ASTC_5x5_UNORM_BLOCK: FTC(RGBA, RGBA_ASTC_5x5)
-	case TKTX_ASTC_5x5_SRGB_BLOCK: FTC(SRGB_ALPHA, SRGB8_ALPHA8_ASTC_5x5)
-	case TKTX_ASTC_6x5_UNORM_BLOCK: FTC(RGBA, RGBA_ASTC_6x5)
-	case TKTX_ASTC_6x5_SRGB_BLOCK: FTC(SRGB_ALPHA, SRGB8_ALPHA8_ASTC_6x5)
-	case TKTX_ASTC_6x6_UNORM_BLOCK: FTC(RGBA, RGBA_ASTC_6x6)
-	case TKTX_ASTC_6x6_SRGB_BLOCK: FTC(SRGB_ALPHA, SRGB8_ALPHA8_ASTC_6x6)
-	case TKTX_ASTC_8x5_UNORM_BLOCK: FTC(RGBA, RGBA_ASTC_8x5)
-	case TKTX_ASTC_8x5_SRGB_BLOCK: FTC(SRGB_ALPHA, SRGB8_ALPHA8_ASTC_8x5)
-	case TKTX_ASTC_8x6_UNORM_BLOCK: FTC(RGBA, RGBA_ASTC_8x6)
-	case TKTX_ASTC_8x6_SRGB_BLOCK: FTC(SRGB_ALPHA, SRGB8_ALPHA8_ASTC_8x6)
-	case TKTX_ASTC_8x8_UNORM_BLOCK: FTC(RGBA, RGBA_ASTC_8x8)
-	case TKTX_ASTC_8x8_SRGB_BLOCK: FTC(SRGB_ALPHA, SRGB8_ALPHA8_ASTC_8x8)
-	case TKTX_ASTC_10x5_UNORM_BLOCK: FTC(RGBA, RGBA_ASTC_10x5)
-	case TKTX_ASTC_10x5_SRGB_BLOCK: FTC(SRGB_ALPHA, SRGB8_ALPHA8_ASTC_10x5)
-	case TKTX_ASTC_10x6_UNORM_BLOCK: FTC(RGBA, RGBA_ASTC_10x6)
-	case TKTX_ASTC_10x6_SRGB_BLOCK: FTC(SRGB_ALPHA, SRGB8_ALPHA8_ASTC_10x6)
-	case TKTX_ASTC_10x8_UNORM_BLOCK: FTC(RGBA, RGBA_ASTC_10x8);
-	case TKTX_ASTC_10x8_SRGB_BLOCK: FTC(SRGB_ALPHA, SRGB8_ALPHA8_ASTC_10x8)
-	case TKTX_ASTC_10x10_UNORM_BLOCK: FTC(RGBA, RGBA_ASTC_10x10)
-	case TKTX_ASTC_10x10_SRGB_BLOCK: FTC(SRGB_ALPHA, SRGB8_ALPHA8_ASTC_10x10)
-	case TKTX_ASTC_12x10_UNORM_BLOCK: FTC(RGBA, RGBA_ASTC_12x10)
-	case TKTX_ASTC_12x10_SRGB_BLOCK: FTC(SRGB_ALPHA, SRGB8_ALPHA8_ASTC_12x10)
-	case TKTX_ASTC_12x12_UNORM_BLOCK: FTC(RGBA, RGBA_ASTC_12x12)
-	case TKTX_ASTC_12x12_SRGB_BLOCK: FTC(SRGB_ALPHA, SRGB8_ALPHA8_ASTC_12x12)
-
+	TINYKTX_FORMAT_TABLE(TINYKTX_TOGL_FT, TINYKTX_TOGL_FTC)
 	default:break;
 	}
 	return false;
 }
-#undef FT
-#undef FTC
+#undef TINYKTX_TOGL_FT
+#undef TINYKTX_TOGL_FTC
 
-TinyKtx_Format TinyKtx_CrackFormatFromGL(uint32_t const glformat,
-																				 uint32_t const gltype,
-																				 uint32_t const glinternalformat,
-																				 uint32_t const typesize) {
-	switch (glinternalformat) {
-	case TINYKTX_GL_COMPRESSED_RGB_S3TC_DXT1: return TKTX_BC1_RGB_UNORM_BLOCK;
-	case TINYKTX_GL_COMPRESSED_RGBA_S3TC_DXT1: return TKTX_BC1_RGBA_UNORM_BLOCK;
-	case TINYKTX_GL_COMPRESSED_RGBA_S3TC_DXT3: return TKTX_BC2_UNORM_BLOCK;
-	case TINYKTX_GL_COMPRESSED_RGBA_S3TC_DXT5: return TKTX_BC3_UNORM_BLOCK;
-	case TINYKTX_GL_COMPRESSED_3DC_X_AMD: return TKTX_BC4_UNORM_BLOCK;
-	case TINYKTX_GL_COMPRESSED_3DC_XY_AMD: return TKTX_BC5_UNORM_BLOCK;
-	case TINYKTX_GL_COMPRESSED_SRGB_PVRTC_2BPPV1: return TKTX_PVR_2BPP_SRGB_BLOCK;
-	case TINYKTX_GL_COMPRESSED_SRGB_PVRTC_4BPPV1: return TKTX_PVR_2BPPA_SRGB_BLOCK;
-	case TINYKTX_GL_COMPRESSED_SRGB_ALPHA_PVRTC_2BPPV1: return TKTX_PVR_2BPPA_SRGB_BLOCK;
-	case TINYKTX_GL_COMPRESSED_SRGB_ALPHA_PVRTC_4BPPV1: return TKTX_PVR_4BPPA_SRGB_BLOCK;
-	case TINYKTX_GL_COMPRESSED_RGB_PVRTC_4BPPV1: return TKTX_PVR_4BPP_UNORM_BLOCK;
-	case TINYKTX_GL_COMPRESSED_RGB_PVRTC_2BPPV1: return TKTX_PVR_2BPP_UNORM_BLOCK;
-	case TINYKTX_GL_COMPRESSED_RGBA_PVRTC_4BPPV1: return TKTX_PVR_4BPPA_UNORM_BLOCK;
-	case TINYKTX_GL_COMPRESSED_RGBA_PVRTC_2BPPV1: return TKTX_PVR_2BPPA_UNORM_BLOCK;
-	case TINYKTX_GL_COMPRESSED_SRGB_S3TC_DXT1: return TKTX_BC1_RGB_SRGB_BLOCK;
-	case TINYKTX_GL_COMPRESSED_SRGB_ALPHA_S3TC_DXT1: return TKTX_BC1_RGBA_SRGB_BLOCK;
-	case TINYKTX_GL_COMPRESSED_SRGB_ALPHA_S3TC_DXT3: return TKTX_BC2_SRGB_BLOCK;
-	case TINYKTX_GL_COMPRESSED_SRGB_ALPHA_S3TC_DXT5: return TKTX_BC3_SRGB_BLOCK;
-	case TINYKTX_GL_COMPRESSED_LUMINANCE_LATC1: return TKTX_BC4_UNORM_BLOCK;
-	case TINYKTX_GL_COMPRESSED_SIGNED_LUMINANCE_LATC1: return TKTX_BC4_SNORM_BLOCK;
-	case TINYKTX_GL_COMPRESSED_LUMINANCE_ALPHA_LATC2: return TKTX_BC5_UNORM_BLOCK;
-	case TINYKTX_GL_COMPRESSED_SIGNED_LUMINANCE_ALPHA_LATC2: return TKTX_BC5_SNORM_BLOCK;
-	case TINYKTX_GL_COMPRESSED_RED_RGTC1: return TKTX_BC4_UNORM_BLOCK;
-	case TINYKTX_GL_COMPRESSED_SIGNED_RED_RGTC1: return TKTX_BC4_SNORM_BLOCK;
-	case TINYKTX_GL_COMPRESSED_RED_GREEN_RGTC2: return TKTX_BC5_UNORM_BLOCK;
-	case TINYKTX_GL_COMPRESSED_SIGNED_RED_GREEN_RGTC2: return TKTX_BC5_SNORM_BLOCK;
-	case TINYKTX_GL_COMPRESSED_ETC1_RGB8_OES: return TKTX_ETC2_R8G8B8_UNORM_BLOCK;
-	case TINYKTX_GL_COMPRESSED_RGBA_BPTC_UNORM: return TKTX_BC7_UNORM_BLOCK;
-	case TINYKTX_GL_COMPRESSED_SRGB_ALPHA_BPTC_UNORM: return TKTX_BC7_SRGB_BLOCK;
-	case TINYKTX_GL_COMPRESSED_RGB_BPTC_SIGNED_FLOAT: return TKTX_BC6H_SFLOAT_BLOCK;
-	case TINYKTX_GL_COMPRESSED_RGB_BPTC_UNSIGNED_FLOAT: return TKTX_BC6H_UFLOAT_BLOCK;
-	case TINYKTX_GL_COMPRESSED_R11_EAC: return TKTX_EAC_R11_UNORM_BLOCK;
-	case TINYKTX_GL_COMPRESSED_SIGNED_R11_EAC: return TKTX_EAC_R11_SNORM_BLOCK;
-	case TINYKTX_GL_COMPRESSED_RG11_EAC: return TKTX_EAC_R11G11_UNORM_BLOCK;
-	case TINYKTX_GL_COMPRESSED_SIGNED_RG11_EAC: return TKTX_EAC_R11G11_UNORM_BLOCK;
-	case TINYKTX_GL_COMPRESSED_RGB8_ETC2: return TKTX_ETC2_R8G8B8_UNORM_BLOCK;
-	case TINYKTX_GL_COMPRESSED_SRGB8_ETC2: return TKTX_ETC2_R8G8B8_SRGB_BLOCK;
-	case TINYKTX_GL_COMPRESSED_RGB8_PUNCHTHROUGH_ALPHA1_ETC2: return TKTX_ETC2_R8G8B8A1_UNORM_BLOCK;
-	case TINYKTX_GL_COMPRESSED_SRGB8_PUNCHTHROUGH_ALPHA1_ETC2: return TKTX_ETC2_R8G8B8A1_SRGB_BLOCK;
-	case TINYKTX_GL_COMPRESSED_RGBA8_ETC2_EAC: return TKTX_ETC2_R8G8B8A8_UNORM_BLOCK;
-	case TINYKTX_GL_COMPRESSED_SRGB8_ALPHA8_ETC2_EAC: return TKTX_ETC2_R8G8B8A8_SRGB_BLOCK;
-	case TINYKTX_GL_COMPRESSED_RGBA_ASTC_4x4: return TKTX_ASTC_4x4_UNORM_BLOCK;
-	case TINYKTX_GL_COMPRESSED_RGBA_ASTC_5x4: return TKTX_ASTC_5x4_UNORM_BLOCK;
-	case TINYKTX_GL_COMPRESSED_RGBA_ASTC_5x5: return TKTX_ASTC_5x5_UNORM_BLOCK;
-	case TINYKTX_GL_COMPRESSED_RGBA_ASTC_6x5: return TKTX_ASTC_6x5_UNORM_BLOCK;
-	case TINYKTX_GL_COMPRESSED_RGBA_ASTC_6x6: return TKTX_ASTC_6x6_UNORM_BLOCK;
-	case TINYKTX_GL_COMPRESSED_RGBA_ASTC_8x5: return TKTX_ASTC_8x5_UNORM_BLOCK;
-	case TINYKTX_GL_COMPRESSED_RGBA_ASTC_8x6: return TKTX_ASTC_8x6_UNORM_BLOCK;
-	case TINYKTX_GL_COMPRESSED_RGBA_ASTC_8x8: return TKTX_ASTC_8x8_UNORM_BLOCK;
-	case TINYKTX_GL_COMPRESSED_RGBA_ASTC_10x5: return TKTX_ASTC_10x5_UNORM_BLOCK;
-	case TINYKTX_GL_COMPRESSED_RGBA_ASTC_10x6: return TKTX_ASTC_10x6_UNORM_BLOCK;
-	case TINYKTX_GL_COMPRESSED_RGBA_ASTC_10x8: return TKTX_ASTC_10x8_UNORM_BLOCK;
-	case TINYKTX_GL_COMPRESSED_RGBA_ASTC_10x10: return TKTX_ASTC_10x10_UNORM_BLOCK;
-	case TINYKTX_GL_COMPRESSED_RGBA_ASTC_12x10: return TKTX_ASTC_12x10_UNORM_BLOCK;
-	case TINYKTX_GL_COMPRESSED_RGBA_ASTC_12x12: return TKTX_ASTC_12x12_UNORM_BLOCK;
-	case TINYKTX_GL_COMPRESSED_SRGB8_ALPHA8_ASTC_4x4: return TKTX_ASTC_4x4_SRGB_BLOCK;
-	case TINYKTX_GL_COMPRESSED_SRGB8_ALPHA8_ASTC_5x4: return TKTX_ASTC_5x4_SRGB_BLOCK;
-	case TINYKTX_GL_COMPRESSED_SRGB8_ALPHA8_ASTC_5x5: return TKTX_ASTC_5x5_SRGB_BLOCK;
-	case TINYKTX_GL_COMPRESSED_SRGB8_ALPHA8_ASTC_6x5: return TKTX_ASTC_6x5_SRGB_BLOCK;
-	case TINYKTX_GL_COMPRESSED_SRGB8_ALPHA8_ASTC_6x6: return TKTX_ASTC_6x6_SRGB_BLOCK;
-	case TINYKTX_GL_COMPRESSED_SRGB8_ALPHA8_ASTC_8x5: return TKTX_ASTC_8x5_SRGB_BLOCK;
-	case TINYKTX_GL_COMPRESSED_SRGB8_ALPHA8_ASTC_8x6: return TKTX_ASTC_8x6_SRGB_BLOCK;
-	case TINYKTX_GL_COMPRESSED_SRGB8_ALPHA8_ASTC_8x8: return TKTX_ASTC_8x8_SRGB_BLOCK;
-	case TINYKTX_GL_COMPRESSED_SRGB8_ALPHA8_ASTC_10x5: return TKTX_ASTC_10x5_SRGB_BLOCK;
-	case TINYKTX_GL_COMPRESSED_SRGB8_ALPHA8_ASTC_10x6: return TKTX_ASTC_10x6_SRGB_BLOCK;
-	case TINYKTX_GL_COMPRESSED_SRGB8_ALPHA8_ASTC_10x8: return TKTX_ASTC_10x8_SRGB_BLOCK;
-	case TINYKTX_GL_COMPRESSED_SRGB8_ALPHA8_ASTC_10x10: return TKTX_ASTC_10x10_SRGB_BLOCK;
-	case TINYKTX_GL_COMPRESSED_SRGB8_ALPHA8_ASTC_12x10: return TKTX_ASTC_12x10_SRGB_BLOCK;
-	case TINYKTX_GL_COMPRESSED_SRGB8_ALPHA8_ASTC_12x12: return TKTX_ASTC_12x12_SRGB_BLOCK;
-
-	// non compressed
-	case TINYKTX_GL_INTFORMAT_RGB4:
-		if(glformat == TINYKTX_GL_FORMAT_RG) {
-			return TKTX_R4G4_UNORM_PACK8;
-		}
-		break;
+typedef struct TinyKtx_GLFormatEntry {
+	uint32_t glInternalFormat;
+	uint32_t glFormat;
+	uint32_t glType;
+	TinyKtx_Format format;
+} TinyKtx_GLFormatEntry;
+
+#define TINYKTX_GLE_FT(ktx, bytes, ch, fmt, type, intfmt, size, tif, rev) \
+	{ TINYKTX_GL_INTFORMAT_##intfmt, TINYKTX_GL_FORMAT_##fmt, TINYKTX_GL_TYPE_##type, TKTX_##ktx },
+#define TINYKTX_GLE_FTC(ktx, bw, bh, bytes, ch, fmt, intfmt, tif, rev) \
+	{ TINYKTX_GL_COMPRESSED_##intfmt, TINYKTX_GL_FORMAT_##fmt, TINYKTX_GL_TYPE_COMPRESSED, TKTX_##ktx },
+#define TINYKTX_GLE_FA(ktx, fmt, type, intfmt) TINYKTX_GLE_FT(ktx, 0, 0, fmt, type, intfmt, 0, 0, 0)
+#define TINYKTX_GLE_FAC(ktx, fmt, intfmt) TINYKTX_GLE_FTC(ktx, 0, 0, 0, 0, fmt, intfmt, 0, 0)
+
+static TinyKtx_GLFormatEntry const TinyKtx_glFormatEntries[] = {
+	TINYKTX_FORMAT_TABLE(TINYKTX_GLE_FT, TINYKTX_GLE_FTC)
+	TINYKTX_FORMAT_ALIASES(TINYKTX_GLE_FA, TINYKTX_GLE_FAC)
+};
+#undef TINYKTX_GLE_FT
+#undef TINYKTX_GLE_FTC
+#undef TINYKTX_GLE_FA
+#undef TINYKTX_GLE_FAC
 
-	case TINYKTX_GL_INTFORMAT_RGBA4:
-		if(glformat == TINYKTX_GL_FORMAT_RGBA) {
-			return TKTX_R4G4B4A4_UNORM_PACK16;
-		} else if(glformat == TINYKTX_GL_FORMAT_BGRA) {
-			return TKTX_B4G4R4A4_UNORM_PACK16;
-		}
-		break;
-	case TINYKTX_GL_INTFORMAT_RGB565:
-		if(gltype == TINYKTX_GL_TYPE_UNSIGNED_SHORT_5_6_5 || glformat == TINYKTX_GL_FORMAT_BGR) {
-			return TKTX_B5G6R5_UNORM_PACK16;
-		} else {
-			return TKTX_R5G6B5_UNORM_PACK16;
-		}
-		break;
+#define TINYKTX_GL_FORMAT_ENTRY_COUNT (sizeof(TinyKtx_glFormatEntries) / sizeof(TinyKtx_glFormatEntries[0]))
 
-	case TINYKTX_GL_INTFORMAT_RGB5_A1:
-		if (gltype == TINYKTX_GL_TYPE_UNSIGNED_SHORT_1_5_5_5_REV) {
-			return TKTX_A1R5G5B5_UNORM_PACK16;
-		} else if (gltype == TINYKTX_GL_TYPE_UNSIGNED_SHORT_5_5_5_1) {
-			if(glformat == TINYKTX_GL_FORMAT_BGRA) {
-				return TKTX_B5G5R5A1_UNORM_PACK16;
-			} else {
-				return TKTX_R5G5B5A1_UNORM_PACK16;
-			}
-		}
-		break;
-	case TINYKTX_GL_INTFORMAT_R8_SNORM:
-	case TINYKTX_GL_INTFORMAT_R8:
-		if(gltype == TINYKTX_GL_TYPE_BYTE || glinternalformat == TINYKTX_GL_INTFORMAT_R8_SNORM) {
-			return TKTX_R8_SNORM;
-		}	else {
-			return TKTX_R8_UNORM;
-		}
-		break;
-	case TINYKTX_GL_INTFORMAT_RG8_SNORM:
-	case TINYKTX_GL_INTFORMAT_RG8:
-		if(gltype == TINYKTX_GL_TYPE_BYTE ||
-				glinternalformat == TINYKTX_GL_INTFORMAT_RG8_SNORM) {
-			return TKTX_R8G8_SNORM;
-		}	else {
-			return TKTX_R8G8_UNORM;
-		}
-		break;
-	case TINYKTX_GL_INTFORMAT_RGB8_SNORM:
-	case TINYKTX_GL_INTFORMAT_RGB8:
-		if(glformat == TINYKTX_GL_FORMAT_BGR) {
-			if(gltype == TINYKTX_GL_TYPE_BYTE ||
-					glinternalformat == TINYKTX_GL_INTFORMAT_RGB8_SNORM) {
-				return TKTX_B8G8R8_SNORM;
-			}	else {
-				return TKTX_B8G8R8_UNORM;
-			}
-		} else {
-			if(gltype == TINYKTX_GL_TYPE_BYTE ||
-					glinternalformat == TINYKTX_GL_INTFORMAT_RGB8_SNORM) {
-				return TKTX_R8G8B8_SNORM;
-			}	else {
-				return TKTX_R8G8B8_UNORM;
-			}
-		}
-		break;
-	case TINYKTX_GL_INTFORMAT_RGBA8_SNORM:
-	case TINYKTX_GL_INTFORMAT_RGBA8:
-		if(glformat == TINYKTX_GL_FORMAT_RGBA) {
-			if(gltype == TINYKTX_GL_TYPE_BYTE ||
-					glinternalformat == TINYKTX_GL_INTFORMAT_RGBA8_SNORM) {
-				return TKTX_R8G8B8A8_SNORM;
-			} else if(gltype == TINYKTX_GL_TYPE_UNSIGNED_BYTE) {
-				return TKTX_R8G8B8A8_UNORM;
-			}
-		} else if(glformat == TINYKTX_GL_FORMAT_BGRA) {
-			if(gltype == TINYKTX_GL_TYPE_BYTE ||
-					glinternalformat == TINYKTX_GL_INTFORMAT_RGBA8_SNORM) {
-				return TKTX_B8G8R8A8_SNORM;
-			} else if(gltype == TINYKTX_GL_TYPE_UNSIGNED_BYTE) {
-				return TKTX_B8G8R8A8_UNORM;
-			}
-		} else if(glformat == TINYKTX_GL_FORMAT_ABGR) {
-			if(gltype == TINYKTX_GL_TYPE_BYTE ||
-					glinternalformat == TINYKTX_GL_INTFORMAT_RGBA8_SNORM) {
-				return TKTX_A8B8G8R8_SNORM_PACK32;
-			} else if(gltype == TINYKTX_GL_TYPE_UNSIGNED_BYTE) {
-				return TKTX_A8B8G8R8_UNORM_PACK32;
-			}
-		}
-		break;
+// the format ignoring _INTEGER and _SNORM
+static uint32_t TinyKtx_baseGLFormat(uint32_t glformat) {
+	switch (glformat) {
+	case TINYKTX_GL_FORMAT_RED_INTEGER:
+	case TINYKTX_GL_FORMAT_RED_SNORM: return TINYKTX_GL_FORMAT_RED;
+	case TINYKTX_GL_FORMAT_GREEN_INTEGER: return TINYKTX_GL_FORMAT_GREEN;
+	case TINYKTX_GL_FORMAT_BLUE_INTEGER: return TINYKTX_GL_FORMAT_BLUE;
+	case TINYKTX_GL_FORMAT_ALPHA_INTEGER: return TINYKTX_GL_FORMAT_ALPHA;
+	case TINYKTX_GL_FORMAT_RG_INTEGER:
+	case TINYKTX_GL_FORMAT_RG_SNORM: return TINYKTX_GL_FORMAT_RG;
+	case TINYKTX_GL_FORMAT_RGB_INTEGER:
+	case TINYKTX_GL_FORMAT_RGB_SNORM: return TINYKTX_GL_FORMAT_RGB;
+	case TINYKTX_GL_FORMAT_RGBA_INTEGER:
+	case TINYKTX_GL_FORMAT_RGBA_SNORM: return TINYKTX_GL_FORMAT_RGBA;
+	case TINYKTX_GL_FORMAT_BGR_INTEGER: return TINYKTX_GL_FORMAT_BGR;
+	case TINYKTX_GL_FORMAT_BGRA_INTEGER: return TINYKTX_GL_FORMAT_BGRA;
+	default: return glformat;
+	}
+}
 
-	case TINYKTX_GL_INTFORMAT_R16: return TKTX_R16_UNORM;
-	case TINYKTX_GL_INTFORMAT_RG16: return TKTX_R16G16_UNORM;
-	case TINYKTX_GL_INTFORMAT_RGB16: return TKTX_R16G16B16_UNORM;
-	case TINYKTX_GL_INTFORMAT_RGBA16: return TKTX_R16G16B16A16_UNORM;
-
-	case TINYKTX_GL_INTFORMAT_R16_SNORM:return TKTX_R16_SNORM;
-	case TINYKTX_GL_INTFORMAT_RG16_SNORM: return TKTX_R16G16_SNORM;
-	case TINYKTX_GL_INTFORMAT_RGB16_SNORM: return TKTX_R16G16B16_SNORM;
-	case TINYKTX_GL_INTFORMAT_RGBA16_SNORM: return TKTX_R16G16B16A16_SNORM;
-
-	case TINYKTX_GL_INTFORMAT_R8I: return TKTX_R8_SINT;
-	case TINYKTX_GL_INTFORMAT_RG8I: return TKTX_R8G8_SINT;
-	case TINYKTX_GL_INTFORMAT_RGB8I:
-		if(glformat == TINYKTX_GL_FORMAT_RGB || glformat == TINYKTX_GL_FORMAT_RGB_INTEGER) {
-			return TKTX_R8G8B8_SINT;
-		} else if(glformat == TINYKTX_GL_FORMAT_BGR || glformat == TINYKTX_GL_FORMAT_BGR_INTEGER) {
-			return TKTX_B8G8R8_SINT;
-		}
-		break;
+// hash index over TinyKtx_glFormatEntries, chained per bucket in table order. One keyed on the
+// internal format, the other on base format and type for files with a FORMAT in the internal
+// format slot. C can't build it at compile time so the first lookup does, the ready flag is
+// published with release/acquire so other threads only ever use a complete index (threads racing
+// on the first lookup each build the same index)
+#define TINYKTX_GL_INDEX_BUCKETS 256
+typedef struct TinyKtx_GLFormatIndex {
+	uint16_t internalFormatHead[TINYKTX_GL_INDEX_BUCKETS];	// entry + 1, 0 ends the chain
+	uint16_t internalFormatNext[TINYKTX_GL_FORMAT_ENTRY_COUNT];
+	uint16_t formatTypeHead[TINYKTX_GL_INDEX_BUCKETS];
+	uint16_t formatTypeNext[TINYKTX_GL_FORMAT_ENTRY_COUNT];
+} TinyKtx_GLFormatIndex;
+
+static TinyKtx_GLFormatIndex TinyKtx_glFormatIndex;
+static uint32_t TinyKtx_glFormatIndexReady;
+
+#if defined(_MSC_VER) && !defined(__clang__)
+#include <intrin.h>
+#define TINYKTX_LOAD_ACQUIRE(p) ((uint32_t) _InterlockedOr((long volatile *) (p), 0))
+#define TINYKTX_STORE_RELEASE(p, v) _InterlockedExchange((long volatile *) (p), (long) (v))
+#else
+#define TINYKTX_LOAD_ACQUIRE(p) __atomic_load_n((p), __ATOMIC_ACQUIRE)
+#define TINYKTX_STORE_RELEASE(p, v) __atomic_store_n((p), (v), __ATOMIC_RELEASE)
+#endif
 
-	case TINYKTX_GL_INTFORMAT_RGBA8I:
-		if(glformat == TINYKTX_GL_FORMAT_RGBA || glformat == TINYKTX_GL_FORMAT_RGBA_INTEGER) {
-			return TKTX_R8G8B8A8_SINT;
-		} else if(glformat == TINYKTX_GL_FORMAT_BGRA || glformat == TINYKTX_GL_FORMAT_BGRA_INTEGER) {
-			return TKTX_B8G8R8A8_SINT;
-		} else if(glformat == TINYKTX_GL_FORMAT_ABGR) {
-			return TKTX_A8B8G8R8_SINT_PACK32;
-		}
-		break;
+static uint32_t TinyKtx_glHash(uint32_t key) {
+	return (key * 2654435761u) >> 24;
+}
 
-	case TINYKTX_GL_INTFORMAT_R16I: return TKTX_R16_SINT;
-	case TINYKTX_GL_INTFORMAT_RG16I: return TKTX_R16G16_SINT;
-	case TINYKTX_GL_INTFORMAT_RGB16I:return TKTX_R16G16B16_SINT;
-	case TINYKTX_GL_INTFORMAT_RGBA16I:return TKTX_R16G16B16A16_SINT;
+static uint32_t TinyKtx_glFormatTypeHash(uint32_t glformat, uint32_t gltype) {
+	return TinyKtx_glHash(glformat ^ (gltype << 16));
+}
 
-	case TINYKTX_GL_INTFORMAT_R32I: return TKTX_R32_SINT;
-	case TINYKTX_GL_INTFORMAT_RG32I: return TKTX_R32G32_SINT;
-	case TINYKTX_GL_INTFORMAT_RGB32I:
-		if(glformat == TINYKTX_GL_FORMAT_RGB || glformat == TINYKTX_GL_FORMAT_RGB_INTEGER) {
-			return TKTX_R32G32B32_SINT;
-		}
-		break;
-	case TINYKTX_GL_INTFORMAT_RGBA32I:return TKTX_R32G32B32A32_SINT;
-
-	case TINYKTX_GL_INTFORMAT_R8UI: return TKTX_R8_UINT;
-	case TINYKTX_GL_INTFORMAT_RG8UI: return TKTX_R8G8_UINT;
-	case TINYKTX_GL_INTFORMAT_RGB8UI:
-		if(glformat == TINYKTX_GL_FORMAT_RGB || glformat == TINYKTX_GL_FORMAT_RGB_INTEGER) {
-			return TKTX_R8G8B8_UINT;
-		} else if(glformat == TINYKTX_GL_FORMAT_BGR || glformat == TINYKTX_GL_FORMAT_BGR_INTEGER) {
-			return TKTX_B8G8R8_UINT;
-		}
-		break;
-	case TINYKTX_GL_INTFORMAT_RGBA8UI:
-		if(glformat == TINYKTX_GL_FORMAT_RGBA || glformat == TINYKTX_GL_FORMAT_RGBA_INTEGER) {
-			return TKTX_R8G8B8A8_UINT;
-		} else if(glformat == TINYKTX_GL_FORMAT_BGRA || glformat == TINYKTX_GL_FORMAT_BGRA_INTEGER) {
-			return TKTX_B8G8R8A8_UINT;
-		} else if(glformat == TINYKTX_GL_FORMAT_ABGR) {
-			return TKTX_A8B8G8R8_UINT_PACK32;
-		}
-		break;
+static TinyKtx_GLFormatIndex const *TinyKtx_getGLFormatIndex(void) {
+	if (TINYKTX_LOAD_ACQUIRE(&TinyKtx_glFormatIndexReady)) {
+		return &TinyKtx_glFormatIndex;
+	}
+	TinyKtx_GLFormatIndex index;
+	memset(&index, 0, sizeof(TinyKtx_GLFormatIndex));
+	// pushed on the front in reverse so chains walk in table order
+	for (size_t i = TINYKTX_GL_FORMAT_ENTRY_COUNT; i-- > 0;) {
+		TinyKtx_GLFormatEntry const *entry = &TinyKtx_glFormatEntries[i];
+		uint32_t const ib = TinyKtx_glHash(entry->glInternalFormat);
+		uint32_t const fb = TinyKtx_glFormatTypeHash(TinyKtx_baseGLFormat(entry->glFormat), entry->glType);
+		index.internalFormatNext[i] = index.internalFormatHead[ib];
+		index.internalFormatHead[ib] = (uint16_t) (i + 1);
+		index.formatTypeNext[i] = index.formatTypeHead[fb];
+		index.formatTypeHead[fb] = (uint16_t) (i + 1);
+	}
+	memcpy(&TinyKtx_glFormatIndex, &index, sizeof(TinyKtx_GLFormatIndex));
+	TINYKTX_STORE_RELEASE(&TinyKtx_glFormatIndexReady, 1u);
+	return &TinyKtx_glFormatIndex;
+}
 
-	case TINYKTX_GL_INTFORMAT_R16UI: return TKTX_R16_UINT;
-	case TINYKTX_GL_INTFORMAT_RG16UI: return TKTX_R16G16_UINT;
-	case TINYKTX_GL_INTFORMAT_RGB16UI:return TKTX_R16G16B16_UINT;
-	case TINYKTX_GL_INTFORMAT_RGBA16UI: return TKTX_R16G16B16A16_UINT;
-
-	case TINYKTX_GL_INTFORMAT_R32UI: return TKTX_R32_UINT;
-	case TINYKTX_GL_INTFORMAT_RG32UI: return TKTX_R32G32_UINT;
-	case TINYKTX_GL_INTFORMAT_RGB32UI: return TKTX_R32G32B32_UINT;
-	case TINYKTX_GL_INTFORMAT_RGBA32UI: return TKTX_R32G32B32A32_UINT;
-
-	case TINYKTX_GL_INTFORMAT_R16F: return TKTX_R16_SFLOAT;
-	case TINYKTX_GL_INTFORMAT_RG16F: return TKTX_R16G16_SFLOAT;
-	case TINYKTX_GL_INTFORMAT_RGB16F: return TKTX_R16G16B16_SFLOAT;
-	case TINYKTX_GL_INTFORMAT_RGBA16F: return TKTX_R16G16B16A16_SFLOAT;
-
-	case TINYKTX_GL_INTFORMAT_R32F: return TKTX_R32_SFLOAT;
-	case TINYKTX_GL_INTFORMAT_RG32F: return TKTX_R32G32_SFLOAT;
-	case TINYKTX_GL_INTFORMAT_RGB32F: return TKTX_R32G32B32_SFLOAT;
-	case TINYKTX_GL_INTFORMAT_RGBA32F: return TKTX_R32G32B32A32_SFLOAT;
-
-	case TINYKTX_GL_INTFORMAT_R11F_G11F_B10F: return TKTX_B10G11R11_UFLOAT_PACK32; //??
-	case TINYKTX_GL_INTFORMAT_UNSIGNED_INT_10F_11F_11F_REV: return TKTX_B10G11R11_UFLOAT_PACK32; //?
-	case TINYKTX_GL_INTFORMAT_RGB9_E5: return TKTX_E5B9G9R9_UFLOAT_PACK32;
-	case TINYKTX_GL_INTFORMAT_SLUMINANCE8_ALPHA8: return TKTX_R8G8_SRGB;
-	case TINYKTX_GL_INTFORMAT_SLUMINANCE8: return TKTX_R8_SRGB;
-
-	case TINYKTX_GL_INTFORMAT_ALPHA8: return TKTX_R8_UNORM;
-	case TINYKTX_GL_INTFORMAT_ALPHA16: return TKTX_R16_UNORM;
-	case TINYKTX_GL_INTFORMAT_LUMINANCE8: return TKTX_R8_UNORM;
-	case TINYKTX_GL_INTFORMAT_LUMINANCE16: return TKTX_R16_UNORM;
-	case TINYKTX_GL_INTFORMAT_LUMINANCE8_ALPHA8: return TKTX_R8G8_UNORM;
-	case TINYKTX_GL_INTFORMAT_LUMINANCE16_ALPHA16: return TKTX_R16G16_UNORM;
-	case TINYKTX_GL_INTFORMAT_INTENSITY8: return TKTX_R8_UNORM;
-	case TINYKTX_GL_INTFORMAT_INTENSITY16: return TKTX_R16_UNORM;
-
-	case TINYKTX_GL_INTFORMAT_ALPHA8_SNORM: return TKTX_R8_SNORM;
-	case TINYKTX_GL_INTFORMAT_LUMINANCE8_SNORM: return TKTX_R8_SNORM;
-	case TINYKTX_GL_INTFORMAT_LUMINANCE8_ALPHA8_SNORM: return TKTX_R8G8_SNORM;
-	case TINYKTX_GL_INTFORMAT_INTENSITY8_SNORM: return TKTX_R8_SNORM;
-	case TINYKTX_GL_INTFORMAT_ALPHA16_SNORM: return TKTX_R16_SNORM;
-	case TINYKTX_GL_INTFORMAT_LUMINANCE16_SNORM: return TKTX_R16_SNORM;
-	case TINYKTX_GL_INTFORMAT_LUMINANCE16_ALPHA16_SNORM: return TKTX_R16G16_SNORM;
-	case TINYKTX_GL_INTFORMAT_INTENSITY16_SNORM: return TKTX_R16_SNORM;
-
-	case TINYKTX_GL_INTFORMAT_SRGB8:
-	case TINYKTX_GL_INTFORMAT_SRGB8_ALPHA8:
-		if (glformat == TINYKTX_GL_FORMAT_SLUMINANCE) {
-			return TKTX_R8_SRGB;
-		} else if (glformat == TINYKTX_GL_FORMAT_SLUMINANCE_ALPHA) {
-			return TKTX_R8G8_SRGB;
-		} else if (glformat == TINYKTX_GL_FORMAT_SRGB) {
-			return TKTX_R8G8B8_SRGB;
-		} else if (glformat == TINYKTX_GL_FORMAT_SRGB_ALPHA) {
-			return TKTX_R8G8B8A8_SRGB;
-		} else if (glformat == TINYKTX_GL_FORMAT_BGR) {
-			return TKTX_B8G8R8_SRGB;
-		} else if (glformat == TINYKTX_GL_FORMAT_BGRA) {
-			return TKTX_B8G8R8A8_SRGB;
-		} else if (glformat == TINYKTX_GL_FORMAT_ABGR) {
-			return TKTX_A8B8G8R8_SRGB_PACK32;
+TinyKtx_Format TinyKtx_CrackFormatFromGL(uint32_t const glformat,
+																				 uint32_t const gltype,
+																				 uint32_t const glinternalformat,
+																				 uint32_t const typesize) {
+	(void) typesize;
+	TinyKtx_GLFormatIndex const *index = TinyKtx_getGLFormatIndex();
+
+	// the internal format must match, the few entries sharing it are scored on the format
+	// (exactly or ignoring _INTEGER/_SNORM) then the type. Ties go to the earliest
+	static uint32_t const bestScore = 4 + 1;
+	uint32_t const baseFormat = TinyKtx_baseGLFormat(glformat);
+	TinyKtx_Format format = TKTX_UNDEFINED;
+	uint32_t score = 0;
+	for (uint32_t i = index->internalFormatHead[TinyKtx_glHash(glinternalformat)]; i != 0; i = index->internalFormatNext[i - 1]) {
+		TinyKtx_GLFormatEntry const *entry = &TinyKtx_glFormatEntries[i - 1];
+		if (entry->glInternalFormat != glinternalformat) {
+			continue;
 		}
-		break;
-	case TINYKTX_GL_INTFORMAT_RGB10_A2:
-		if(glformat == TINYKTX_GL_FORMAT_BGRA) {
-			return TKTX_A2R10G10B10_UNORM_PACK32;
-		} else if(glformat == TINYKTX_GL_FORMAT_RGBA) {
-			return TKTX_A2B10G10R10_UNORM_PACK32;
-		} else		if(glformat == TINYKTX_GL_FORMAT_BGRA_INTEGER) {
-			return TKTX_A2R10G10B10_UINT_PACK32;
-		} else if(glformat == TINYKTX_GL_FORMAT_RGBA_INTEGER) {
-			return TKTX_A2B10G10R10_UINT_PACK32;
+		uint32_t s = 0;
+		if (entry->glFormat == glformat) {
+			s += 4;
+		} else if (TinyKtx_baseGLFormat(entry->glFormat) == baseFormat) {
+			s += 2;
 		}
-		break;
-
-		// apparently we get FORMAT formats in the internal format slot sometimes
-	case TINYKTX_GL_FORMAT_RED:
-		switch(gltype) {
-		case TINYKTX_GL_TYPE_BYTE: return TKTX_R8_SNORM;
-		case TINYKTX_GL_TYPE_UNSIGNED_BYTE: return TKTX_R8_UNORM;
-		case TINYKTX_GL_TYPE_SHORT: return TKTX_R16_SNORM;
-		case TINYKTX_GL_TYPE_UNSIGNED_SHORT:return TKTX_R16_UNORM;
-		case TINYKTX_GL_TYPE_INT: return TKTX_R32_SINT;
-		case TINYKTX_GL_TYPE_UNSIGNED_INT: return TKTX_R32_UINT;
-		case TINYKTX_GL_TYPE_FLOAT: return TKTX_R32_SFLOAT;
-			//	case TINYKTX_GL_TYPE_DOUBLE:				return TKTX_R64G64B64A64_SFLOAT;
-		case TINYKTX_GL_TYPE_HALF_FLOAT: return TKTX_R16_SFLOAT;
-		default: return TKTX_UNDEFINED;
+		if (entry->glType == gltype) {
+			s += 1;
 		}
-	case TINYKTX_GL_FORMAT_RG:
-		switch(gltype) {
-		case TINYKTX_GL_TYPE_BYTE: return TKTX_R8G8_SNORM;
-		case TINYKTX_GL_TYPE_UNSIGNED_BYTE: return TKTX_R8G8_UNORM;
-		case TINYKTX_GL_TYPE_SHORT: return TKTX_R16G16_SNORM;
-		case TINYKTX_GL_TYPE_UNSIGNED_SHORT:return TKTX_R16G16_UNORM;
-		case TINYKTX_GL_TYPE_INT: return TKTX_R32G32_SINT;
-		case TINYKTX_GL_TYPE_UNSIGNED_INT: return TKTX_R32G32_UINT;
-		case TINYKTX_GL_TYPE_FLOAT: return TKTX_R32G32_SFLOAT;
-			//	case TINYKTX_GL_TYPE_DOUBLE:				return TKTX_R64G64_SFLOAT;
-		case TINYKTX_GL_TYPE_HALF_FLOAT: return TKTX_R16G16_SFLOAT;
-		default: return TKTX_UNDEFINED;
+		if (format == TKTX_UNDEFINED || s > score) {
+			score = s;
+			format = entry->format;
+			if (score == bestScore) {
+				break;
+			}
 		}
+	}
+	if (format != TKTX_UNDEFINED) {
+		return format;
+	}
 
-	case TINYKTX_GL_FORMAT_RGB:
-		switch(gltype) {
-		case TINYKTX_GL_TYPE_BYTE: return TKTX_R8G8B8_SNORM;
-		case TINYKTX_GL_TYPE_UNSIGNED_BYTE: return TKTX_R8G8B8_UNORM;
-		case TINYKTX_GL_TYPE_SHORT: return TKTX_R16G16B16_SNORM;
-		case TINYKTX_GL_TYPE_UNSIGNED_SHORT:return TKTX_R16G16B16_UNORM;
-		case TINYKTX_GL_TYPE_INT: return TKTX_R32G32B32_SINT;
-		case TINYKTX_GL_TYPE_UNSIGNED_INT: return TKTX_R32G32B32_UINT;
-		case TINYKTX_GL_TYPE_FLOAT: return TKTX_R32G32B32_SFLOAT;
-			//	case TINYKTX_GL_TYPE_DOUBLE:				return TKTX_R64G64B64_SFLOAT;
-		case TINYKTX_GL_TYPE_HALF_FLOAT: return TKTX_R16G16B16_SFLOAT;
-		default: return TKTX_UNDEFINED;
+	// Apparently we get FORMAT formats in the internal format slot sometimes, those
+	// match on format and type alone
+	for (uint32_t i = index->formatTypeHead[TinyKtx_glFormatTypeHash(glinternalformat, gltype)]; i != 0; i = index->formatTypeNext[i - 1]) {
+		TinyKtx_GLFormatEntry const *entry = &TinyKtx_glFormatEntries[i - 1];
+		if (entry->glType != gltype || TinyKtx_baseGLFormat(entry->glFormat) != glinternalformat) {
+			continue;
 		}
-	case TINYKTX_GL_FORMAT_RGBA:
-		switch(gltype) {
-		case TINYKTX_GL_TYPE_BYTE: return TKTX_R8G8B8A8_SNORM;
-		case TINYKTX_GL_TYPE_UNSIGNED_BYTE: return TKTX_R8G8B8A8_UNORM;
-		case TINYKTX_GL_TYPE_SHORT: return TKTX_R16G16B16A16_SNORM;
-		case TINYKTX_GL_TYPE_UNSIGNED_SHORT:return TKTX_R16G16B16A16_UNORM;
-		case TINYKTX_GL_TYPE_INT: return TKTX_R32G32B32A32_SINT;
-		case TINYKTX_GL_TYPE_UNSIGNED_INT: return TKTX_R32G32B32A32_UINT;
-		case TINYKTX_GL_TYPE_FLOAT: return TKTX_R32G32B32A32_SFLOAT;
-			//	case TINYKTX_GL_TYPE_DOUBLE:				return TKTX_R64G64B64A64_SFLOAT;
-		case TINYKTX_GL_TYPE_HALF_FLOAT: return TKTX_R16G16B16A16_SFLOAT;
-		default: return TKTX_UNDEFINED;
+		if (entry->glFormat == glinternalformat) {
+			return entry->format;
+		}
+		if (format == TKTX_UNDEFINED) {
+			format = entry->format;
 		}
-
-		// can't handle yet
-	case TINYKTX_GL_INTFORMAT_ALPHA4:
-	case TINYKTX_GL_INTFORMAT_ALPHA12:
-	case TINYKTX_GL_INTFORMAT_LUMINANCE4:
-	case TINYKTX_GL_INTFORMAT_LUMINANCE12:
-	case TINYKTX_GL_INTFORMAT_LUMINANCE4_ALPHA4:
-	case TINYKTX_GL_INTFORMAT_LUMINANCE6_ALPHA2:
-	case TINYKTX_GL_INTFORMAT_LUMINANCE12_ALPHA4:
-	case TINYKTX_GL_INTFORMAT_LUMINANCE12_ALPHA12:
-	case TINYKTX_GL_INTFORMAT_INTENSITY4:
-	case TINYKTX_GL_INTFORMAT_INTENSITY12:
-	case TINYKTX_GL_INTFORMAT_RGB2:
-	case TINYKTX_GL_INTFORMAT_RGB5:
-	case TINYKTX_GL_INTFORMAT_RGB10:
-	case TINYKTX_GL_INTFORMAT_RGB12:
-	case TINYKTX_GL_INTFORMAT_RGBA2:
-	case TINYKTX_GL_INTFORMAT_RGBA12:
-	case TINYKTX_GL_INTFORMAT_FLOAT_32_UNSIGNED_INT_24_8_REV:
-	case TINYKTX_GL_COMPRESSED_SRGB_ALPHA_PVRTC_2BPPV2:
-	case TINYKTX_GL_COMPRESSED_SRGB_ALPHA_PVRTC_4BPPV2:
-	case TINYKTX_GL_COMPRESSED_ATC_RGB:
-	case TINYKTX_GL_COMPRESSED_ATC_RGBA_EXPLICIT_ALPHA:
-	case TINYKTX_GL_COMPRESSED_ATC_RGBA_INTERPOLATED_ALPHA:
-	default: break;
 	}
-	return TKTX_UNDEFINED;
+	return format;
 }
+#undef TINYKTX_LOAD_ACQUIRE
+#undef TINYKTX_STORE_RELEASE
 
 uint32_t TinyKtx_ElementCountFromGLFormat(uint32_t fmt){
 	switch(fmt) {
@@ -1899,12 +2156,6 @@ bool TinyKtx_ByteDividableFromGLType(uint32_t type){
 	return false;
 }
 TinyKtx_Format TinyKtx_GetFormat(TinyKtx_ContextHandle handle) {
-	uint32_t glformat;
-	uint32_t gltype;
-	uint32_t glinternalformat;
-	uint32_t typesize;
-	uint32_t glbaseinternalformat;
-
 	TinyKtx_Context *ctx = (TinyKtx_Context *) handle;
 	if (ctx == NULL)
 		return TKTX_UNDEFINED;
@@ -1914,10 +2165,7 @@ TinyKtx_Format TinyKtx_GetFormat(TinyKtx_ContextHandle handle) {
 		return TKTX_UNDEFINED;
 	}
 
-	if(TinyKtx_GetFormatGL(handle, &glformat, &gltype, &glinternalformat, &typesize, &glbaseinternalformat) == false)
-		return TKTX_UNDEFINED;
-
-	return TinyKtx_CrackFormatFromGL(glformat, gltype, glinternalformat, typesize);
+	return ctx->format;
 }
 static uint32_t TinyKtx_MipMapReduce(uint32_t value, uint32_t mipmaplevel) {
 
@@ -1994,137 +2242,1405 @@ uint32_t TinyKtx_UnpackedRowStride(TinyKtx_ContextHandle handle, uint32_t mipmap
 	return 0;
 }
 
+uint64_t TinyKtx_DepthSliceSize(TinyKtx_ContextHandle handle, uint32_t mipmaplevel) {
+	TinyKtx_Context *ctx = (TinyKtx_Context *) handle;
+	if (ctx == NULL)
+		return 0;
+	if (ctx->headerValid == false) {
+		ctx->callbacks.errorFn(ctx->user, "Header data hasn't been read yet or its invalid");
+		return 0;
+	}
+	if (mipmaplevel >= ctx->header.numberOfMipmapLevels) {
+		ctx->callbacks.errorFn(ctx->user, "Invalid mipmap level");
+		return 0;
+	}
+	// slices of arrays and cubemaps aren't contiguous (and KTX v1 has no 3D arrays anyway)
+	if (ctx->header.numberOfArrayElements > 1 || ctx->header.numberOfFaces > 1) {
+		ctx->callbacks.errorFn(ctx->user, "Depth slices can only be read from 3D textures");
+		return 0;
+	}
 
-bool TinyKtx_WriteImageGL(TinyKtx_WriteCallbacks const *callbacks,
-													void *user,
-													uint32_t width,
-													uint32_t height,
-													uint32_t depth,
-													uint32_t slices,
-													uint32_t mipmaplevels,
-													uint32_t format,
-													uint32_t internalFormat,
-													uint32_t baseFormat,
-													uint32_t type,
-													uint32_t typeSize,
-													bool cubemap,
-													uint32_t const *mipmapsizes,
-													void const **mipmaps) {
+	uint32_t const w = TinyKtx_MipMapReduce(ctx->header.pixelWidth, mipmaplevel);
+	uint32_t const h = TinyKtx_MipMapReduce(ctx->header.pixelHeight, mipmaplevel);
+	// rows of small types are padded to 4 bytes (GL_UNPACK_ALIGNMENT), everything else is a
+	// multiple of 4 already
+	uint32_t const rowStride = TinyKtx_UnpackedRowStride(handle, mipmaplevel);
+	if (rowStride)
+		return (uint64_t) rowStride * h;
+
+	uint32_t bw, bh, bd, bytes;
+	if (!TinyKtx_FormatBlockInfo(TinyKtx_GetFormat(handle), &bw, &bh, &bd, &bytes) || bd != 1) {
+		ctx->callbacks.errorFn(ctx->user, "Depth slices need a known format with 2D blocks");
+		return 0;
+	}
+	return (uint64_t) ((w + bw - 1) / bw) * ((h + bh - 1) / bh) * bytes;
+}
 
-	TinyKtx_Header header;
-	memcpy(header.identifier, TinyKtx_fileIdentifier, 12);
-	header.endianness = 0x04030201;
-	header.glFormat = format;
-	header.glInternalFormat = internalFormat;
-	header.glBaseInternalFormat = baseFormat;
-	header.glType = type;
-	header.glTypeSize = typeSize;
-	header.pixelWidth = width;
-	header.pixelHeight = (height == 1) ? 0 : height;
-	header.pixelDepth = (depth == 1) ? 0 : depth;
-	header.numberOfArrayElements = (slices == 1) ? 0 : slices;
-	header.numberOfFaces = cubemap ? 6 : 1;
-	header.numberOfMipmapLevels = mipmaplevels;
-	// TODO keyvalue pair data
-	header.bytesOfKeyValueData = 0;
-	callbacks->writeFn(user, &header, sizeof(TinyKtx_Header));
+bool TinyKtx_ReadDepthSlices(TinyKtx_ContextHandle handle,
+														 uint32_t mipmaplevel,
+														 uint32_t z0,
+														 uint32_t z1,
+														 void *dst,
+														 size_t dstSize) {
+	TinyKtx_Context *ctx = (TinyKtx_Context *) handle;
+	if (ctx == NULL || dst == NULL)
+		return false;
 
-	uint32_t w = (width == 0) ? 1 : width;
-	uint32_t h = (height == 0) ? 1 : height;
-	uint32_t d = (depth == 0) ? 1 : depth;
-	uint32_t sl = (slices == 0) ? 1 : slices;
-	static uint8_t const padding[4] = {0, 0, 0, 0};
+	uint64_t const sliceSize = TinyKtx_DepthSliceSize(handle, mipmaplevel);
+	if (sliceSize == 0)
+		return false;
+	uint32_t const depth = TinyKtx_MipMapReduce(ctx->header.pixelDepth, mipmaplevel);
+	if (z0 >= z1 || z1 > depth) {
+		ctx->callbacks.errorFn(ctx->user, "Invalid depth slice range");
+		return false;
+	}
+	uint64_t const byteCount = sliceSize * (z1 - z0);
+	if (dstSize < byteCount) {
+		ctx->callbacks.errorFn(ctx->user, "Depth slice destination is too small");
+		return false;
+	}
 
-	for (uint32_t i = 0u; i < mipmaplevels; ++i) {
+	// leaves the stream at the start of the level data
+	uint64_t const levelSize = TinyKtx_imageSize(handle, mipmaplevel, true);
+	if (levelSize == 0)
+		return false;
+	if (levelSize < sliceSize * depth) {
+		ctx->callbacks.errorFn(ctx->user, "Mipmap level is smaller than its format and dimensions need");
+		return false;
+	}
+	int64_t const levelStart = ctx->callbacks.tellFn(ctx->user);
+	ctx->callbacks.seekFn(ctx->user, levelStart + (int64_t) (sliceSize * z0));
+	if (!TinyKtx_read(ctx, dst, byteCount)) {
+		ctx->callbacks.errorFn(ctx->user, "Truncated mipmap level");
+		return false;
+	}
+	return true;
+}
 
-		bool writeRaw = true;
+static float TinyKtx_asFloat(uint32_t u) {
+	float f;
+	memcpy(&f, &u, sizeof(float));
+	return f;
+}
+static uint32_t TinyKtx_asUint(float f) {
+	uint32_t u;
+	memcpy(&u, &f, sizeof(float));
+	return u;
+}
 
-		if(	typeSize < 4 &&
-				TinyKtx_ByteDividableFromGLType(type)) {
+// exponent rebias and a magic multiply for denormals (after ryg's half_to_float_fast5)
+static float TinyKtx_halfToFloat(uint16_t h) {
+	uint32_t const shiftedExp = 0x7C00u << 13;
+	uint32_t o = ((uint32_t) h & 0x7FFFu) << 13;
+	uint32_t const exp = o & shiftedExp;
+	o += (127u - 15u) << 23;
+	if (exp == shiftedExp) {
+		o += (128u - 16u) << 23; // inf/nan
+	} else if (exp == 0) {
+		o = TinyKtx_asUint(TinyKtx_asFloat(o + (1u << 23)) - TinyKtx_asFloat(113u << 23)); // denormal
+	}
+	return TinyKtx_asFloat(o | (((uint32_t) h & 0x8000u) << 16));
+}
 
-			uint32_t const s = typeSize;
-			uint32_t const n = TinyKtx_ElementCountFromGLFormat(format);
-			if (n == 0) {
-				callbacks->errorFn(user, "TinyKtx_ElementCountFromGLFormat error");
-				return false;
-			}
-			uint32_t const snl = s * n * w;
-			uint32_t const k = ((snl + 3u) & ~3u);
+// round to nearest even (after ryg's float_to_half_fast3_rtne)
+static uint16_t TinyKtx_floatToHalf(float value) {
+	uint32_t u = TinyKtx_asUint(value);
+	uint32_t const sign = u & 0x80000000u;
+	u ^= sign;
+	uint16_t o;
+	if (u >= ((127u + 16u) << 23)) {
+		o = (u > (255u << 23)) ? 0x7E00 : 0x7C00; // nan or inf
+	} else if (u < (113u << 23)) {
+		// denormal, let the float adder do the rounding
+		float const denormMagic = TinyKtx_asFloat(((127u - 15u) + (23u - 10u) + 1u) << 23);
+		o = (uint16_t) (TinyKtx_asUint(TinyKtx_asFloat(u) + denormMagic) - TinyKtx_asUint(denormMagic));
+	} else {
+		uint32_t const mantOdd = (u >> 13) & 1u;
+		u += ((uint32_t) (15 - 127) << 23) + 0xFFFu;
+		u += mantOdd;
+		o = (uint16_t) (u >> 13);
+	}
+	return (uint16_t) (o | (sign >> 16));
+}
 
-			uint32_t const size = (k * h * d * snl);
-			if (size < mipmapsizes[i]) {
-				callbacks->errorFn(user, "Internal size error, padding should only ever expand");
-				return false;
-			}
+static void TinyKtx_halfsToFloats(uint16_t const *src, float *dst, size_t count) {
+	size_t i = 0;
+#if defined(TINYKTX_F16C)
+	for (; i + 8 <= count; i += 8) {
+		_mm256_storeu_ps(dst + i, _mm256_cvtph_ps(_mm_loadu_si128((__m128i const *) (src + i))));
+	}
+#elif defined(TINYKTX_NEON)
+	for (; i + 4 <= count; i += 4) {
+		vst1q_f32(dst + i, vcvt_f32_f16(vreinterpret_f16_u16(vld1_u16(src + i))));
+	}
+#elif defined(TINYKTX_SSE2)
+	// the same bit tricks as TinyKtx_halfToFloat with selects instead of branches
+	__m128i const zero = _mm_setzero_si128();
+	__m128i const shiftedExp = _mm_set1_epi32(0x7C00 << 13);
+	__m128i const rebias = _mm_set1_epi32((127 - 15) << 23);
+	__m128i const infRebias = _mm_set1_epi32((128 - 16) << 23);
+	__m128i const denormBias = _mm_set1_epi32(1 << 23);
+	__m128 const magic = _mm_castsi128_ps(_mm_set1_epi32(113 << 23));
+	for (; i + 4 <= count; i += 4) {
+		__m128i const h = _mm_unpacklo_epi16(_mm_loadl_epi64((__m128i const *) (src + i)), zero);
+		__m128i o = _mm_slli_epi32(_mm_and_si128(h, _mm_set1_epi32(0x7FFF)), 13);
+		__m128i const exp = _mm_and_si128(o, shiftedExp);
+		o = _mm_add_epi32(o, rebias);
+		o = _mm_add_epi32(o, _mm_and_si128(_mm_cmpeq_epi32(exp, shiftedExp), infRebias));
+		__m128i const isDenorm = _mm_cmpeq_epi32(exp, zero);
+		__m128i const denorm = _mm_castps_si128(_mm_sub_ps(_mm_castsi128_ps(_mm_add_epi32(o, denormBias)), magic));
+		o = _mm_or_si128(_mm_and_si128(isDenorm, denorm), _mm_andnot_si128(isDenorm, o));
+		o = _mm_or_si128(o, _mm_slli_epi32(_mm_and_si128(h, _mm_set1_epi32(0x8000)), 16));
+		_mm_storeu_ps(dst + i, _mm_castsi128_ps(o));
+	}
+#endif
+	for (; i < count; ++i) {
+		dst[i] = TinyKtx_halfToFloat(src[i]);
+	}
+}
 
-			// if we need to expand for padding take the slow per row write route
-			if (size > mipmapsizes[i]) {
-				callbacks->writeFn(user, &size, sizeof(uint32_t));
-
-				uint8_t const *src = (uint8_t const*) mipmaps[i];
-				for (uint32_t ww = 0u; ww < sl; ++ww) {
-					for (uint32_t zz = 0; zz < d; ++zz) {
-						for (uint32_t yy = 0; yy < h; ++yy) {
-							callbacks->writeFn(user, src, snl);
-							callbacks->writeFn(user, padding, k - snl);
-							src += snl;
-						}
-					}
-				}
-				uint32_t paddCount = ((size + 3u) & ~3u) - size;
-				if(paddCount > 3) {
-					callbacks->errorFn(user, "Internal error: padding bytes > 3");
-					return false;
-				}
+static void TinyKtx_floatsToHalfs(float const *src, uint16_t *dst, size_t count) {
+	size_t i = 0;
+#if defined(TINYKTX_F16C)
+	for (; i + 8 <= count; i += 8) {
+		_mm_storeu_si128((__m128i *) (dst + i), _mm256_cvtps_ph(_mm256_loadu_ps(src + i), _MM_FROUND_TO_NEAREST_INT));
+	}
+#elif defined(TINYKTX_NEON)
+	for (; i + 4 <= count; i += 4) {
+		vst1_u16(dst + i, vreinterpret_u16_f16(vcvt_f16_f32(vld1q_f32(src + i))));
+	}
+#endif
+	for (; i < count; ++i) {
+		dst[i] = TinyKtx_floatToHalf(src[i]);
+	}
+}
 
-				callbacks->writeFn(user, padding, paddCount);
-				writeRaw = false;
-			}
-		}
+// unsigned 5 bit exponent floats (the 10 and 11 bit parts of B10G11R11) share the half's bias
+static uint32_t TinyKtx_floatToSmallFloat(float value, uint32_t mantissaBits) {
+	uint32_t const u = TinyKtx_asUint(value);
+	uint32_t const infinity = 0x1Fu << mantissaBits;
+	uint32_t const maxFinite = infinity - 1u;
+	if ((u & 0x7F800000u) == 0x7F800000u) {
+		if (u & 0x7FFFFFu)
+			return infinity | ((1u << mantissaBits) - 1u); // nan
+		return (u & 0x80000000u) ? 0 : infinity;
+	}
+	if ((u & 0x80000000u) || u == 0)
+		return 0;
+	if (u < (113u << 23)) {
+		// denormal, scale so the mantissa lands in the float's integer range and let the adder round
+		float const scaled = value * TinyKtx_asFloat((127u + 14u + mantissaBits) << 23);
+		return TinyKtx_asUint(scaled + 8388608.0f) - 0x4B000000u;
+	}
+	uint32_t const shift = 23u - mantissaBits;
+	uint32_t r = u - ((127u - 15u) << 23);
+	r += (1u << (shift - 1u)) - 1u + ((r >> shift) & 1u);
+	r >>= shift;
+	return (r > maxFinite) ? maxFinite : r;
+}
 
-		if(writeRaw) {
-			uint32_t const size = ((mipmapsizes[i] + 3u) & ~3u);
-			callbacks->writeFn(user, mipmapsizes + i, sizeof(uint32_t));
-			callbacks->writeFn(user, mipmaps[i], mipmapsizes[i]);
-			callbacks->writeFn(user, padding, size - mipmapsizes[i]);
-		}
+static void TinyKtx_rgb9e5ToFloats(uint32_t v, float *dst) {
+	// 2^(exponent - 15 - 9)
+	float const scale = TinyKtx_asFloat(((v >> 27) + 127u - 24u) << 23);
+	dst[0] = (float) (v & 0x1FFu) * scale;
+	dst[1] = (float) ((v >> 9) & 0x1FFu) * scale;
+	dst[2] = (float) ((v >> 18) & 0x1FFu) * scale;
+}
 
-		if(w > 1) w = w / 2;
-		if(h > 1) h = h / 2;
-		if(d > 1) d = d / 2;
+// as EXT_texture_shared_exponent describes
+static uint32_t TinyKtx_floatsToRgb9e5(float const *src) {
+	float const maxValue = 65408.0f; // (2^9 - 1) / 2^9 * 2^16
+	float c[3];
+	for (uint32_t i = 0; i < 3; ++i) {
+		float const v = src[i];
+		c[i] = (v > 0.0f) ? ((v < maxValue) ? v : maxValue) : 0.0f; // nan fails both and is 0
+	}
+	float const maxc = (c[0] > c[1]) ? ((c[0] > c[2]) ? c[0] : c[2]) : ((c[1] > c[2]) ? c[1] : c[2]);
+	// floor(log2(maxc)) from the float exponent, at least -16
+	int32_t exp = (int32_t) ((TinyKtx_asUint(maxc) >> 23) & 0xFF) - 127;
+	if (exp < -16) exp = -16;
+	exp += 1 + 15;
+	float denom = TinyKtx_asFloat((uint32_t) (exp - 15 - 9 + 127) << 23);
+	if ((uint32_t) (maxc / denom + 0.5f) == 512u) {
+		denom *= 2.0f;
+		exp += 1;
 	}
+	uint32_t const r = (uint32_t) (c[0] / denom + 0.5f);
+	uint32_t const g = (uint32_t) (c[1] / denom + 0.5f);
+	uint32_t const b = (uint32_t) (c[2] / denom + 0.5f);
+	return ((uint32_t) exp << 27) | (b << 18) | (g << 9) | r;
+}
 
-	return true;
+// floats per pixel of the formats TinyKtx_FormatToFloat takes, 0 for others
+static uint32_t TinyKtx_floatChannelCount(TinyKtx_Format format) {
+	switch (format) {
+	case TKTX_R16_SFLOAT: return 1;
+	case TKTX_R16G16_SFLOAT: return 2;
+	case TKTX_R16G16B16_SFLOAT: return 3;
+	case TKTX_R16G16B16A16_SFLOAT: return 4;
+	case TKTX_R32_SFLOAT: return 1;
+	case TKTX_R32G32_SFLOAT: return 2;
+	case TKTX_R32G32B32_SFLOAT: return 3;
+	case TKTX_R32G32B32A32_SFLOAT: return 4;
+	case TKTX_B10G11R11_UFLOAT_PACK32: return 3;
+	case TKTX_E5B9G9R9_UFLOAT_PACK32: return 3;
+	default: return 0;
+	}
 }
 
-bool TinyKtx_WriteImage(TinyKtx_WriteCallbacks const *callbacks,
-												void *user,
-												uint32_t width,
-												uint32_t height,
-												uint32_t depth,
-												uint32_t slices,
-												uint32_t mipmaplevels,
-												TinyKtx_Format format,
-												bool cubemap,
-												uint32_t const *mipmapsizes,
-												void const **mipmaps) {
-	uint32_t glformat;
-	uint32_t glinternalFormat;
-	uint32_t gltype;
-	uint32_t gltypeSize;
-	if (TinyKtx_CrackFormatToGL(format, &glformat, &gltype, &glinternalFormat, &gltypeSize) == false)
+bool TinyKtx_FormatToFloat(TinyKtx_Format format, void const *src, float *dst, size_t pixelCount) {
+	uint32_t const channels = TinyKtx_floatChannelCount(format);
+	if (channels == 0 || src == NULL || dst == NULL)
 		return false;
 
-	return TinyKtx_WriteImageGL(callbacks,
-															user,
-															width,
-															height,
-															depth,
-															slices,
+	switch (format) {
+	case TKTX_B10G11R11_UFLOAT_PACK32: {
+		// widen to halfs (same exponent) a batch at a time then use the half kernel
+		uint8_t const *s = (uint8_t const *) src;
+		uint16_t halfs[64 * 3];
+		for (size_t i = 0; i < pixelCount;) {
+			size_t const n = (pixelCount - i < 64) ? pixelCount - i : 64;
+			for (size_t j = 0; j < n; ++j) {
+				uint32_t v;
+				memcpy(&v, s + (i + j) * 4, sizeof(uint32_t));
+				halfs[j * 3 + 0] = (uint16_t) ((v & 0x7FFu) << 4);
+				halfs[j * 3 + 1] = (uint16_t) (((v >> 11) & 0x7FFu) << 4);
+				halfs[j * 3 + 2] = (uint16_t) (((v >> 22) & 0x3FFu) << 5);
+			}
+			TinyKtx_halfsToFloats(halfs, dst + i * 3, n * 3);
+			i += n;
+		}
+		return true;
+	}
+	case TKTX_E5B9G9R9_UFLOAT_PACK32: {
+		uint8_t const *s = (uint8_t const *) src;
+		for (size_t i = 0; i < pixelCount; ++i) {
+			uint32_t v;
+			memcpy(&v, s + i * 4, sizeof(uint32_t));
+			TinyKtx_rgb9e5ToFloats(v, dst + i * 3);
+		}
+		return true;
+	}
+	case TKTX_R32_SFLOAT:
+	case TKTX_R32G32_SFLOAT:
+	case TKTX_R32G32B32_SFLOAT:
+	case TKTX_R32G32B32A32_SFLOAT:
+		memcpy(dst, src, pixelCount * channels * sizeof(float));
+		return true;
+	default:
+		TinyKtx_halfsToFloats((uint16_t const *) src, dst, pixelCount * channels);
+		return true;
+	}
+}
+
+bool TinyKtx_FormatFromFloat(TinyKtx_Format format, float const *src, void *dst, size_t pixelCount) {
+	uint32_t const channels = TinyKtx_floatChannelCount(format);
+	if (channels == 0 || src == NULL || dst == NULL)
+		return false;
+
+	uint8_t *d = (uint8_t *) dst;
+	switch (format) {
+	case TKTX_B10G11R11_UFLOAT_PACK32:
+		for (size_t i = 0; i < pixelCount; ++i) {
+			float const *c = src + i * 3;
+			uint32_t const v = TinyKtx_floatToSmallFloat(c[0], 6) |
+					(TinyKtx_floatToSmallFloat(c[1], 6) << 11) |
+					(TinyKtx_floatToSmallFloat(c[2], 5) << 22);
+			memcpy(d + i * 4, &v, sizeof(uint32_t));
+		}
+		return true;
+	case TKTX_E5B9G9R9_UFLOAT_PACK32:
+		for (size_t i = 0; i < pixelCount; ++i) {
+			uint32_t const v = TinyKtx_floatsToRgb9e5(src + i * 3);
+			memcpy(d + i * 4, &v, sizeof(uint32_t));
+		}
+		return true;
+	case TKTX_R32_SFLOAT:
+	case TKTX_R32G32_SFLOAT:
+	case TKTX_R32G32B32_SFLOAT:
+	case TKTX_R32G32B32A32_SFLOAT:
+		memcpy(dst, src, pixelCount * channels * sizeof(float));
+		return true;
+	default:
+		TinyKtx_floatsToHalfs(src, (uint16_t *) dst, pixelCount * channels);
+		return true;
+	}
+}
+
+// 8 bit channel expansion/swizzle to 4 bytes per pixel. Each destination byte either comes from
+// a source byte or is a constant, held for 4 pixels at a time as a pshufb/tbl style mask where
+// 0x80 selects the constant (the shuffle leaves those 0 and the constants are or'ed in)
+typedef struct TinyKtx_ByteSwizzle {
+	uint32_t srcBytes;
+	uint8_t mask[16];
+	uint8_t constant[16];
+} TinyKtx_ByteSwizzle;
+
+static void TinyKtx_makeSwizzle(TinyKtx_ByteSwizzle *swz, uint32_t srcBytes, uint8_t const channels[4], uint8_t one) {
+	swz->srcBytes = srcBytes;
+	for (uint32_t p = 0; p < 4; ++p) {
+		for (uint32_t c = 0; c < 4; ++c) {
+			uint8_t const ch = channels[c];
+			swz->mask[p * 4 + c] = (ch & 0x80) ? 0x80 : (uint8_t) (p * srcBytes + ch);
+			swz->constant[p * 4 + c] = (ch == 0x80) ? 0 : (ch == 0x81) ? one : 0;
+		}
+	}
+}
+
+static void TinyKtx_swizzleRow(TinyKtx_ByteSwizzle const *swz, uint8_t const *src, uint8_t *dst, uint32_t count) {
+	uint32_t const sb = swz->srcBytes;
+	uint32_t i = 0;
+	// every 16 byte load has to stay inside the row
+#if defined(TINYKTX_AVX2)
+	__m256i const mask = _mm256_broadcastsi128_si256(_mm_loadu_si128((__m128i const *) swz->mask));
+	__m256i const constant = _mm256_broadcastsi128_si256(_mm_loadu_si128((__m128i const *) swz->constant));
+	for (; (uint64_t) (count - i) * sb >= 4 * sb + 16; i += 8) {
+		__m128i const lo = _mm_loadu_si128((__m128i const *) (src + i * sb));
+		__m128i const hi = _mm_loadu_si128((__m128i const *) (src + (i + 4) * sb));
+		__m256i const v = _mm256_inserti128_si256(_mm256_castsi128_si256(lo), hi, 1);
+		_mm256_storeu_si256((__m256i *) (dst + i * 4), _mm256_or_si256(_mm256_shuffle_epi8(v, mask), constant));
+	}
+#endif
+#if defined(TINYKTX_SSSE3)
+	{
+		__m128i const mask = _mm_loadu_si128((__m128i const *) swz->mask);
+		__m128i const constant = _mm_loadu_si128((__m128i const *) swz->constant);
+		for (; (uint64_t) (count - i) * sb >= 16; i += 4) {
+			__m128i const v = _mm_loadu_si128((__m128i const *) (src + i * sb));
+			_mm_storeu_si128((__m128i *) (dst + i * 4), _mm_or_si128(_mm_shuffle_epi8(v, mask), constant));
+		}
+	}
+#elif defined(TINYKTX_NEON)
+	{
+		uint8x16_t const mask = vld1q_u8(swz->mask);
+		uint8x16_t const constant = vld1q_u8(swz->constant);
+		for (; (uint64_t) (count - i) * sb >= 16; i += 4) {
+			vst1q_u8(dst + i * 4, vorrq_u8(vqtbl1q_u8(vld1q_u8(src + i * sb), mask), constant));
+		}
+	}
+#endif
+	for (; i < count; ++i) {
+		uint8_t const *s = src + i * sb;
+		uint8_t *d = dst + i * 4;
+		for (uint32_t c = 0; c < 4; ++c) {
+			d[c] = (swz->mask[c] & 0x80) ? swz->constant[c] : s[swz->mask[c]];
+		}
+	}
+}
+
+// byte layout of the 8 bit per channel formats, pixel bytes then the source byte of R, G, B and A
+// (0x80 is 0 and 0x81 is 1). glFormat picks the legacy luminance/alpha/intensity layouts, 0 if none.
+// numeric is the position in the format's block of 7 (UNORM, SNORM, USCALED, SSCALED, UINT, SINT, SRGB)
+static uint8_t const *TinyKtx_byteLayout(TinyKtx_Format format, uint32_t glFormat, uint32_t *numeric) {
+	if (format < TKTX_R8_UNORM || format > TKTX_A8B8G8R8_SRGB_PACK32)
+		return NULL;
+	static uint8_t const layouts[7][5] = {
+			{ 1, 0, 0x80, 0x80, 0x81 }, // R
+			{ 2, 0, 1, 0x80, 0x81 },		// RG
+			{ 3, 0, 1, 2, 0x81 },				// RGB
+			{ 3, 2, 1, 0, 0x81 },				// BGR
+			{ 4, 0, 1, 2, 3 },					// RGBA
+			{ 4, 2, 1, 0, 3 },					// BGRA
+			{ 4, 0, 1, 2, 3 },					// ABGR_PACK32 is RGBA in memory
+	};
+	uint32_t const index = format - TKTX_R8_UNORM;
+	*numeric = index % 7;
+	// legacy formats loaded as R/RG
+	static uint8_t const luminance[] = { 1, 0, 0, 0, 0x81 };
+	static uint8_t const luminanceAlpha[] = { 2, 0, 0, 0, 1 };
+	static uint8_t const alpha[] = { 1, 0x80, 0x80, 0x80, 0 };
+	static uint8_t const intensity[] = { 1, 0, 0, 0, 0 };
+	switch (glFormat) {
+	case TINYKTX_GL_FORMAT_LUMINANCE: return luminance;
+	case TINYKTX_GL_FORMAT_LUMINANCE_ALPHA: return luminanceAlpha;
+	case TINYKTX_GL_FORMAT_ALPHA: return alpha;
+	case TINYKTX_GL_FORMAT_INTENSITY: return intensity;
+	default: return layouts[index / 7];
+	}
+}
+
+static uint8_t TinyKtx_numericOne(uint32_t numeric) {
+	return (numeric == 0 || numeric == 6) ? 0xFF : (numeric == 1) ? 0x7F : 1;
+}
+
+static bool TinyKtx_levelSwizzle(TinyKtx_Context *ctx, TinyKtx_Format format, TinyKtx_ByteSwizzle *swz) {
+	uint32_t numeric;
+	uint8_t const *layout = TinyKtx_byteLayout(ctx->format, ctx->header.glFormat, &numeric);
+	if (layout == NULL || format < TKTX_R8G8B8A8_UNORM || format > TKTX_R8G8B8A8_SRGB ||
+			numeric != (uint32_t) (format - TKTX_R8_UNORM) % 7)
+		return false;
+	TinyKtx_makeSwizzle(swz, layout[0], layout + 1, TinyKtx_numericOne(numeric));
+	return true;
+}
+
+// 8 bit to float, sRGB decoded then plain unorm. One table so AVX2 can gather from both at once
+static float const TinyKtx_byteToFloat[512] = {
+		0.0f, 0.000303526991f, 0.000607053982f, 0.000910580973f, 0.00121410796f, 0.00151763496f, 0.00182116195f, 0.00212468882f,
+		0.00242821593f, 0.0027317428f, 0.00303526991f, 0.00334653584f, 0.00367650739f, 0.00402471703f, 0.00439144205f, 0.00477695325f,
+		0.00518151652f, 0.00560539169f, 0.00604883302f, 0.00651209056f, 0.00699541019f, 0.00749903219f, 0.00802319311f, 0.00856812578f,
+		0.00913405884f, 0.00972121768f, 0.010329823f, 0.0109600937f, 0.0116122449f, 0.012286488f, 0.0129830325f, 0.0137020834f,
+		0.0144438436f, 0.0152085144f, 0.0159962941f, 0.0168073755f, 0.0176419541f, 0.01850022f, 0.0193823613f, 0.0202885624f,
+		0.0212190095f, 0.0221738853f, 0.0231533665f, 0.0241576321f, 0.0251868591f, 0.0262412224f, 0.0273208916f, 0.02842604f,
+		0.0295568351f, 0.0307134446f, 0.0318960324f, 0.0331047662f, 0.0343398079f, 0.0356013142f, 0.0368894488f, 0.0382043719f,
+		0.0395462364f, 0.0409151986f, 0.0423114114f, 0.043735031f, 0.045186203f, 0.0466650873f, 0.0481718257f, 0.0497065671f,
+		0.0512694567f, 0.0528606474f, 0.054480277f, 0.0561284907f, 0.0578054301f, 0.0595112368f, 0.0612460524f, 0.0630100146f,
+		0.064803265f, 0.0666259378f, 0.0684781671f, 0.0703600943f, 0.0722718537f, 0.0742135718f, 0.0761853829f, 0.078187421f,
+		0.0802198201f, 0.0822827071f, 0.0843762085f, 0.0865004584f, 0.0886555836f, 0.0908417106f, 0.0930589661f, 0.0953074694f,
+		0.097587347f, 0.0998987257f, 0.102241732f, 0.104616486f, 0.107023105f, 0.10946171f, 0.111932427f, 0.114435375f,
+		0.116970666f, 0.119538426f, 0.122138776f, 0.124771819f, 0.127437681f, 0.130136475f, 0.13286832f, 0.135633335f,
+		0.138431609f, 0.141263291f, 0.144128472f, 0.147027269f, 0.149959788f, 0.152926147f, 0.155926466f, 0.158960834f,
+		0.162029371f, 0.165132195f, 0.168269396f, 0.171441108f, 0.174647406f, 0.177888423f, 0.18116425f, 0.18447499f,
+		0.187820777f, 0.191201687f, 0.194617838f, 0.198069319f, 0.20155625f, 0.205078736f, 0.208636865f, 0.212230757f,
+		0.215860501f, 0.219526201f, 0.223227963f, 0.226965874f, 0.230740055f, 0.23455058f, 0.238397568f, 0.242281124f,
+		0.246201321f, 0.25015828f, 0.254152089f, 0.258182853f, 0.262250662f, 0.266355604f, 0.270497799f, 0.274677306f,
+		0.278894275f, 0.283148736f, 0.287440836f, 0.291770637f, 0.296138257f, 0.300543785f, 0.304987311f, 0.309468925f,
+		0.313988715f, 0.318546772f, 0.323143214f, 0.327778101f, 0.332451522f, 0.337163627f, 0.341914415f, 0.346704066f,
+		0.351532608f, 0.356400132f, 0.361306787f, 0.366252601f, 0.371237695f, 0.376262128f, 0.38132602f, 0.386429429f,
+		0.391572475f, 0.396755219f, 0.401977777f, 0.407240212f, 0.412542611f, 0.417885065f, 0.423267663f, 0.428690493f,
+		0.434153646f, 0.439657182f, 0.445201188f, 0.450785786f, 0.456411034f, 0.462076992f, 0.467783809f, 0.473531485f,
+		0.479320168f, 0.48514995f, 0.491020858f, 0.496932983f, 0.502886474f, 0.50888133f, 0.514917672f, 0.520995557f,
+		0.527115107f, 0.533276379f, 0.539479494f, 0.545724452f, 0.55201143f, 0.558340371f, 0.564711511f, 0.571124852f,
+		0.577580452f, 0.584078431f, 0.590618849f, 0.597201765f, 0.603827357f, 0.610495567f, 0.617206573f, 0.623960376f,
+		0.630757153f, 0.637596846f, 0.644479692f, 0.651405632f, 0.658374846f, 0.665387273f, 0.672443151f, 0.679542482f,
+		0.686685324f, 0.693871737f, 0.701101899f, 0.708375752f, 0.715693474f, 0.723055124f, 0.730460763f, 0.73791039f,
+		0.745404184f, 0.752942204f, 0.760524511f, 0.768151164f, 0.775822222f, 0.783537805f, 0.791297913f, 0.799102724f,
+		0.806952238f, 0.814846575f, 0.822785735f, 0.830769897f, 0.838799f, 0.846873224f, 0.854992628f, 0.863157213f,
+		0.871367097f, 0.8796224f, 0.887923121f, 0.896269381f, 0.904661179f, 0.913098633f, 0.921581864f, 0.930110872f,
+		0.938685715f, 0.947306514f, 0.955973327f, 0.964686275f, 0.973445296f, 0.982250571f, 0.991102099f, 1.0f,
+		0.0f, 0.00392156886f, 0.00784313772f, 0.0117647061f, 0.0156862754f, 0.0196078438f, 0.0235294122f, 0.0274509806f,
+		0.0313725509f, 0.0352941193f, 0.0392156877f, 0.0431372561f, 0.0470588244f, 0.0509803928f, 0.0549019612f, 0.0588235296f,
+		0.0627451017f, 0.0666666701f, 0.0705882385f, 0.0745098069f, 0.0784313753f, 0.0823529437f, 0.0862745121f, 0.0901960805f,
+		0.0941176489f, 0.0980392173f, 0.101960786f, 0.105882354f, 0.109803922f, 0.113725491f, 0.117647059f, 0.121568628f,
+		0.125490203f, 0.129411772f, 0.13333334f, 0.137254909f, 0.141176477f, 0.145098045f, 0.149019614f, 0.152941182f,
+		0.156862751f, 0.160784319f, 0.164705887f, 0.168627456f, 0.172549024f, 0.176470593f, 0.180392161f, 0.184313729f,
+		0.188235298f, 0.192156866f, 0.196078435f, 0.200000003f, 0.203921571f, 0.20784314f, 0.211764708f, 0.215686277f,
+		0.219607845f, 0.223529413f, 0.227450982f, 0.23137255f, 0.235294119f, 0.239215687f, 0.243137255f, 0.247058824f,
+		0.250980407f, 0.254901975f, 0.258823544f, 0.262745112f, 0.266666681f, 0.270588249f, 0.274509817f, 0.278431386f,
+		0.282352954f, 0.286274523f, 0.290196091f, 0.294117659f, 0.298039228f, 0.301960796f, 0.305882365f, 0.309803933f,
+		0.313725501f, 0.31764707f, 0.321568638f, 0.325490206f, 0.329411775f, 0.333333343f, 0.337254912f, 0.34117648f,
+		0.345098048f, 0.349019617f, 0.352941185f, 0.356862754f, 0.360784322f, 0.36470589f, 0.368627459f, 0.372549027f,
+		0.376470596f, 0.380392164f, 0.384313732f, 0.388235301f, 0.392156869f, 0.396078438f, 0.400000006f, 0.403921574f,
+		0.407843143f, 0.411764711f, 0.41568628f, 0.419607848f, 0.423529416f, 0.427450985f, 0.431372553f, 0.435294122f,
+		0.43921569f, 0.443137258f, 0.447058827f, 0.450980395f, 0.454901963f, 0.458823532f, 0.4627451f, 0.466666669f,
+		0.470588237f, 0.474509805f, 0.478431374f, 0.482352942f, 0.486274511f, 0.490196079f, 0.494117647f, 0.498039216f,
+		0.501960814f, 0.505882382f, 0.509803951f, 0.513725519f, 0.517647088f, 0.521568656f, 0.525490224f, 0.529411793f,
+		0.533333361f, 0.53725493f, 0.541176498f, 0.545098066f, 0.549019635f, 0.552941203f, 0.556862772f, 0.56078434f,
+		0.564705908f, 0.568627477f, 0.572549045f, 0.576470613f, 0.580392182f, 0.58431375f, 0.588235319f, 0.592156887f,
+		0.596078455f, 0.600000024f, 0.603921592f, 0.607843161f, 0.611764729f, 0.615686297f, 0.619607866f, 0.623529434f,
+		0.627451003f, 0.631372571f, 0.635294139f, 0.639215708f, 0.643137276f, 0.647058845f, 0.650980413f, 0.654901981f,
+		0.65882355f, 0.662745118f, 0.666666687f, 0.670588255f, 0.674509823f, 0.678431392f, 0.68235296f, 0.686274529f,
+		0.690196097f, 0.694117665f, 0.698039234f, 0.701960802f, 0.70588237f, 0.709803939f, 0.713725507f, 0.717647076f,
+		0.721568644f, 0.725490212f, 0.729411781f, 0.733333349f, 0.737254918f, 0.741176486f, 0.745098054f, 0.749019623f,
+		0.752941191f, 0.75686276f, 0.760784328f, 0.764705896f, 0.768627465f, 0.772549033f, 0.776470602f, 0.78039217f,
+		0.784313738f, 0.788235307f, 0.792156875f, 0.796078444f, 0.800000012f, 0.80392158f, 0.807843149f, 0.811764717f,
+		0.815686285f, 0.819607854f, 0.823529422f, 0.827450991f, 0.831372559f, 0.835294127f, 0.839215696f, 0.843137264f,
+		0.847058833f, 0.850980401f, 0.854901969f, 0.858823538f, 0.862745106f, 0.866666675f, 0.870588243f, 0.874509811f,
+		0.87843138f, 0.882352948f, 0.886274517f, 0.890196085f, 0.894117653f, 0.898039222f, 0.90196079f, 0.905882359f,
+		0.909803927f, 0.913725495f, 0.917647064f, 0.921568632f, 0.925490201f, 0.929411769f, 0.933333337f, 0.937254906f,
+		0.941176474f, 0.945098042f, 0.949019611f, 0.952941179f, 0.956862748f, 0.960784316f, 0.964705884f, 0.968627453f,
+		0.972549021f, 0.97647059f, 0.980392158f, 0.984313726f, 0.988235295f, 0.992156863f, 0.996078432f, 1.0f,
+};
+
+// linear values half way between consecutive sRGB codes, the encoded value is the number of
+// thresholds at or below the linear value so rounds exactly as round(255 * srgb(x)) would
+static float const TinyKtx_srgbThresholds[255] = {
+		0.000151763496f, 0.000455290487f, 0.000758817478f, 0.00106234441f, 0.0013658714f, 0.00166939839f, 0.00197292538f, 0.00227645249f,
+		0.00257997937f, 0.00288350624f, 0.00318830088f, 0.00350925932f, 0.00384831498f, 0.00420574797f, 0.00458183279f, 0.00497683743f,
+		0.00539102405f, 0.00582465064f, 0.00627796957f, 0.00675122766f, 0.00724466844f, 0.00775853032f, 0.00829304848f, 0.00884845294f,
+		0.00942497049f, 0.0100228256f, 0.010642237f, 0.011283421f, 0.0119465925f, 0.0126319602f, 0.0133397318f, 0.0140701123f,
+		0.0148233026f, 0.0155995032f, 0.0163989104f, 0.0172217153f, 0.0180681143f, 0.0189382937f, 0.0198324434f, 0.0207507443f,
+		0.0216933824f, 0.0226605386f, 0.0236523896f, 0.0246691145f, 0.0257108882f, 0.0267778821f, 0.0278702695f, 0.0289882198f,
+		0.0301319025f, 0.0313014798f, 0.0324971229f, 0.0337189883f, 0.0349672437f, 0.0362420455f, 0.0375435539f, 0.0388719253f,
+		0.04022732f, 0.041609887f, 0.0430197865f, 0.0444571637f, 0.0459221713f, 0.0474149622f, 0.0489356853f, 0.0504844859f,
+		0.0520615056f, 0.0536668971f, 0.055300802f, 0.0569633618f, 0.0586547181f, 0.0603750125f, 0.0621243827f, 0.0639029741f,
+		0.0657109171f, 0.0675483495f, 0.0694154128f, 0.0713122338f, 0.0732389539f, 0.0751957074f, 0.0771826133f, 0.0791998208f,
+		0.0812474415f, 0.0833256245f, 0.085434489f, 0.0875741541f, 0.089744769f, 0.091946438f, 0.0941793025f, 0.0964434743f,
+		0.098739095f, 0.101066269f, 0.10342513f, 0.105815805f, 0.108238399f, 0.110693045f, 0.113179862f, 0.115698971f,
+		0.118250482f, 0.120834522f, 0.123451203f, 0.126100644f, 0.128782958f, 0.131498262f, 0.134246677f, 0.137028307f,
+		0.13984327f, 0.142691687f, 0.145573661f, 0.148489311f, 0.151438728f, 0.15442206f, 0.157439381f, 0.160490826f,
+		0.163576499f, 0.166696489f, 0.169850931f, 0.173039913f, 0.176263571f, 0.179521978f, 0.182815254f, 0.186143503f,
+		0.189506829f, 0.192905352f, 0.196339145f, 0.199808344f, 0.203313038f, 0.206853345f, 0.210429341f, 0.214041144f,
+		0.217688844f, 0.22137256f, 0.225092396f, 0.228848428f, 0.232640758f, 0.236469507f, 0.240334779f, 0.244236633f,
+		0.248175204f, 0.252150565f, 0.256162852f, 0.260212123f, 0.264298469f, 0.268422037f, 0.272582889f, 0.276781112f,
+		0.281016797f, 0.285290092f, 0.289601028f, 0.293949723f, 0.298336297f, 0.30276081f, 0.30722335f, 0.311724037f,
+		0.31626296f, 0.32084018f, 0.325455844f, 0.330109984f, 0.334802747f, 0.339534163f, 0.344304383f, 0.349113464f,
+		0.353961498f, 0.358848572f, 0.363774776f, 0.368740231f, 0.373744965f, 0.378789127f, 0.383872777f, 0.388996005f,
+		0.3941589f, 0.399361521f, 0.404604018f, 0.40988642f, 0.415208817f, 0.420571357f, 0.425974041f, 0.431417018f,
+		0.436900347f, 0.442424119f, 0.447988421f, 0.453593314f, 0.459238917f, 0.464925289f, 0.470652521f, 0.476420701f,
+		0.482229918f, 0.488080233f, 0.493971765f, 0.499904543f, 0.505878687f, 0.511894286f, 0.517951429f, 0.524050117f,
+		0.530190527f, 0.536372721f, 0.542596757f, 0.548862696f, 0.555170655f, 0.561520696f, 0.567912877f, 0.574347317f,
+		0.580824137f, 0.587343335f, 0.593904972f, 0.600509226f, 0.607156098f, 0.613845706f, 0.62057811f, 0.62735337f,
+		0.634171605f, 0.641032875f, 0.647937238f, 0.654884815f, 0.661875665f, 0.668909788f, 0.675987363f, 0.683108449f,
+		0.690273106f, 0.697481334f, 0.704733372f, 0.712029159f, 0.719368815f, 0.72675246f, 0.734180033f, 0.741651773f,
+		0.749167681f, 0.756727815f, 0.764332294f, 0.77198112f, 0.779674411f, 0.787412286f, 0.795194745f, 0.803021908f,
+		0.810893834f, 0.818810523f, 0.826772213f, 0.834778786f, 0.842830479f, 0.850927293f, 0.859069228f, 0.867256522f,
+		0.875489056f, 0.883767068f, 0.892090559f, 0.900459588f, 0.908874214f, 0.917334557f, 0.925840616f, 0.934392571f,
+		0.942990363f, 0.951634169f, 0.960324049f, 0.969060004f, 0.977842152f, 0.986670554f, 0.995545268f,
+};
+
+static uint8_t TinyKtx_linearToSrgb8(float v) {
+	uint32_t code = 0;
+	for (uint32_t step = 128; step; step >>= 1) {
+		if (code + step <= 255 && v >= TinyKtx_srgbThresholds[code + step - 1])
+			code += step;
+	}
+	return (uint8_t) code;
+}
+
+// RGBA8 to RGBA float, srgb picks the table for the colour channels (alpha is always linear)
+static void TinyKtx_rgba8ToFloats(uint8_t const *src, float *dst, size_t count, bool srgb, bool premultiply) {
+	size_t i = 0;
+#if defined(TINYKTX_AVX2)
+	__m256i const offset = srgb ? _mm256_setr_epi32(0, 0, 0, 256, 0, 0, 0, 256) : _mm256_set1_epi32(256);
+	__m256 const one = _mm256_set1_ps(1.0f);
+	for (; i + 2 <= count; i += 2) {
+		__m256i const bytes = _mm256_cvtepu8_epi32(_mm_loadl_epi64((__m128i const *) (src + i * 4)));
+		__m256 v = _mm256_i32gather_ps(TinyKtx_byteToFloat, _mm256_add_epi32(bytes, offset), 4);
+		if (premultiply) {
+			// (a, a, a, 1) per pixel
+			__m256 const alpha = _mm256_blend_ps(_mm256_permute_ps(v, 0xFF), one, 0x88);
+			v = _mm256_mul_ps(v, alpha);
+		}
+		_mm256_storeu_ps(dst + i * 4, v);
+	}
+#endif
+	uint32_t const colorBase = srgb ? 0 : 256;
+	for (; i < count; ++i) {
+		uint8_t const *s = src + i * 4;
+		float *d = dst + i * 4;
+		float const a = TinyKtx_byteToFloat[256 + s[3]];
+		float const m = premultiply ? a : 1.0f;
+		d[0] = TinyKtx_byteToFloat[colorBase + s[0]] * m;
+		d[1] = TinyKtx_byteToFloat[colorBase + s[1]] * m;
+		d[2] = TinyKtx_byteToFloat[colorBase + s[2]] * m;
+		d[3] = a;
+	}
+}
+
+static bool TinyKtx_colorLayout(TinyKtx_Format format, uint32_t glFormat, TinyKtx_ByteSwizzle *swz, bool *srgb) {
+	uint32_t numeric;
+	uint8_t const *layout = TinyKtx_byteLayout(format, glFormat, &numeric);
+	if (layout == NULL || (numeric != 0 && numeric != 6))
+		return false;
+	TinyKtx_makeSwizzle(swz, layout[0], layout + 1, 0xFF);
+	*srgb = numeric == 6;
+	return true;
+}
+
+// expands to RGBA8 a batch at a time so the table lookups always see whole pixels
+static void TinyKtx_decodeColorPixels(TinyKtx_ByteSwizzle const *swz, bool srgb, bool premultiply,
+																			uint8_t const *src, float *dst, size_t count) {
+	uint8_t rgba[64 * 4];
+	for (size_t i = 0; i < count;) {
+		size_t const n = (count - i < 64) ? count - i : 64;
+		TinyKtx_swizzleRow(swz, src + i * swz->srcBytes, rgba, (uint32_t) n);
+		TinyKtx_rgba8ToFloats(rgba, dst + i * 4, n, srgb, premultiply);
+		i += n;
+	}
+}
+
+bool TinyKtx_DecodeColor(TinyKtx_Format format, uint32_t colorFlags, void const *src, float *dst, size_t pixelCount) {
+	TinyKtx_ByteSwizzle swz;
+	bool srgb;
+	if (src == NULL || dst == NULL || !TinyKtx_colorLayout(format, 0, &swz, &srgb))
+		return false;
+	TinyKtx_decodeColorPixels(&swz, srgb && (colorFlags & TKTX_COLOR_LINEAR),
+														(colorFlags & TKTX_COLOR_PREMULTIPLIED) != 0, (uint8_t const *) src, dst, pixelCount);
+	return true;
+}
+
+bool TinyKtx_EncodeColor(TinyKtx_Format format, uint32_t colorFlags, float const *src, void *dst, size_t pixelCount) {
+	TinyKtx_ByteSwizzle swz;
+	bool srgb;
+	if (src == NULL || dst == NULL || !TinyKtx_colorLayout(format, 0, &swz, &srgb))
+		return false;
+	srgb = srgb && (colorFlags & TKTX_COLOR_LINEAR);
+	bool const unpremultiply = (colorFlags & TKTX_COLOR_PREMULTIPLIED) != 0;
+
+	uint8_t *d = (uint8_t *) dst;
+	for (size_t i = 0; i < pixelCount; ++i) {
+		float const *c = src + i * 4;
+		float const a = (c[3] > 0.0f) ? ((c[3] < 1.0f) ? c[3] : 1.0f) : 0.0f;
+		float const scale = unpremultiply ? ((a > 0.0f) ? 1.0f / a : 0.0f) : 1.0f;
+		uint8_t rgba[4];
+		for (uint32_t j = 0; j < 3; ++j) {
+			float v = c[j] * scale;
+			v = (v > 0.0f) ? ((v < 1.0f) ? v : 1.0f) : 0.0f; // nan fails both and is 0
+			rgba[j] = srgb ? TinyKtx_linearToSrgb8(v) : (uint8_t) (v * 255.0f + 0.5f);
+		}
+		rgba[3] = (uint8_t) (a * 255.0f + 0.5f);
+		// the mask's first pixel says which byte each channel lives in
+		for (uint32_t j = 0; j < 4; ++j) {
+			if ((swz.mask[j] & 0x80) == 0)
+				d[swz.mask[j]] = rgba[j];
+		}
+		d += swz.srcBytes;
+	}
+	return true;
+}
+
+// how ReadLevelAs turns pixels of the file into pixels of the requested format
+typedef enum TinyKtx_ConversionKind {
+	TKTX_CONVERT_COPY,
+	TKTX_CONVERT_SWIZZLE,
+	TKTX_CONVERT_FLOAT,
+	TKTX_CONVERT_COLOR,
+} TinyKtx_ConversionKind;
+
+typedef struct TinyKtx_LevelConversion {
+	TinyKtx_ConversionKind kind;
+	uint32_t srcBytes;	// per pixel, 1 for copies as those can be split anywhere
+	uint32_t dstBytes;
+	TinyKtx_ByteSwizzle swizzle;
+	// colour pass
+	bool srgb;
+	bool premultiply;
+	bool half;
+} TinyKtx_LevelConversion;
+
+static bool TinyKtx_levelConversion(TinyKtx_Context *ctx, TinyKtx_Format format, uint32_t colorFlags, TinyKtx_LevelConversion *conv) {
+	if (format == TKTX_UNDEFINED)
+		return false;
+	if (format == ctx->format) {
+		conv->kind = TKTX_CONVERT_COPY;
+		conv->srcBytes = conv->dstBytes = 1;
+		return true;
+	}
+	if (TinyKtx_levelSwizzle(ctx, format, &conv->swizzle)) {
+		conv->kind = TKTX_CONVERT_SWIZZLE;
+		conv->srcBytes = conv->swizzle.srcBytes;
+		conv->dstBytes = 4;
+		return true;
+	}
+	if ((format == TKTX_R32G32B32A32_SFLOAT || format == TKTX_R16G16B16A16_SFLOAT) &&
+			TinyKtx_colorLayout(ctx->format, ctx->header.glFormat, &conv->swizzle, &conv->srgb)) {
+		conv->kind = TKTX_CONVERT_COLOR;
+		conv->srgb = conv->srgb && (colorFlags & TKTX_COLOR_LINEAR);
+		conv->premultiply = (colorFlags & TKTX_COLOR_PREMULTIPLIED) != 0;
+		conv->half = format == TKTX_R16G16B16A16_SFLOAT;
+		conv->srcBytes = conv->swizzle.srcBytes;
+		conv->dstBytes = conv->half ? 8 : 16;
+		return true;
+	}
+	// to 32 bit float with the same channels, the file has to be in our endian
+	static TinyKtx_Format const floatFormats[] = { TKTX_R32_SFLOAT, TKTX_R32G32_SFLOAT, TKTX_R32G32B32_SFLOAT, TKTX_R32G32B32A32_SFLOAT };
+	uint32_t const channels = TinyKtx_floatChannelCount(ctx->format);
+	if (channels == 0 || format != floatFormats[channels - 1] || !ctx->sameEndian)
+		return false;
+	uint32_t bytes;
+	if (!TinyKtx_FormatBlockInfo(ctx->format, NULL, NULL, NULL, &bytes))
+		return false;
+	conv->kind = TKTX_CONVERT_FLOAT;
+	conv->srcBytes = bytes;
+	conv->dstBytes = channels * (uint32_t) sizeof(float);
+	return true;
+}
+
+static void TinyKtx_convertPixels(TinyKtx_Context *ctx, TinyKtx_LevelConversion const *conv, uint8_t const *src, uint8_t *dst, uint32_t count) {
+	switch (conv->kind) {
+	case TKTX_CONVERT_COPY: memcpy(dst, src, count); break;
+	case TKTX_CONVERT_SWIZZLE: TinyKtx_swizzleRow(&conv->swizzle, src, dst, count); break;
+	case TKTX_CONVERT_FLOAT: TinyKtx_FormatToFloat(ctx->format, src, (float *) dst, count); break;
+	case TKTX_CONVERT_COLOR:
+		if (conv->half) {
+			// while it's still in cache
+			float floats[64 * 4];
+			for (uint32_t i = 0; i < count;) {
+				uint32_t const n = (count - i < 64) ? count - i : 64;
+				TinyKtx_decodeColorPixels(&conv->swizzle, conv->srgb, conv->premultiply, src + i * conv->srcBytes, floats, n);
+				TinyKtx_floatsToHalfs(floats, (uint16_t *) (dst + i * 8), n * 4);
+				i += n;
+			}
+		} else {
+			TinyKtx_decodeColorPixels(&conv->swizzle, conv->srgb, conv->premultiply, src, (float *) dst, count);
+		}
+		break;
+	}
+}
+
+// BC1 to BC5 store the pixels of each row of a block apart from the others so the rows can be
+// swapped without decoding. Only the first rows rows are used, the rest are padding
+static void TinyKtx_flipBc1Rows(uint8_t *block, uint32_t rows) {
+	// colour indices, a byte per row after the two endpoints
+	for (uint32_t y = 0; y < rows / 2; ++y) {
+		uint8_t const t = block[4 + y];
+		block[4 + y] = block[4 + rows - 1 - y];
+		block[4 + rows - 1 - y] = t;
+	}
+}
+
+static void TinyKtx_flipBc2AlphaRows(uint8_t *block, uint32_t rows) {
+	// 4 bit alphas, 16 bits per row
+	for (uint32_t y = 0; y < rows / 2; ++y) {
+		uint8_t const t0 = block[y * 2];
+		uint8_t const t1 = block[y * 2 + 1];
+		block[y * 2] = block[(rows - 1 - y) * 2];
+		block[y * 2 + 1] = block[(rows - 1 - y) * 2 + 1];
+		block[(rows - 1 - y) * 2] = t0;
+		block[(rows - 1 - y) * 2 + 1] = t1;
+	}
+}
+
+static void TinyKtx_flipBc4Rows(uint8_t *block, uint32_t rows) {
+	// 3 bit indices after the two endpoints, 12 bits per row
+	uint64_t bits = 0;
+	for (uint32_t i = 0; i < 6; ++i) {
+		bits |= (uint64_t) block[2 + i] << (i * 8);
+	}
+	uint64_t flipped = bits;
+	for (uint32_t y = 0; y < rows; ++y) {
+		flipped &= ~(0xFFFull << (y * 12));
+		flipped |= ((bits >> ((rows - 1 - y) * 12)) & 0xFFFull) << (y * 12);
+	}
+	for (uint32_t i = 0; i < 6; ++i) {
+		block[2 + i] = (uint8_t) (flipped >> (i * 8));
+	}
+}
+
+// block size if each block of format can be flipped, else 0
+static uint32_t TinyKtx_flippableBlockSize(TinyKtx_Format format) {
+	switch (format) {
+	case TKTX_BC1_RGB_UNORM_BLOCK:
+	case TKTX_BC1_RGB_SRGB_BLOCK:
+	case TKTX_BC1_RGBA_UNORM_BLOCK:
+	case TKTX_BC1_RGBA_SRGB_BLOCK:
+	case TKTX_BC4_UNORM_BLOCK:
+	case TKTX_BC4_SNORM_BLOCK: return 8;
+	case TKTX_BC2_UNORM_BLOCK:
+	case TKTX_BC2_SRGB_BLOCK:
+	case TKTX_BC3_UNORM_BLOCK:
+	case TKTX_BC3_SRGB_BLOCK:
+	case TKTX_BC5_UNORM_BLOCK:
+	case TKTX_BC5_SNORM_BLOCK: return 16;
+	default: return 0;
+	}
+}
+
+// the row a (block) row lands on, mirrored within its depth slice when flipping
+static uint64_t TinyKtx_destinationRow(uint64_t row, uint64_t sliceRows, bool flip) {
+	return flip ? row - row % sliceRows + sliceRows - 1 - row % sliceRows : row;
+}
+
+static void TinyKtx_flipBlockRow(TinyKtx_Format format, uint8_t *blocks, uint32_t blockCount, uint32_t rows) {
+	uint32_t const blockSize = TinyKtx_flippableBlockSize(format);
+	for (uint32_t i = 0; i < blockCount; ++i) {
+		uint8_t *block = blocks + (size_t) i * blockSize;
+		switch (format) {
+		case TKTX_BC2_UNORM_BLOCK:
+		case TKTX_BC2_SRGB_BLOCK:
+			TinyKtx_flipBc2AlphaRows(block, rows);
+			TinyKtx_flipBc1Rows(block + 8, rows);
+			break;
+		case TKTX_BC3_UNORM_BLOCK:
+		case TKTX_BC3_SRGB_BLOCK:
+			TinyKtx_flipBc4Rows(block, rows);
+			TinyKtx_flipBc1Rows(block + 8, rows);
+			break;
+		case TKTX_BC4_UNORM_BLOCK:
+		case TKTX_BC4_SNORM_BLOCK:
+			TinyKtx_flipBc4Rows(block, rows);
+			break;
+		case TKTX_BC5_UNORM_BLOCK:
+		case TKTX_BC5_SNORM_BLOCK:
+			TinyKtx_flipBc4Rows(block, rows);
+			TinyKtx_flipBc4Rows(block + 8, rows);
+			break;
+		default:
+			TinyKtx_flipBc1Rows(block, rows);
+			break;
+		}
+	}
+}
+
+uint64_t TinyKtx_LevelSizeAs(TinyKtx_ContextHandle handle, uint32_t mipmaplevel, TinyKtx_Format format) {
+	TinyKtx_Context *ctx = (TinyKtx_Context *) handle;
+	if (ctx == NULL || ctx->headerValid == false)
+		return 0;
+	if (mipmaplevel >= ctx->header.numberOfMipmapLevels || mipmaplevel >= TINYKTX_MAX_MIPMAPLEVELS)
+		return 0;
+
+	TinyKtx_LevelConversion conv;
+	if (!TinyKtx_levelConversion(ctx, format, 0, &conv))
+		return 0;
+
+	uint64_t sizes[TINYKTX_MAX_MIPMAPLEVELS];
+	if (!TinyKtx_ComputeMipmapSizes64(ctx->header.pixelWidth, ctx->header.pixelHeight, ctx->header.pixelDepth,
+																		ctx->header.numberOfArrayElements, mipmaplevel + 1, format,
+																		ctx->header.numberOfFaces == 6, sizes))
+		return 0;
+	return sizes[mipmaplevel];
+}
+
+bool TinyKtx_ReadLevelAs(TinyKtx_ContextHandle handle,
+												 uint32_t mipmaplevel,
+												 TinyKtx_Format format,
+												 void *dst,
+												 size_t dstSize) {
+	return TinyKtx_ReadLevelAsColor(handle, mipmaplevel, format, 0, dst, dstSize);
+}
+
+bool TinyKtx_ReadLevelAsColor(TinyKtx_ContextHandle handle,
+															uint32_t mipmaplevel,
+															TinyKtx_Format format,
+															uint32_t colorFlags,
+															void *dst,
+															size_t dstSize) {
+	TinyKtx_Context *ctx = (TinyKtx_Context *) handle;
+	if (ctx == NULL || dst == NULL)
+		return false;
+	if (ctx->headerValid == false) {
+		ctx->callbacks.errorFn(ctx->user, "Header data hasn't been read yet or its invalid");
+		return false;
+	}
+
+	uint64_t const dstByteCount = TinyKtx_LevelSizeAs(handle, mipmaplevel, format);
+	if (dstByteCount == 0) {
+		ctx->callbacks.errorFn(ctx->user, "Mipmap level can't be read as the requested format");
+		return false;
+	}
+	if (dstSize < dstByteCount) {
+		ctx->callbacks.errorFn(ctx->user, "Destination is too small for the mipmap level");
+		return false;
+	}
+	TinyKtx_LevelConversion conv;
+	TinyKtx_levelConversion(ctx, format, colorFlags, &conv);
+	if (colorFlags != 0 && conv.kind != TKTX_CONVERT_COLOR) {
+		ctx->callbacks.errorFn(ctx->user, "Color flags need an 8 bit UNORM or SRGB level read as float");
+		return false;
+	}
+
+	// the padding the writer would have used, older files without row padding are accepted too
+	TinyKtx_Layout layout;
+	if (!TinyKtx_ComputeLayout(ctx->format, ctx->header.pixelWidth, ctx->header.pixelHeight, ctx->header.pixelDepth,
+														 ctx->header.numberOfArrayElements, ctx->header.numberOfFaces, mipmaplevel + 1,
+														 TKTX_CONTAINER_KTX1, &layout)) {
+		ctx->callbacks.errorFn(ctx->user, "Mipmap level layout can't be computed");
+		return false;
+	}
+	TinyKtx_LevelLayout const *lvl = &layout.level[mipmaplevel];
+	TinyKtx_FormatTraits traits;
+	TinyKtx_GetFormatTraits(ctx->format, &traits);
+	uint64_t const images = (uint64_t) layout.layers * layout.faces;
+	uint64_t const rowCount = (uint64_t) ((lvl->height + traits.blockHeight - 1) / traits.blockHeight) * lvl->depth;
+	uint64_t const rowBytes = (uint64_t) ((lvl->width + traits.blockWidth - 1) / traits.blockWidth) * traits.blockByteSize;
+
+	// flipping mirrors the (block) rows of each depth slice, blocks are flipped inside as well
+	TinyKtx_Origin const fileOrigin = TinyKtx_GetOrigin(handle);
+	if (ctx->readOrigin != TKTX_ORIGIN_FILE && fileOrigin == TKTX_ORIGIN_UNKNOWN) {
+		ctx->callbacks.errorFn(ctx->user, "File has no KTXorientation so can't be read to an origin");
+		return false;
+	}
+	bool const flip = ctx->readOrigin != TKTX_ORIGIN_FILE && ctx->readOrigin != fileOrigin && lvl->height > 1;
+	bool const flipBlocks = flip && traits.blockHeight > 1;
+	uint64_t const sliceRows = rowCount / lvl->depth;
+	uint32_t const blockRows = (lvl->height < traits.blockHeight) ? lvl->height : traits.blockHeight;
+	if (flipBlocks && (TinyKtx_flippableBlockSize(ctx->format) == 0 ||
+										 (lvl->height > traits.blockHeight && lvl->height % traits.blockHeight != 0))) {
+		ctx->callbacks.errorFn(ctx->user, "Mipmap level can't be flipped to the requested origin");
+		return false;
+	}
+
+	// leaves the stream at the start of the level data
+	uint64_t const levelSize = TinyKtx_imageSize(handle, mipmaplevel, true);
+	if (levelSize == 0)
+		return false;
+	uint64_t rowStride, faceStride;
+	if (levelSize == lvl->byteLength) {
+		rowStride = lvl->rowStride;
+		faceStride = lvl->faceStride;
+	} else if (levelSize == lvl->packedByteLength) {
+		rowStride = rowBytes;
+		faceStride = rowBytes * rowCount;
+	} else {
+		ctx->callbacks.errorFn(ctx->user, "Mipmap level size doesn't match its format and dimensions");
+		return false;
+	}
+	uint64_t const facePadding = faceStride - rowStride * rowCount;
+
+	// whole rows per read if they fit, otherwise rows are read in pieces of whole pixels
+	size_t const maxChunk = ctx->callbacks.maxChunkSize ? ctx->callbacks.maxChunkSize : 64 * 1024;
+	size_t const unit = conv.srcBytes;
+	size_t bufferSize = (rowStride * rowCount < maxChunk) ? (size_t) (rowStride * rowCount) : maxChunk;
+	if (rowStride > bufferSize)
+		bufferSize -= bufferSize % unit;
+	// room for the face padding and a few pixels whatever the limit
+	if (bufferSize < 4 * unit)
+		bufferSize = 4 * unit;
+	uint8_t *buffer = (uint8_t *) ctx->callbacks.allocFn(ctx->user, bufferSize);
+	if (buffer == NULL)
+		return false;
+
+	uint64_t const dstRowBytes = (rowBytes / unit) * conv.dstBytes;
+	uint64_t const rowsPerRead = (rowStride <= bufferSize) ? bufferSize / rowStride : 0;
+	bool okay = true;
+	for (uint64_t image = 0; image < images && okay; ++image) {
+		uint8_t *imageOut = (uint8_t *) dst + image * rowCount * dstRowBytes;
+		for (uint64_t row = 0; row < rowCount && okay;) {
+			if (rowsPerRead) {
+				uint64_t const n = (rowCount - row < rowsPerRead) ? rowCount - row : rowsPerRead;
+				okay = TinyKtx_read(ctx, buffer, n * rowStride);
+				for (uint64_t i = 0; i < n && okay; ++i) {
+					uint64_t const r = row + i;
+					uint8_t *out = imageOut + TinyKtx_destinationRow(r, sliceRows, flip) * dstRowBytes;
+					TinyKtx_convertPixels(ctx, &conv, buffer + i * rowStride, out, (uint32_t) (rowBytes / unit));
+					if (flipBlocks)
+						TinyKtx_flipBlockRow(ctx->format, out, (uint32_t) (rowBytes / traits.blockByteSize), blockRows);
+				}
+				row += n;
+			} else {
+				uint8_t *const rowOut = imageOut + TinyKtx_destinationRow(row, sliceRows, flip) * dstRowBytes;
+				uint8_t *out = rowOut;
+				for (uint64_t offset = 0; offset < rowStride && okay;) {
+					size_t const n = (rowStride - offset < bufferSize) ? (size_t) (rowStride - offset) : bufferSize;
+					okay = TinyKtx_read(ctx, buffer, n);
+					// pieces are whole pixels, only the row padding at the end is skipped
+					size_t const used = (offset >= rowBytes) ? 0 : (offset + n <= rowBytes) ? n : (size_t) (rowBytes - offset);
+					TinyKtx_convertPixels(ctx, &conv, buffer, out, (uint32_t) (used / unit));
+					out += (used / unit) * conv.dstBytes;
+					offset += n;
+				}
+				if (okay && flipBlocks)
+					TinyKtx_flipBlockRow(ctx->format, rowOut, (uint32_t) (rowBytes / traits.blockByteSize), blockRows);
+				row++;
+			}
+		}
+		if (okay && facePadding)
+			okay = TinyKtx_read(ctx, buffer, facePadding);
+	}
+	ctx->callbacks.freeFn(ctx->user, buffer);
+	if (!okay)
+		ctx->callbacks.errorFn(ctx->user, "Truncated mipmap level");
+	return okay;
+}
+
+static uint32_t TinyKtx_layoutImageCount(TinyKtx_WriteLayout const *layout) {
+	return ((layout->slices == 0) ? 1 : layout->slices) * layout->faces;
+}
+
+static void TinyKtx_fillHeaderFromLayout(TinyKtx_WriteLayout const *layout, TinyKtx_Header *header) {
+	memcpy(header->identifier, TinyKtx_fileIdentifier, 12);
+	header->endianness = 0x04030201;
+	header->glFormat = layout->glFormat;
+	header->glInternalFormat = layout->glInternalFormat;
+	header->glBaseInternalFormat = layout->glBaseInternalFormat;
+	header->glType = layout->glType;
+	header->glTypeSize = layout->glTypeSize;
+	header->pixelWidth = layout->width;
+	header->pixelHeight = (layout->height == 1) ? 0 : layout->height;
+	header->pixelDepth = (layout->depth == 1) ? 0 : layout->depth;
+	header->numberOfArrayElements = (layout->slices == 1) ? 0 : layout->slices;
+	header->numberOfFaces = layout->faces;
+	header->numberOfMipmapLevels = layout->mipmaplevels;
+	// the writers don't emit key/value data
+	header->bytesOfKeyValueData = 0;
+}
+
+bool TinyKtx_ComputeWriteLayoutGL(TinyKtx_WriteCallbacks const *callbacks,
+																	void *user,
+																	uint32_t width,
+																	uint32_t height,
+																	uint32_t depth,
+																	uint32_t slices,
+																	uint32_t mipmaplevels,
+																	uint32_t format,
+																	uint32_t internalFormat,
+																	uint32_t baseFormat,
+																	uint32_t type,
+																	uint32_t typeSize,
+																	bool cubemap,
+																	uint32_t const *mipmapsizes,
+																	TinyKtx_WriteLayout *layout) {
+	if (layout == NULL)
+		return false;
+	memset(layout, 0, sizeof(TinyKtx_WriteLayout));
+
+	if (mipmaplevels == 0 || mipmaplevels > TINYKTX_MAX_MIPMAPLEVELS) {
+		callbacks->errorFn(user, "Invalid number of mipmap levels");
+		return false;
+	}
+
+	// if the format is known every level size can be computed and checked before writing
+	uint32_t computedsizes[TINYKTX_MAX_MIPMAPLEVELS];
+	TinyKtx_Format const knownFormat = TinyKtx_CrackFormatFromGL(format, type, internalFormat, typeSize);
+	bool const known = TinyKtx_ComputeMipmapSizes(width, height, depth, slices, mipmaplevels,
+																								knownFormat, cubemap, computedsizes);
+	if (mipmapsizes == NULL) {
+		if (!known) {
+			callbacks->errorFn(user, "No mipmap sizes provided and the format is unknown");
+			return false;
+		}
+		mipmapsizes = computedsizes;
+	}
+
+	layout->width = width;
+	layout->height = height;
+	layout->depth = depth;
+	layout->slices = slices;
+	layout->faces = cubemap ? 6 : 1;
+	layout->mipmaplevels = mipmaplevels;
+	layout->glFormat = format;
+	layout->glInternalFormat = internalFormat;
+	layout->glBaseInternalFormat = baseFormat;
+	layout->glType = type;
+	layout->glTypeSize = typeSize;
+
+	// same rule as the reader, only small byte dividable types have row padding
+	uint32_t pixelByteSize = 0;
+	if (typeSize < 4 && TinyKtx_ByteDividableFromGLType(type)) {
+		uint32_t const n = TinyKtx_ElementCountFromGLFormat(format);
+		if (n == 0) {
+			callbacks->errorFn(user, "TinyKtx_ElementCountFromGLFormat error");
+			return false;
+		}
+		pixelByteSize = typeSize * n;
+	}
+
+	uint32_t const images = TinyKtx_layoutImageCount(layout);
+	// non array cubemaps store each face with its own padding and the imageSize is per face
+	bool const cubePadding = cubemap && slices <= 1;
+
+	uint32_t w = (width == 0) ? 1 : width;
+	uint32_t h = (height == 0) ? 1 : height;
+	uint32_t d = (depth == 0) ? 1 : depth;
+	// no key/value data, the first level follows the header
+	uint64_t offset = sizeof(TinyKtx_Header);
+
+	for (uint32_t i = 0u; i < mipmaplevels; ++i) {
+		TinyKtx_WriteLevelLayout *lvl = &layout->levels[i];
+
+		if (mipmapsizes[i] == 0 || (mipmapsizes[i] % images) != 0) {
+			callbacks->errorFn(user, "Mipmap size isn't a multiple of the slice and face count");
+			return false;
+		}
+		lvl->sourceFaceByteLength = mipmapsizes[i] / images;
+		lvl->faceByteLength = lvl->sourceFaceByteLength;
+
+		if (pixelByteSize) {
+			lvl->rowByteLength = pixelByteSize * w;
+			lvl->rowStride = (lvl->rowByteLength + 3u) & ~3u;
+			lvl->rowCount = h * d;
+			uint32_t const packed = lvl->rowByteLength * lvl->rowCount;
+			uint32_t const padded = lvl->rowStride * lvl->rowCount;
+			if (lvl->sourceFaceByteLength != packed && lvl->sourceFaceByteLength != padded) {
+				callbacks->errorFn(user, "Mipmap size doesn't match the format and dimensions");
+				return false;
+			}
+			lvl->faceByteLength = padded;
+		} else if (known && mipmapsizes[i] != computedsizes[i]) {
+			callbacks->errorFn(user, "Mipmap size doesn't match the format and dimensions");
+			return false;
+		}
+
+		lvl->faceStride = cubePadding ? ((lvl->faceByteLength + 3u) & ~3u) : lvl->faceByteLength;
+		uint64_t const levelByteLength = (uint64_t) lvl->faceStride * images;
+		if (levelByteLength > 0xFFFFFFFFu) {
+			callbacks->errorFn(user, "Mipmap level is too large for KTX v1");
+			return false;
+		}
+		lvl->imageSize = cubePadding ? lvl->faceByteLength : (uint32_t) levelByteLength;
+		lvl->sizeOffset = offset;
+		lvl->dataOffset = offset + sizeof(uint32_t);
+		offset = (lvl->dataOffset + levelByteLength + 3u) & ~(uint64_t) 3u;
+
+		if (w > 1) w = w / 2;
+		if (h > 1) h = h / 2;
+		if (d > 1) d = d / 2;
+	}
+	layout->totalByteLength = offset;
+
+	return true;
+}
+
+bool TinyKtx_ComputeWriteLayout(TinyKtx_WriteCallbacks const *callbacks,
+																void *user,
+																uint32_t width,
+																uint32_t height,
+																uint32_t depth,
+																uint32_t slices,
+																uint32_t mipmaplevels,
+																TinyKtx_Format format,
+																bool cubemap,
+																uint32_t const *mipmapsizes,
+																TinyKtx_WriteLayout *layout) {
+	uint32_t glformat;
+	uint32_t glinternalFormat;
+	uint32_t gltype;
+	uint32_t gltypeSize;
+	if (TinyKtx_CrackFormatToGL(format, &glformat, &gltype, &glinternalFormat, &gltypeSize) == false)
+		return false;
+
+	return TinyKtx_ComputeWriteLayoutGL(callbacks,
+																			user,
+																			width,
+																			height,
+																			depth,
+																			slices,
+																			mipmaplevels,
+																			glformat,
+																			glinternalFormat,
+																			TinyKtx_baseGLFormat(glformat),
+																			gltype,
+																			gltypeSize,
+																			cubemap,
+																			mipmapsizes,
+																			layout);
+}
+
+bool TinyKtx_WriteHeaderPositional(TinyKtx_WriteCallbacks const *callbacks,
+																	 void *user,
+																	 TinyKtx_WriteLayout const *layout) {
+	if (callbacks->pwriteFn == NULL) {
+		callbacks->errorFn(user, "Positional writer requires pwriteFn");
+		return false;
+	}
+
+	TinyKtx_Header header;
+	TinyKtx_fillHeaderFromLayout(layout, &header);
+	callbacks->pwriteFn(user, 0, &header, sizeof(TinyKtx_Header));
+
+	static uint8_t const padding[4] = {0, 0, 0, 0};
+	uint32_t const images = TinyKtx_layoutImageCount(layout);
+
+	for (uint32_t i = 0u; i < layout->mipmaplevels; ++i) {
+		TinyKtx_WriteLevelLayout const *lvl = &layout->levels[i];
+		callbacks->pwriteFn(user, lvl->sizeOffset, &lvl->imageSize, sizeof(uint32_t));
+
+		uint32_t const facePadding = lvl->faceStride - lvl->faceByteLength;
+		if (facePadding) {
+			for (uint32_t j = 0u; j < images; ++j) {
+				callbacks->pwriteFn(user, lvl->dataOffset + (uint64_t) j * lvl->faceStride + lvl->faceByteLength,
+														padding, facePadding);
+			}
+		}
+
+		uint64_t const end = lvl->dataOffset + (uint64_t) lvl->faceStride * images;
+		uint64_t const next = (i + 1 < layout->mipmaplevels) ? layout->levels[i + 1].sizeOffset : layout->totalByteLength;
+		if (next > end) {
+			callbacks->pwriteFn(user, end, padding, (size_t) (next - end));
+		}
+	}
+	return true;
+}
+
+bool TinyKtx_WriteFacePositional(TinyKtx_WriteCallbacks const *callbacks,
+																 void *user,
+																 TinyKtx_WriteLayout const *layout,
+																 uint32_t mipmaplevel,
+																 uint32_t slice,
+																 uint32_t face,
+																 void const *data) {
+	if (callbacks->pwriteFn == NULL) {
+		callbacks->errorFn(user, "Positional writer requires pwriteFn");
+		return false;
+	}
+	if (mipmaplevel >= layout->mipmaplevels) {
+		callbacks->errorFn(user, "Invalid mipmap level");
+		return false;
+	}
+	if (face >= layout->faces || slice >= ((layout->slices == 0) ? 1 : layout->slices)) {
+		callbacks->errorFn(user, "Invalid slice or face");
+		return false;
+	}
+
+	TinyKtx_WriteLevelLayout const *lvl = &layout->levels[mipmaplevel];
+	uint64_t offset = lvl->dataOffset + (uint64_t) (slice * layout->faces + face) * lvl->faceStride;
+
+	if (lvl->sourceFaceByteLength == lvl->faceByteLength) {
+		callbacks->pwriteFn(user, offset, data, lvl->faceByteLength);
+		return true;
+	}
+
+	static uint8_t const padding[4] = {0, 0, 0, 0};
+	uint32_t const rowPadding = lvl->rowStride - lvl->rowByteLength;
+	uint8_t const *src = (uint8_t const *) data;
+
+	// expand the rows into a staging buffer so its a single write, if we can't allocate
+	// take the slow per row write route
+	uint8_t *staging = NULL;
+	if (callbacks->allocFn && callbacks->freeFn) {
+		staging = (uint8_t *) callbacks->allocFn(user, lvl->faceByteLength);
+	}
+
+	if (staging) {
+		uint8_t *dst = staging;
+		for (uint32_t r = 0u; r < lvl->rowCount; ++r) {
+			memcpy(dst, src, lvl->rowByteLength);
+			memset(dst + lvl->rowByteLength, 0, rowPadding);
+			src += lvl->rowByteLength;
+			dst += lvl->rowStride;
+		}
+		callbacks->pwriteFn(user, offset, staging, lvl->faceByteLength);
+		callbacks->freeFn(user, staging);
+	} else {
+		for (uint32_t r = 0u; r < lvl->rowCount; ++r) {
+			callbacks->pwriteFn(user, offset, src, lvl->rowByteLength);
+			callbacks->pwriteFn(user, offset + lvl->rowByteLength, padding, rowPadding);
+			src += lvl->rowByteLength;
+			offset += lvl->rowStride;
+		}
+	}
+	return true;
+}
+
+bool TinyKtx_WriteLevelPositional(TinyKtx_WriteCallbacks const *callbacks,
+																	void *user,
+																	TinyKtx_WriteLayout const *layout,
+																	uint32_t mipmaplevel,
+																	void const *data) {
+	if (mipmaplevel >= layout->mipmaplevels) {
+		callbacks->errorFn(user, "Invalid mipmap level");
+		return false;
+	}
+	TinyKtx_WriteLevelLayout const *lvl = &layout->levels[mipmaplevel];
+	uint8_t const *src = (uint8_t const *) data;
+	uint32_t const sl = (layout->slices == 0) ? 1 : layout->slices;
+	for (uint32_t s = 0u; s < sl; ++s) {
+		for (uint32_t f = 0u; f < layout->faces; ++f) {
+			if (!TinyKtx_WriteFacePositional(callbacks, user, layout, mipmaplevel, s, f, src))
+				return false;
+			src += lvl->sourceFaceByteLength;
+		}
+	}
+	return true;
+}
+
+// serial writer for a computed layout, source data is either one pointer per level
+// or (if faces isn't NULL) one per slice/face
+static bool TinyKtx_writeSerial(TinyKtx_WriteCallbacks const *callbacks,
+																void *user,
+																TinyKtx_WriteLayout const *layout,
+																void const **mipmaps,
+																void const **faces) {
+	static uint8_t const padding[4] = {0, 0, 0, 0};
+	uint32_t const images = TinyKtx_layoutImageCount(layout);
+
+	// check all the data is there before writing anything
+	void const **table = faces ? faces : mipmaps;
+	uint32_t const count = faces ? layout->mipmaplevels * images : layout->mipmaplevels;
+	for (uint32_t i = 0u; i < count; ++i) {
+		if (table == NULL || table[i] == NULL) {
+			callbacks->errorFn(user, faces ? "Missing slice/face data" : "Missing mipmap data");
+			return false;
+		}
+	}
+
+	TinyKtx_Header header;
+	TinyKtx_fillHeaderFromLayout(layout, &header);
+	callbacks->writeFn(user, &header, sizeof(TinyKtx_Header));
+
+	for (uint32_t i = 0u; i < layout->mipmaplevels; ++i) {
+		TinyKtx_WriteLevelLayout const *lvl = &layout->levels[i];
+		callbacks->writeFn(user, &lvl->imageSize, sizeof(uint32_t));
+
+		uint8_t const *src = faces ? NULL : (uint8_t const *) mipmaps[i];
+		for (uint32_t j = 0u; j < images; ++j) {
+			if (faces) {
+				src = (uint8_t const *) faces[i * images + j];
+			}
+			if (lvl->sourceFaceByteLength == lvl->faceByteLength) {
+				callbacks->writeFn(user, src, lvl->faceByteLength);
+				src += lvl->faceByteLength;
+			} else {
+				// if we need to expand for padding take the slow per row write route
+				for (uint32_t r = 0u; r < lvl->rowCount; ++r) {
+					callbacks->writeFn(user, src, lvl->rowByteLength);
+					callbacks->writeFn(user, padding, lvl->rowStride - lvl->rowByteLength);
+					src += lvl->rowByteLength;
+				}
+			}
+			callbacks->writeFn(user, padding, lvl->faceStride - lvl->faceByteLength);
+		}
+
+		uint64_t const end = lvl->dataOffset + (uint64_t) lvl->faceStride * images;
+		uint64_t const next = (i + 1 < layout->mipmaplevels) ? layout->levels[i + 1].sizeOffset : layout->totalByteLength;
+		callbacks->writeFn(user, padding, (size_t) (next - end));
+	}
+
+	return true;
+}
+
+bool TinyKtx_WriteImageGL(TinyKtx_WriteCallbacks const *callbacks,
+													void *user,
+													uint32_t width,
+													uint32_t height,
+													uint32_t depth,
+													uint32_t slices,
+													uint32_t mipmaplevels,
+													uint32_t format,
+													uint32_t internalFormat,
+													uint32_t baseFormat,
+													uint32_t type,
+													uint32_t typeSize,
+													bool cubemap,
+													uint32_t const *mipmapsizes,
+													void const **mipmaps) {
+
+	TinyKtx_WriteLayout layout;
+	if (!TinyKtx_ComputeWriteLayoutGL(callbacks, user,
+																		width, height, depth, slices, mipmaplevels,
+																		format, internalFormat, baseFormat, type, typeSize,
+																		cubemap, mipmapsizes, &layout)) {
+		return false;
+	}
+
+	return TinyKtx_writeSerial(callbacks, user, &layout, mipmaps, NULL);
+}
+
+bool TinyKtx_WriteImageFacesGL(TinyKtx_WriteCallbacks const *callbacks,
+															 void *user,
+															 uint32_t width,
+															 uint32_t height,
+															 uint32_t depth,
+															 uint32_t slices,
+															 uint32_t mipmaplevels,
+															 uint32_t format,
+															 uint32_t internalFormat,
+															 uint32_t baseFormat,
+															 uint32_t type,
+															 uint32_t typeSize,
+															 bool cubemap,
+															 uint32_t const *mipmapsizes,
+															 void const **faces) {
+
+	TinyKtx_WriteLayout layout;
+	if (!TinyKtx_ComputeWriteLayoutGL(callbacks, user,
+																		width, height, depth, slices, mipmaplevels,
+																		format, internalFormat, baseFormat, type, typeSize,
+																		cubemap, mipmapsizes, &layout)) {
+		return false;
+	}
+
+	return TinyKtx_writeSerial(callbacks, user, &layout, NULL, faces);
+}
+
+bool TinyKtx_WriteImage(TinyKtx_WriteCallbacks const *callbacks,
+												void *user,
+												uint32_t width,
+												uint32_t height,
+												uint32_t depth,
+												uint32_t slices,
+												uint32_t mipmaplevels,
+												TinyKtx_Format format,
+												bool cubemap,
+												uint32_t const *mipmapsizes,
+												void const **mipmaps) {
+	uint32_t glformat;
+	uint32_t glinternalFormat;
+	uint32_t gltype;
+	uint32_t gltypeSize;
+	if (TinyKtx_CrackFormatToGL(format, &glformat, &gltype, &glinternalFormat, &gltypeSize) == false)
+		return false;
+
+	return TinyKtx_WriteImageGL(callbacks,
+															user,
+															width,
+															height,
+															depth,
+															slices,
 															mipmaplevels,
 															glformat,
 															glinternalFormat,
-															glinternalFormat, //??
+															TinyKtx_baseGLFormat(glformat),
 															gltype,
 															gltypeSize,
 															cubemap,
@@ -2133,159 +3649,404 @@ bool TinyKtx_WriteImage(TinyKtx_WriteCallbacks const *callbacks,
 	);
 
 }
+bool TinyKtx_WriteImageFaces(TinyKtx_WriteCallbacks const *callbacks,
+														 void *user,
+														 uint32_t width,
+														 uint32_t height,
+														 uint32_t depth,
+														 uint32_t slices,
+														 uint32_t mipmaplevels,
+														 TinyKtx_Format format,
+														 bool cubemap,
+														 uint32_t const *mipmapsizes,
+														 void const **faces) {
+	uint32_t glformat;
+	uint32_t glinternalFormat;
+	uint32_t gltype;
+	uint32_t gltypeSize;
+	if (TinyKtx_CrackFormatToGL(format, &glformat, &gltype, &glinternalFormat, &gltypeSize) == false)
+		return false;
+
+	return TinyKtx_WriteImageFacesGL(callbacks,
+																	 user,
+																	 width,
+																	 height,
+																	 depth,
+																	 slices,
+																	 mipmaplevels,
+																	 glformat,
+																	 glinternalFormat,
+																	 TinyKtx_baseGLFormat(glformat),
+																	 gltype,
+																	 gltypeSize,
+																	 cubemap,
+																	 mipmapsizes,
+																	 faces
+	);
+}
+
+// layout of an already written file, offsets shifted to where the reader found them
+static bool TinyKtx_updateLayout(TinyKtx_Context *ctx,
+																 TinyKtx_WriteCallbacks const *callbacks,
+																 void *user,
+																 uint32_t mipmaplevel,
+																 TinyKtx_WriteLayout *layout) {
+	if (ctx->headerValid == false) {
+		callbacks->errorFn(user, "Header data hasn't been read yet or its invalid");
+		return false;
+	}
+	if (callbacks->pwriteFn == NULL) {
+		callbacks->errorFn(user, "Updating a file requires pwriteFn");
+		return false;
+	}
+	uint32_t const levelCount = TinyKtx_NumberOfMipmaps((TinyKtx_ContextHandle) ctx);
+	if (mipmaplevel >= levelCount || mipmaplevel >= TINYKTX_MAX_MIPMAPLEVELS) {
+		callbacks->errorFn(user, "Invalid mipmap level");
+		return false;
+	}
+
+	uint32_t mipmapsizes[TINYKTX_MAX_MIPMAPLEVELS];
+	for (uint32_t i = 0u; i <= mipmaplevel; ++i) {
+		uint64_t const size = TinyKtx_imageSize((TinyKtx_ContextHandle) ctx, i, false);
+		if (size == 0)
+			return false;
+		if (size > 0xFFFFFFFFu) {
+			callbacks->errorFn(user, "Mipmap level is too large for KTX v1");
+			return false;
+		}
+		mipmapsizes[i] = (uint32_t) size;
+	}
+
+	if (!TinyKtx_ComputeWriteLayoutGL(callbacks, user,
+																		ctx->header.pixelWidth,
+																		ctx->header.pixelHeight,
+																		ctx->header.pixelDepth,
+																		ctx->header.numberOfArrayElements,
+																		mipmaplevel + 1,
+																		ctx->header.glFormat,
+																		ctx->header.glInternalFormat,
+																		ctx->header.glBaseInternalFormat,
+																		ctx->header.glType,
+																		ctx->header.glTypeSize,
+																		ctx->header.numberOfFaces == 6,
+																		mipmapsizes,
+																		layout)) {
+		return false;
+	}
+
+	// the layout assumes no key value data
+	uint64_t const delta = ctx->firstImagePos - sizeof(TinyKtx_Header);
+	for (uint32_t i = 0u; i <= mipmaplevel; ++i) {
+		layout->levels[i].sizeOffset += delta;
+		layout->levels[i].dataOffset += delta;
+	}
+	return true;
+}
+
+// accept the same packed or row padded data the writer does
+static bool TinyKtx_updateSourceSize(TinyKtx_WriteCallbacks const *callbacks,
+																		 void *user,
+																		 TinyKtx_WriteLevelLayout *lvl,
+																		 uint32_t faceSize) {
+	if (faceSize == lvl->faceByteLength ||
+			(lvl->rowStride && faceSize == lvl->rowByteLength * lvl->rowCount)) {
+		lvl->sourceFaceByteLength = faceSize;
+		return true;
+	}
+	// non array cubemaps may have had cube padding included in the stored size
+	if (lvl->rowStride == 0 && lvl->faceStride != lvl->faceByteLength &&
+			((faceSize + 3u) & ~3u) == lvl->faceStride) {
+		lvl->sourceFaceByteLength = lvl->faceByteLength = faceSize;
+		return true;
+	}
+	callbacks->errorFn(user, "Update data size doesn't match the existing data");
+	return false;
+}
+
+bool TinyKtx_UpdateFace(TinyKtx_ContextHandle handle,
+												TinyKtx_WriteCallbacks const *callbacks,
+												void *user,
+												uint32_t mipmaplevel,
+												uint32_t slice,
+												uint32_t face,
+												void const *data,
+												uint32_t dataSize) {
+	TinyKtx_Context *ctx = (TinyKtx_Context *) handle;
+	if (ctx == NULL)
+		return false;
+
+	TinyKtx_WriteLayout layout;
+	if (!TinyKtx_updateLayout(ctx, callbacks, user, mipmaplevel, &layout))
+		return false;
+	if (!TinyKtx_updateSourceSize(callbacks, user, &layout.levels[mipmaplevel], dataSize))
+		return false;
+
+	TinyKtx_ReleaseImageRawData(handle, mipmaplevel);
+	return TinyKtx_WriteFacePositional(callbacks, user, &layout, mipmaplevel, slice, face, data);
+}
+
+bool TinyKtx_UpdateLevel(TinyKtx_ContextHandle handle,
+												 TinyKtx_WriteCallbacks const *callbacks,
+												 void *user,
+												 uint32_t mipmaplevel,
+												 void const *data,
+												 uint32_t dataSize) {
+	TinyKtx_Context *ctx = (TinyKtx_Context *) handle;
+	if (ctx == NULL)
+		return false;
+
+	TinyKtx_WriteLayout layout;
+	if (!TinyKtx_updateLayout(ctx, callbacks, user, mipmaplevel, &layout))
+		return false;
+
+	uint32_t const images = TinyKtx_layoutImageCount(&layout);
+	if ((dataSize % images) != 0) {
+		callbacks->errorFn(user, "Update data size doesn't match the existing data");
+		return false;
+	}
+	if (!TinyKtx_updateSourceSize(callbacks, user, &layout.levels[mipmaplevel], dataSize / images))
+		return false;
+
+	TinyKtx_ReleaseImageRawData(handle, mipmaplevel);
+	return TinyKtx_WriteLevelPositional(callbacks, user, &layout, mipmaplevel, data);
+}
+
+
+
+#define TINYKTX_TRAITS_FT(ktx, bytes, ch, fmt, type, intfmt, size, tif, rev) \
+	case TKTX_##ktx: traits->blockWidth = 1; \
+									traits->blockHeight = 1; \
+									traits->blockByteSize = bytes; \
+									traits->channelCount = ch; \
+									traits->compressed = false; \
+									break;
+#define TINYKTX_TRAITS_FTC(ktx, bw, bh, bytes, ch, fmt, intfmt, tif, rev) \
+	case TKTX_##ktx: traits->blockWidth = bw; \
+									traits->blockHeight = bh; \
+									traits->blockByteSize = bytes; \
+									traits->channelCount = ch; \
+									traits->compressed = true; \
+									break;
+
+bool TinyKtx_GetFormatTraits(TinyKtx_Format format, TinyKtx_FormatTraits *traits) {
+	switch (format) {
+	TINYKTX_FORMAT_TABLE(TINYKTX_TRAITS_FT, TINYKTX_TRAITS_FTC)
+	default: return false;
+	}
+	traits->blockDepth = 1;
+	return true;
+}
+#undef TINYKTX_TRAITS_FT
+#undef TINYKTX_TRAITS_FTC
+
+bool TinyKtx_FormatBlockInfo(TinyKtx_Format format,
+														 uint32_t *blockWidth,
+														 uint32_t *blockHeight,
+														 uint32_t *blockDepth,
+														 uint32_t *blockByteSize) {
+	TinyKtx_FormatTraits traits;
+	if (!TinyKtx_GetFormatTraits(format, &traits))
+		return false;
+	if (blockWidth) *blockWidth = traits.blockWidth;
+	if (blockHeight) *blockHeight = traits.blockHeight;
+	if (blockDepth) *blockDepth = traits.blockDepth;
+	if (blockByteSize) *blockByteSize = traits.blockByteSize;
+	return true;
+}
+
+static bool TinyKtx_mul64(uint64_t a, uint64_t b, uint64_t *result) {
+	if (b != 0 && a > ~(uint64_t) 0 / b)
+		return false;
+	*result = a * b;
+	return true;
+}
+
+bool TinyKtx_ComputeMipmapSizes64(uint32_t width,
+																	uint32_t height,
+																	uint32_t depth,
+																	uint32_t slices,
+																	uint32_t mipmaplevels,
+																	TinyKtx_Format format,
+																	bool cubemap,
+																	uint64_t *mipmapsizes) {
+	uint32_t bw, bh, bd, bytes;
+	if (mipmaplevels > TINYKTX_MAX_MIPMAPLEVELS || !TinyKtx_FormatBlockInfo(format, &bw, &bh, &bd, &bytes))
+		return false;
+
+	uint64_t const images = (uint64_t) ((slices == 0) ? 1 : slices) * (cubemap ? 6 : 1);
+	for (uint32_t i = 0u; i < mipmaplevels; ++i) {
+		uint64_t const bx = (TinyKtx_MipMapReduce(width, i) + bw - 1) / bw;
+		uint64_t const by = (TinyKtx_MipMapReduce(height, i) + bh - 1) / bh;
+		uint64_t const bz = (TinyKtx_MipMapReduce(depth, i) + bd - 1) / bd;
+		// bogus headers can overflow even 64 bits
+		uint64_t size = bx;
+		if (!TinyKtx_mul64(size, by, &size) || !TinyKtx_mul64(size, bz, &size) ||
+				!TinyKtx_mul64(size, bytes, &size) || !TinyKtx_mul64(size, images, &size))
+			return false;
+		mipmapsizes[i] = size;
+	}
+	return true;
+}
+
+bool TinyKtx_ComputeMipmapSizes(uint32_t width,
+																uint32_t height,
+																uint32_t depth,
+																uint32_t slices,
+																uint32_t mipmaplevels,
+																TinyKtx_Format format,
+																bool cubemap,
+																uint32_t *mipmapsizes) {
+	uint64_t sizes[TINYKTX_MAX_MIPMAPLEVELS];
+	if (!TinyKtx_ComputeMipmapSizes64(width, height, depth, slices, mipmaplevels, format, cubemap, sizes))
+		return false;
+	for (uint32_t i = 0u; i < mipmaplevels; ++i) {
+		if (sizes[i] > 0xFFFFFFFFu)
+			return false;
+		mipmapsizes[i] = (uint32_t) sizes[i];
+	}
+	return true;
+}
+
+// byte size of the data format descriptor the KTX v2 writer emits, 4 byte total size, 24 byte
+// basic block header and 16 bytes per sample. Kept here so layouts don't need tinyktx2.h
+static uint32_t TinyKtx_ktx2DfdByteLength(TinyKtx_Format format, TinyKtx_FormatTraits const *traits) {
+	uint32_t samples = traits->channelCount;
+	if (format == TKTX_E5B9G9R9_UFLOAT_PACK32) {
+		samples = 6; // 3 mantissa and 3 exponent samples
+	} else if (traits->compressed) {
+		switch (format) {
+		case TKTX_BC2_UNORM_BLOCK:
+		case TKTX_BC2_SRGB_BLOCK:
+		case TKTX_BC3_UNORM_BLOCK:
+		case TKTX_BC3_SRGB_BLOCK:
+		case TKTX_BC5_UNORM_BLOCK:
+		case TKTX_BC5_SNORM_BLOCK:
+		case TKTX_ETC2_R8G8B8A1_UNORM_BLOCK:
+		case TKTX_ETC2_R8G8B8A1_SRGB_BLOCK:
+		case TKTX_ETC2_R8G8B8A8_UNORM_BLOCK:
+		case TKTX_ETC2_R8G8B8A8_SRGB_BLOCK:
+		case TKTX_EAC_R11G11_UNORM_BLOCK:
+		case TKTX_EAC_R11G11_SNORM_BLOCK:
+			samples = 2;
+			break;
+		default:
+			samples = 1;
+			break;
+		}
+	}
+	return 4 + 24 + 16 * samples;
+}
+
+bool TinyKtx_ComputeLayout(TinyKtx_Format format,
+													 uint32_t width,
+													 uint32_t height,
+													 uint32_t depth,
+													 uint32_t layers,
+													 uint32_t faces,
+													 uint32_t levels,
+													 TinyKtx_Container container,
+													 TinyKtx_Layout *layout) {
+	if (layout == NULL)
+		return false;
+	memset(layout, 0, sizeof(TinyKtx_Layout));
+
+	TinyKtx_FormatTraits traits;
+	if (!TinyKtx_GetFormatTraits(format, &traits))
+		return false;
+	if (levels == 0 || levels > TINYKTX_MAX_MIPMAPLEVELS || (faces != 1 && faces != 6))
+		return false;
+	if (container != TKTX_CONTAINER_KTX1 && container != TKTX_CONTAINER_KTX2)
+		return false;
+
+	uint64_t packedSizes[TINYKTX_MAX_MIPMAPLEVELS];
+	if (!TinyKtx_ComputeMipmapSizes64(width, height, depth, layers, levels, format, faces == 6, packedSizes))
+		return false;
+
+	layout->container = container;
+	layout->format = format;
+	layout->layers = (layers == 0) ? 1 : layers;
+	layout->faces = faces;
+	layout->levels = levels;
+	uint64_t const images = (uint64_t) layout->layers * faces;
+
+	for (uint32_t i = 0u; i < levels; ++i) {
+		TinyKtx_LevelLayout *lvl = &layout->level[i];
+		lvl->width = TinyKtx_MipMapReduce(width, i);
+		lvl->height = TinyKtx_MipMapReduce(height, i);
+		lvl->depth = TinyKtx_MipMapReduce(depth, i);
+		lvl->packedByteLength = packedSizes[i];
+		lvl->faceByteLength = packedSizes[i] / images;
+		lvl->faceStride = lvl->faceByteLength;
+		lvl->byteLength = packedSizes[i];
+		uint64_t const rowStride = (uint64_t) ((lvl->width + traits.blockWidth - 1) / traits.blockWidth) * traits.blockByteSize;
+		if (rowStride > 0xFFFFFFFFu)
+			return false;
+		lvl->rowStride = (uint32_t) rowStride;
+	}
+
+	if (container == TKTX_CONTAINER_KTX2) {
+		// header, level index then the dfd. Level data follows smallest level first, each
+		// aligned to lcm(texel block size, 4)
+		uint64_t offset = 80 + 24 * (uint64_t) levels + TinyKtx_ktx2DfdByteLength(format, &traits);
+		uint64_t const bytes = traits.blockByteSize;
+		uint64_t const alignment = (bytes % 4 == 0) ? bytes : (bytes % 2 == 0) ? bytes * 2 : bytes * 4;
+		for (uint32_t i = levels; i-- > 0;) {
+			TinyKtx_LevelLayout *lvl = &layout->level[i];
+			offset = ((offset + alignment - 1) / alignment) * alignment;
+			lvl->byteOffset = offset;
+			offset += lvl->byteLength;
+		}
+		layout->totalByteLength = offset;
+		return true;
+	}
+
+	// KTX v1, same rules as the writer. Only small byte dividable types have row padding
+	// (GL_UNPACK_ALIGNMENT 4) and non array cubemaps pad each face to 4 bytes
+	uint32_t glformat, gltype, glinternalformat, typesize;
+	if (!TinyKtx_CrackFormatToGL(format, &glformat, &gltype, &glinternalformat, &typesize))
+		return false;
+	bool const rowPadding = typesize < 4 && TinyKtx_ByteDividableFromGLType(gltype);
+	bool const cubePadding = faces == 6 && layers <= 1;
+
+	uint64_t offset = sizeof(TinyKtx_Header);
+	for (uint32_t i = 0u; i < levels; ++i) {
+		TinyKtx_LevelLayout *lvl = &layout->level[i];
+		if (rowPadding) {
+			lvl->rowStride = (lvl->rowStride + 3u) & ~3u;
+			lvl->faceByteLength = (uint64_t) lvl->rowStride * lvl->height * lvl->depth;
+		}
+		lvl->faceStride = cubePadding ? ((lvl->faceByteLength + 3u) & ~(uint64_t) 3u) : lvl->faceByteLength;
+		if (!TinyKtx_mul64(lvl->faceStride, images, &lvl->byteLength) || lvl->byteLength > 0xFFFFFFFFu)
+			return false;
+		lvl->byteOffset = offset + sizeof(uint32_t); // after the imageSize
+		offset = (lvl->byteOffset + lvl->byteLength + 3u) & ~(uint64_t) 3u;
+	}
+	layout->totalByteLength = offset;
+	return true;
+}
+
+uint64_t TinyKtx_LayoutImageOffset(TinyKtx_Layout const *layout, uint32_t level, uint32_t layer, uint32_t face) {
+	if (layout == NULL || level >= layout->levels || layer >= layout->layers || face >= layout->faces)
+		return 0;
+	TinyKtx_LevelLayout const *lvl = &layout->level[level];
+	return lvl->byteOffset + ((uint64_t) layer * layout->faces + face) * lvl->faceStride;
+}
 
 // tiny_imageformat/tinyimageformat.h pr tinyimageformat_base.h needs included
 // before tinyktx.h for this functionality
 #ifdef TINYIMAGEFORMAT_BASE_H_
+#define TINYKTX_TIF_FROM_FT(ktx, bytes, ch, fmt, type, intfmt, size, tif, rev) case TKTX_##ktx: return TinyImageFormat_##tif;
+#define TINYKTX_TIF_FROM_FTC(ktx, bw, bh, bytes, ch, fmt, intfmt, tif, rev) case TKTX_##ktx: return TinyImageFormat_##tif;
+#define TINYKTX_TIF_TO_0(ktx, tif)
+#define TINYKTX_TIF_TO_1(ktx, tif) case TinyImageFormat_##tif: return TKTX_##ktx;
+#define TINYKTX_TIF_TO_FT(ktx, bytes, ch, fmt, type, intfmt, size, tif, rev) TINYKTX_TIF_TO_##rev(ktx, tif)
+#define TINYKTX_TIF_TO_FTC(ktx, bw, bh, bytes, ch, fmt, intfmt, tif, rev) TINYKTX_TIF_TO_##rev(ktx, tif)
+
 TinyImageFormat TinyImageFormat_FromTinyKtxFormat(TinyKtx_Format format)
 {
 	switch(format) {
 	case TKTX_UNDEFINED: return TinyImageFormat_UNDEFINED;
-	case TKTX_R4G4_UNORM_PACK8: return TinyImageFormat_R4G4_UNORM;
-	case TKTX_R4G4B4A4_UNORM_PACK16: return TinyImageFormat_R4G4B4A4_UNORM;
-	case TKTX_B4G4R4A4_UNORM_PACK16: return TinyImageFormat_B4G4R4A4_UNORM;
-	case TKTX_R5G6B5_UNORM_PACK16: return TinyImageFormat_R5G6B5_UNORM;
-	case TKTX_B5G6R5_UNORM_PACK16: return TinyImageFormat_B5G6R5_UNORM;
-	case TKTX_R5G5B5A1_UNORM_PACK16: return TinyImageFormat_R5G5B5A1_UNORM;
-	case TKTX_B5G5R5A1_UNORM_PACK16: return TinyImageFormat_B5G5R5A1_UNORM;
-	case TKTX_A1R5G5B5_UNORM_PACK16: return TinyImageFormat_A1R5G5B5_UNORM;
-	case TKTX_R8_UNORM: return TinyImageFormat_R8_UNORM;
-	case TKTX_R8_SNORM: return TinyImageFormat_R8_SNORM;
-	case TKTX_R8_UINT: return TinyImageFormat_R8_UINT;
-	case TKTX_R8_SINT: return TinyImageFormat_R8_SINT;
-	case TKTX_R8_SRGB: return TinyImageFormat_R8_SRGB;
-	case TKTX_R8G8_UNORM: return TinyImageFormat_R8G8_UNORM;
-	case TKTX_R8G8_SNORM: return TinyImageFormat_R8G8_SNORM;
-	case TKTX_R8G8_UINT: return TinyImageFormat_R8G8_UINT;
-	case TKTX_R8G8_SINT: return TinyImageFormat_R8G8_SINT;
-	case TKTX_R8G8_SRGB: return TinyImageFormat_R8G8_SRGB;
-	case TKTX_R8G8B8_UNORM: return TinyImageFormat_R8G8B8_UNORM;
-	case TKTX_R8G8B8_SNORM: return TinyImageFormat_R8G8B8_SNORM;
-	case TKTX_R8G8B8_UINT: return TinyImageFormat_R8G8B8_UINT;
-	case TKTX_R8G8B8_SINT: return TinyImageFormat_R8G8B8_SINT;
-	case TKTX_R8G8B8_SRGB: return TinyImageFormat_R8G8B8_SRGB;
-	case TKTX_B8G8R8_UNORM: return TinyImageFormat_B8G8R8_UNORM;
-	case TKTX_B8G8R8_SNORM: return TinyImageFormat_B8G8R8_SNORM;
-	case TKTX_B8G8R8_UINT: return TinyImageFormat_B8G8R8_UINT;
-	case TKTX_B8G8R8_SINT: return TinyImageFormat_B8G8R8_SINT;
-	case TKTX_B8G8R8_SRGB: return TinyImageFormat_B8G8R8_SRGB;
-	case TKTX_R8G8B8A8_UNORM: return TinyImageFormat_R8G8B8A8_UNORM;
-	case TKTX_R8G8B8A8_SNORM: return TinyImageFormat_R8G8B8A8_SNORM;
-	case TKTX_R8G8B8A8_UINT: return TinyImageFormat_R8G8B8A8_UINT;
-	case TKTX_R8G8B8A8_SINT: return TinyImageFormat_R8G8B8A8_SINT;
-	case TKTX_R8G8B8A8_SRGB: return TinyImageFormat_R8G8B8A8_SRGB;
-	case TKTX_B8G8R8A8_UNORM: return TinyImageFormat_B8G8R8A8_UNORM;
-	case TKTX_B8G8R8A8_SNORM: return TinyImageFormat_B8G8R8A8_SNORM;
-	case TKTX_B8G8R8A8_UINT: return TinyImageFormat_B8G8R8A8_UINT;
-	case TKTX_B8G8R8A8_SINT: return TinyImageFormat_B8G8R8A8_SINT;
-	case TKTX_B8G8R8A8_SRGB: return TinyImageFormat_B8G8R8A8_SRGB;
-	case TKTX_E5B9G9R9_UFLOAT_PACK32: return TinyImageFormat_E5B9G9R9_UFLOAT;
-	case TKTX_A2R10G10B10_UNORM_PACK32: return TinyImageFormat_B10G10R10A2_UNORM;
-	case TKTX_A2R10G10B10_UINT_PACK32: return TinyImageFormat_B10G10R10A2_UINT;
-	case TKTX_A2B10G10R10_UNORM_PACK32: return TinyImageFormat_R10G10B10A2_UNORM;
-	case TKTX_A2B10G10R10_UINT_PACK32: return TinyImageFormat_R10G10B10A2_UINT;
-	case TKTX_B10G11R11_UFLOAT_PACK32: return TinyImageFormat_B10G11R11_UFLOAT;
-	case TKTX_R16_UNORM: return TinyImageFormat_R16_UNORM;
-	case TKTX_R16_SNORM: return TinyImageFormat_R16_SNORM;
-	case TKTX_R16_UINT: return TinyImageFormat_R16_UINT;
-	case TKTX_R16_SINT: return TinyImageFormat_R16_SINT;
-	case TKTX_R16_SFLOAT: return TinyImageFormat_R16_SFLOAT;
-	case TKTX_R16G16_UNORM: return TinyImageFormat_R16G16_UNORM;
-	case TKTX_R16G16_SNORM: return TinyImageFormat_R16G16_SNORM;
-	case TKTX_R16G16_UINT: return TinyImageFormat_R16G16_UINT;
-	case TKTX_R16G16_SINT: return TinyImageFormat_R16G16_SINT;
-	case TKTX_R16G16_SFLOAT: return TinyImageFormat_R16G16_SFLOAT;
-	case TKTX_R16G16B16_UNORM: return TinyImageFormat_R16G16B16_UNORM;
-	case TKTX_R16G16B16_SNORM: return TinyImageFormat_R16G16B16_SNORM;
-	case TKTX_R16G16B16_UINT: return TinyImageFormat_R16G16B16_UINT;
-	case TKTX_R16G16B16_SINT: return TinyImageFormat_R16G16B16_SINT;
-	case TKTX_R16G16B16_SFLOAT: return TinyImageFormat_R16G16B16_SFLOAT;
-	case TKTX_R16G16B16A16_UNORM: return TinyImageFormat_R16G16B16A16_UNORM;
-	case TKTX_R16G16B16A16_SNORM: return TinyImageFormat_R16G16B16A16_SNORM;
-	case TKTX_R16G16B16A16_UINT: return TinyImageFormat_R16G16B16A16_UINT;
-	case TKTX_R16G16B16A16_SINT: return TinyImageFormat_R16G16B16A16_SINT;
-	case TKTX_R16G16B16A16_SFLOAT: return TinyImageFormat_R16G16B16A16_SFLOAT;
-	case TKTX_R32_UINT: return TinyImageFormat_R32_UINT;
-	case TKTX_R32_SINT: return TinyImageFormat_R32_SINT;
-	case TKTX_R32_SFLOAT: return TinyImageFormat_R32_SFLOAT;
-	case TKTX_R32G32_UINT: return TinyImageFormat_R32G32_UINT;
-	case TKTX_R32G32_SINT: return TinyImageFormat_R32G32_SINT;
-	case TKTX_R32G32_SFLOAT: return TinyImageFormat_R32G32_SFLOAT;
-	case TKTX_R32G32B32_UINT: return TinyImageFormat_R32G32B32_UINT;
-	case TKTX_R32G32B32_SINT: return TinyImageFormat_R32G32B32_SINT;
-	case TKTX_R32G32B32_SFLOAT: return TinyImageFormat_R32G32B32_SFLOAT;
-	case TKTX_R32G32B32A32_UINT: return TinyImageFormat_R32G32B32A32_UINT;
-	case TKTX_R32G32B32A32_SINT: return TinyImageFormat_R32G32B32A32_SINT;
-	case TKTX_R32G32B32A32_SFLOAT: return TinyImageFormat_R32G32B32A32_SFLOAT;
-	case TKTX_BC1_RGB_UNORM_BLOCK: return TinyImageFormat_DXBC1_RGB_UNORM;
-	case TKTX_BC1_RGB_SRGB_BLOCK: return TinyImageFormat_DXBC1_RGB_SRGB;
-	case TKTX_BC1_RGBA_UNORM_BLOCK: return TinyImageFormat_DXBC1_RGBA_UNORM;
-	case TKTX_BC1_RGBA_SRGB_BLOCK: return TinyImageFormat_DXBC1_RGBA_SRGB;
-	case TKTX_BC2_UNORM_BLOCK: return TinyImageFormat_DXBC2_UNORM;
-	case TKTX_BC2_SRGB_BLOCK: return TinyImageFormat_DXBC2_SRGB;
-	case TKTX_BC3_UNORM_BLOCK: return TinyImageFormat_DXBC3_UNORM;
-	case TKTX_BC3_SRGB_BLOCK: return TinyImageFormat_DXBC3_SRGB;
-	case TKTX_BC4_UNORM_BLOCK: return TinyImageFormat_DXBC4_UNORM;
-	case TKTX_BC4_SNORM_BLOCK: return TinyImageFormat_DXBC4_SNORM;
-	case TKTX_BC5_UNORM_BLOCK: return TinyImageFormat_DXBC5_UNORM;
-	case TKTX_BC5_SNORM_BLOCK: return TinyImageFormat_DXBC5_SNORM;
-	case TKTX_BC6H_UFLOAT_BLOCK: return TinyImageFormat_DXBC6H_UFLOAT;
-	case TKTX_BC6H_SFLOAT_BLOCK: return TinyImageFormat_DXBC6H_SFLOAT;
-	case TKTX_BC7_UNORM_BLOCK: return TinyImageFormat_DXBC7_UNORM;
-	case TKTX_BC7_SRGB_BLOCK: return TinyImageFormat_DXBC7_SRGB;
-	case TKTX_PVR_2BPP_UNORM_BLOCK: return TinyImageFormat_PVRTC1_2BPP_UNORM;
-	case TKTX_PVR_2BPPA_UNORM_BLOCK: return TinyImageFormat_PVRTC1_2BPP_UNORM;
-	case TKTX_PVR_4BPP_UNORM_BLOCK: return TinyImageFormat_PVRTC1_4BPP_UNORM;
-	case TKTX_PVR_4BPPA_UNORM_BLOCK: return TinyImageFormat_PVRTC1_4BPP_UNORM;
-	case TKTX_PVR_2BPP_SRGB_BLOCK: return TinyImageFormat_PVRTC1_2BPP_SRGB;
-	case TKTX_PVR_2BPPA_SRGB_BLOCK: return TinyImageFormat_PVRTC1_2BPP_SRGB;
-	case TKTX_PVR_4BPP_SRGB_BLOCK: return TinyImageFormat_PVRTC1_4BPP_SRGB;
-	case TKTX_PVR_4BPPA_SRGB_BLOCK: return TinyImageFormat_PVRTC1_4BPP_SRGB;
-
-	case TKTX_ETC2_R8G8B8_UNORM_BLOCK: return TinyImageFormat_ETC2_R8G8B8_UNORM;
-	case TKTX_ETC2_R8G8B8A1_UNORM_BLOCK: return TinyImageFormat_ETC2_R8G8B8A1_UNORM;
-	case TKTX_ETC2_R8G8B8A8_UNORM_BLOCK: return TinyImageFormat_ETC2_R8G8B8A8_UNORM;
-	case TKTX_ETC2_R8G8B8_SRGB_BLOCK: return TinyImageFormat_ETC2_R8G8B8_SRGB;
-	case TKTX_ETC2_R8G8B8A1_SRGB_BLOCK: return TinyImageFormat_ETC2_R8G8B8A1_SRGB;
-	case TKTX_ETC2_R8G8B8A8_SRGB_BLOCK: return TinyImageFormat_ETC2_R8G8B8A8_SRGB;
-	case TKTX_EAC_R11_UNORM_BLOCK: return TinyImageFormat_ETC2_EAC_R11_UNORM;
-	case TKTX_EAC_R11G11_UNORM_BLOCK: return TinyImageFormat_ETC2_EAC_R11G11_UNORM;
-	case TKTX_EAC_R11_SNORM_BLOCK: return TinyImageFormat_ETC2_EAC_R11_SNORM;
-	case TKTX_EAC_R11G11_SNORM_BLOCK: return TinyImageFormat_ETC2_EAC_R11G11_SNORM;
-	case TKTX_ASTC_4x4_UNORM_BLOCK: return TinyImageFormat_ASTC_4x4_UNORM;
-	case TKTX_ASTC_4x4_SRGB_BLOCK: return TinyImageFormat_ASTC_4x4_SRGB;
-	case TKTX_ASTC_5x4_UNORM_BLOCK: return TinyImageFormat_ASTC_5x4_UNORM;
-	case TKTX_ASTC_5x4_SRGB_BLOCK: return TinyImageFormat_ASTC_5x4_SRGB;
-	case TKTX_ASTC_5x5_UNORM_BLOCK: return TinyImageFormat_ASTC_5x5_UNORM;
-	case TKTX_ASTC_5x5_SRGB_BLOCK: return TinyImageFormat_ASTC_5x5_SRGB;
-	case TKTX_ASTC_6x5_UNORM_BLOCK: return TinyImageFormat_ASTC_6x5_UNORM;
-	case TKTX_ASTC_6x5_SRGB_BLOCK: return TinyImageFormat_ASTC_6x5_SRGB;
-	case TKTX_ASTC_6x6_UNORM_BLOCK: return TinyImageFormat_ASTC_6x6_UNORM;
-	case TKTX_ASTC_6x6_SRGB_BLOCK: return TinyImageFormat_ASTC_6x6_SRGB;
-	case TKTX_ASTC_8x5_UNORM_BLOCK: return TinyImageFormat_ASTC_8x5_UNORM;
-	case TKTX_ASTC_8x5_SRGB_BLOCK: return TinyImageFormat_ASTC_8x5_SRGB;
-	case TKTX_ASTC_8x6_UNORM_BLOCK: return TinyImageFormat_ASTC_8x6_UNORM;
-	case TKTX_ASTC_8x6_SRGB_BLOCK: return TinyImageFormat_ASTC_8x6_SRGB;
-	case TKTX_ASTC_8x8_UNORM_BLOCK: return TinyImageFormat_ASTC_8x8_UNORM;
-	case TKTX_ASTC_8x8_SRGB_BLOCK: return TinyImageFormat_ASTC_8x8_SRGB;
-	case TKTX_ASTC_10x5_UNORM_BLOCK: return TinyImageFormat_ASTC_10x5_UNORM;
-	case TKTX_ASTC_10x5_SRGB_BLOCK: return TinyImageFormat_ASTC_10x5_SRGB;
-	case TKTX_ASTC_10x6_UNORM_BLOCK: return TinyImageFormat_ASTC_10x6_UNORM;
-	case TKTX_ASTC_10x6_SRGB_BLOCK: return TinyImageFormat_ASTC_10x6_SRGB;
-	case TKTX_ASTC_10x8_UNORM_BLOCK: return TinyImageFormat_ASTC_10x8_UNORM;
-	case TKTX_ASTC_10x8_SRGB_BLOCK: return TinyImageFormat_ASTC_10x8_SRGB;
-	case TKTX_ASTC_10x10_UNORM_BLOCK: return TinyImageFormat_ASTC_10x10_UNORM;
-	case TKTX_ASTC_10x10_SRGB_BLOCK: return TinyImageFormat_ASTC_10x10_SRGB;
-	case TKTX_ASTC_12x10_UNORM_BLOCK: return TinyImageFormat_ASTC_12x10_UNORM;
-	case TKTX_ASTC_12x10_SRGB_BLOCK: return TinyImageFormat_ASTC_12x10_SRGB;
-	case TKTX_ASTC_12x12_UNORM_BLOCK: return TinyImageFormat_ASTC_12x12_UNORM;
-	case TKTX_ASTC_12x12_SRGB_BLOCK: return TinyImageFormat_ASTC_12x12_SRGB;
-
-	case TKTX_A8B8G8R8_UNORM_PACK32:break;
-	case TKTX_A8B8G8R8_SNORM_PACK32:break;
-	case TKTX_A8B8G8R8_UINT_PACK32:break;
-	case TKTX_A8B8G8R8_SINT_PACK32:break;
-	case TKTX_A8B8G8R8_SRGB_PACK32:break;
+	TINYKTX_FORMAT_TABLE(TINYKTX_TIF_FROM_FT, TINYKTX_TIF_FROM_FTC)
 	}
 
 	return TinyImageFormat_UNDEFINED;
@@ -2294,110 +4055,18 @@ TinyImageFormat TinyImageFormat_FromTinyKtxFormat(TinyKtx_Format format)
 TinyKtx_Format TinyImageFormat_ToTinyKtxFormat(TinyImageFormat format) {
 
 	switch (format) {
-	case TinyImageFormat_UNDEFINED: return TKTX_UNDEFINED;
-	case TinyImageFormat_R4G4_UNORM: return TKTX_R4G4_UNORM_PACK8;
-	case TinyImageFormat_R4G4B4A4_UNORM: return TKTX_R4G4B4A4_UNORM_PACK16;
-	case TinyImageFormat_B4G4R4A4_UNORM: return TKTX_B4G4R4A4_UNORM_PACK16;
-	case TinyImageFormat_R5G6B5_UNORM: return TKTX_R5G6B5_UNORM_PACK16;
-	case TinyImageFormat_B5G6R5_UNORM: return TKTX_B5G6R5_UNORM_PACK16;
-	case TinyImageFormat_R5G5B5A1_UNORM: return TKTX_R5G5B5A1_UNORM_PACK16;
-	case TinyImageFormat_B5G5R5A1_UNORM: return TKTX_B5G5R5A1_UNORM_PACK16;
-	case TinyImageFormat_A1R5G5B5_UNORM: return TKTX_A1R5G5B5_UNORM_PACK16;
-	case TinyImageFormat_R8_UNORM: return TKTX_R8_UNORM;
-	case TinyImageFormat_R8_SNORM: return TKTX_R8_SNORM;
-	case TinyImageFormat_R8_UINT: return TKTX_R8_UINT;
-	case TinyImageFormat_R8_SINT: return TKTX_R8_SINT;
-	case TinyImageFormat_R8_SRGB: return TKTX_R8_SRGB;
-	case TinyImageFormat_R8G8_UNORM: return TKTX_R8G8_UNORM;
-	case TinyImageFormat_R8G8_SNORM: return TKTX_R8G8_SNORM;
-	case TinyImageFormat_R8G8_UINT: return TKTX_R8G8_UINT;
-	case TinyImageFormat_R8G8_SINT: return TKTX_R8G8_SINT;
-	case TinyImageFormat_R8G8_SRGB: return TKTX_R8G8_SRGB;
-	case TinyImageFormat_R8G8B8_UNORM: return TKTX_R8G8B8_UNORM;
-	case TinyImageFormat_R8G8B8_SNORM: return TKTX_R8G8B8_SNORM;
-	case TinyImageFormat_R8G8B8_UINT: return TKTX_R8G8B8_UINT;
-	case TinyImageFormat_R8G8B8_SINT: return TKTX_R8G8B8_SINT;
-	case TinyImageFormat_R8G8B8_SRGB: return TKTX_R8G8B8_SRGB;
-	case TinyImageFormat_B8G8R8_UNORM: return TKTX_B8G8R8_UNORM;
-	case TinyImageFormat_B8G8R8_SNORM: return TKTX_B8G8R8_SNORM;
-	case TinyImageFormat_B8G8R8_UINT: return TKTX_B8G8R8_UINT;
-	case TinyImageFormat_B8G8R8_SINT: return TKTX_B8G8R8_SINT;
-	case TinyImageFormat_B8G8R8_SRGB: return TKTX_B8G8R8_SRGB;
-	case TinyImageFormat_R8G8B8A8_UNORM: return TKTX_R8G8B8A8_UNORM;
-	case TinyImageFormat_R8G8B8A8_SNORM: return TKTX_R8G8B8A8_SNORM;
-	case TinyImageFormat_R8G8B8A8_UINT: return TKTX_R8G8B8A8_UINT;
-	case TinyImageFormat_R8G8B8A8_SINT: return TKTX_R8G8B8A8_SINT;
-	case TinyImageFormat_R8G8B8A8_SRGB: return TKTX_R8G8B8A8_SRGB;
-	case TinyImageFormat_B8G8R8A8_UNORM: return TKTX_B8G8R8A8_UNORM;
-	case TinyImageFormat_B8G8R8A8_SNORM: return TKTX_B8G8R8A8_SNORM;
-	case TinyImageFormat_B8G8R8A8_UINT: return TKTX_B8G8R8A8_UINT;
-	case TinyImageFormat_B8G8R8A8_SINT: return TKTX_B8G8R8A8_SINT;
-	case TinyImageFormat_B8G8R8A8_SRGB: return TKTX_B8G8R8A8_SRGB;
-	case TinyImageFormat_R10G10B10A2_UNORM: return TKTX_A2B10G10R10_UNORM_PACK32;
-	case TinyImageFormat_R10G10B10A2_UINT: return TKTX_A2B10G10R10_UINT_PACK32;
-	case TinyImageFormat_B10G10R10A2_UNORM: return TKTX_A2R10G10B10_UNORM_PACK32;
-	case TinyImageFormat_B10G10R10A2_UINT: return TKTX_A2R10G10B10_UINT_PACK32;
-	case TinyImageFormat_R16_UNORM: return TKTX_R16_UNORM;
-	case TinyImageFormat_R16_SNORM: return TKTX_R16_SNORM;
-	case TinyImageFormat_R16_UINT: return TKTX_R16_UINT;
-	case TinyImageFormat_R16_SINT: return TKTX_R16_SINT;
-	case TinyImageFormat_R16_SFLOAT: return TKTX_R16_SFLOAT;
-	case TinyImageFormat_R16G16_UNORM: return TKTX_R16G16_UNORM;
-	case TinyImageFormat_R16G16_SNORM: return TKTX_R16G16_SNORM;
-	case TinyImageFormat_R16G16_UINT: return TKTX_R16G16_UINT;
-	case TinyImageFormat_R16G16_SINT: return TKTX_R16G16_SINT;
-	case TinyImageFormat_R16G16_SFLOAT: return TKTX_R16G16_SFLOAT;
-	case TinyImageFormat_R16G16B16_UNORM: return TKTX_R16G16B16_UNORM;
-	case TinyImageFormat_R16G16B16_SNORM: return TKTX_R16G16B16_SNORM;
-	case TinyImageFormat_R16G16B16_UINT: return TKTX_R16G16B16_UINT;
-	case TinyImageFormat_R16G16B16_SINT: return TKTX_R16G16B16_SINT;
-	case TinyImageFormat_R16G16B16_SFLOAT: return TKTX_R16G16B16_SFLOAT;
-	case TinyImageFormat_R16G16B16A16_UNORM: return TKTX_R16G16B16A16_UNORM;
-	case TinyImageFormat_R16G16B16A16_SNORM: return TKTX_R16G16B16A16_SNORM;
-	case TinyImageFormat_R16G16B16A16_UINT: return TKTX_R16G16B16A16_UINT;
-	case TinyImageFormat_R16G16B16A16_SINT: return TKTX_R16G16B16A16_SINT;
-	case TinyImageFormat_R16G16B16A16_SFLOAT: return TKTX_R16G16B16A16_SFLOAT;
-	case TinyImageFormat_R32_UINT: return TKTX_R32_UINT;
-	case TinyImageFormat_R32_SINT: return TKTX_R32_SINT;
-	case TinyImageFormat_R32_SFLOAT: return TKTX_R32_SFLOAT;
-	case TinyImageFormat_R32G32_UINT: return TKTX_R32G32_UINT;
-	case TinyImageFormat_R32G32_SINT: return TKTX_R32G32_SINT;
-	case TinyImageFormat_R32G32_SFLOAT: return TKTX_R32G32_SFLOAT;
-	case TinyImageFormat_R32G32B32_UINT: return TKTX_R32G32B32_UINT;
-	case TinyImageFormat_R32G32B32_SINT: return TKTX_R32G32B32_SINT;
-	case TinyImageFormat_R32G32B32_SFLOAT: return TKTX_R32G32B32_SFLOAT;
-	case TinyImageFormat_R32G32B32A32_UINT: return TKTX_R32G32B32A32_UINT;
-	case TinyImageFormat_R32G32B32A32_SINT: return TKTX_R32G32B32A32_SINT;
-	case TinyImageFormat_R32G32B32A32_SFLOAT: return TKTX_R32G32B32A32_SFLOAT;
-	case TinyImageFormat_B10G11R11_UFLOAT: return TKTX_B10G11R11_UFLOAT_PACK32;
-	case TinyImageFormat_E5B9G9R9_UFLOAT: return TKTX_E5B9G9R9_UFLOAT_PACK32;
-
-	case TinyImageFormat_DXBC1_RGB_UNORM: return TKTX_BC1_RGB_UNORM_BLOCK;
-	case TinyImageFormat_DXBC1_RGB_SRGB: return TKTX_BC1_RGB_SRGB_BLOCK;
-	case TinyImageFormat_DXBC1_RGBA_UNORM: return TKTX_BC1_RGBA_UNORM_BLOCK;
-	case TinyImageFormat_DXBC1_RGBA_SRGB: return TKTX_BC1_RGBA_SRGB_BLOCK;
-	case TinyImageFormat_DXBC2_UNORM: return TKTX_BC2_UNORM_BLOCK;
-	case TinyImageFormat_DXBC2_SRGB: return TKTX_BC2_SRGB_BLOCK;
-	case TinyImageFormat_DXBC3_UNORM: return TKTX_BC3_UNORM_BLOCK;
-	case TinyImageFormat_DXBC3_SRGB: return TKTX_BC3_SRGB_BLOCK;
-	case TinyImageFormat_DXBC4_UNORM: return TKTX_BC4_UNORM_BLOCK;
-	case TinyImageFormat_DXBC4_SNORM: return TKTX_BC4_SNORM_BLOCK;
-	case TinyImageFormat_DXBC5_UNORM: return TKTX_BC5_UNORM_BLOCK;
-	case TinyImageFormat_DXBC5_SNORM: return TKTX_BC5_SNORM_BLOCK;
-	case TinyImageFormat_DXBC6H_UFLOAT: return TKTX_BC6H_UFLOAT_BLOCK;
-	case TinyImageFormat_DXBC6H_SFLOAT: return TKTX_BC6H_SFLOAT_BLOCK;
-	case TinyImageFormat_DXBC7_UNORM: return TKTX_BC7_UNORM_BLOCK;
-	case TinyImageFormat_DXBC7_SRGB: return TKTX_BC7_SRGB_BLOCK;
-	case TinyImageFormat_PVRTC1_2BPP_UNORM: return TKTX_PVR_2BPPA_UNORM_BLOCK;
-	case TinyImageFormat_PVRTC1_4BPP_UNORM: return TKTX_PVR_4BPPA_UNORM_BLOCK;
-	case TinyImageFormat_PVRTC1_2BPP_SRGB: return TKTX_PVR_2BPPA_SRGB_BLOCK;
-	case TinyImageFormat_PVRTC1_4BPP_SRGB: return TKTX_PVR_4BPPA_SRGB_BLOCK;
-
-	default: return TKTX_UNDEFINED;
-	};
+	TINYKTX_FORMAT_TABLE(TINYKTX_TIF_TO_FT, TINYKTX_TIF_TO_FTC)
+	default: break;
+	}
 
 	return TKTX_UNDEFINED;
 }
+#undef TINYKTX_TIF_FROM_FT
+#undef TINYKTX_TIF_FROM_FTC
+#undef TINYKTX_TIF_TO_0
+#undef TINYKTX_TIF_TO_1
+#undef TINYKTX_TIF_TO_FT
+#undef TINYKTX_TIF_TO_FTC
 #endif // end TinyImageFormat conversion
 
 #endif // end implementation
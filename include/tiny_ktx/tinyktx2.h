@@ -15,6 +15,7 @@
 #ifndef TINYKTX_HAVE_MEMCPY
 #include <string.h> 	// for memcpy
 #endif
+#include "tinyktx.h"	// for TinyKtx_Format and the format helpers
 
 #ifdef __cplusplus
 extern "C" {
@@ -27,16 +28,97 @@ typedef struct TinyKtx2_Context *TinyKtx2_ContextHandle;
 typedef void *(*TinyKtx2_AllocFunc)(void *user, size_t size);
 typedef void (*TinyKtx2_FreeFunc)(void *user, void *memory);
 typedef size_t (*TinyKtx2_ReadFunc)(void *user, void *buffer, size_t byteCount);
+// seek and tell are optional, without seek the stream is forward only and seeks forward are
+// done by reading and discarding (see TinyKtx2_StreamLevels)
 typedef bool (*TinyKtx2_SeekFunc)(void *user, int64_t offset);
 typedef int64_t (*TinyKtx2_TellFunc)(void *user);
 typedef void (*TinyKtx2_ErrorFunc)(void *user, char const *msg);
-typedef bool (*TinyKtx2_SuperDecompress)(void* user, void* const sgdData, void const* src, size_t srcSize, void const* dst, size_t dstSize);
+
+typedef enum TinyKtx2_SuperCompressionScheme {
+	TKTX2_SUPERCOMPRESSION_NONE = 0,
+	TKTX2_SUPERCOMPRESSION_CRN = 1,
+	TKTX2_SUPERCOMPRESSION_ZSTD = 2,
+	TKTX2_SUPERCOMPRESSION_ZLIB = 3,
+} TinyKtx2_SuperCompressionScheme;
+
+// decompresses srcSize bytes of src into exactly dstSize bytes at dst
+typedef bool (*TinyKtx2_SuperDecompress)(void* user, void* const sgdData, void const* src, size_t srcSize, void* dst, size_t dstSize);
+
+// Built in decompressors are used for any scheme without a user decompressor.
+// Define TINYKTX2_HAVE_ZLIB and/or TINYKTX2_HAVE_ZSTD before the implementation (and link zlib/zstd)
+// to enable them. Decoder state is kept by the context and reused for every level and file
+// until the context is destroyed
 
 typedef struct TinyKtx2_SuperDecompressTableEntry {
 	uint32_t superId;
 	TinyKtx2_SuperDecompress decompressor;
 } TinyKtx2_SuperDecompressTableEntry;
 
+// Streaming decompressors are fed the compressed level a chunk at a time as it is read, so the
+// whole compressed level is never in memory. init returns per level state (NULL on failure) for
+// decompressing into exactly dstSize bytes at dst, feed is called with each chunk in order and
+// finish must check all of dst was produced and free the state (it is always called after init)
+typedef void *(*TinyKtx2_StreamDecompressInit)(void *user, void *const sgdData, void *dst, size_t dstSize);
+typedef bool (*TinyKtx2_StreamDecompressFeed)(void *user, void *state, void const *src, size_t srcSize);
+typedef bool (*TinyKtx2_StreamDecompressFinish)(void *user, void *state);
+
+typedef struct TinyKtx2_StreamDecompressTableEntry {
+	uint32_t superId;
+	TinyKtx2_StreamDecompressInit init;
+	TinyKtx2_StreamDecompressFeed feed;
+	TinyKtx2_StreamDecompressFinish finish;
+} TinyKtx2_StreamDecompressTableEntry;
+
+#define TINYKTX2_DEFAULT_STREAM_CHUNK_SIZE (256 * 1024)
+
+// Supercompression global data (SGD) is only read with the first supercompressed level.
+// Files from the same encoder often carry identical SGD, shareGlobalData lets a batch loader keep
+// one copy. It is given the content hash (see TinyKtx2_HashGlobalData) and the data just read and
+// returns the copy to use, which must stay valid until the context is reset or destroyed.
+// sgd itself is reused by the context so must be copied to be kept, return it to use it as is
+typedef void const *(*TinyKtx2_ShareGlobalDataFunc)(void *user, uint64_t key, void const *sgd, uint64_t byteLength);
+
+// KTX v2 universal textures (VK_FORMAT_UNDEFINED with a BasisLZ/ETC1S or UASTC DFD) have to be
+// transcoded to a GPU format before use
+typedef enum TinyKtx2_UniversalFormat {
+	TKTX2_UNIVERSAL_NONE = 0,
+	TKTX2_UNIVERSAL_ETC1S = 163,
+	TKTX2_UNIVERSAL_UASTC = 166,
+} TinyKtx2_UniversalFormat;
+
+// one image (a z slice of a face of an array layer) of a level to transcode. levelData is the whole
+// level with any supercompression removed, images are stored by layer then face then z slice
+typedef struct TinyKtx2_TranscodeImage {
+	uint32_t level;
+	uint32_t layer;
+	uint32_t face;
+	uint32_t zSlice;
+	uint32_t imageIndex;
+	uint32_t imageCount;
+	uint32_t width;				// of the level
+	uint32_t height;
+	void const *levelData;
+	size_t levelDataSize;
+	void *dst;						// this image in the target format
+	size_t dstSize;
+} TinyKtx2_TranscodeImage;
+
+// called for every image of a level, possibly from many threads at once
+typedef bool (*TinyKtx2_TranscodeFunc)(void *user, void *const sgdData, TinyKtx2_TranscodeImage const *image);
+
+// one entry per supported universal format and target format pair
+typedef struct TinyKtx2_TranscoderTableEntry {
+	uint32_t universalFormat;
+	TinyKtx_Format targetFormat;
+	TinyKtx2_TranscodeFunc transcode;
+} TinyKtx2_TranscoderTableEntry;
+
+// built in UASTC to R8G8B8A8 (UNORM and SRGB) transcoders, defined by the tinyktx_decode.h
+// implementation. Define TINYKTX2_HAVE_DECODE before the implementation (the library does) to use
+// them for any pair the callbacks' transcoder table doesn't have
+#define TINYKTX2_UASTC_TRANSCODER_COUNT 2
+extern TinyKtx2_TranscoderTableEntry const TinyKtx2_UastcTranscoders[TINYKTX2_UASTC_TRANSCODER_COUNT];
+
 typedef struct TinyKtx2_Callbacks {
 	TinyKtx2_ErrorFunc error;
 	TinyKtx2_AllocFunc alloc;
@@ -47,18 +129,34 @@ typedef struct TinyKtx2_Callbacks {
 
 	size_t numSuperDecompressors;
 	TinyKtx2_SuperDecompressTableEntry const* superDecompressors;
+
+	size_t numStreamDecompressors;
+	TinyKtx2_StreamDecompressTableEntry const* streamDecompressors;
+	size_t streamChunkSize; // 0 is TINYKTX2_DEFAULT_STREAM_CHUNK_SIZE
+
+	TinyKtx2_ShareGlobalDataFunc shareGlobalData; // optional
+
+	size_t numTranscoders;
+	TinyKtx2_TranscoderTableEntry const *transcoders;
+
+	// 0 is unlimited. No single read or level alloc call is larger than this, bigger
+	// levels have to be read with TinyKtx2_ReadLevelChunks
+	size_t maxChunkSize;
 } TinyKtx2_Callbacks;
 
 TinyKtx2_ContextHandle TinyKtx2_CreateContext(TinyKtx2_Callbacks const *callbacks, void *user);
-void TinyKtx2_DestroyContext(TinyKtx_ContextHandle handle);
+void TinyKtx2_DestroyContext(TinyKtx2_ContextHandle handle);
 
 // reset lets you reuse the context for another file (saves an alloc/free cycle)
 void TinyKtx2_Reset(TinyKtx2_ContextHandle handle);
 
-// call this to read the header file should already be at the start of the KTX data
+// call this to read the header file should already be at the start of the KTX data.
+// The level index, data format descriptor and key/value data are fetched with a single read
+// after the header and checked against the format and dimensions
 bool TinyKtx2_ReadHeader(TinyKtx2_ContextHandle handle);
 
 // this is slow linear search. TODO add iterator style reading of key value pairs
+// value points to the value bytes straight after the key's null terminator
 bool TinyKtx2_GetValue(TinyKtx2_ContextHandle handle, char const *key, void const **value);
 
 bool TinyKtx2_Is1D(TinyKtx2_ContextHandle handle);
@@ -79,7 +177,9 @@ bool TinyKtx2_NeedsGenerationOfMipmaps(TinyKtx2_ContextHandle handle);
 bool TinyKtx2_NeedsEndianCorrecting(TinyKtx2_ContextHandle handle);
 
 uint32_t TinyKtx2_NumberOfMipmaps(TinyKtx2_ContextHandle handle);
+// 0 (with an error) if the level is 4GB or more, use TinyKtx2_ImageSize64 for those
 uint32_t TinyKtx2_ImageSize(TinyKtx2_ContextHandle handle, uint32_t mipmaplevel);
+uint64_t TinyKtx2_ImageSize64(TinyKtx2_ContextHandle handle, uint32_t mipmaplevel);
 
 bool TinyKtx2_IsMipMapLevelUnpacked(TinyKtx2_ContextHandle handle, uint32_t mipmaplevel);
 // this is required to read Unpacked data correctly
@@ -87,456 +187,298 @@ uint32_t TinyKtx2_UnpackedRowStride(TinyKtx2_ContextHandle handle, uint32_t mipm
 
 // data return by ImageRawData is owned by the context. Don't free it!
 void const *TinyKtx2_ImageRawData(TinyKtx2_ContextHandle handle, uint32_t mipmaplevel);
+// releases the context's copy of a level early (rather than at reset/destroy)
+void TinyKtx2_ReleaseImageRawData(TinyKtx2_ContextHandle handle, uint32_t mipmaplevel);
+
+// called with each level as soon as it has been read (and decompressed), data is owned by the context
+typedef void (*TinyKtx2_LevelReadyFunc)(void *user, uint32_t mipmaplevel, void const *data, size_t byteLength);
+// loads every level in file order, which is smallest first, calling levelReady as each one arrives
+// so low mips can be shown before the rest of the file is there. Works on forward only streams
+// (the reads never go backwards). levelReady may release the level if it has no further use for it
+bool TinyKtx2_StreamLevels(TinyKtx2_ContextHandle handle, TinyKtx2_LevelReadyFunc levelReady, void *levelUser);
+
+// called with each piece of a level in order, byteOffset is from the start of the level.
+// data is only valid during the call, return false to stop reading
+typedef bool (*TinyKtx2_LevelChunkFunc)(void *user, uint32_t mipmaplevel, uint64_t byteOffset, void const *data, size_t byteCount);
+// reads a level a piece at a time through a single buffer of at most maxChunkSize bytes
+// (streamChunkSize if that is unlimited), so levels of any size can be copied to their
+// destination without ever being in memory at once. Not supercompressed files
+bool TinyKtx2_ReadLevelChunks(TinyKtx2_ContextHandle handle, uint32_t mipmaplevel, TinyKtx2_LevelChunkFunc chunkFn, void *chunkUser);
+
+// bytes of one depth slice of a level of a 3D texture. 0 on error
+uint64_t TinyKtx2_DepthSliceSize(TinyKtx2_ContextHandle handle, uint32_t mipmaplevel);
+// reads depth slices [z0, z1) of a level of a 3D texture into dst ((z1 - z0) * TinyKtx2_DepthSliceSize
+// bytes) with one seek and read, the rest of the level isn't touched. Not supercompressed files
+bool TinyKtx2_ReadDepthSlices(TinyKtx2_ContextHandle handle,
+															uint32_t mipmaplevel,
+															uint32_t z0,
+															uint32_t z1,
+															void *dst,
+															size_t dstSize);
+
+// TinyKtx2 never creates threads, work that can run in parallel is handed to a dispatch
+// function that must run task(taskData, i) for every i in [0, taskCount) (on as many threads
+// as it likes) and only return once they have all finished.
+typedef void (*TinyKtx2_TaskFunc)(void *taskData, uint32_t taskIndex);
+typedef void (*TinyKtx2_DispatchFunc)(void *dispatchUser, TinyKtx2_TaskFunc task, void *taskData, uint32_t taskCount);
+
+// loads every level in levelMask (bit n = level n), after which TinyKtx2_ImageRawData returns
+// them without further work. Compressed data is read serially via the read callback, then each
+// supercompressed level is decompressed as its own task. Decompressors must be thread safe.
+// dispatch can be NULL to decompress on the calling thread, in which case a streaming
+// decompressor (user or built in) is preferred if there is one for the scheme
+bool TinyKtx2_DecodeLevels(TinyKtx2_ContextHandle handle,
+													 uint32_t levelMask,
+													 TinyKtx2_DispatchFunc dispatch,
+													 void *dispatchUser);
+
+// the level index entry, offsets are from the start of the KTX data so any level can be
+// read directly without touching the others
+bool TinyKtx2_LevelIndex(TinyKtx2_ContextHandle handle,
+												 uint32_t mipmaplevel,
+												 uint64_t *byteOffset,
+												 uint64_t *byteLength,
+												 uint64_t *uncompressedByteLength);
+uint32_t TinyKtx2_GetSuperCompressionScheme(TinyKtx2_ContextHandle handle);
+// the raw data format descriptor (starting with its total size), owned by the context
+void const *TinyKtx2_DataFormatDescriptor(TinyKtx2_ContextHandle handle, uint32_t *byteLength);
+
+// content hash used as the key for sharing supercompression global data
+uint64_t TinyKtx2_HashGlobalData(void const *data, uint64_t byteLength);
+// provides the supercompression global data by reference so it isn't read from the file.
+// Call after TinyKtx2_ReadHeader, byteLength must match the header and data must stay valid
+// until the context is reset or destroyed
+bool TinyKtx2_SetSuperCompressionGlobalData(TinyKtx2_ContextHandle handle, void const *data, uint64_t byteLength);
+// the supercompression global data (read now if it hasn't been yet) and its key, NULL if there is none
+void const *TinyKtx2_SuperCompressionGlobalData(TinyKtx2_ContextHandle handle, uint64_t *byteLength, uint64_t *key);
+
+#define TINYKTX2_MAX_TEXEL_CHANNELS 8
+
+// one sample of the data format descriptor
+typedef struct TinyKtx2_TexelChannel {
+	uint8_t channelType;		// colour model specific, for RGBSDA R 0, G 1, B 2, A 15
+	uint8_t qualifiers;			// linear 0x10, exponent 0x20, signed 0x40, float 0x80
+	uint16_t bitOffset;			// from the lsb of the little endian texel block
+	uint16_t bitLength;			// in bits (not the DFD's length - 1)
+	uint32_t lower;
+	uint32_t upper;
+} TinyKtx2_TexelChannel;
+
+// the first basic block of the data format descriptor, parsed once by TinyKtx2_ReadHeader
+// so conversion code can pick a path without interpreting the DFD per texel
+typedef struct TinyKtx2_TexelLayout {
+	uint8_t colorModel;				// 0 if the DFD has no basic block
+	uint8_t colorPrimaries;
+	uint8_t transferFunction;	// linear 1, sRGB 2
+	bool premultiplied;
+	uint8_t blockWidth;				// texel block dimensions
+	uint8_t blockHeight;
+	uint8_t blockDepth;
+	uint8_t channelCount;
+	uint32_t bytesPerBlock;		// 0 for supercompressed universal formats
+	TinyKtx2_TexelChannel channels[TINYKTX2_MAX_TEXEL_CHANNELS];
+	TinyKtx_Format format;			// the TinyKtx_Format with this layout, TKTX_UNDEFINED if none
+} TinyKtx2_TexelLayout;
+
+// owned by the context
+TinyKtx2_TexelLayout const *TinyKtx2_GetTexelLayout(TinyKtx2_ContextHandle handle);
+
+TinyKtx2_UniversalFormat TinyKtx2_GetUniversalFormat(TinyKtx2_ContextHandle handle);
+// true if TinyKtx2_TranscodeLevel can produce targetFormat: a universal texture needs an entry
+// for it in the transcoder table (or a built in one), anything else can only go to its own format
+bool TinyKtx2_CanTranscode(TinyKtx2_ContextHandle handle, TinyKtx_Format targetFormat);
+// the size of a level transcoded to targetFormat, 0 if the target format isn't a known format
+size_t TinyKtx2_TranscodedLevelSize(TinyKtx2_ContextHandle handle, uint32_t mipmaplevel, TinyKtx_Format targetFormat);
+// transcodes a level into dst (TinyKtx2_TranscodedLevelSize bytes, images in the same order as the
+// level) using the transcoder table, each image is its own task (see TinyKtx2_DecodeLevels for
+// dispatch). Other textures can only be 'transcoded' to their own format, which is a copy.
+// Once TinyKtx2_DecodeLevels has loaded them, different levels can be transcoded on different threads
+bool TinyKtx2_TranscodeLevel(TinyKtx2_ContextHandle handle,
+														 uint32_t mipmaplevel,
+														 TinyKtx_Format targetFormat,
+														 void *dst,
+														 size_t dstSize,
+														 TinyKtx2_DispatchFunc dispatch,
+														 void *dispatchUser);
 
 typedef void (*TinyKtx2_WriteFunc)(void *user, void const *buffer, size_t byteCount);
+// positional (pwrite style) write, used by the positional writer. If levels are written from
+// multiple threads this will be called from all of them at the same time
+typedef void (*TinyKtx2_PositionalWriteFunc)(void *user, uint64_t offset, void const *buffer, size_t byteCount);
 
 typedef struct TinyKtx2_WriteCallbacks {
 	TinyKtx2_ErrorFunc error;
 	TinyKtx2_AllocFunc alloc;
 	TinyKtx2_FreeFunc free;
 	TinyKtx2_WriteFunc write;
+	TinyKtx2_PositionalWriteFunc pwrite; // only required by the positional writer
 } TinyKtx2_WriteCallbacks;
 
-
+// ktx v2 has no row padding, mipmaps must be tightly packed
+// the GL format is converted to the equivalent TinyKtx_Format
 bool TinyKtx2_WriteImageGL(TinyKtx2_WriteCallbacks const *callbacks,
-													void *user,
-													uint32_t width,
-													uint32_t height,
-													uint32_t depth,
-													uint32_t slices,
-													uint32_t mipmaplevels,
-													uint32_t format,
-													uint32_t internalFormat,
-													uint32_t baseFormat,
-													uint32_t type,
-													uint32_t typeSize,
-													bool cubemap,
-													uint32_t const *mipmapsizes,
-													void const **mipmaps);
-
-// ktx v1 is based on GL (slightly confusing imho) texture format system
-// there is format, internal format, type etc.
-
-// we try and expose a more dx12/vulkan/metal style of format
-// but obviously still need to GL data so bare with me.
-// a TinyKTX_Format is the equivilent to GL/KTX Format and Type
-// the API doesn't expose the actual values (which come from GL itself)
-// but provide an API call to crack them back into the actual GL values).
-
-// Ktx v2 is based on VkFormat and also DFD, so we now base the
-// enumeration values of TinyKtx_Format on the Vkformat values where possible
-
-#ifndef TINYKTX_DEFINED
-typedef enum TinyImageFormat_VkFormat {
-	TIF_VK_FORMAT_UNDEFINED = 0,
-	TIF_VK_FORMAT_R4G4_UNORM_PACK8 = 1,
-	TIF_VK_FORMAT_R4G4B4A4_UNORM_PACK16 = 2,
-	TIF_VK_FORMAT_B4G4R4A4_UNORM_PACK16 = 3,
-	TIF_VK_FORMAT_R5G6B5_UNORM_PACK16 = 4,
-	TIF_VK_FORMAT_B5G6R5_UNORM_PACK16 = 5,
-	TIF_VK_FORMAT_R5G5B5A1_UNORM_PACK16 = 6,
-	TIF_VK_FORMAT_B5G5R5A1_UNORM_PACK16 = 7,
-	TIF_VK_FORMAT_A1R5G5B5_UNORM_PACK16 = 8,
-	TIF_VK_FORMAT_R8_UNORM = 9,
-	TIF_VK_FORMAT_R8_SNORM = 10,
-	TIF_VK_FORMAT_R8_USCALED = 11,
-	TIF_VK_FORMAT_R8_SSCALED = 12,
-	TIF_VK_FORMAT_R8_UINT = 13,
-	TIF_VK_FORMAT_R8_SINT = 14,
-	TIF_VK_FORMAT_R8_SRGB = 15,
-	TIF_VK_FORMAT_R8G8_UNORM = 16,
-	TIF_VK_FORMAT_R8G8_SNORM = 17,
-	TIF_VK_FORMAT_R8G8_USCALED = 18,
-	TIF_VK_FORMAT_R8G8_SSCALED = 19,
-	TIF_VK_FORMAT_R8G8_UINT = 20,
-	TIF_VK_FORMAT_R8G8_SINT = 21,
-	TIF_VK_FORMAT_R8G8_SRGB = 22,
-	TIF_VK_FORMAT_R8G8B8_UNORM = 23,
-	TIF_VK_FORMAT_R8G8B8_SNORM = 24,
-	TIF_VK_FORMAT_R8G8B8_USCALED = 25,
-	TIF_VK_FORMAT_R8G8B8_SSCALED = 26,
-	TIF_VK_FORMAT_R8G8B8_UINT = 27,
-	TIF_VK_FORMAT_R8G8B8_SINT = 28,
-	TIF_VK_FORMAT_R8G8B8_SRGB = 29,
-	TIF_VK_FORMAT_B8G8R8_UNORM = 30,
-	TIF_VK_FORMAT_B8G8R8_SNORM = 31,
-	TIF_VK_FORMAT_B8G8R8_USCALED = 32,
-	TIF_VK_FORMAT_B8G8R8_SSCALED = 33,
-	TIF_VK_FORMAT_B8G8R8_UINT = 34,
-	TIF_VK_FORMAT_B8G8R8_SINT = 35,
-	TIF_VK_FORMAT_B8G8R8_SRGB = 36,
-	TIF_VK_FORMAT_R8G8B8A8_UNORM = 37,
-	TIF_VK_FORMAT_R8G8B8A8_SNORM = 38,
-	TIF_VK_FORMAT_R8G8B8A8_USCALED = 39,
-	TIF_VK_FORMAT_R8G8B8A8_SSCALED = 40,
-	TIF_VK_FORMAT_R8G8B8A8_UINT = 41,
-	TIF_VK_FORMAT_R8G8B8A8_SINT = 42,
-	TIF_VK_FORMAT_R8G8B8A8_SRGB = 43,
-	TIF_VK_FORMAT_B8G8R8A8_UNORM = 44,
-	TIF_VK_FORMAT_B8G8R8A8_SNORM = 45,
-	TIF_VK_FORMAT_B8G8R8A8_USCALED = 46,
-	TIF_VK_FORMAT_B8G8R8A8_SSCALED = 47,
-	TIF_VK_FORMAT_B8G8R8A8_UINT = 48,
-	TIF_VK_FORMAT_B8G8R8A8_SINT = 49,
-	TIF_VK_FORMAT_B8G8R8A8_SRGB = 50,
-	TIF_VK_FORMAT_A8B8G8R8_UNORM_PACK32 = 51,
-	TIF_VK_FORMAT_A8B8G8R8_SNORM_PACK32 = 52,
-	TIF_VK_FORMAT_A8B8G8R8_USCALED_PACK32 = 53,
-	TIF_VK_FORMAT_A8B8G8R8_SSCALED_PACK32 = 54,
-	TIF_VK_FORMAT_A8B8G8R8_UINT_PACK32 = 55,
-	TIF_VK_FORMAT_A8B8G8R8_SINT_PACK32 = 56,
-	TIF_VK_FORMAT_A8B8G8R8_SRGB_PACK32 = 57,
-	TIF_VK_FORMAT_A2R10G10B10_UNORM_PACK32 = 58,
-	TIF_VK_FORMAT_A2R10G10B10_SNORM_PACK32 = 59,
-	TIF_VK_FORMAT_A2R10G10B10_USCALED_PACK32 = 60,
-	TIF_VK_FORMAT_A2R10G10B10_SSCALED_PACK32 = 61,
-	TIF_VK_FORMAT_A2R10G10B10_UINT_PACK32 = 62,
-	TIF_VK_FORMAT_A2R10G10B10_SINT_PACK32 = 63,
-	TIF_VK_FORMAT_A2B10G10R10_UNORM_PACK32 = 64,
-	TIF_VK_FORMAT_A2B10G10R10_SNORM_PACK32 = 65,
-	TIF_VK_FORMAT_A2B10G10R10_USCALED_PACK32 = 66,
-	TIF_VK_FORMAT_A2B10G10R10_SSCALED_PACK32 = 67,
-	TIF_VK_FORMAT_A2B10G10R10_UINT_PACK32 = 68,
-	TIF_VK_FORMAT_A2B10G10R10_SINT_PACK32 = 69,
-	TIF_VK_FORMAT_R16_UNORM = 70,
-	TIF_VK_FORMAT_R16_SNORM = 71,
-	TIF_VK_FORMAT_R16_USCALED = 72,
-	TIF_VK_FORMAT_R16_SSCALED = 73,
-	TIF_VK_FORMAT_R16_UINT = 74,
-	TIF_VK_FORMAT_R16_SINT = 75,
-	TIF_VK_FORMAT_R16_SFLOAT = 76,
-	TIF_VK_FORMAT_R16G16_UNORM = 77,
-	TIF_VK_FORMAT_R16G16_SNORM = 78,
-	TIF_VK_FORMAT_R16G16_USCALED = 79,
-	TIF_VK_FORMAT_R16G16_SSCALED = 80,
-	TIF_VK_FORMAT_R16G16_UINT = 81,
-	TIF_VK_FORMAT_R16G16_SINT = 82,
-	TIF_VK_FORMAT_R16G16_SFLOAT = 83,
-	TIF_VK_FORMAT_R16G16B16_UNORM = 84,
-	TIF_VK_FORMAT_R16G16B16_SNORM = 85,
-	TIF_VK_FORMAT_R16G16B16_USCALED = 86,
-	TIF_VK_FORMAT_R16G16B16_SSCALED = 87,
-	TIF_VK_FORMAT_R16G16B16_UINT = 88,
-	TIF_VK_FORMAT_R16G16B16_SINT = 89,
-	TIF_VK_FORMAT_R16G16B16_SFLOAT = 90,
-	TIF_VK_FORMAT_R16G16B16A16_UNORM = 91,
-	TIF_VK_FORMAT_R16G16B16A16_SNORM = 92,
-	TIF_VK_FORMAT_R16G16B16A16_USCALED = 93,
-	TIF_VK_FORMAT_R16G16B16A16_SSCALED = 94,
-	TIF_VK_FORMAT_R16G16B16A16_UINT = 95,
-	TIF_VK_FORMAT_R16G16B16A16_SINT = 96,
-	TIF_VK_FORMAT_R16G16B16A16_SFLOAT = 97,
-	TIF_VK_FORMAT_R32_UINT = 98,
-	TIF_VK_FORMAT_R32_SINT = 99,
-	TIF_VK_FORMAT_R32_SFLOAT = 100,
-	TIF_VK_FORMAT_R32G32_UINT = 101,
-	TIF_VK_FORMAT_R32G32_SINT = 102,
-	TIF_VK_FORMAT_R32G32_SFLOAT = 103,
-	TIF_VK_FORMAT_R32G32B32_UINT = 104,
-	TIF_VK_FORMAT_R32G32B32_SINT = 105,
-	TIF_VK_FORMAT_R32G32B32_SFLOAT = 106,
-	TIF_VK_FORMAT_R32G32B32A32_UINT = 107,
-	TIF_VK_FORMAT_R32G32B32A32_SINT = 108,
-	TIF_VK_FORMAT_R32G32B32A32_SFLOAT = 109,
-	TIF_VK_FORMAT_R64_UINT = 110,
-	TIF_VK_FORMAT_R64_SINT = 111,
-	TIF_VK_FORMAT_R64_SFLOAT = 112,
-	TIF_VK_FORMAT_R64G64_UINT = 113,
-	TIF_VK_FORMAT_R64G64_SINT = 114,
-	TIF_VK_FORMAT_R64G64_SFLOAT = 115,
-	TIF_VK_FORMAT_R64G64B64_UINT = 116,
-	TIF_VK_FORMAT_R64G64B64_SINT = 117,
-	TIF_VK_FORMAT_R64G64B64_SFLOAT = 118,
-	TIF_VK_FORMAT_R64G64B64A64_UINT = 119,
-	TIF_VK_FORMAT_R64G64B64A64_SINT = 120,
-	TIF_VK_FORMAT_R64G64B64A64_SFLOAT = 121,
-	TIF_VK_FORMAT_B10G11R11_UFLOAT_PACK32 = 122,
-	TIF_VK_FORMAT_E5B9G9R9_UFLOAT_PACK32 = 123,
-	TIF_VK_FORMAT_D16_UNORM = 124,
-	TIF_VK_FORMAT_X8_D24_UNORM_PACK32 = 125,
-	TIF_VK_FORMAT_D32_SFLOAT = 126,
-	TIF_VK_FORMAT_S8_UINT = 127,
-	TIF_VK_FORMAT_D16_UNORM_S8_UINT = 128,
-	TIF_VK_FORMAT_D24_UNORM_S8_UINT = 129,
-	TIF_VK_FORMAT_D32_SFLOAT_S8_UINT = 130,
-	TIF_VK_FORMAT_BC1_RGB_UNORM_BLOCK = 131,
-	TIF_VK_FORMAT_BC1_RGB_SRGB_BLOCK = 132,
-	TIF_VK_FORMAT_BC1_RGBA_UNORM_BLOCK = 133,
-	TIF_VK_FORMAT_BC1_RGBA_SRGB_BLOCK = 134,
-	TIF_VK_FORMAT_BC2_UNORM_BLOCK = 135,
-	TIF_VK_FORMAT_BC2_SRGB_BLOCK = 136,
-	TIF_VK_FORMAT_BC3_UNORM_BLOCK = 137,
-	TIF_VK_FORMAT_BC3_SRGB_BLOCK = 138,
-	TIF_VK_FORMAT_BC4_UNORM_BLOCK = 139,
-	TIF_VK_FORMAT_BC4_SNORM_BLOCK = 140,
-	TIF_VK_FORMAT_BC5_UNORM_BLOCK = 141,
-	TIF_VK_FORMAT_BC5_SNORM_BLOCK = 142,
-	TIF_VK_FORMAT_BC6H_UFLOAT_BLOCK = 143,
-	TIF_VK_FORMAT_BC6H_SFLOAT_BLOCK = 144,
-	TIF_VK_FORMAT_BC7_UNORM_BLOCK = 145,
-	TIF_VK_FORMAT_BC7_SRGB_BLOCK = 146,
-	TIF_VK_FORMAT_ETC2_R8G8B8_UNORM_BLOCK = 147,
-	TIF_VK_FORMAT_ETC2_R8G8B8_SRGB_BLOCK = 148,
-	TIF_VK_FORMAT_ETC2_R8G8B8A1_UNORM_BLOCK = 149,
-	TIF_VK_FORMAT_ETC2_R8G8B8A1_SRGB_BLOCK = 150,
-	TIF_VK_FORMAT_ETC2_R8G8B8A8_UNORM_BLOCK = 151,
-	TIF_VK_FORMAT_ETC2_R8G8B8A8_SRGB_BLOCK = 152,
-	TIF_VK_FORMAT_EAC_R11_UNORM_BLOCK = 153,
-	TIF_VK_FORMAT_EAC_R11_SNORM_BLOCK = 154,
-	TIF_VK_FORMAT_EAC_R11G11_UNORM_BLOCK = 155,
-	TIF_VK_FORMAT_EAC_R11G11_SNORM_BLOCK = 156,
-	TIF_VK_FORMAT_ASTC_4x4_UNORM_BLOCK = 157,
-	TIF_VK_FORMAT_ASTC_4x4_SRGB_BLOCK = 158,
-	TIF_VK_FORMAT_ASTC_5x4_UNORM_BLOCK = 159,
-	TIF_VK_FORMAT_ASTC_5x4_SRGB_BLOCK = 160,
-	TIF_VK_FORMAT_ASTC_5x5_UNORM_BLOCK = 161,
-	TIF_VK_FORMAT_ASTC_5x5_SRGB_BLOCK = 162,
-	TIF_VK_FORMAT_ASTC_6x5_UNORM_BLOCK = 163,
-	TIF_VK_FORMAT_ASTC_6x5_SRGB_BLOCK = 164,
-	TIF_VK_FORMAT_ASTC_6x6_UNORM_BLOCK = 165,
-	TIF_VK_FORMAT_ASTC_6x6_SRGB_BLOCK = 166,
-	TIF_VK_FORMAT_ASTC_8x5_UNORM_BLOCK = 167,
-	TIF_VK_FORMAT_ASTC_8x5_SRGB_BLOCK = 168,
-	TIF_VK_FORMAT_ASTC_8x6_UNORM_BLOCK = 169,
-	TIF_VK_FORMAT_ASTC_8x6_SRGB_BLOCK = 170,
-	TIF_VK_FORMAT_ASTC_8x8_UNORM_BLOCK = 171,
-	TIF_VK_FORMAT_ASTC_8x8_SRGB_BLOCK = 172,
-	TIF_VK_FORMAT_ASTC_10x5_UNORM_BLOCK = 173,
-	TIF_VK_FORMAT_ASTC_10x5_SRGB_BLOCK = 174,
-	TIF_VK_FORMAT_ASTC_10x6_UNORM_BLOCK = 175,
-	TIF_VK_FORMAT_ASTC_10x6_SRGB_BLOCK = 176,
-	TIF_VK_FORMAT_ASTC_10x8_UNORM_BLOCK = 177,
-	TIF_VK_FORMAT_ASTC_10x8_SRGB_BLOCK = 178,
-	TIF_VK_FORMAT_ASTC_10x10_UNORM_BLOCK = 179,
-	TIF_VK_FORMAT_ASTC_10x10_SRGB_BLOCK = 180,
-	TIF_VK_FORMAT_ASTC_12x10_UNORM_BLOCK = 181,
-	TIF_VK_FORMAT_ASTC_12x10_SRGB_BLOCK = 182,
-	TIF_VK_FORMAT_ASTC_12x12_UNORM_BLOCK = 183,
-	TIF_VK_FORMAT_ASTC_12x12_SRGB_BLOCK = 184,
-
-	TIF_VK_FORMAT_G8B8G8R8_422_UNORM = 1000156000,
-	TIF_VK_FORMAT_B8G8R8G8_422_UNORM = 1000156001,
-	TIF_VK_FORMAT_G8_B8_R8_3PLANE_420_UNORM = 1000156002,
-	TIF_VK_FORMAT_G8_B8R8_2PLANE_420_UNORM = 1000156003,
-	TIF_VK_FORMAT_G8_B8_R8_3PLANE_422_UNORM = 1000156004,
-	TIF_VK_FORMAT_G8_B8R8_2PLANE_422_UNORM = 1000156005,
-	TIF_VK_FORMAT_G8_B8_R8_3PLANE_444_UNORM = 1000156006,
-	TIF_VK_FORMAT_R10X6_UNORM_PACK16 = 1000156007,
-	TIF_VK_FORMAT_R10X6G10X6_UNORM_2PACK16 = 1000156008,
-	TIF_VK_FORMAT_R10X6G10X6B10X6A10X6_UNORM_4PACK16 = 1000156009,
-	TIF_VK_FORMAT_G10X6B10X6G10X6R10X6_422_UNORM_4PACK16 = 1000156010,
-	TIF_VK_FORMAT_B10X6G10X6R10X6G10X6_422_UNORM_4PACK16 = 1000156011,
-	TIF_VK_FORMAT_G10X6_B10X6_R10X6_3PLANE_420_UNORM_3PACK16 = 1000156012,
-	TIF_VK_FORMAT_G10X6_B10X6R10X6_2PLANE_420_UNORM_3PACK16 = 1000156013,
-	TIF_VK_FORMAT_G10X6_B10X6_R10X6_3PLANE_422_UNORM_3PACK16 = 1000156014,
-	TIF_VK_FORMAT_G10X6_B10X6R10X6_2PLANE_422_UNORM_3PACK16 = 1000156015,
-	TIF_VK_FORMAT_G10X6_B10X6_R10X6_3PLANE_444_UNORM_3PACK16 = 1000156016,
-	TIF_VK_FORMAT_R12X4_UNORM_PACK16 = 1000156017,
-	TIF_VK_FORMAT_R12X4G12X4_UNORM_2PACK16 = 1000156018,
-	TIF_VK_FORMAT_R12X4G12X4B12X4A12X4_UNORM_4PACK16 = 1000156019,
-	TIF_VK_FORMAT_G12X4B12X4G12X4R12X4_422_UNORM_4PACK16 = 1000156020,
-	TIF_VK_FORMAT_B12X4G12X4R12X4G12X4_422_UNORM_4PACK16 = 1000156021,
-	TIF_VK_FORMAT_G12X4_B12X4_R12X4_3PLANE_420_UNORM_3PACK16 = 1000156022,
-	TIF_VK_FORMAT_G12X4_B12X4R12X4_2PLANE_420_UNORM_3PACK16 = 1000156023,
-	TIF_VK_FORMAT_G12X4_B12X4_R12X4_3PLANE_422_UNORM_3PACK16 = 1000156024,
-	TIF_VK_FORMAT_G12X4_B12X4R12X4_2PLANE_422_UNORM_3PACK16 = 1000156025,
-	TIF_VK_FORMAT_G12X4_B12X4_R12X4_3PLANE_444_UNORM_3PACK16 = 1000156026,
-	TIF_VK_FORMAT_G16B16G16R16_422_UNORM = 1000156027,
-	TIF_VK_FORMAT_B16G16R16G16_422_UNORM = 1000156028,
-	TIF_VK_FORMAT_G16_B16_R16_3PLANE_420_UNORM = 1000156029,
-	TIF_VK_FORMAT_G16_B16R16_2PLANE_420_UNORM = 1000156030,
-	TIF_VK_FORMAT_G16_B16_R16_3PLANE_422_UNORM = 1000156031,
-	TIF_VK_FORMAT_G16_B16R16_2PLANE_422_UNORM = 1000156032,
-	TIF_VK_FORMAT_G16_B16_R16_3PLANE_444_UNORM = 1000156033,
-	TIF_VK_FORMAT_PVRTC1_2BPP_UNORM_BLOCK_IMG = 1000054000,
-	TIF_VK_FORMAT_PVRTC1_4BPP_UNORM_BLOCK_IMG = 1000054001,
-	TIF_VK_FORMAT_PVRTC2_2BPP_UNORM_BLOCK_IMG = 1000054002,
-	TIF_VK_FORMAT_PVRTC2_4BPP_UNORM_BLOCK_IMG = 1000054003,
-	TIF_VK_FORMAT_PVRTC1_2BPP_SRGB_BLOCK_IMG = 1000054004,
-	TIF_VK_FORMAT_PVRTC1_4BPP_SRGB_BLOCK_IMG = 1000054005,
-	TIF_VK_FORMAT_PVRTC2_2BPP_SRGB_BLOCK_IMG = 1000054006,
-	TIF_VK_FORMAT_PVRTC2_4BPP_SRGB_BLOCK_IMG = 1000054007,
-} TinyKTX_VkFormat;
-
-#define TINYKTX_MEV(x) TKTX_##x = TIF_VK_FORMAT_##x
-typedef enum TinyKtx_Format {
-	TINYKTX_MEV(UNDEFINED),
-	TINYKTX_MEV(R4G4_UNORM_PACK8),
-	TINYKTX_MEV(R4G4B4A4_UNORM_PACK16),
-	TINYKTX_MEV(B4G4R4A4_UNORM_PACK16),
-	TINYKTX_MEV(R5G6B5_UNORM_PACK16),
-	TINYKTX_MEV(B5G6R5_UNORM_PACK16),
-	TINYKTX_MEV(R5G5B5A1_UNORM_PACK16),
-	TINYKTX_MEV(B5G5R5A1_UNORM_PACK16),
-	TINYKTX_MEV(A1R5G5B5_UNORM_PACK16),
-
-	TINYKTX_MEV(R8_UNORM),
-	TINYKTX_MEV(R8_SNORM),
-	TINYKTX_MEV(R8_UINT),
-	TINYKTX_MEV(R8_SINT),
-	TINYKTX_MEV(R8_SRGB),
-
-	TINYKTX_MEV(R8G8_UNORM),
-	TINYKTX_MEV(R8G8_SNORM),
-	TINYKTX_MEV(R8G8_UINT),
-	TINYKTX_MEV(R8G8_SINT),
-	TINYKTX_MEV(R8G8_SRGB),
-
-	TINYKTX_MEV(R8G8B8_UNORM),
-	TINYKTX_MEV(R8G8B8_SNORM),
-	TINYKTX_MEV(R8G8B8_UINT),
-	TINYKTX_MEV(R8G8B8_SINT),
-	TINYKTX_MEV(R8G8B8_SRGB),
-	TINYKTX_MEV(B8G8R8_UNORM),
-	TINYKTX_MEV(B8G8R8_SNORM),
-	TINYKTX_MEV(B8G8R8_UINT),
-	TINYKTX_MEV(B8G8R8_SINT),
-	TINYKTX_MEV(B8G8R8_SRGB),
-
-	TINYKTX_MEV(R8G8B8A8_UNORM),
-	TINYKTX_MEV(R8G8B8A8_SNORM),
-	TINYKTX_MEV(R8G8B8A8_UINT),
-	TINYKTX_MEV(R8G8B8A8_SINT),
-	TINYKTX_MEV(R8G8B8A8_SRGB),
-	TINYKTX_MEV(B8G8R8A8_UNORM),
-	TINYKTX_MEV(B8G8R8A8_SNORM),
-	TINYKTX_MEV(B8G8R8A8_UINT),
-	TINYKTX_MEV(B8G8R8A8_SINT),
-	TINYKTX_MEV(B8G8R8A8_SRGB),
-
-	TINYKTX_MEV(A8B8G8R8_UNORM_PACK32),
-	TINYKTX_MEV(A8B8G8R8_SNORM_PACK32),
-	TINYKTX_MEV(A8B8G8R8_UINT_PACK32),
-	TINYKTX_MEV(A8B8G8R8_SINT_PACK32),
-	TINYKTX_MEV(A8B8G8R8_SRGB_PACK32),
-
-	TINYKTX_MEV(E5B9G9R9_UFLOAT_PACK32),
-	TINYKTX_MEV(A2R10G10B10_UNORM_PACK32),
-	TINYKTX_MEV(A2R10G10B10_UINT_PACK32),
-	TINYKTX_MEV(A2B10G10R10_UNORM_PACK32),
-	TINYKTX_MEV(A2B10G10R10_UINT_PACK32),
-	TINYKTX_MEV(B10G11R11_UFLOAT_PACK32),
-
-	TINYKTX_MEV(R16_UNORM),
-	TINYKTX_MEV(R16_SNORM),
-	TINYKTX_MEV(R16_UINT),
-	TINYKTX_MEV(R16_SINT),
-	TINYKTX_MEV(R16_SFLOAT),
-	TINYKTX_MEV(R16G16_UNORM),
-	TINYKTX_MEV(R16G16_SNORM),
-	TINYKTX_MEV(R16G16_UINT),
-	TINYKTX_MEV(R16G16_SINT),
-	TINYKTX_MEV(R16G16_SFLOAT),
-	TINYKTX_MEV(R16G16B16_UNORM),
-	TINYKTX_MEV(R16G16B16_SNORM),
-	TINYKTX_MEV(R16G16B16_UINT),
-	TINYKTX_MEV(R16G16B16_SINT),
-	TINYKTX_MEV(R16G16B16_SFLOAT),
-	TINYKTX_MEV(R16G16B16A16_UNORM),
-	TINYKTX_MEV(R16G16B16A16_SNORM),
-	TINYKTX_MEV(R16G16B16A16_UINT),
-	TINYKTX_MEV(R16G16B16A16_SINT),
-	TINYKTX_MEV(R16G16B16A16_SFLOAT),
-	TINYKTX_MEV(R32_UINT),
-	TINYKTX_MEV(R32_SINT),
-	TINYKTX_MEV(R32_SFLOAT),
-	TINYKTX_MEV(R32G32_UINT),
-	TINYKTX_MEV(R32G32_SINT),
-	TINYKTX_MEV(R32G32_SFLOAT),
-	TINYKTX_MEV(R32G32B32_UINT),
-	TINYKTX_MEV(R32G32B32_SINT),
-	TINYKTX_MEV(R32G32B32_SFLOAT),
-	TINYKTX_MEV(R32G32B32A32_UINT),
-	TINYKTX_MEV(R32G32B32A32_SINT),
-	TINYKTX_MEV(R32G32B32A32_SFLOAT),
-
-	TINYKTX_MEV(BC1_RGB_UNORM_BLOCK),
-	TINYKTX_MEV(BC1_RGB_SRGB_BLOCK),
-	TINYKTX_MEV(BC1_RGBA_UNORM_BLOCK),
-	TINYKTX_MEV(BC1_RGBA_SRGB_BLOCK),
-	TINYKTX_MEV(BC2_UNORM_BLOCK),
-	TINYKTX_MEV(BC2_SRGB_BLOCK),
-	TINYKTX_MEV(BC3_UNORM_BLOCK),
-	TINYKTX_MEV(BC3_SRGB_BLOCK),
-	TINYKTX_MEV(BC4_UNORM_BLOCK),
-	TINYKTX_MEV(BC4_SNORM_BLOCK),
-	TINYKTX_MEV(BC5_UNORM_BLOCK),
-	TINYKTX_MEV(BC5_SNORM_BLOCK),
-	TINYKTX_MEV(BC6H_UFLOAT_BLOCK),
-	TINYKTX_MEV(BC6H_SFLOAT_BLOCK),
-	TINYKTX_MEV(BC7_UNORM_BLOCK),
-	TINYKTX_MEV(BC7_SRGB_BLOCK),
-
-	TINYKTX_MEV(ETC2_R8G8B8_UNORM_BLOCK),
-	TINYKTX_MEV(ETC2_R8G8B8A1_UNORM_BLOCK),
-	TINYKTX_MEV(ETC2_R8G8B8A8_UNORM_BLOCK),
-	TINYKTX_MEV(ETC2_R8G8B8_SRGB_BLOCK),
-	TINYKTX_MEV(ETC2_R8G8B8A1_SRGB_BLOCK),
-	TINYKTX_MEV(ETC2_R8G8B8A8_SRGB_BLOCK),
-	TINYKTX_MEV(EAC_R11_UNORM_BLOCK),
-	TINYKTX_MEV(EAC_R11G11_UNORM_BLOCK),
-	TINYKTX_MEV(EAC_R11_SNORM_BLOCK),
-	TINYKTX_MEV(EAC_R11G11_SNORM_BLOCK),
-
-	TKTX_PVR_2BPP_BLOCK = TIF_VK_FORMAT_PVRTC1_2BPP_UNORM_BLOCK_IMG,
-	TKTX_PVR_2BPPA_BLOCK = TIF_VK_FORMAT_PVRTC2_2BPP_UNORM_BLOCK_IMG,
-	TKTX_PVR_4BPP_BLOCK = TIF_VK_FORMAT_PVRTC1_4BPP_UNORM_BLOCK_IMG,
-	TKTX_PVR_4BPPA_BLOCK = TIF_VK_FORMAT_PVRTC2_4BPP_UNORM_BLOCK_IMG,
-	TKTX_PVR_2BPP_SRGB_BLOCK = TIF_VK_FORMAT_PVRTC1_2BPP_SRGB_BLOCK_IMG,
-	TKTX_PVR_2BPPA_SRGB_BLOCK = TIF_VK_FORMAT_PVRTC2_2BPP_SRGB_BLOCK_IMG,
-	TKTX_PVR_4BPP_SRGB_BLOCK = TIF_VK_FORMAT_PVRTC1_4BPP_SRGB_BLOCK_IMG,
-	TKTX_PVR_4BPPA_SRGB_BLOCK = TIF_VK_FORMAT_PVRTC2_4BPP_SRGB_BLOCK_IMG,
-
-	TINYKTX_MEV(ASTC_4x4_UNORM_BLOCK),
-	TINYKTX_MEV(ASTC_4x4_SRGB_BLOCK),
-	TINYKTX_MEV(ASTC_5x4_UNORM_BLOCK),
-	TINYKTX_MEV(ASTC_5x4_SRGB_BLOCK),
-	TINYKTX_MEV(ASTC_5x5_UNORM_BLOCK),
-	TINYKTX_MEV(ASTC_5x5_SRGB_BLOCK),
-	TINYKTX_MEV(ASTC_6x5_UNORM_BLOCK),
-	TINYKTX_MEV(ASTC_6x5_SRGB_BLOCK),
-	TINYKTX_MEV(ASTC_6x6_UNORM_BLOCK),
-	TINYKTX_MEV(ASTC_6x6_SRGB_BLOCK),
-	TINYKTX_MEV(ASTC_8x5_UNORM_BLOCK),
-	TINYKTX_MEV(ASTC_8x5_SRGB_BLOCK),
-	TINYKTX_MEV(ASTC_8x6_UNORM_BLOCK),
-	TINYKTX_MEV(ASTC_8x6_SRGB_BLOCK),
-	TINYKTX_MEV(ASTC_8x8_UNORM_BLOCK),
-	TINYKTX_MEV(ASTC_8x8_SRGB_BLOCK),
-	TINYKTX_MEV(ASTC_10x5_UNORM_BLOCK),
-	TINYKTX_MEV(ASTC_10x5_SRGB_BLOCK),
-	TINYKTX_MEV(ASTC_10x6_UNORM_BLOCK),
-	TINYKTX_MEV(ASTC_10x6_SRGB_BLOCK),
-	TINYKTX_MEV(ASTC_10x8_UNORM_BLOCK),
-	TINYKTX_MEV(ASTC_10x8_SRGB_BLOCK),
-	TINYKTX_MEV(ASTC_10x10_UNORM_BLOCK),
-	TINYKTX_MEV(ASTC_10x10_SRGB_BLOCK),
-	TINYKTX_MEV(ASTC_12x10_UNORM_BLOCK),
-	TINYKTX_MEV(ASTC_12x10_SRGB_BLOCK),
-	TINYKTX_MEV(ASTC_12x12_UNORM_BLOCK),
-	TINYKTX_MEV(ASTC_12x12_SRGB_BLOCK),
-
-} TinyKtx_Format;
-#undef TINYKTX_MEV
-
-#define TINYKTX_DEFINED
-#endif
-
-TinyKtx_Format TinyKtx_GetFormat(TinyKtx2_ContextHandle handle);
+													 void *user,
+													 uint32_t width,
+													 uint32_t height,
+													 uint32_t depth,
+													 uint32_t slices,
+													 uint32_t mipmaplevels,
+													 uint32_t format,
+													 uint32_t internalFormat,
+													 uint32_t baseFormat,
+													 uint32_t type,
+													 uint32_t typeSize,
+													 bool cubemap,
+													 uint32_t const *mipmapsizes,
+													 void const **mipmaps);
+
+// Ktx v2 is based on VkFormat and also DFD, TinyKtx_Format enumeration values
+// are the Vkformat values where possible (see tinyktx.h)
+
+// VK_FORMAT_UNDEFINED files return the format their DFD describes, if there is one
+TinyKtx_Format TinyKtx2_GetFormat(TinyKtx2_ContextHandle handle);
+// KTX v2 data is always tightly packed, mipmapsizes can be NULL to have them computed
+// (see TinyKtx_ComputeMipmapSizes). Provided sizes must match exactly
 bool TinyKtx2_WriteImage(TinyKtx2_WriteCallbacks const *callbacks,
-												void *user,
-												uint32_t width,
-												uint32_t height,
-												uint32_t depth,
-												uint32_t slices,
-												uint32_t mipmaplevels,
-												TinyKtx_Format format,
-												bool cubemap,
-												uint32_t const *mipmapsizes,
-												void const **mipmaps);
+												 void *user,
+												 uint32_t width,
+												 uint32_t height,
+												 uint32_t depth,
+												 uint32_t slices,
+												 uint32_t mipmaplevels,
+												 TinyKtx_Format format,
+												 bool cubemap,
+												 uint32_t const *mipmapsizes,
+												 void const **mipmaps);
+// same as TinyKtx2_WriteImage but takes a pointer per slice/face instead of per level
+// faces is a [mipmaplevel][slice][face] table, faces[(mipmaplevel * slices + slice) * faceCount + face]
+// with faceCount 6 for cubemaps else 1 (slices of 0 counts as 1).
+// mipmapsizes are still the size of the whole level (all slices and faces) or NULL
+bool TinyKtx2_WriteImageFaces(TinyKtx2_WriteCallbacks const *callbacks,
+															void *user,
+															uint32_t width,
+															uint32_t height,
+															uint32_t depth,
+															uint32_t slices,
+															uint32_t mipmaplevels,
+															TinyKtx_Format format,
+															bool cubemap,
+															uint32_t const *mipmapsizes,
+															void const **faces);
+
+// Like ktx v1 the file layout is known before any image data is written, the positional
+// writer computes it once and then levels (or faces) can be written in any order from
+// multiple threads via pwrite. TinyKtx2_WriteHeaderPositional writes the header, level index,
+// DFD and all the padding between levels. Like TinyKtx2_WriteImage no key/value data is written.
+typedef struct TinyKtx2_WriteLevelLayout {
+	uint64_t byteOffset;			// file offset of this level
+	uint64_t byteLength;			// bytes of all slices/faces of this level
+	uint64_t faceByteLength;	// bytes of one slice/face
+} TinyKtx2_WriteLevelLayout;
+
+typedef struct TinyKtx2_WriteLayout {
+	TinyKtx_Format format;
+	uint32_t width;
+	uint32_t height;
+	uint32_t depth;
+	uint32_t slices;
+	uint32_t faces;
+	uint32_t mipmaplevels;
+	uint32_t dfdByteOffset;
+	uint32_t dfdByteLength;
+	uint64_t totalByteLength;
+	TinyKtx2_WriteLevelLayout levels[TINYKTX2_MAX_MIPMAPLEVELS];
+} TinyKtx2_WriteLayout;
+
+bool TinyKtx2_ComputeWriteLayout(TinyKtx2_WriteCallbacks const *callbacks,
+																 void *user,
+																 uint32_t width,
+																 uint32_t height,
+																 uint32_t depth,
+																 uint32_t slices,
+																 uint32_t mipmaplevels,
+																 TinyKtx_Format format,
+																 bool cubemap,
+																 uint32_t const *mipmapsizes,
+																 TinyKtx2_WriteLayout *layout);
+// same with 64 bit mipmapsizes (or NULL) for levels of 4GB or more
+bool TinyKtx2_ComputeWriteLayout64(TinyKtx2_WriteCallbacks const *callbacks,
+																	 void *user,
+																	 uint32_t width,
+																	 uint32_t height,
+																	 uint32_t depth,
+																	 uint32_t slices,
+																	 uint32_t mipmaplevels,
+																	 TinyKtx_Format format,
+																	 bool cubemap,
+																	 uint64_t const *mipmapsizes,
+																	 TinyKtx2_WriteLayout *layout);
+
+// writes everything except the image data itself
+bool TinyKtx2_WriteHeaderPositional(TinyKtx2_WriteCallbacks const *callbacks,
+																		void *user,
+																		TinyKtx2_WriteLayout const *layout);
+// writes all slices/faces of a level, thread safe as long as pwrite is
+bool TinyKtx2_WriteLevelPositional(TinyKtx2_WriteCallbacks const *callbacks,
+																	 void *user,
+																	 TinyKtx2_WriteLayout const *layout,
+																	 uint32_t mipmaplevel,
+																	 void const *data);
+// writes a single slice/face of a level, data is faceByteLength bytes
+bool TinyKtx2_WriteFacePositional(TinyKtx2_WriteCallbacks const *callbacks,
+																	void *user,
+																	TinyKtx2_WriteLayout const *layout,
+																	uint32_t mipmaplevel,
+																	uint32_t slice,
+																	uint32_t face,
+																	void const *data);
+
+// Rewrite a single level or slice/face of an existing file. handle must have read the header
+// of the file being updated. Data of the same size is written in place via pwrite, which must
+// write to that same file: offsets are positions in the stream the read callbacks see, so a KTX
+// that doesn't start at offset 0 (embedded in a larger file) is updated where it is.
+// Only supercompressed levels can change size, then the whole file is streamed via write to a
+// new destination with an updated level index, everything else is copied from the source file.
+// Any data previously returned by TinyKtx2_ImageRawData for the level is released
+bool TinyKtx2_UpdateLevel(TinyKtx2_ContextHandle handle,
+													TinyKtx2_WriteCallbacks const *callbacks,
+													void *user,
+													uint32_t mipmaplevel,
+													void const *data,
+													uint64_t byteLength,
+													uint64_t uncompressedByteLength);
+// in place only, not valid for supercompressed files
+bool TinyKtx2_UpdateFace(TinyKtx2_ContextHandle handle,
+												 TinyKtx2_WriteCallbacks const *callbacks,
+												 void *user,
+												 uint32_t mipmaplevel,
+												 uint32_t slice,
+												 uint32_t face,
+												 void const *data,
+												 uint64_t byteLength);
+
+// compresses srcSize bytes of src into a buffer allocated with the write callbacks alloc
+typedef bool (*TinyKtx2_SuperCompress)(void *user, void const *src, size_t srcSize, void **dst, size_t *dstSize);
+
+// Converts a KTX v1 file to KTX v2 one level at a time, so at most one level (plus its repacked
+// copy if the v1 data has row or cube padding) is held in memory. ktx1 must have read its header.
+// The format is mapped via TinyKtx_CrackFormatFromGL and the output is written via pwrite.
+// If compressor isn't NULL each level is supercompressed with it and tagged as scheme
+bool TinyKtx2_ConvertFromKtx1(TinyKtx_ContextHandle ktx1,
+															TinyKtx2_WriteCallbacks const *callbacks,
+															void *user,
+															TinyKtx2_SuperCompressionScheme scheme,
+															TinyKtx2_SuperCompress compressor);
 
 #ifdef TINYKTX2_IMPLEMENTATION
 
+#ifdef TINYKTX2_HAVE_ZLIB
+#include <zlib.h>
+#endif
+#ifdef TINYKTX2_HAVE_ZSTD
+#include <zstd.h>
+#endif
+
 typedef struct TinyKtx2_KeyValuePair {
 	uint32_t size;
 } TinyKtx2_KeyValuePair; // followed by at least size bytes (aligned to 4)
@@ -544,6 +486,7 @@ typedef struct TinyKtx2_KeyValuePair {
 typedef struct TinyKtx2_HeaderV2 {
 	uint8_t identifier[12];
 	TinyKtx_Format vkFormat;
+	uint32_t typeSize;
 	uint32_t pixelWidth;
 	uint32_t pixelHeight;
 	uint32_t pixelDepth;
@@ -566,37 +509,105 @@ typedef struct TinyKtx2_Level {
 	uint64_t uncompressedByteLength;
 } TinyKtx2_Level;
 
-typedef enum TinyKtx2_SuperCompressionScheme {
-	TKTX2_SUPERCOMPRESSION_NONE = 0,
-	TKTX2_SUPERCOMPRESSION_CRN = 1,
-	TKTX2_SUPERCOMPRESSION_ZLIB = 2,
-	TKTX2_SUPERCOMPRESSION_ZSTD = 3,
-} TinyKtx2_SuperCompressionScheme;
+// built in decoder state, one per decode task so parallel decodes never share one
+typedef struct TinyKtx2_Decoders {
+#ifdef TINYKTX2_HAVE_ZLIB
+	z_stream *zlib[TINYKTX2_MAX_MIPMAPLEVELS];
+#endif
+#ifdef TINYKTX2_HAVE_ZSTD
+	ZSTD_DCtx *zstd[TINYKTX2_MAX_MIPMAPLEVELS];
+#endif
+	// streaming state of the built in decoders (always slot 0)
+	uint8_t *streamDst;
+	size_t streamDstLeft;
+	bool streamEnded;
+} TinyKtx2_Decoders;
 
 typedef struct TinyKtx2_Context {
 	TinyKtx2_Callbacks callbacks;
 	void *user;
 	uint64_t headerPos;
 	uint64_t firstImagePos;
+	uint64_t streamPos;								// survives reset, for streams without tell
 
 	TinyKtx2_Header header;
 
-	TinyKtx2_KeyValuePair const *keyData;
+	uint8_t const *metaData;					// level index, dfd and kvd in one block
+	uint32_t const *dfd;
+	uint8_t const *keyData;
+	TinyKtx2_TexelLayout texelLayout;
+	TinyKtx_Format format;						// vkFormat or the format the DFD describes
 	bool headerValid;
 	bool sameEndian;
-	void* sgdData;
+	void const *sgdData;							// sgdBuffer, shared or user provided
+	uint64_t sgdKey;
+	bool sgdKeyValid;
 
-	TinyKtx2_Level levels[TINYKTX_MAX_MIPMAPLEVELS];
-	uint8_t const *mipmaps[TINYKTX_MAX_MIPMAPLEVELS];
+	TinyKtx2_Level levels[TINYKTX2_MAX_MIPMAPLEVELS];
+	uint8_t const *mipmaps[TINYKTX2_MAX_MIPMAPLEVELS];
 
+	TinyKtx2_Decoders decoders; // survives reset
+	uint8_t *sgdBuffer;					// survives reset
+	size_t sgdBufferSize;
 } TinyKtx2_Context;
 
+// data format descriptor (DFD) basic block, enough to describe every TinyKtx_Format
+#define TINYKTX2_DFD_MAX_SAMPLES 6
+#define TINYKTX2_DFD_MAX_WORDS (1 + 6 + (4 * TINYKTX2_DFD_MAX_SAMPLES))
+
+typedef enum TinyKtx2_DfdNumeric {
+	TKTX2_DFD_UNORM,
+	TKTX2_DFD_SNORM,
+	TKTX2_DFD_UINT,
+	TKTX2_DFD_SINT,
+	TKTX2_DFD_UFLOAT,
+	TKTX2_DFD_SFLOAT,
+	TKTX2_DFD_SRGB,
+} TinyKtx2_DfdNumeric;
+
+typedef struct TinyKtx2_DfdChannel {
+	uint8_t channel;
+	uint8_t bitLength;
+	uint16_t bitOffset;
+} TinyKtx2_DfdChannel;
+
+#define TKTX2_DFD_CH_R 0
+#define TKTX2_DFD_CH_G 1
+#define TKTX2_DFD_CH_B 2
+#define TKTX2_DFD_CH_A 15
+#define TKTX2_DFD_CH_COLOR 0		// BCn, ASTC and PVRTC single sample
+#define TKTX2_DFD_CH_BC1_ALPHA 1
+#define TKTX2_DFD_CH_ETC2_COLOR 2
+
+#define TKTX2_DFD_MODEL_RGBSDA 1
+#define TKTX2_DFD_MODEL_BC1A 128
+#define TKTX2_DFD_MODEL_BC2 129
+#define TKTX2_DFD_MODEL_BC3 130
+#define TKTX2_DFD_MODEL_BC4 131
+#define TKTX2_DFD_MODEL_BC5 132
+#define TKTX2_DFD_MODEL_BC6H 133
+#define TKTX2_DFD_MODEL_BC7 134
+#define TKTX2_DFD_MODEL_ETC2 161
+#define TKTX2_DFD_MODEL_ASTC 162
+#define TKTX2_DFD_MODEL_ETC1S 163
+#define TKTX2_DFD_MODEL_PVRTC 164
+#define TKTX2_DFD_MODEL_PVRTC2 165
+#define TKTX2_DFD_MODEL_UASTC 166
+
+#define TKTX2_DFD_QUALIFIER_LINEAR 0x10
+#define TKTX2_DFD_QUALIFIER_EXPONENT 0x20
+#define TKTX2_DFD_QUALIFIER_SIGNED 0x40
+#define TKTX2_DFD_QUALIFIER_FLOAT 0x80
+
 
 static uint8_t TinyKtx2_fileIdentifier[12] = {
 		0xAB, 0x4B, 0x54, 0x58, 0x20, 0x32, 0x30, 0xBB, 0x0D, 0x0A, 0x1A, 0x0A
 };
 
-static void TinyKtx2_NullErrorFunc(void *user, char const *msg) {}
+static void TinyKtx2_NullErrorFunc(void *user, char const *msg) {
+	(void) user;
+	(void) msg;
+}
 
 TinyKtx2_ContextHandle TinyKtx2_CreateContext(TinyKtx2_Callbacks const *callbacks, void *user) {
 	TinyKtx2_Context *ctx = (TinyKtx2_Context *) callbacks->alloc(user, sizeof(TinyKtx2_Context));
@@ -607,7 +618,7 @@ TinyKtx2_ContextHandle TinyKtx2_CreateContext(TinyKtx2_Callbacks const *callback
 	memcpy(&ctx->callbacks, callbacks, sizeof(TinyKtx2_Callbacks));
 	ctx->user = user;
 	if (ctx->callbacks.error == NULL) {
-		ctx->callbacks.error = &TinyKtx_NullErrorFunc;
+		ctx->callbacks.error = &TinyKtx2_NullErrorFunc;
 	}
 
 	if (ctx->callbacks.read == NULL) {
@@ -622,14 +633,6 @@ TinyKtx2_ContextHandle TinyKtx2_CreateContext(TinyKtx2_Callbacks const *callback
 		ctx->callbacks.error(user, "TinyKtx must have free callback");
 		return NULL;
 	}
-	if (ctx->callbacks.seek == NULL) {
-		ctx->callbacks.error(user, "TinyKtx must have seek callback");
-		return NULL;
-	}
-	if (ctx->callbacks.tell == NULL) {
-		ctx->callbacks.error(user, "TinyKtx must have tell callback");
-		return NULL;
-	}
 
 	TinyKtx2_Reset(ctx);
 
@@ -642,6 +645,23 @@ void TinyKtx2_DestroyContext(TinyKtx2_ContextHandle handle) {
 		return;
 	TinyKtx2_Reset(handle);
 
+	for (int i = 0; i < TINYKTX2_MAX_MIPMAPLEVELS; ++i) {
+#ifdef TINYKTX2_HAVE_ZLIB
+		if (ctx->decoders.zlib[i] != NULL) {
+			inflateEnd(ctx->decoders.zlib[i]);
+			ctx->callbacks.free(ctx->user, ctx->decoders.zlib[i]);
+		}
+#endif
+#ifdef TINYKTX2_HAVE_ZSTD
+		if (ctx->decoders.zstd[i] != NULL) {
+			ZSTD_freeDCtx(ctx->decoders.zstd[i]);
+		}
+#endif
+	}
+	if (ctx->sgdBuffer != NULL) {
+		ctx->callbacks.free(ctx->user, ctx->sgdBuffer);
+	}
+
 	ctx->callbacks.free(ctx->user, ctx);
 }
 
@@ -652,41 +672,164 @@ void TinyKtx2_Reset(TinyKtx2_ContextHandle handle) {
 
 	// backup user provided callbacks and data
 	TinyKtx2_Callbacks callbacks;
-	memcpy(&callbacks, &ctx->callbacks, sizeof(TinyKtx_Callbacks));
+	memcpy(&callbacks, &ctx->callbacks, sizeof(TinyKtx2_Callbacks));
 	void *user = ctx->user;
-
-	// free any super compression global data we've allocated
-	if (ctx->sgdData != NULL) {
-		callbacks.free(user, (void *) ctx->sgdData);
-	}
+	TinyKtx2_Decoders decoders;
+	memcpy(&decoders, &ctx->decoders, sizeof(TinyKtx2_Decoders));
+	uint8_t *sgdBuffer = ctx->sgdBuffer;
+	size_t const sgdBufferSize = ctx->sgdBufferSize;
+	uint64_t const streamPos = ctx->streamPos;
 
 	// free memory of sub data
-	if (ctx->keyData != NULL) {
-		callbacks.free(user, (void *) ctx->keyData);
+	if (ctx->metaData != NULL) {
+		callbacks.free(user, (void *) ctx->metaData);
 	}
 
-	for (int i = 0; i < TINYKTX_MAX_MIPMAPLEVELS; ++i) {
+	for (int i = 0; i < TINYKTX2_MAX_MIPMAPLEVELS; ++i) {
 		if (ctx->mipmaps[i] != NULL) {
 			callbacks.free(user, (void *) ctx->mipmaps[i]);
 		}
 	}
 
 	// reset to default state
-	memset(ctx, 0, sizeof(TinyKtx_Context));
-	memcpy(&ctx->callbacks, &callbacks, sizeof(TinyKtx_Callbacks));
+	memset(ctx, 0, sizeof(TinyKtx2_Context));
+	memcpy(&ctx->callbacks, &callbacks, sizeof(TinyKtx2_Callbacks));
 	ctx->user = user;
+	memcpy(&ctx->decoders, &decoders, sizeof(TinyKtx2_Decoders));
+	ctx->sgdBuffer = sgdBuffer;
+	ctx->sgdBufferSize = sgdBufferSize;
+	ctx->streamPos = streamPos;
+}
+
+// all reads go through here so the position is known without tell, reads are split so no
+// single read call is larger than maxChunkSize
+static size_t TinyKtx2_read(TinyKtx2_Context *ctx, void *buffer, size_t byteCount) {
+	size_t const maxChunk = ctx->callbacks.maxChunkSize ? ctx->callbacks.maxChunkSize : byteCount;
+	size_t total = 0;
+	while (total < byteCount) {
+		size_t const size = (byteCount - total < maxChunk) ? byteCount - total : maxChunk;
+		size_t const read = ctx->callbacks.read(ctx->user, (uint8_t *) buffer + total, size);
+		ctx->streamPos += read;
+		total += read;
+		if (read != size)
+			break;
+	}
+	return total;
+}
+
+// whole levels must fit in a single allocation
+static bool TinyKtx2_levelFits(TinyKtx2_Context *ctx, uint64_t byteLength) {
+	if (byteLength > (size_t) -1 || (ctx->callbacks.maxChunkSize && byteLength > ctx->callbacks.maxChunkSize)) {
+		ctx->callbacks.error(ctx->user, "Mipmap level is larger than maxChunkSize, use TinyKtx2_ReadLevelChunks");
+		return false;
+	}
+	return true;
+}
+
+// forward only streams skip forward by reading, going backwards is an error
+static bool TinyKtx2_seek(TinyKtx2_Context *ctx, uint64_t pos) {
+	if (ctx->callbacks.seek != NULL) {
+		if (!ctx->callbacks.seek(ctx->user, (int64_t) pos)) {
+			ctx->callbacks.error(ctx->user, "Seek failed");
+			return false;
+		}
+		ctx->streamPos = pos;
+		return true;
+	}
+	if (pos < ctx->streamPos) {
+		ctx->callbacks.error(ctx->user, "Can't seek backwards in a forward only stream");
+		return false;
+	}
+	uint8_t skip[1024];
+	while (ctx->streamPos < pos) {
+		size_t const size = (pos - ctx->streamPos < sizeof(skip)) ? (size_t) (pos - ctx->streamPos) : sizeof(skip);
+		if (TinyKtx2_read(ctx, skip, size) != size) {
+			ctx->callbacks.error(ctx->user, "Truncated KTX V2 data");
+			return false;
+		}
+	}
+	return true;
+}
 
+
+static uint32_t TinyKtx2_BuildDfd(TinyKtx_Format format, uint32_t dfd[TINYKTX2_DFD_MAX_WORDS]);
+
+// DFDs match if the colour model, transfer function, block and samples match
+static bool TinyKtx2_dfdMatches(uint32_t const *a, uint32_t const *b) {
+	uint32_t const sampleWords = ((a[2] >> 16) - 24) / 4;
+	if ((a[2] >> 16) != (b[2] >> 16) || (a[3] & 0x00FF00FF) != (b[3] & 0x00FF00FF) || a[4] != b[4] || a[5] != b[5])
+		return false;
+	for (uint32_t i = 0; i < sampleWords; i += 4) {
+		// ignore the sample position
+		if (a[7 + i] != b[7 + i] || a[9 + i] != b[9 + i] || a[10 + i] != b[10 + i])
+			return false;
+	}
+	return true;
 }
 
+// fills in the texel layout from the first DFD block, ignores blocks it doesn't understand
+static void TinyKtx2_parseDfd(TinyKtx2_Context *ctx) {
+	TinyKtx2_TexelLayout *layout = &ctx->texelLayout;
+	memset(layout, 0, sizeof(TinyKtx2_TexelLayout));
+	layout->format = ctx->header.vkFormat;
+
+	uint32_t const *dfd = ctx->dfd;
+	uint32_t const blockSize = (ctx->header.dfdByteLength >= 28) ? dfd[2] >> 16 : 0;
+	if (blockSize < 24 || blockSize + 4 > ctx->header.dfdByteLength ||
+			dfd[1] != 0 || (dfd[2] & 0xFFFF) != 2) // khronos basic block version 2
+		return;
+
+	layout->colorModel = (uint8_t) (dfd[3] & 0xFF);
+	layout->colorPrimaries = (uint8_t) ((dfd[3] >> 8) & 0xFF);
+	layout->transferFunction = (uint8_t) ((dfd[3] >> 16) & 0xFF);
+	layout->premultiplied = ((dfd[3] >> 24) & 0x1) != 0;
+	layout->blockWidth = (uint8_t) ((dfd[4] & 0xFF) + 1);
+	layout->blockHeight = (uint8_t) (((dfd[4] >> 8) & 0xFF) + 1);
+	layout->blockDepth = (uint8_t) (((dfd[4] >> 16) & 0xFF) + 1);
+	layout->bytesPerBlock = dfd[5] & 0xFF;
+
+	uint32_t const sampleCount = (blockSize - 24) / 16;
+	for (uint32_t i = 0; i < sampleCount && i < TINYKTX2_MAX_TEXEL_CHANNELS; ++i) {
+		uint32_t const *sample = dfd + 7 + i * 4;
+		TinyKtx2_TexelChannel *channel = &layout->channels[i];
+		channel->bitOffset = (uint16_t) (sample[0] & 0xFFFF);
+		channel->bitLength = (uint16_t) (((sample[0] >> 16) & 0xFF) + 1);
+		channel->channelType = (uint8_t) ((sample[0] >> 24) & 0x0F);
+		channel->qualifiers = (uint8_t) ((sample[0] >> 24) & 0xF0);
+		channel->lower = sample[2];
+		channel->upper = sample[3];
+		layout->channelCount++;
+	}
+
+	// match it to a known format
+	if (layout->format != TKTX_UNDEFINED)
+		return;
+	uint32_t known[TINYKTX2_DFD_MAX_WORDS];
+	for (uint32_t f = TKTX_UNDEFINED + 1; f <= TKTX_ASTC_12x12_SRGB_BLOCK; ++f) {
+		uint32_t const size = TinyKtx2_BuildDfd((TinyKtx_Format) f, known);
+		if (size == blockSize + 4 && TinyKtx2_dfdMatches(dfd, known)) {
+			layout->format = (TinyKtx_Format) f;
+			return;
+		}
+	}
+}
 
-bool TinyKtx2_ReadHeader(TinyKtx_ContextHandle handle) {
+bool TinyKtx2_ReadHeader(TinyKtx2_ContextHandle handle) {
 	TinyKtx2_Context *ctx = (TinyKtx2_Context *) handle;
 	if (ctx == NULL)
 		return false;
+	if (ctx->metaData != NULL) {
+		TinyKtx2_Reset(handle);
+	}
 
-
-	ctx->headerPos = ctx->callbacks.tell(ctx->user);
-	ctx->callbacks.read(ctx->user, &ctx->header, sizeof(TinyKtx2_Header));
+	if (ctx->callbacks.tell != NULL) {
+		ctx->streamPos = (uint64_t) ctx->callbacks.tell(ctx->user);
+	}
+	ctx->headerPos = ctx->streamPos;
+	if (TinyKtx2_read(ctx, &ctx->header, sizeof(TinyKtx2_Header)) != sizeof(TinyKtx2_Header)) {
+		ctx->callbacks.error(ctx->user, "Truncated KTX V2 header");
+		return false;
+	}
 
 	if (memcmp(&ctx->header.identifier, TinyKtx2_fileIdentifier, 12) != 0) {
 		ctx->callbacks.error(ctx->user, "Not a KTX  V2 file or corrupted as identified isn't valid");
@@ -697,21 +840,81 @@ bool TinyKtx2_ReadHeader(TinyKtx_ContextHandle handle) {
 		ctx->callbacks.error(ctx->user, "no. of Faces must be 1 or 6");
 		return false;
 	}
-	// cap level to max
-	if(ctx->header.levelCount >= TINYKTX2_MAX_MIPMAPLEVELS) {
-		ctx->header.levelCount = TINYKTX2_MAX_MIPMAPLEVELS;
+	if (ctx->header.pixelWidth == 0 || (ctx->header.faceCount == 6 && ctx->header.pixelDepth > 1)) {
+		ctx->callbacks.error(ctx->user, "Invalid dimensions");
+		return false;
 	}
+
 	// 0 level count means wants mip maps from the 1 stored
-	uint32_t const levelCount = ctx->header.levelCount ? ctx->header.levelCount : 1;
+	uint32_t const fileLevelCount = ctx->header.levelCount ? ctx->header.levelCount : 1;
+	uint64_t const indexEnd = sizeof(TinyKtx2_Header) + (uint64_t) sizeof(TinyKtx2_Level) * fileLevelCount;
+
+	// the index, dfd and kvd follow the header in that order, fetch them all in one go
+	uint64_t const dfdEnd = (uint64_t) ctx->header.dfdByteOffset + ctx->header.dfdByteLength;
+	uint64_t const kvdEnd = (uint64_t) ctx->header.kvdByteOffset + ctx->header.kvdByteLength;
+	if (ctx->header.dfdByteOffset != indexEnd || ctx->header.dfdByteLength < sizeof(uint32_t) ||
+			(ctx->header.kvdByteLength && ctx->header.kvdByteOffset < dfdEnd)) {
+		ctx->callbacks.error(ctx->user, "Invalid data format descriptor or key/value data position");
+		return false;
+	}
+	uint64_t const metaEnd = (ctx->header.kvdByteLength && kvdEnd > dfdEnd) ? kvdEnd : dfdEnd;
+	if (ctx->header.sgdByteLength && ctx->header.sgdByteOffset < metaEnd) {
+		ctx->callbacks.error(ctx->user, "Invalid supercompression global data position");
+		return false;
+	}
 
-	ctx->callbacks.read(ctx->user, &ctx->levels, sizeof(TinyKtx2_Header) * levelCount);
+	size_t const metaSize = (size_t) (metaEnd - sizeof(TinyKtx2_Header));
+	ctx->metaData = (uint8_t const *) ctx->callbacks.alloc(ctx->user, metaSize);
+	if (ctx->metaData == NULL)
+		return false;
+	if (TinyKtx2_read(ctx, (void *) ctx->metaData, metaSize) != metaSize) {
+		ctx->callbacks.error(ctx->user, "Truncated KTX V2 level index or descriptor");
+		return false;
+	}
+	ctx->dfd = (uint32_t const *) (ctx->metaData + (ctx->header.dfdByteOffset - sizeof(TinyKtx2_Header)));
+	if (ctx->dfd[0] != ctx->header.dfdByteLength) {
+		ctx->callbacks.error(ctx->user, "Data format descriptor size mismatch");
+		return false;
+	}
+	if (ctx->header.kvdByteLength) {
+		ctx->keyData = ctx->metaData + (ctx->header.kvdByteOffset - sizeof(TinyKtx2_Header));
+	}
+	TinyKtx2_parseDfd(ctx);
+	ctx->format = ctx->texelLayout.format;
 
-	if(ctx->header.sgdByteLength > 0) {
-		ctx->sgdData = ctx->callbacks.alloc(ctx->user, ctx->header.sgdByteLength);
-		ctx->callbacks.seek(ctx->user, ctx->header.sgdByteOffset);
-		ctx->callbacks.read(ctx->user, ctx->sgdData, ctx->header.sgdByteLength);
+	// cap level to max
+	if (ctx->header.levelCount > TINYKTX2_MAX_MIPMAPLEVELS) {
+		ctx->header.levelCount = TINYKTX2_MAX_MIPMAPLEVELS;
+	}
+	uint32_t const levelCount = ctx->header.levelCount ? ctx->header.levelCount : 1;
+	memcpy(ctx->levels, ctx->metaData, sizeof(TinyKtx2_Level) * levelCount);
+
+	// when the format is known every level size can be checked up front
+	uint64_t expectedSizes[TINYKTX2_MAX_MIPMAPLEVELS];
+	bool const known = ctx->header.supercompressionScheme != TKTX2_SUPERCOMPRESSION_CRN &&
+			TinyKtx_ComputeMipmapSizes64(ctx->header.pixelWidth, ctx->header.pixelHeight, ctx->header.pixelDepth,
+																 ctx->header.arrayElementCount, levelCount, ctx->format,
+																 ctx->header.faceCount == 6, expectedSizes);
+	uint64_t const dataStart = ctx->header.sgdByteLength ? ctx->header.sgdByteOffset + ctx->header.sgdByteLength : metaEnd;
+	for (uint32_t i = 0u; i < levelCount; ++i) {
+		TinyKtx2_Level const *lvl = &ctx->levels[i];
+		if (lvl->byteOffset < dataStart || lvl->byteOffset + lvl->byteLength < lvl->byteOffset) {
+			ctx->callbacks.error(ctx->user, "Invalid level index");
+			return false;
+		}
+		if (ctx->header.supercompressionScheme == TKTX2_SUPERCOMPRESSION_NONE &&
+				lvl->byteLength != lvl->uncompressedByteLength) {
+			ctx->callbacks.error(ctx->user, "Level has no super compression but compressed and uncompressed sizes are different");
+			return false;
+		}
+		if (known && lvl->uncompressedByteLength != expectedSizes[i]) {
+			ctx->callbacks.error(ctx->user, "Level size doesn't match the format and dimensions");
+			return false;
+		}
 	}
 
+	// supercompression global data is read with the first supercompressed level
+	ctx->headerValid = true;
 	return true;
 }
 
@@ -729,16 +932,22 @@ bool TinyKtx2_GetValue(TinyKtx2_ContextHandle handle, char const *key, void cons
 		return false;
 	}
 
-	TinyKtx2_KeyValuePair const *curKey = ctx->keyData;
-	while (((uint8_t *) curKey - (uint8_t *) ctx->keyData) < ctx->header.bytesOfKeyValueData) {
-		char const *kvp = (char const *) curKey;
-
-		if (strcmp(kvp, key) == 0) {
-			size_t sl = strlen(kvp);
-			*value = (void const *) (kvp + sl);
+	// each entry is a uint32_t size then a null terminated key and the value, padded to 4
+	uint8_t const *cur = ctx->keyData;
+	uint8_t const *const end = ctx->keyData + ctx->header.kvdByteLength;
+	while (cur < end && (size_t) (end - cur) >= sizeof(TinyKtx2_KeyValuePair)) {
+		TinyKtx2_KeyValuePair kvp;
+		memcpy(&kvp, cur, sizeof(TinyKtx2_KeyValuePair));
+		char const *keyValue = (char const *) (cur + sizeof(TinyKtx2_KeyValuePair));
+		if (kvp.size > (size_t) (end - (uint8_t const *) keyValue))
+			break;
+
+		size_t const keyLength = strlen(key);
+		if (keyLength < kvp.size && memcmp(keyValue, key, keyLength + 1) == 0) {
+			*value = (void const *) (keyValue + keyLength + 1);
 			return true;
 		}
-		curKey = curKey + ((curKey->size + 3u) & ~3u);
+		cur = (uint8_t const *) keyValue + ((kvp.size + 3u) & ~3u);
 	}
 	return false;
 }
@@ -753,7 +962,7 @@ bool TinyKtx2_Is1D(TinyKtx2_ContextHandle handle) {
 	}
 	return (ctx->header.pixelHeight <= 1) && (ctx->header.pixelDepth <= 1 );
 }
-bool TinyKtx2_Is2D(TinyKtx_ContextHandle handle) {
+bool TinyKtx2_Is2D(TinyKtx2_ContextHandle handle) {
 	TinyKtx2_Context *ctx = (TinyKtx2_Context *) handle;
 	if (ctx == NULL)
 		return false;
@@ -785,10 +994,10 @@ bool TinyKtx2_IsCubemap(TinyKtx2_ContextHandle handle) {
 		return false;
 	}
 
-	return (ctx->header.numberOfFaces == 6);
+	return (ctx->header.faceCount == 6);
 }
 bool TinyKtx2_IsArray(TinyKtx2_ContextHandle handle) {
-	TinyKtx_Context *ctx = (TinyKtx2_Context *) handle;
+	TinyKtx2_Context *ctx = (TinyKtx2_Context *) handle;
 	if (ctx == NULL)
 		return false;
 	if (ctx->headerValid == false) {
@@ -796,7 +1005,7 @@ bool TinyKtx2_IsArray(TinyKtx2_ContextHandle handle) {
 		return false;
 	}
 
-	return (ctx->header.numberOfArrayElements > 1);
+	return (ctx->header.arrayElementCount > 1);
 }
 
 bool TinyKtx2_Dimensions(TinyKtx2_ContextHandle handle,
@@ -814,11 +1023,11 @@ bool TinyKtx2_Dimensions(TinyKtx2_ContextHandle handle,
 	if (width)
 		*width = ctx->header.pixelWidth;
 	if (height)
-		*height = ctx->header.pixelWidth;
+		*height = ctx->header.pixelHeight;
 	if (depth)
 		*depth = ctx->header.pixelDepth;
 	if (slices)
-		*slices = ctx->header.numberOfArrayElements;
+		*slices = ctx->header.arrayElementCount;
 	return true;
 }
 
@@ -866,7 +1075,7 @@ uint32_t TinyKtx2_ArraySlices(TinyKtx2_ContextHandle handle) {
 		return 0;
 	}
 
-	return ctx->header.numberOfArrayElements;
+	return ctx->header.arrayElementCount;
 }
 
 uint32_t TinyKtx2_NumberOfMipmaps(TinyKtx2_ContextHandle handle) {
@@ -892,143 +1101,1943 @@ bool TinyKtx2_NeedsGenerationOfMipmaps(TinyKtx2_ContextHandle handle) {
 	return ctx->header.levelCount == 0;
 }
 
-uint32_t TinyKtx_ImageSize(TinyKtx_ContextHandle handle, uint32_t mipmaplevel) {
+bool TinyKtx2_NeedsEndianCorrecting(TinyKtx2_ContextHandle handle) {
+	(void) handle;
+	// KTX v2 files are always little endian
+	return false;
+}
+
+bool TinyKtx2_GetFormatGL(TinyKtx2_ContextHandle handle,
+													uint32_t *glformat,
+													uint32_t *gltype,
+													uint32_t *glinternalformat,
+													uint32_t *typesize,
+													uint32_t *glbaseinternalformat) {
 	TinyKtx2_Context *ctx = (TinyKtx2_Context *) handle;
+	if (ctx == NULL)
+		return false;
+	if (ctx->headerValid == false) {
+		ctx->callbacks.error(ctx->user, "Header data hasn't been read yet or its invalid");
+		return false;
+	}
+	if (!TinyKtx_CrackFormatToGL(ctx->format, glformat, gltype, glinternalformat, typesize)) {
+		ctx->callbacks.error(ctx->user, "Format has no GL equivalent");
+		return false;
+	}
+	*glbaseinternalformat = *glinternalformat;
+	return true;
+}
 
-	if (mipmaplevel >= ctx->header.levelCount) {
-		ctx->callbacks.error(ctx->user, "Invalid mipmap level");
-		return 0;
+bool TinyKtx2_IsMipMapLevelUnpacked(TinyKtx2_ContextHandle handle, uint32_t mipmaplevel) {
+	(void) handle;
+	(void) mipmaplevel;
+	// KTX v2 levels are always tightly packed
+	return false;
+}
+
+uint32_t TinyKtx2_UnpackedRowStride(TinyKtx2_ContextHandle handle, uint32_t mipmaplevel) {
+	(void) handle;
+	(void) mipmaplevel;
+	return 0;
+}
+
+bool TinyKtx2_LevelIndex(TinyKtx2_ContextHandle handle,
+												 uint32_t mipmaplevel,
+												 uint64_t *byteOffset,
+												 uint64_t *byteLength,
+												 uint64_t *uncompressedByteLength) {
+	TinyKtx2_Context *ctx = (TinyKtx2_Context *) handle;
+	if (ctx == NULL)
+		return false;
+	if (ctx->headerValid == false) {
+		ctx->callbacks.error(ctx->user, "Header data hasn't been read yet or its invalid");
+		return false;
 	}
-	if (mipmaplevel >= TINYKTX2_MAX_MIPMAPLEVELS) {
+	if (mipmaplevel >= TinyKtx2_NumberOfMipmaps(handle)) {
 		ctx->callbacks.error(ctx->user, "Invalid mipmap level");
-		return 0;
+		return false;
 	}
-
-	return ctx->levels[mipmaplevel].uncompressedByteLength;
+	TinyKtx2_Level const *lvl = &ctx->levels[mipmaplevel];
+	if (byteOffset)
+		*byteOffset = lvl->byteOffset;
+	if (byteLength)
+		*byteLength = lvl->byteLength;
+	if (uncompressedByteLength)
+		*uncompressedByteLength = lvl->uncompressedByteLength;
+	return true;
 }
 
-void const *TinyKtx2_ImageRawData(TinyKtx2_ContextHandle handle, uint32_t mipmaplevel) {
+TinyKtx2_TexelLayout const *TinyKtx2_GetTexelLayout(TinyKtx2_ContextHandle handle) {
 	TinyKtx2_Context *ctx = (TinyKtx2_Context *) handle;
 	if (ctx == NULL)
 		return NULL;
-
 	if (ctx->headerValid == false) {
 		ctx->callbacks.error(ctx->user, "Header data hasn't been read yet or its invalid");
 		return NULL;
 	}
+	return &ctx->texelLayout;
+}
 
-	if (mipmaplevel >= ctx->header.levelCount) {
-		ctx->callbacks.error(ctx->user, "Invalid mipmap level");
-		return NULL;
+uint32_t TinyKtx2_GetSuperCompressionScheme(TinyKtx2_ContextHandle handle) {
+	TinyKtx2_Context *ctx = (TinyKtx2_Context *) handle;
+	if (ctx == NULL)
+		return TKTX2_SUPERCOMPRESSION_NONE;
+	if (ctx->headerValid == false) {
+		ctx->callbacks.error(ctx->user, "Header data hasn't been read yet or its invalid");
+		return TKTX2_SUPERCOMPRESSION_NONE;
 	}
+	return ctx->header.supercompressionScheme;
+}
 
-	if (mipmaplevel >= TINYKTX2_MAX_MIPMAPLEVELS) {
-		ctx->callbacks.error(ctx->user, "Invalid mipmap level");
+void const *TinyKtx2_DataFormatDescriptor(TinyKtx2_ContextHandle handle, uint32_t *byteLength) {
+	TinyKtx2_Context *ctx = (TinyKtx2_Context *) handle;
+	if (ctx == NULL)
+		return NULL;
+	if (ctx->headerValid == false) {
+		ctx->callbacks.error(ctx->user, "Header data hasn't been read yet or its invalid");
 		return NULL;
 	}
+	if (byteLength)
+		*byteLength = ctx->header.dfdByteLength;
+	return ctx->dfd;
+}
 
-	if (ctx->mipmaps[mipmaplevel] != NULL)
-		return ctx->mipmaps[mipmaplevel];
+uint64_t TinyKtx2_HashGlobalData(void const *data, uint64_t byteLength) {
+	// FNV-1a style mix a 64 bit word at a time, SGD can be megabytes
+	uint8_t const *bytes = (uint8_t const *) data;
+	uint64_t hash = 0xcbf29ce484222325ull ^ byteLength;
+	while (byteLength >= 8) {
+		uint64_t word;
+		memcpy(&word, bytes, 8);
+		hash = (hash ^ word) * 0x100000001b3ull;
+		hash ^= hash >> 29;
+		bytes += 8;
+		byteLength -= 8;
+	}
+	while (byteLength--) {
+		hash = (hash ^ *bytes++) * 0x100000001b3ull;
+	}
+	return hash ^ (hash >> 32);
+}
 
-	TinyKtx_Level* lvl = &ctx->levels[mipmaplevel];
-	if (lvl->byteLength == 0 || lvl->uncompressedByteLength == 0)
-		return NULL;
+bool TinyKtx2_SetSuperCompressionGlobalData(TinyKtx2_ContextHandle handle, void const *data, uint64_t byteLength) {
+	TinyKtx2_Context *ctx = (TinyKtx2_Context *) handle;
+	if (ctx == NULL)
+		return false;
+	if (ctx->headerValid == false) {
+		ctx->callbacks.error(ctx->user, "Header data hasn't been read yet or its invalid");
+		return false;
+	}
+	if (data == NULL || byteLength != ctx->header.sgdByteLength) {
+		ctx->callbacks.error(ctx->user, "Supercompression global data size doesn't match the header");
+		return false;
+	}
+	ctx->sgdData = data;
+	ctx->sgdKeyValid = false;
+	return true;
+}
 
-	// allocate decompressed buffer
-	ctx->mipmaps[mipmaplevel] = (uint8_t const*) ctx->callbacks.alloc(ctx->user, lvl->uncompressedByteLength);
-	if (ctx->mipmaps[mipmaplevel] == NULL)
-		return NULL;
+// reads the supercompression global data into the context's buffer (reused between files)
+// and offers it to the share callback
+static bool TinyKtx2_loadGlobalData(TinyKtx2_Context *ctx) {
+	if (ctx->sgdData != NULL || ctx->header.sgdByteLength == 0)
+		return true;
 
-	// handle no super compression first (save an buffer allocation)
-	if(ctx->header.supercompressionScheme == TKTX2_SUPERCOMPRESSION_NONE) {
-		if(lvl->uncompressedByteLength != lvl->byteLength) {
-			ctx->callbacks.error(ctx->user, "mipmap image data has no super compression but compressed and uncompressed data sizes are different");
-			ctx->callbacks.free(ctx->user, (void*)ctx->mipmaps[mipmaplevel]);
-			return NULL;
+	size_t const size = (size_t) ctx->header.sgdByteLength;
+	if (ctx->sgdBufferSize < size) {
+		if (ctx->sgdBuffer != NULL) {
+			ctx->callbacks.free(ctx->user, ctx->sgdBuffer);
 		}
-		ctx->callbacks.seek(ctx->user, lvl->byteOffset);
-		ctx->callbacks.read(ctx->user, (void *) ctx->mipmaps[mipmaplevel], lvl->byteLength);
-		return ctx->mipmaps[mipmaplevel];
+		ctx->sgdBufferSize = 0;
+		ctx->sgdBuffer = (uint8_t *) ctx->callbacks.alloc(ctx->user, size);
+		if (ctx->sgdBuffer == NULL)
+			return false;
+		ctx->sgdBufferSize = size;
 	}
 
-	// this data is super compressed, we need to see if the user provided a decompressor and if so use it
-
-	TinyKtx_SuperDecompress decompressor = NULL;
-	// see if the user provided the decompressor we need
-	for(size_t i = 0; i < ctx->callbacks.numSuperDecompressors;++i) {
-		if(ctx->callbacks.superDecompressors[i].superId == ctx->headerV2.supercompressionScheme) {
-			decompressor = ctx->callbacks.superDecompressors[i].decompressor;
-		}
+	if (!TinyKtx2_seek(ctx, ctx->headerPos + ctx->header.sgdByteOffset))
+		return false;
+	if (TinyKtx2_read(ctx, ctx->sgdBuffer, size) != size) {
+		ctx->callbacks.error(ctx->user, "Truncated supercompression global data");
+		return false;
 	}
-	if(decompressor == NULL) {
-		ctx->callbacks.error(ctx->user, "user did not provide a decompressor for use with this type of super decompressor");
-		ctx->callbacks.free(ctx->user, (void*)ctx->mipmaps[mipmaplevel]);
-		return NULL;
+	ctx->sgdData = ctx->sgdBuffer;
+
+	if (ctx->callbacks.shareGlobalData != NULL) {
+		ctx->sgdKey = TinyKtx2_HashGlobalData(ctx->sgdBuffer, size);
+		ctx->sgdKeyValid = true;
+		void const *shared = ctx->callbacks.shareGlobalData(ctx->user, ctx->sgdKey, ctx->sgdBuffer, size);
+		if (shared != NULL) {
+			ctx->sgdData = shared;
+		}
 	}
+	return true;
+}
 
-	// read the compressed data into its own buffer (free once decompression has occured)
-	uint8_t const* compressedBuffer = (uint8_t const*)ctx->callbacks.alloc(ctx->user, lvl->byteLength);
-	if(compressedBuffer == NULL) {
-		ctx->callbacks.free(ctx->user, (void*)ctx->mipmaps[mipmaplevel]);
+void const *TinyKtx2_SuperCompressionGlobalData(TinyKtx2_ContextHandle handle, uint64_t *byteLength, uint64_t *key) {
+	TinyKtx2_Context *ctx = (TinyKtx2_Context *) handle;
+	if (ctx == NULL)
 		return NULL;
-	}
-	ctx->callbacks.seek(ctx->user, lvl->byteOffset);
-	ctx->callbacks.read(ctx->user, (void *) compressedBuffer, lvl->byteLength);
-	bool okay = decompressor(ctx->user, ctx->sgdData, compressedBuffer, lvl->byteLength, ctx->mipmaps[mipmaplevel], lvl->uncompressedByteLength);
-
-	if(!okay) {
-		ctx->callbacks.error(ctx->user, "user decompressor failed");
-		ctx->callbacks.free(ctx->user, (void *) compressedBuffer);
-		ctx->callbacks.free(ctx->user, (void *) ctx->mipmaps[mipmaplevel]);
+	if (ctx->headerValid == false) {
+		ctx->callbacks.error(ctx->user, "Header data hasn't been read yet or its invalid");
 		return NULL;
 	}
+	if (byteLength)
+		*byteLength = ctx->header.sgdByteLength;
+	if (ctx->header.sgdByteLength == 0 || !TinyKtx2_loadGlobalData(ctx))
+		return NULL;
 
-	ctx->callbacks.free(ctx->user, (void *) compressedBuffer);
-	return ctx->mipmaps[mipmaplevel];
-
+	if (key) {
+		if (!ctx->sgdKeyValid) {
+			ctx->sgdKey = TinyKtx2_HashGlobalData(ctx->sgdData, ctx->header.sgdByteLength);
+			ctx->sgdKeyValid = true;
+		}
+		*key = ctx->sgdKey;
+	}
+	return ctx->sgdData;
 }
 
-TinyKtx_Format TinyKtx2_GetFormat(TinyKtx2_ContextHandle handle) {
+uint64_t TinyKtx2_ImageSize64(TinyKtx2_ContextHandle handle, uint32_t mipmaplevel) {
 	TinyKtx2_Context *ctx = (TinyKtx2_Context *) handle;
 	if (ctx == NULL)
-		return TKTX_UNDEFINED;
-
+		return 0;
 	if (ctx->headerValid == false) {
 		ctx->callbacks.error(ctx->user, "Header data hasn't been read yet or its invalid");
-		return TKTX_UNDEFINED;
+		return 0;
+	}
+
+	if (mipmaplevel >= TinyKtx2_NumberOfMipmaps(handle)) {
+		ctx->callbacks.error(ctx->user, "Invalid mipmap level");
+		return 0;
 	}
-	// TODO handle DFD only described formats (VK_FORMAT_UNDEFINED)
-	return (TinyKtx_Format)ctx->header.vkFormat;
+	if (mipmaplevel >= TINYKTX2_MAX_MIPMAPLEVELS) {
+		ctx->callbacks.error(ctx->user, "Invalid mipmap level");
+		return 0;
+	}
+
+	return ctx->levels[mipmaplevel].uncompressedByteLength;
 }
-static uint32_t TinyKtx2_MipMapReduce(uint32_t value, uint32_t mipmaplevel) {
 
-	// handle 0 being passed in
-	if(value <= 1) return 1;
+uint32_t TinyKtx2_ImageSize(TinyKtx2_ContextHandle handle, uint32_t mipmaplevel) {
+	uint64_t const size = TinyKtx2_ImageSize64(handle, mipmaplevel);
+	if (size > 0xFFFFFFFFu) {
+		TinyKtx2_Context *ctx = (TinyKtx2_Context *) handle;
+		ctx->callbacks.error(ctx->user, "Mipmap level is 4GB or more, use TinyKtx2_ImageSize64");
+		return 0;
+	}
+	return (uint32_t) size;
+}
 
-	// there are better ways of doing this (log2 etc.) but this doesn't require any
-	// dependecies and isn't used enough to matter imho
-	for (uint32_t i = 0u; i < mipmaplevel;++i) {
-		if(value <= 1) return 1;
-		value = value / 2;
+static TinyKtx2_SuperDecompress TinyKtx2_findDecompressor(TinyKtx2_Context *ctx) {
+	for (size_t i = 0; i < ctx->callbacks.numSuperDecompressors; ++i) {
+		if (ctx->callbacks.superDecompressors[i].superId == ctx->header.supercompressionScheme) {
+			return ctx->callbacks.superDecompressors[i].decompressor;
+		}
 	}
-	return value;
+	return NULL;
 }
 
+static bool TinyKtx2_hasBuiltinDecompressor(uint32_t scheme) {
+	(void) scheme;
+#ifdef TINYKTX2_HAVE_ZLIB
+	if (scheme == TKTX2_SUPERCOMPRESSION_ZLIB)
+		return true;
+#endif
+#ifdef TINYKTX2_HAVE_ZSTD
+	if (scheme == TKTX2_SUPERCOMPRESSION_ZSTD)
+		return true;
+#endif
+	return false;
+}
 
+// creates any missing decoder state for slots [0, count), called before tasks are dispatched
+// so only the decode itself runs on other threads
+static bool TinyKtx2_prepareBuiltinDecoders(TinyKtx2_Context *ctx, uint32_t count) {
+	(void) ctx;
+	for (uint32_t i = 0u; i < count; ++i) {
+#ifdef TINYKTX2_HAVE_ZLIB
+		if (ctx->header.supercompressionScheme == TKTX2_SUPERCOMPRESSION_ZLIB && ctx->decoders.zlib[i] == NULL) {
+			z_stream *zs = (z_stream *) ctx->callbacks.alloc(ctx->user, sizeof(z_stream));
+			if (zs == NULL)
+				return false;
+			memset(zs, 0, sizeof(z_stream));
+			if (inflateInit(zs) != Z_OK) {
+				ctx->callbacks.free(ctx->user, zs);
+				ctx->callbacks.error(ctx->user, "zlib init failed");
+				return false;
+			}
+			ctx->decoders.zlib[i] = zs;
+		}
+#endif
+#ifdef TINYKTX2_HAVE_ZSTD
+		if (ctx->header.supercompressionScheme == TKTX2_SUPERCOMPRESSION_ZSTD && ctx->decoders.zstd[i] == NULL) {
+			ctx->decoders.zstd[i] = ZSTD_createDCtx();
+			if (ctx->decoders.zstd[i] == NULL) {
+				ctx->callbacks.error(ctx->user, "zstd init failed");
+				return false;
+			}
+		}
+#endif
+	}
+	return true;
+}
 
-bool TinyKtx2_WriteImage(TinyKtx2_WriteCallbacks const *callbacks,
-												void *user,
-												uint32_t width,
-												uint32_t height,
-												uint32_t depth,
-												uint32_t slices,
-												uint32_t mipmaplevels,
-												TinyKtx_Format format,
-												bool cubemap,
-												uint32_t const *mipmapsizes,
-												void const **mipmaps) {
-	ASSERT(false);
+// decompresses straight into the level buffer with the slots reused decoder
+static bool TinyKtx2_builtinDecompress(TinyKtx2_Context *ctx,
+																			 uint32_t slot,
+																			 void const *src,
+																			 size_t srcSize,
+																			 void *dst,
+																			 size_t dstSize) {
+	// unused when built without zlib and zstd
+	(void) ctx;
+	(void) slot;
+	(void) src;
+	(void) srcSize;
+	(void) dst;
+	(void) dstSize;
+#ifdef TINYKTX2_HAVE_ZLIB
+	if (ctx->header.supercompressionScheme == TKTX2_SUPERCOMPRESSION_ZLIB) {
+		z_stream *zs = ctx->decoders.zlib[slot];
+		if (inflateReset(zs) != Z_OK)
+			return false;
+		// avail_in/out are 32 bit, feed large levels in pieces
+		size_t const maxChunk = (uInt) -1;
+		size_t inLeft = srcSize;
+		size_t outLeft = dstSize;
+		zs->next_in = (Bytef *) src;
+		zs->avail_in = 0;
+		zs->next_out = (Bytef *) dst;
+		zs->avail_out = 0;
+		int ret = Z_OK;
+		while (ret == Z_OK) {
+			if (zs->avail_in == 0) {
+				zs->avail_in = (uInt) (inLeft < maxChunk ? inLeft : maxChunk);
+				inLeft -= zs->avail_in;
+			}
+			if (zs->avail_out == 0) {
+				zs->avail_out = (uInt) (outLeft < maxChunk ? outLeft : maxChunk);
+				outLeft -= zs->avail_out;
+			}
+			ret = inflate(zs, Z_NO_FLUSH);
+		}
+		return ret == Z_STREAM_END && zs->avail_out == 0 && outLeft == 0;
+	}
+#endif
+#ifdef TINYKTX2_HAVE_ZSTD
+	if (ctx->header.supercompressionScheme == TKTX2_SUPERCOMPRESSION_ZSTD) {
+		size_t const size = ZSTD_decompressDCtx(ctx->decoders.zstd[slot], dst, dstSize, src, srcSize);
+		return !ZSTD_isError(size) && size == dstSize;
+	}
+#endif
+	return false;
+}
+
+// built in streaming decoders, user is the context
+static void *TinyKtx2_builtinStreamInit(void *user, void *const sgdData, void *dst, size_t dstSize) {
+	(void) sgdData;
+	TinyKtx2_Context *ctx = (TinyKtx2_Context *) user;
+	TinyKtx2_Decoders *dec = &ctx->decoders;
+	if (!TinyKtx2_prepareBuiltinDecoders(ctx, 1))
+		return NULL;
+	dec->streamDst = (uint8_t *) dst;
+	dec->streamDstLeft = dstSize;
+	dec->streamEnded = false;
+#ifdef TINYKTX2_HAVE_ZLIB
+	if (ctx->header.supercompressionScheme == TKTX2_SUPERCOMPRESSION_ZLIB) {
+		if (inflateReset(dec->zlib[0]) != Z_OK)
+			return NULL;
+		dec->zlib[0]->avail_out = 0;
+	}
+#endif
+#ifdef TINYKTX2_HAVE_ZSTD
+	if (ctx->header.supercompressionScheme == TKTX2_SUPERCOMPRESSION_ZSTD) {
+		if (ZSTD_isError(ZSTD_DCtx_reset(dec->zstd[0], ZSTD_reset_session_only)))
+			return NULL;
+	}
+#endif
+	return dec;
 }
+
+static bool TinyKtx2_builtinStreamFeed(void *user, void *state, void const *src, size_t srcSize) {
+	TinyKtx2_Context *ctx = (TinyKtx2_Context *) user;
+	(void) ctx;
+	(void) src;
+	TinyKtx2_Decoders *dec = (TinyKtx2_Decoders *) state;
+	if (dec->streamEnded)
+		return srcSize == 0; // data after the end of the stream
+#ifdef TINYKTX2_HAVE_ZLIB
+	if (ctx->header.supercompressionScheme == TKTX2_SUPERCOMPRESSION_ZLIB) {
+		z_stream *zs = dec->zlib[0];
+		size_t const maxChunk = (uInt) -1;
+		uint8_t const *in = (uint8_t const *) src;
+		while (srcSize) {
+			zs->next_in = (Bytef *) in;
+			zs->avail_in = (uInt) (srcSize < maxChunk ? srcSize : maxChunk);
+			in += zs->avail_in;
+			srcSize -= zs->avail_in;
+			while (zs->avail_in) {
+				if (zs->avail_out == 0 && dec->streamDstLeft) {
+					zs->next_out = (Bytef *) dec->streamDst;
+					zs->avail_out = (uInt) (dec->streamDstLeft < maxChunk ? dec->streamDstLeft : maxChunk);
+					dec->streamDst += zs->avail_out;
+					dec->streamDstLeft -= zs->avail_out;
+				}
+				// with the level full only the stream trailer can still be consumed
+				int const ret = inflate(zs, Z_NO_FLUSH);
+				if (ret == Z_STREAM_END) {
+					dec->streamEnded = true;
+					return zs->avail_in == 0 && srcSize == 0;
+				}
+				if (ret != Z_OK)
+					return false;
+			}
+		}
+		return true;
+	}
+#endif
+#ifdef TINYKTX2_HAVE_ZSTD
+	if (ctx->header.supercompressionScheme == TKTX2_SUPERCOMPRESSION_ZSTD) {
+		ZSTD_inBuffer in = { src, srcSize, 0 };
+		ZSTD_outBuffer out = { dec->streamDst, dec->streamDstLeft, 0 };
+		while (in.pos < in.size) {
+			size_t const inPos = in.pos;
+			size_t const outPos = out.pos;
+			size_t const ret = ZSTD_decompressStream(dec->zstd[0], &out, &in);
+			if (ZSTD_isError(ret))
+				return false;
+			if (ret == 0) {
+				dec->streamEnded = true;
+				break;
+			}
+			if (in.pos == inPos && out.pos == outPos)
+				return false; // no progress, more output than the level size
+		}
+		dec->streamDst += out.pos;
+		dec->streamDstLeft -= out.pos;
+		return in.pos == in.size;
+	}
+#endif
+	return false;
+}
+
+static bool TinyKtx2_builtinStreamFinish(void *user, void *state) {
+	(void) user;
+	TinyKtx2_Decoders *dec = (TinyKtx2_Decoders *) state;
+	bool okay = dec->streamEnded && dec->streamDstLeft == 0;
+#ifdef TINYKTX2_HAVE_ZLIB
+	TinyKtx2_Context *ctx = (TinyKtx2_Context *) user;
+	if (ctx->header.supercompressionScheme == TKTX2_SUPERCOMPRESSION_ZLIB) {
+		okay = okay && dec->zlib[0]->avail_out == 0;
+	}
+#endif
+	return okay;
+}
+
+static TinyKtx2_StreamDecompressTableEntry const TinyKtx2_builtinStreamDecompressor = {
+		0,
+		&TinyKtx2_builtinStreamInit,
+		&TinyKtx2_builtinStreamFeed,
+		&TinyKtx2_builtinStreamFinish
+};
+
+// user stream decompressor for the scheme, else the built in one if there is one
+static TinyKtx2_StreamDecompressTableEntry const *TinyKtx2_findStreamDecompressor(TinyKtx2_Context *ctx, void **user) {
+	for (size_t i = 0; i < ctx->callbacks.numStreamDecompressors; ++i) {
+		if (ctx->callbacks.streamDecompressors[i].superId == ctx->header.supercompressionScheme) {
+			*user = ctx->user;
+			return &ctx->callbacks.streamDecompressors[i];
+		}
+	}
+	if (TinyKtx2_hasBuiltinDecompressor(ctx->header.supercompressionScheme)) {
+		*user = ctx;
+		return &TinyKtx2_builtinStreamDecompressor;
+	}
+	return NULL;
+}
+
+// size of a buffer for reading byteLength bytes a chunk at a time
+static size_t TinyKtx2_chunkBufferSize(TinyKtx2_Context *ctx, uint64_t byteLength) {
+	size_t chunkSize = ctx->callbacks.streamChunkSize ? ctx->callbacks.streamChunkSize : TINYKTX2_DEFAULT_STREAM_CHUNK_SIZE;
+	if (ctx->callbacks.maxChunkSize && chunkSize > ctx->callbacks.maxChunkSize)
+		chunkSize = ctx->callbacks.maxChunkSize;
+	return (byteLength < chunkSize) ? (size_t) byteLength : chunkSize;
+}
+
+// reads and decompresses a level a chunk at a time straight into dst
+static bool TinyKtx2_streamLevel(TinyKtx2_Context *ctx,
+																 TinyKtx2_StreamDecompressTableEntry const *stream,
+																 void *streamUser,
+																 uint32_t mipmaplevel,
+																 uint8_t *dst) {
+	TinyKtx2_Level const *lvl = &ctx->levels[mipmaplevel];
+	size_t const bufferSize = TinyKtx2_chunkBufferSize(ctx, lvl->byteLength);
+	uint8_t *chunk = (uint8_t *) ctx->callbacks.alloc(ctx->user, bufferSize);
+	if (chunk == NULL)
+		return false;
+	if (!TinyKtx2_seek(ctx, ctx->headerPos + lvl->byteOffset)) {
+		ctx->callbacks.free(ctx->user, chunk);
+		return false;
+	}
+
+	void *state = stream->init(streamUser, (void *) ctx->sgdData, dst, (size_t) lvl->uncompressedByteLength);
+	if (state == NULL) {
+		ctx->callbacks.free(ctx->user, chunk);
+		ctx->callbacks.error(ctx->user, "Stream decompressor init failed");
+		return false;
+	}
+
+	bool truncated = false;
+	bool okay = true;
+	for (uint64_t left = lvl->byteLength; left && okay;) {
+		size_t const size = (left < bufferSize) ? (size_t) left : bufferSize;
+		if (TinyKtx2_read(ctx, chunk, size) != size) {
+			truncated = true;
+			break;
+		}
+		okay = stream->feed(streamUser, state, chunk, size);
+		left -= size;
+	}
+	// finish is always called so the decompressor can release its state
+	okay = stream->finish(streamUser, state) && okay;
+	ctx->callbacks.free(ctx->user, chunk);
+	if (truncated) {
+		ctx->callbacks.error(ctx->user, "Truncated mipmap level");
+		return false;
+	}
+	if (!okay) {
+		ctx->callbacks.error(ctx->user, "Supercompressed level failed to decompress");
+	}
+	return okay;
+}
+
+// reads the level as stored in the file into a new buffer
+static uint8_t *TinyKtx2_readLevel(TinyKtx2_Context *ctx, uint32_t mipmaplevel) {
+	TinyKtx2_Level const *lvl = &ctx->levels[mipmaplevel];
+	if (!TinyKtx2_levelFits(ctx, lvl->byteLength))
+		return NULL;
+	uint8_t *buffer = (uint8_t *) ctx->callbacks.alloc(ctx->user, (size_t) lvl->byteLength);
+	if (buffer == NULL)
+		return NULL;
+
+	if (!TinyKtx2_seek(ctx, ctx->headerPos + lvl->byteOffset)) {
+		ctx->callbacks.free(ctx->user, buffer);
+		return NULL;
+	}
+	if (TinyKtx2_read(ctx, buffer, (size_t) lvl->byteLength) != lvl->byteLength) {
+		ctx->callbacks.error(ctx->user, "Truncated mipmap level");
+		ctx->callbacks.free(ctx->user, buffer);
+		return NULL;
+	}
+	return buffer;
+}
+
+typedef struct TinyKtx2_DecodeTasks {
+	TinyKtx2_Context *ctx;
+	TinyKtx2_SuperDecompress decompressor;
+	uint32_t levels[TINYKTX2_MAX_MIPMAPLEVELS];
+	uint8_t *src[TINYKTX2_MAX_MIPMAPLEVELS];
+	uint8_t *dst[TINYKTX2_MAX_MIPMAPLEVELS];
+	bool okay[TINYKTX2_MAX_MIPMAPLEVELS];
+} TinyKtx2_DecodeTasks;
+
+static void TinyKtx2_decodeTask(void *taskData, uint32_t taskIndex) {
+	TinyKtx2_DecodeTasks *tasks = (TinyKtx2_DecodeTasks *) taskData;
+	TinyKtx2_Context *ctx = tasks->ctx;
+	TinyKtx2_Level const *lvl = &ctx->levels[tasks->levels[taskIndex]];
+	if (tasks->decompressor) {
+		tasks->okay[taskIndex] = tasks->decompressor(ctx->user, (void *) ctx->sgdData,
+																								 tasks->src[taskIndex], (size_t) lvl->byteLength,
+																								 tasks->dst[taskIndex], (size_t) lvl->uncompressedByteLength);
+	} else {
+		tasks->okay[taskIndex] = TinyKtx2_builtinDecompress(ctx, taskIndex,
+																												tasks->src[taskIndex], (size_t) lvl->byteLength,
+																												tasks->dst[taskIndex], (size_t) lvl->uncompressedByteLength);
+	}
+}
+
+// levels in the order they are stored in the file, smallest first for files that follow the spec
+static void TinyKtx2_levelFileOrder(TinyKtx2_Context *ctx, uint32_t levelCount, uint32_t *order) {
+	for (uint32_t i = 0u; i < levelCount; ++i) {
+		uint32_t j = i;
+		for (; j > 0 && ctx->levels[order[j - 1]].byteOffset > ctx->levels[i].byteOffset; --j) {
+			order[j] = order[j - 1];
+		}
+		order[j] = i;
+	}
+}
+
+bool TinyKtx2_DecodeLevels(TinyKtx2_ContextHandle handle,
+													 uint32_t levelMask,
+													 TinyKtx2_DispatchFunc dispatch,
+													 void *dispatchUser) {
+	TinyKtx2_Context *ctx = (TinyKtx2_Context *) handle;
+	if (ctx == NULL)
+		return false;
+
+	if (ctx->headerValid == false) {
+		ctx->callbacks.error(ctx->user, "Header data hasn't been read yet or its invalid");
+		return false;
+	}
+
+	uint32_t const levelCount = TinyKtx2_NumberOfMipmaps(handle);
+	if ((levelMask >> levelCount) != 0) {
+		ctx->callbacks.error(ctx->user, "Invalid mipmap level");
+		return false;
+	}
+
+	// levels are read in file order so reads only go forward
+	uint32_t order[TINYKTX2_MAX_MIPMAPLEVELS];
+	TinyKtx2_levelFileOrder(ctx, levelCount, order);
+
+	// handle no super compression first (no decompression or extra buffers needed)
+	if (ctx->header.supercompressionScheme == TKTX2_SUPERCOMPRESSION_NONE) {
+		for (uint32_t n = 0u; n < levelCount; ++n) {
+			uint32_t const i = order[n];
+			if ((levelMask & (1u << i)) == 0 || ctx->mipmaps[i] != NULL)
+				continue;
+			ctx->mipmaps[i] = TinyKtx2_readLevel(ctx, i);
+			if (ctx->mipmaps[i] == NULL)
+				return false;
+		}
+		return true;
+	}
+
+	// this data is super compressed, use the users decompressor for the scheme or a built in one.
+	// A user streaming decompressor comes first, then a user one, then the built in ones
+	TinyKtx2_DecodeTasks tasks;
+	memset(&tasks, 0, sizeof(TinyKtx2_DecodeTasks));
+	tasks.ctx = ctx;
+	tasks.decompressor = TinyKtx2_findDecompressor(ctx);
+	void *streamUser = NULL;
+	TinyKtx2_StreamDecompressTableEntry const *stream = TinyKtx2_findStreamDecompressor(ctx, &streamUser);
+	if (stream == &TinyKtx2_builtinStreamDecompressor && tasks.decompressor != NULL) {
+		stream = NULL;
+	}
+	bool const haveDecompressor = tasks.decompressor != NULL ||
+			TinyKtx2_hasBuiltinDecompressor(ctx->header.supercompressionScheme);
+	if (stream == NULL && !haveDecompressor) {
+		ctx->callbacks.error(ctx->user, "user did not provide a decompressor for use with this type of super decompressor");
+		return false;
+	}
+	if (!TinyKtx2_loadGlobalData(ctx))
+		return false;
+
+	uint32_t pendingCount = 0;
+	for (uint32_t i = 0u; i < levelCount; ++i) {
+		if ((levelMask & (1u << i)) == 0 || ctx->mipmaps[i] != NULL)
+			continue;
+		if (ctx->levels[i].uncompressedByteLength == 0) {
+			ctx->callbacks.error(ctx->user, "Level has no uncompressed size");
+			return false;
+		}
+		if (!TinyKtx2_levelFits(ctx, ctx->levels[i].uncompressedByteLength))
+			return false;
+		pendingCount++;
+	}
+
+	// streaming never holds a whole compressed level but runs on this thread, so only use it if
+	// there is nothing to gain from parallel decompression
+	if (stream && (dispatch == NULL || pendingCount < 2 || !haveDecompressor)) {
+		for (uint32_t n = 0u; n < levelCount; ++n) {
+			uint32_t const i = order[n];
+			if ((levelMask & (1u << i)) == 0 || ctx->mipmaps[i] != NULL)
+				continue;
+			uint8_t *dst = (uint8_t *) ctx->callbacks.alloc(ctx->user, (size_t) ctx->levels[i].uncompressedByteLength);
+			if (dst == NULL)
+				return false;
+			if (!TinyKtx2_streamLevel(ctx, stream, streamUser, i, dst)) {
+				ctx->callbacks.free(ctx->user, dst);
+				return false;
+			}
+			ctx->mipmaps[i] = dst;
+		}
+		return true;
+	}
+
+	// reads are serial (the callbacks aren't thread safe), only the decompression is parallel
+	bool okay = true;
+	uint32_t taskCount = 0;
+	for (uint32_t n = 0u; n < levelCount && okay; ++n) {
+		uint32_t const i = order[n];
+		if ((levelMask & (1u << i)) == 0 || ctx->mipmaps[i] != NULL)
+			continue;
+		tasks.levels[taskCount] = i;
+		tasks.dst[taskCount] = (uint8_t *) ctx->callbacks.alloc(ctx->user, (size_t) ctx->levels[i].uncompressedByteLength);
+		tasks.src[taskCount] = tasks.dst[taskCount] ? TinyKtx2_readLevel(ctx, i) : NULL;
+		okay = tasks.src[taskCount] != NULL;
+		taskCount++;
+	}
+
+	if (okay && tasks.decompressor == NULL) {
+		okay = TinyKtx2_prepareBuiltinDecoders(ctx, taskCount);
+	}
+
+	if (okay && taskCount) {
+		if (dispatch) {
+			dispatch(dispatchUser, &TinyKtx2_decodeTask, &tasks, taskCount);
+		} else {
+			for (uint32_t i = 0u; i < taskCount; ++i) {
+				TinyKtx2_decodeTask(&tasks, i);
+			}
+		}
+	}
+
+	// levels that decoded are kept even if others failed
+	bool decoded = true;
+	for (uint32_t i = 0u; i < taskCount; ++i) {
+		if (tasks.src[i]) {
+			ctx->callbacks.free(ctx->user, tasks.src[i]);
+		}
+		if (okay && tasks.okay[i]) {
+			ctx->mipmaps[tasks.levels[i]] = tasks.dst[i];
+		} else {
+			if (okay && decoded) {
+				ctx->callbacks.error(ctx->user, "Supercompressed level failed to decompress");
+			}
+			if (tasks.dst[i]) {
+				ctx->callbacks.free(ctx->user, tasks.dst[i]);
+			}
+			decoded = false;
+		}
+	}
+	return okay && decoded;
+}
+
+void const *TinyKtx2_ImageRawData(TinyKtx2_ContextHandle handle, uint32_t mipmaplevel) {
+	TinyKtx2_Context *ctx = (TinyKtx2_Context *) handle;
+	if (ctx == NULL)
+		return NULL;
+
+	if (ctx->headerValid == false) {
+		ctx->callbacks.error(ctx->user, "Header data hasn't been read yet or its invalid");
+		return NULL;
+	}
+
+	if (mipmaplevel >= TinyKtx2_NumberOfMipmaps(handle)) {
+		ctx->callbacks.error(ctx->user, "Invalid mipmap level");
+		return NULL;
+	}
+
+	if (ctx->mipmaps[mipmaplevel] != NULL)
+		return ctx->mipmaps[mipmaplevel];
+
+	if (ctx->levels[mipmaplevel].byteLength == 0)
+		return NULL;
+
+	if (!TinyKtx2_DecodeLevels(handle, 1u << mipmaplevel, NULL, NULL))
+		return NULL;
+
+	return ctx->mipmaps[mipmaplevel];
+}
+
+void TinyKtx2_ReleaseImageRawData(TinyKtx2_ContextHandle handle, uint32_t mipmaplevel) {
+	TinyKtx2_Context *ctx = (TinyKtx2_Context *) handle;
+	if (ctx == NULL || mipmaplevel >= TINYKTX2_MAX_MIPMAPLEVELS)
+		return;
+	if (ctx->mipmaps[mipmaplevel] != NULL) {
+		ctx->callbacks.free(ctx->user, (void *) ctx->mipmaps[mipmaplevel]);
+		ctx->mipmaps[mipmaplevel] = NULL;
+	}
+}
+
+bool TinyKtx2_StreamLevels(TinyKtx2_ContextHandle handle, TinyKtx2_LevelReadyFunc levelReady, void *levelUser) {
+	TinyKtx2_Context *ctx = (TinyKtx2_Context *) handle;
+	if (ctx == NULL)
+		return false;
+	if (ctx->headerValid == false) {
+		ctx->callbacks.error(ctx->user, "Header data hasn't been read yet or its invalid");
+		return false;
+	}
+
+	uint32_t const levelCount = TinyKtx2_NumberOfMipmaps(handle);
+	uint32_t order[TINYKTX2_MAX_MIPMAPLEVELS];
+	TinyKtx2_levelFileOrder(ctx, levelCount, order);
+	for (uint32_t n = 0u; n < levelCount; ++n) {
+		uint32_t const i = order[n];
+		if (ctx->levels[i].byteLength == 0)
+			continue;
+		if (!TinyKtx2_DecodeLevels(handle, 1u << i, NULL, NULL))
+			return false;
+		if (levelReady != NULL) {
+			levelReady(levelUser, i, ctx->mipmaps[i], (size_t) ctx->levels[i].uncompressedByteLength);
+		}
+	}
+	return true;
+}
+
+bool TinyKtx2_ReadLevelChunks(TinyKtx2_ContextHandle handle, uint32_t mipmaplevel, TinyKtx2_LevelChunkFunc chunkFn, void *chunkUser) {
+	TinyKtx2_Context *ctx = (TinyKtx2_Context *) handle;
+	if (ctx == NULL || chunkFn == NULL)
+		return false;
+	if (ctx->headerValid == false) {
+		ctx->callbacks.error(ctx->user, "Header data hasn't been read yet or its invalid");
+		return false;
+	}
+	if (mipmaplevel >= TinyKtx2_NumberOfMipmaps(handle)) {
+		ctx->callbacks.error(ctx->user, "Invalid mipmap level");
+		return false;
+	}
+	if (ctx->header.supercompressionScheme != TKTX2_SUPERCOMPRESSION_NONE) {
+		ctx->callbacks.error(ctx->user, "Supercompressed levels can't be read in chunks, use TinyKtx2_DecodeLevels");
+		return false;
+	}
+
+	TinyKtx2_Level const *lvl = &ctx->levels[mipmaplevel];
+	if (lvl->byteLength == 0)
+		return false;
+	size_t const bufferSize = TinyKtx2_chunkBufferSize(ctx, lvl->byteLength);
+	uint8_t *buffer = (uint8_t *) ctx->callbacks.alloc(ctx->user, bufferSize);
+	if (buffer == NULL)
+		return false;
+	if (!TinyKtx2_seek(ctx, ctx->headerPos + lvl->byteOffset)) {
+		ctx->callbacks.free(ctx->user, buffer);
+		return false;
+	}
+
+	bool okay = true;
+	for (uint64_t offset = 0; offset < lvl->byteLength && okay;) {
+		size_t const size = (lvl->byteLength - offset < bufferSize) ? (size_t) (lvl->byteLength - offset) : bufferSize;
+		if (TinyKtx2_read(ctx, buffer, size) != size) {
+			ctx->callbacks.error(ctx->user, "Truncated mipmap level");
+			okay = false;
+			break;
+		}
+		okay = chunkFn(chunkUser, mipmaplevel, offset, buffer, size);
+		offset += size;
+	}
+	ctx->callbacks.free(ctx->user, buffer);
+	return okay;
+}
+
+TinyKtx_Format TinyKtx2_GetFormat(TinyKtx2_ContextHandle handle) {
+	TinyKtx2_Context *ctx = (TinyKtx2_Context *) handle;
+	if (ctx == NULL)
+		return TKTX_UNDEFINED;
+
+	if (ctx->headerValid == false) {
+		ctx->callbacks.error(ctx->user, "Header data hasn't been read yet or its invalid");
+		return TKTX_UNDEFINED;
+	}
+	return ctx->format;
+}
+static uint32_t TinyKtx2_MipMapReduce(uint32_t value, uint32_t mipmaplevel) {
+
+	// handle 0 being passed in
+	if(value <= 1) return 1;
+
+	// there are better ways of doing this (log2 etc.) but this doesn't require any
+	// dependecies and isn't used enough to matter imho
+	for (uint32_t i = 0u; i < mipmaplevel;++i) {
+		if(value <= 1) return 1;
+		value = value / 2;
+	}
+	return value;
+}
+
+TinyKtx2_UniversalFormat TinyKtx2_GetUniversalFormat(TinyKtx2_ContextHandle handle) {
+	TinyKtx2_Context *ctx = (TinyKtx2_Context *) handle;
+	if (ctx == NULL)
+		return TKTX2_UNIVERSAL_NONE;
+	if (ctx->headerValid == false) {
+		ctx->callbacks.error(ctx->user, "Header data hasn't been read yet or its invalid");
+		return TKTX2_UNIVERSAL_NONE;
+	}
+	if (ctx->header.vkFormat != TKTX_UNDEFINED)
+		return TKTX2_UNIVERSAL_NONE;
+
+	switch (ctx->texelLayout.colorModel) {
+		case TKTX2_DFD_MODEL_ETC1S: return TKTX2_UNIVERSAL_ETC1S;
+		case TKTX2_DFD_MODEL_UASTC: return TKTX2_UNIVERSAL_UASTC;
+		default: return TKTX2_UNIVERSAL_NONE;
+	}
+}
+
+// layers, faces and z slices are each a separate image to transcode
+static uint32_t TinyKtx2_levelImageCount(TinyKtx2_Context *ctx, uint32_t mipmaplevel) {
+	uint32_t const layers = ctx->header.arrayElementCount ? ctx->header.arrayElementCount : 1;
+	uint32_t const faces = ctx->header.faceCount ? ctx->header.faceCount : 1;
+	return layers * faces * TinyKtx2_MipMapReduce(ctx->header.pixelDepth, mipmaplevel);
+}
+
+uint64_t TinyKtx2_DepthSliceSize(TinyKtx2_ContextHandle handle, uint32_t mipmaplevel) {
+	TinyKtx2_Context *ctx = (TinyKtx2_Context *) handle;
+	if (ctx == NULL)
+		return 0;
+	if (ctx->headerValid == false) {
+		ctx->callbacks.error(ctx->user, "Header data hasn't been read yet or its invalid");
+		return 0;
+	}
+	if (mipmaplevel >= TinyKtx2_NumberOfMipmaps(handle)) {
+		ctx->callbacks.error(ctx->user, "Invalid mipmap level");
+		return 0;
+	}
+	// images are stored by layer then face then z slice, only plain 3D textures have all their
+	// slices next to each other
+	if (ctx->header.arrayElementCount > 1 || ctx->header.faceCount > 1) {
+		ctx->callbacks.error(ctx->user, "Depth slices can only be read from 3D textures");
+		return 0;
+	}
+
+	uint32_t bw, bh, bd, bytes;
+	if (!TinyKtx_FormatBlockInfo(ctx->format, &bw, &bh, &bd, &bytes) || bd != 1) {
+		ctx->callbacks.error(ctx->user, "Depth slices need a known format with 2D blocks");
+		return 0;
+	}
+	uint32_t const w = TinyKtx2_MipMapReduce(ctx->header.pixelWidth, mipmaplevel);
+	uint32_t const h = TinyKtx2_MipMapReduce(ctx->header.pixelHeight, mipmaplevel);
+	return (uint64_t) ((w + bw - 1) / bw) * ((h + bh - 1) / bh) * bytes;
+}
+
+bool TinyKtx2_ReadDepthSlices(TinyKtx2_ContextHandle handle,
+															uint32_t mipmaplevel,
+															uint32_t z0,
+															uint32_t z1,
+															void *dst,
+															size_t dstSize) {
+	TinyKtx2_Context *ctx = (TinyKtx2_Context *) handle;
+	if (ctx == NULL || dst == NULL)
+		return false;
+
+	uint64_t const sliceSize = TinyKtx2_DepthSliceSize(handle, mipmaplevel);
+	if (sliceSize == 0)
+		return false;
+	if (ctx->header.supercompressionScheme != TKTX2_SUPERCOMPRESSION_NONE) {
+		ctx->callbacks.error(ctx->user, "Depth slices can't be read from supercompressed levels");
+		return false;
+	}
+	uint32_t const depth = TinyKtx2_MipMapReduce(ctx->header.pixelDepth, mipmaplevel);
+	if (z0 >= z1 || z1 > depth) {
+		ctx->callbacks.error(ctx->user, "Invalid depth slice range");
+		return false;
+	}
+	uint64_t const byteCount = sliceSize * (z1 - z0);
+	if (dstSize < byteCount) {
+		ctx->callbacks.error(ctx->user, "Depth slice destination is too small");
+		return false;
+	}
+
+	// ReadHeader has already checked the level size against the dimensions
+	TinyKtx2_Level const *lvl = &ctx->levels[mipmaplevel];
+	if (!TinyKtx2_seek(ctx, ctx->headerPos + lvl->byteOffset + sliceSize * z0))
+		return false;
+	if (TinyKtx2_read(ctx, dst, (size_t) byteCount) != byteCount) {
+		ctx->callbacks.error(ctx->user, "Truncated mipmap level");
+		return false;
+	}
+	return true;
+}
+
+size_t TinyKtx2_TranscodedLevelSize(TinyKtx2_ContextHandle handle, uint32_t mipmaplevel, TinyKtx_Format targetFormat) {
+	TinyKtx2_Context *ctx = (TinyKtx2_Context *) handle;
+	if (ctx == NULL)
+		return 0;
+	if (ctx->headerValid == false) {
+		ctx->callbacks.error(ctx->user, "Header data hasn't been read yet or its invalid");
+		return 0;
+	}
+	if (mipmaplevel >= TinyKtx2_NumberOfMipmaps(handle)) {
+		ctx->callbacks.error(ctx->user, "Invalid mipmap level");
+		return 0;
+	}
+	uint32_t imageSize;
+	if (!TinyKtx_ComputeMipmapSizes(TinyKtx2_MipMapReduce(ctx->header.pixelWidth, mipmaplevel),
+																	TinyKtx2_MipMapReduce(ctx->header.pixelHeight, mipmaplevel),
+																	1, 1, 1, targetFormat, false, &imageSize)) {
+		return 0;
+	}
+	return (size_t) imageSize * TinyKtx2_levelImageCount(ctx, mipmaplevel);
+}
+
+static TinyKtx2_TranscoderTableEntry const *TinyKtx2_transcoderIn(TinyKtx2_TranscoderTableEntry const *table,
+																																	 size_t count,
+																																	 TinyKtx2_UniversalFormat universal,
+																																	 TinyKtx_Format targetFormat) {
+	for (size_t i = 0; i < count; ++i) {
+		if (table[i].universalFormat == (uint32_t) universal && table[i].targetFormat == targetFormat)
+			return &table[i];
+	}
+	return NULL;
+}
+
+// the user's table first, then the built in transcoders
+static TinyKtx2_TranscoderTableEntry const *TinyKtx2_findTranscoder(TinyKtx2_Context *ctx,
+																																		TinyKtx2_UniversalFormat universal,
+																																		TinyKtx_Format targetFormat) {
+	TinyKtx2_TranscoderTableEntry const *entry =
+			TinyKtx2_transcoderIn(ctx->callbacks.transcoders, ctx->callbacks.numTranscoders, universal, targetFormat);
+#ifdef TINYKTX2_HAVE_DECODE
+	if (entry == NULL) {
+		entry = TinyKtx2_transcoderIn(TinyKtx2_UastcTranscoders, TINYKTX2_UASTC_TRANSCODER_COUNT, universal, targetFormat);
+	}
+#endif
+	return entry;
+}
+
+bool TinyKtx2_CanTranscode(TinyKtx2_ContextHandle handle, TinyKtx_Format targetFormat) {
+	TinyKtx2_Context *ctx = (TinyKtx2_Context *) handle;
+	if (ctx == NULL || ctx->headerValid == false || targetFormat == TKTX_UNDEFINED)
+		return false;
+	TinyKtx2_UniversalFormat const universal = TinyKtx2_GetUniversalFormat(handle);
+	if (universal != TKTX2_UNIVERSAL_NONE)
+		return TinyKtx2_findTranscoder(ctx, universal, targetFormat) != NULL;
+	return targetFormat == ctx->format;
+}
+
+typedef struct TinyKtx2_TranscodeTasks {
+	TinyKtx2_Context *ctx;
+	TinyKtx2_TranscodeFunc transcode;
+	TinyKtx2_TranscodeImage level;	// everything but the per image fields
+	uint32_t faces;
+	uint32_t depth;
+	size_t imageSize;
+	bool *okay;
+} TinyKtx2_TranscodeTasks;
+
+static void TinyKtx2_transcodeTask(void *taskData, uint32_t taskIndex) {
+	TinyKtx2_TranscodeTasks *tasks = (TinyKtx2_TranscodeTasks *) taskData;
+	TinyKtx2_TranscodeImage image = tasks->level;
+	image.imageIndex = taskIndex;
+	image.layer = taskIndex / (tasks->faces * tasks->depth);
+	image.face = (taskIndex / tasks->depth) % tasks->faces;
+	image.zSlice = taskIndex % tasks->depth;
+	image.dst = (uint8_t *) image.dst + tasks->imageSize * taskIndex;
+	image.dstSize = tasks->imageSize;
+	tasks->okay[taskIndex] = tasks->transcode(tasks->ctx->user, (void *) tasks->ctx->sgdData, &image);
+}
+
+bool TinyKtx2_TranscodeLevel(TinyKtx2_ContextHandle handle,
+														 uint32_t mipmaplevel,
+														 TinyKtx_Format targetFormat,
+														 void *dst,
+														 size_t dstSize,
+														 TinyKtx2_DispatchFunc dispatch,
+														 void *dispatchUser) {
+	TinyKtx2_Context *ctx = (TinyKtx2_Context *) handle;
+	if (ctx == NULL)
+		return false;
+	size_t const levelSize = TinyKtx2_TranscodedLevelSize(handle, mipmaplevel, targetFormat);
+	if (levelSize == 0) {
+		ctx->callbacks.error(ctx->user, "Can't transcode to the target format");
+		return false;
+	}
+	if (dst == NULL || dstSize != levelSize) {
+		ctx->callbacks.error(ctx->user, "Transcode destination size doesn't match the target format");
+		return false;
+	}
+
+	TinyKtx2_UniversalFormat const universal = TinyKtx2_GetUniversalFormat(handle);
+	TinyKtx2_TranscoderTableEntry const *entry = NULL;
+	if (universal != TKTX2_UNIVERSAL_NONE) {
+		entry = TinyKtx2_findTranscoder(ctx, universal, targetFormat);
+		if (entry == NULL) {
+			ctx->callbacks.error(ctx->user, "No transcoder for this target format");
+			return false;
+		}
+	} else if (targetFormat != ctx->format) {
+		ctx->callbacks.error(ctx->user, "Only universal textures can be transcoded to another format");
+		return false;
+	}
+
+	void const *levelData = TinyKtx2_ImageRawData(handle, mipmaplevel);
+	if (levelData == NULL)
+		return false;
+
+	// already in the target format
+	if (entry == NULL) {
+		memcpy(dst, levelData, dstSize);
+		return true;
+	}
+
+	uint32_t const imageCount = TinyKtx2_levelImageCount(ctx, mipmaplevel);
+	TinyKtx2_TranscodeTasks tasks;
+	memset(&tasks, 0, sizeof(TinyKtx2_TranscodeTasks));
+	tasks.ctx = ctx;
+	tasks.transcode = entry->transcode;
+	tasks.level.level = mipmaplevel;
+	tasks.level.imageCount = imageCount;
+	tasks.level.width = TinyKtx2_MipMapReduce(ctx->header.pixelWidth, mipmaplevel);
+	tasks.level.height = TinyKtx2_MipMapReduce(ctx->header.pixelHeight, mipmaplevel);
+	tasks.level.levelData = levelData;
+	tasks.level.levelDataSize = (size_t) ctx->levels[mipmaplevel].uncompressedByteLength;
+	tasks.level.dst = dst;
+	tasks.faces = ctx->header.faceCount ? ctx->header.faceCount : 1;
+	tasks.depth = TinyKtx2_MipMapReduce(ctx->header.pixelDepth, mipmaplevel);
+	tasks.imageSize = levelSize / imageCount;
+	tasks.okay = (bool *) ctx->callbacks.alloc(ctx->user, sizeof(bool) * imageCount);
+	if (tasks.okay == NULL)
+		return false;
+
+	if (dispatch != NULL && imageCount > 1) {
+		dispatch(dispatchUser, &TinyKtx2_transcodeTask, &tasks, imageCount);
+	} else {
+		for (uint32_t i = 0u; i < imageCount; ++i) {
+			TinyKtx2_transcodeTask(&tasks, i);
+		}
+	}
+
+	bool okay = true;
+	for (uint32_t i = 0u; i < imageCount; ++i) {
+		okay = okay && tasks.okay[i];
+	}
+	ctx->callbacks.free(ctx->user, tasks.okay);
+	if (!okay) {
+		ctx->callbacks.error(ctx->user, "Transcode failed");
+	}
+	return okay;
+}
+
+
+
+static uint32_t TinyKtx2_dfdBasicBlock(uint32_t *dfd,
+																			 uint32_t colorModel,
+																			 TinyKtx2_DfdNumeric numeric,
+																			 uint32_t blockWidth,
+																			 uint32_t blockHeight,
+																			 uint32_t bytesPlane,
+																			 TinyKtx2_DfdChannel const *channels,
+																			 uint32_t channelCount) {
+	bool const compressed = colorModel != TKTX2_DFD_MODEL_RGBSDA;
+	uint32_t const blockSize = 24 + 16 * channelCount;
+
+	dfd[0] = 4 + blockSize;
+	dfd[1] = 0; // vendor Khronos, descriptor type basic
+	dfd[2] = 2 | (blockSize << 16); // version 2
+	dfd[3] = colorModel | (1 << 8) | // BT709 primaries
+			((numeric == TKTX2_DFD_SRGB ? 2u : 1u) << 16); // transfer function
+	dfd[4] = (blockWidth - 1) | ((blockHeight - 1) << 8);
+	dfd[5] = bytesPlane;
+	dfd[6] = 0;
+
+	uint32_t *s = dfd + 7;
+	for (uint32_t i = 0; i < channelCount; ++i, s += 4) {
+		uint32_t const bits = channels[i].bitLength;
+		uint32_t qualifiers = 0;
+		uint32_t lower = 0;
+		uint32_t upper = (compressed || bits >= 32) ? 0xFFFFFFFFu : ((1u << bits) - 1u);
+		switch (numeric) {
+		case TKTX2_DFD_UNORM: break;
+		case TKTX2_DFD_SRGB:
+			if (channels[i].channel == TKTX2_DFD_CH_A && !compressed) qualifiers = TKTX2_DFD_QUALIFIER_LINEAR;
+			break;
+		case TKTX2_DFD_SNORM:
+			qualifiers = TKTX2_DFD_QUALIFIER_SIGNED;
+			if (compressed || bits >= 32) {
+				lower = 0x80000000u;
+				upper = 0x7FFFFFFFu;
+			} else {
+				upper = (1u << (bits - 1)) - 1u;
+				lower = (uint32_t) -(int32_t) upper;
+			}
+			break;
+		case TKTX2_DFD_UINT: lower = 0; upper = 1; break;
+		case TKTX2_DFD_SINT:
+			qualifiers = TKTX2_DFD_QUALIFIER_SIGNED;
+			lower = 0xFFFFFFFFu;
+			upper = 1;
+			break;
+		case TKTX2_DFD_UFLOAT:
+			qualifiers = TKTX2_DFD_QUALIFIER_FLOAT;
+			lower = 0;
+			upper = 0x3F800000u;
+			break;
+		case TKTX2_DFD_SFLOAT:
+			qualifiers = TKTX2_DFD_QUALIFIER_FLOAT | TKTX2_DFD_QUALIFIER_SIGNED;
+			lower = 0xBF800000u;
+			upper = 0x3F800000u;
+			break;
+		}
+		s[0] = channels[i].bitOffset | ((bits - 1u) << 16) | ((channels[i].channel | qualifiers) << 24);
+		s[1] = 0; // sample position
+		s[2] = lower;
+		s[3] = upper;
+	}
+	return dfd[0];
+}
+
+// returns the byte size of the dfd (including the total size word) or 0 for unknown formats
+static uint32_t TinyKtx2_BuildDfd(TinyKtx_Format format, uint32_t dfd[TINYKTX2_DFD_MAX_WORDS]) {
+	uint32_t bw, bh, bd, bytes;
+	if (!TinyKtx_FormatBlockInfo(format, &bw, &bh, &bd, &bytes))
+		return 0;
+
+	// channel layouts, bit offsets are from the lsb of the little endian block
+#define TKTX2_CH(c, o, l) { TKTX2_DFD_CH_##c, l, o }
+	static TinyKtx2_DfdChannel const R4G4[] = { TKTX2_CH(G, 0, 4), TKTX2_CH(R, 4, 4) };
+	static TinyKtx2_DfdChannel const R4G4B4A4[] = { TKTX2_CH(A, 0, 4), TKTX2_CH(B, 4, 4), TKTX2_CH(G, 8, 4), TKTX2_CH(R, 12, 4) };
+	static TinyKtx2_DfdChannel const B4G4R4A4[] = { TKTX2_CH(A, 0, 4), TKTX2_CH(R, 4, 4), TKTX2_CH(G, 8, 4), TKTX2_CH(B, 12, 4) };
+	static TinyKtx2_DfdChannel const R5G6B5[] = { TKTX2_CH(B, 0, 5), TKTX2_CH(G, 5, 6), TKTX2_CH(R, 11, 5) };
+	static TinyKtx2_DfdChannel const B5G6R5[] = { TKTX2_CH(R, 0, 5), TKTX2_CH(G, 5, 6), TKTX2_CH(B, 11, 5) };
+	static TinyKtx2_DfdChannel const R5G5B5A1[] = { TKTX2_CH(A, 0, 1), TKTX2_CH(B, 1, 5), TKTX2_CH(G, 6, 5), TKTX2_CH(R, 11, 5) };
+	static TinyKtx2_DfdChannel const B5G5R5A1[] = { TKTX2_CH(A, 0, 1), TKTX2_CH(R, 1, 5), TKTX2_CH(G, 6, 5), TKTX2_CH(B, 11, 5) };
+	static TinyKtx2_DfdChannel const A1R5G5B5[] = { TKTX2_CH(B, 0, 5), TKTX2_CH(G, 5, 5), TKTX2_CH(R, 10, 5), TKTX2_CH(A, 15, 1) };
+	static TinyKtx2_DfdChannel const A2R10G10B10[] = { TKTX2_CH(B, 0, 10), TKTX2_CH(G, 10, 10), TKTX2_CH(R, 20, 10), TKTX2_CH(A, 30, 2) };
+	static TinyKtx2_DfdChannel const A2B10G10R10[] = { TKTX2_CH(R, 0, 10), TKTX2_CH(G, 10, 10), TKTX2_CH(B, 20, 10), TKTX2_CH(A, 30, 2) };
+	static TinyKtx2_DfdChannel const B10G11R11[] = { TKTX2_CH(R, 0, 11), TKTX2_CH(G, 11, 11), TKTX2_CH(B, 22, 10) };
+
+	static TinyKtx2_DfdChannel const BC1[] = { TKTX2_CH(COLOR, 0, 64) };
+	static TinyKtx2_DfdChannel const BC1A[] = { TKTX2_CH(BC1_ALPHA, 0, 64) };
+	static TinyKtx2_DfdChannel const BC2_3[] = { TKTX2_CH(A, 0, 64), TKTX2_CH(COLOR, 64, 64) };
+	static TinyKtx2_DfdChannel const BC4[] = { TKTX2_CH(R, 0, 64) };
+	static TinyKtx2_DfdChannel const BC5[] = { TKTX2_CH(R, 0, 64), TKTX2_CH(G, 64, 64) };
+	static TinyKtx2_DfdChannel const BLOCK128[] = { TKTX2_CH(COLOR, 0, 128) };
+	static TinyKtx2_DfdChannel const PVRTC[] = { TKTX2_CH(COLOR, 0, 64) };
+	static TinyKtx2_DfdChannel const ETC2_RGB[] = { TKTX2_CH(ETC2_COLOR, 0, 64) };
+	static TinyKtx2_DfdChannel const ETC2_RGBA1[] = { TKTX2_CH(ETC2_COLOR, 0, 64), TKTX2_CH(A, 0, 64) };
+	static TinyKtx2_DfdChannel const ETC2_RGBA[] = { TKTX2_CH(A, 0, 64), TKTX2_CH(ETC2_COLOR, 64, 64) };
+	static TinyKtx2_DfdChannel const EAC_R[] = { TKTX2_CH(R, 0, 64) };
+	static TinyKtx2_DfdChannel const EAC_RG[] = { TKTX2_CH(R, 0, 64), TKTX2_CH(G, 64, 64) };
+#undef TKTX2_CH
+
+#define TKTX2_PACKED(fmt, layout, num) case TKTX_##fmt: \
+	return TinyKtx2_dfdBasicBlock(dfd, TKTX2_DFD_MODEL_RGBSDA, num, 1, 1, bytes, layout, sizeof(layout) / sizeof(layout[0]));
+#define TKTX2_BLOCK(fmt, model, layout, num) case TKTX_##fmt: \
+	return TinyKtx2_dfdBasicBlock(dfd, model, num, bw, bh, bytes, layout, sizeof(layout) / sizeof(layout[0]));
+
+	switch (format) {
+	TKTX2_PACKED(R4G4_UNORM_PACK8, R4G4, TKTX2_DFD_UNORM)
+	TKTX2_PACKED(R4G4B4A4_UNORM_PACK16, R4G4B4A4, TKTX2_DFD_UNORM)
+	TKTX2_PACKED(B4G4R4A4_UNORM_PACK16, B4G4R4A4, TKTX2_DFD_UNORM)
+	TKTX2_PACKED(R5G6B5_UNORM_PACK16, R5G6B5, TKTX2_DFD_UNORM)
+	TKTX2_PACKED(B5G6R5_UNORM_PACK16, B5G6R5, TKTX2_DFD_UNORM)
+	TKTX2_PACKED(R5G5B5A1_UNORM_PACK16, R5G5B5A1, TKTX2_DFD_UNORM)
+	TKTX2_PACKED(B5G5R5A1_UNORM_PACK16, B5G5R5A1, TKTX2_DFD_UNORM)
+	TKTX2_PACKED(A1R5G5B5_UNORM_PACK16, A1R5G5B5, TKTX2_DFD_UNORM)
+	TKTX2_PACKED(A2R10G10B10_UNORM_PACK32, A2R10G10B10, TKTX2_DFD_UNORM)
+	TKTX2_PACKED(A2R10G10B10_UINT_PACK32, A2R10G10B10, TKTX2_DFD_UINT)
+	TKTX2_PACKED(A2B10G10R10_UNORM_PACK32, A2B10G10R10, TKTX2_DFD_UNORM)
+	TKTX2_PACKED(A2B10G10R10_UINT_PACK32, A2B10G10R10, TKTX2_DFD_UINT)
+	TKTX2_PACKED(B10G11R11_UFLOAT_PACK32, B10G11R11, TKTX2_DFD_UFLOAT)
+
+	case TKTX_E5B9G9R9_UFLOAT_PACK32: {
+		// shared exponent, 3 mantissa samples followed by 3 exponent samples
+		static TinyKtx2_DfdChannel const E5B9G9R9[] = {
+				{ TKTX2_DFD_CH_R, 9, 0 }, { TKTX2_DFD_CH_G, 9, 9 }, { TKTX2_DFD_CH_B, 9, 18 },
+				{ TKTX2_DFD_CH_R, 5, 27 }, { TKTX2_DFD_CH_G, 5, 27 }, { TKTX2_DFD_CH_B, 5, 27 },
+		};
+		uint32_t const size = TinyKtx2_dfdBasicBlock(dfd, TKTX2_DFD_MODEL_RGBSDA, TKTX2_DFD_UNORM, 1, 1, bytes, E5B9G9R9, 6);
+		for (uint32_t i = 0; i < 6; ++i) {
+			uint32_t *s = dfd + 7 + i * 4;
+			if (i < 3) {
+				s[2] = 0;
+				s[3] = 256;
+			} else {
+				s[0] |= (uint32_t) TKTX2_DFD_QUALIFIER_EXPONENT << 24;
+				s[2] = 15;
+				s[3] = 31;
+			}
+		}
+		return size;
+	}
+
+	TKTX2_BLOCK(BC1_RGB_UNORM_BLOCK, TKTX2_DFD_MODEL_BC1A, BC1, TKTX2_DFD_UNORM)
+	TKTX2_BLOCK(BC1_RGB_SRGB_BLOCK, TKTX2_DFD_MODEL_BC1A, BC1, TKTX2_DFD_SRGB)
+	TKTX2_BLOCK(BC1_RGBA_UNORM_BLOCK, TKTX2_DFD_MODEL_BC1A, BC1A, TKTX2_DFD_UNORM)
+	TKTX2_BLOCK(BC1_RGBA_SRGB_BLOCK, TKTX2_DFD_MODEL_BC1A, BC1A, TKTX2_DFD_SRGB)
+	TKTX2_BLOCK(BC2_UNORM_BLOCK, TKTX2_DFD_MODEL_BC2, BC2_3, TKTX2_DFD_UNORM)
+	TKTX2_BLOCK(BC2_SRGB_BLOCK, TKTX2_DFD_MODEL_BC2, BC2_3, TKTX2_DFD_SRGB)
+	TKTX2_BLOCK(BC3_UNORM_BLOCK, TKTX2_DFD_MODEL_BC3, BC2_3, TKTX2_DFD_UNORM)
+	TKTX2_BLOCK(BC3_SRGB_BLOCK, TKTX2_DFD_MODEL_BC3, BC2_3, TKTX2_DFD_SRGB)
+	TKTX2_BLOCK(BC4_UNORM_BLOCK, TKTX2_DFD_MODEL_BC4, BC4, TKTX2_DFD_UNORM)
+	TKTX2_BLOCK(BC4_SNORM_BLOCK, TKTX2_DFD_MODEL_BC4, BC4, TKTX2_DFD_SNORM)
+	TKTX2_BLOCK(BC5_UNORM_BLOCK, TKTX2_DFD_MODEL_BC5, BC5, TKTX2_DFD_UNORM)
+	TKTX2_BLOCK(BC5_SNORM_BLOCK, TKTX2_DFD_MODEL_BC5, BC5, TKTX2_DFD_SNORM)
+	TKTX2_BLOCK(BC6H_UFLOAT_BLOCK, TKTX2_DFD_MODEL_BC6H, BLOCK128, TKTX2_DFD_UFLOAT)
+	TKTX2_BLOCK(BC6H_SFLOAT_BLOCK, TKTX2_DFD_MODEL_BC6H, BLOCK128, TKTX2_DFD_SFLOAT)
+	TKTX2_BLOCK(BC7_UNORM_BLOCK, TKTX2_DFD_MODEL_BC7, BLOCK128, TKTX2_DFD_UNORM)
+	TKTX2_BLOCK(BC7_SRGB_BLOCK, TKTX2_DFD_MODEL_BC7, BLOCK128, TKTX2_DFD_SRGB)
+
+	TKTX2_BLOCK(ETC2_R8G8B8_UNORM_BLOCK, TKTX2_DFD_MODEL_ETC2, ETC2_RGB, TKTX2_DFD_UNORM)
+	TKTX2_BLOCK(ETC2_R8G8B8_SRGB_BLOCK, TKTX2_DFD_MODEL_ETC2, ETC2_RGB, TKTX2_DFD_SRGB)
+	TKTX2_BLOCK(ETC2_R8G8B8A1_UNORM_BLOCK, TKTX2_DFD_MODEL_ETC2, ETC2_RGBA1, TKTX2_DFD_UNORM)
+	TKTX2_BLOCK(ETC2_R8G8B8A1_SRGB_BLOCK, TKTX2_DFD_MODEL_ETC2, ETC2_RGBA1, TKTX2_DFD_SRGB)
+	TKTX2_BLOCK(ETC2_R8G8B8A8_UNORM_BLOCK, TKTX2_DFD_MODEL_ETC2, ETC2_RGBA, TKTX2_DFD_UNORM)
+	TKTX2_BLOCK(ETC2_R8G8B8A8_SRGB_BLOCK, TKTX2_DFD_MODEL_ETC2, ETC2_RGBA, TKTX2_DFD_SRGB)
+	TKTX2_BLOCK(EAC_R11_UNORM_BLOCK, TKTX2_DFD_MODEL_ETC2, EAC_R, TKTX2_DFD_UNORM)
+	TKTX2_BLOCK(EAC_R11_SNORM_BLOCK, TKTX2_DFD_MODEL_ETC2, EAC_R, TKTX2_DFD_SNORM)
+	TKTX2_BLOCK(EAC_R11G11_UNORM_BLOCK, TKTX2_DFD_MODEL_ETC2, EAC_RG, TKTX2_DFD_UNORM)
+	TKTX2_BLOCK(EAC_R11G11_SNORM_BLOCK, TKTX2_DFD_MODEL_ETC2, EAC_RG, TKTX2_DFD_SNORM)
+
+	TKTX2_BLOCK(PVR_2BPP_UNORM_BLOCK, TKTX2_DFD_MODEL_PVRTC, PVRTC, TKTX2_DFD_UNORM)
+	TKTX2_BLOCK(PVR_4BPP_UNORM_BLOCK, TKTX2_DFD_MODEL_PVRTC, PVRTC, TKTX2_DFD_UNORM)
+	TKTX2_BLOCK(PVR_2BPP_SRGB_BLOCK, TKTX2_DFD_MODEL_PVRTC, PVRTC, TKTX2_DFD_SRGB)
+	TKTX2_BLOCK(PVR_4BPP_SRGB_BLOCK, TKTX2_DFD_MODEL_PVRTC, PVRTC, TKTX2_DFD_SRGB)
+	TKTX2_BLOCK(PVR_2BPPA_UNORM_BLOCK, TKTX2_DFD_MODEL_PVRTC2, PVRTC, TKTX2_DFD_UNORM)
+	TKTX2_BLOCK(PVR_4BPPA_UNORM_BLOCK, TKTX2_DFD_MODEL_PVRTC2, PVRTC, TKTX2_DFD_UNORM)
+	TKTX2_BLOCK(PVR_2BPPA_SRGB_BLOCK, TKTX2_DFD_MODEL_PVRTC2, PVRTC, TKTX2_DFD_SRGB)
+	TKTX2_BLOCK(PVR_4BPPA_SRGB_BLOCK, TKTX2_DFD_MODEL_PVRTC2, PVRTC, TKTX2_DFD_SRGB)
+
+	default: break;
+	}
+#undef TKTX2_PACKED
+#undef TKTX2_BLOCK
+
+	// ASTC formats all share a layout, only the footprint changes
+	if (format >= TKTX_ASTC_4x4_UNORM_BLOCK && format <= TKTX_ASTC_12x12_SRGB_BLOCK) {
+		bool const srgb = ((format - TKTX_ASTC_4x4_UNORM_BLOCK) & 1) != 0;
+		return TinyKtx2_dfdBasicBlock(dfd, TKTX2_DFD_MODEL_ASTC, srgb ? TKTX2_DFD_SRGB : TKTX2_DFD_UNORM,
+																	bw, bh, bytes, BLOCK128, 1);
+	}
+
+	// everything else is whole bytes per channel, figure out channel order and numeric type
+	// from the vulkan style format name order (uncompressed formats are in blocks of 7 or 5)
+	TinyKtx2_DfdChannel channels[4];
+	uint32_t channelCount;
+	uint32_t channelBits;
+	char const *order;
+	TinyKtx2_DfdNumeric numeric;
+	if (format >= TKTX_R8_UNORM && format <= TKTX_A8B8G8R8_SRGB_PACK32) {
+		static char const *const orders[] = { "R", "RG", "RGB", "BGR", "RGBA", "BGRA", "RGBA" };
+		static TinyKtx2_DfdNumeric const numerics[] = {
+				TKTX2_DFD_UNORM, TKTX2_DFD_SNORM, TKTX2_DFD_UNORM, TKTX2_DFD_SNORM, // USCALED/SSCALED as norm
+				TKTX2_DFD_UINT, TKTX2_DFD_SINT, TKTX2_DFD_SRGB };
+		uint32_t const index = format - TKTX_R8_UNORM;
+		order = orders[index / 7];
+		numeric = numerics[index % 7];
+		channelBits = 8;
+	} else if (format >= TKTX_R16_UNORM && format <= TKTX_R16G16B16A16_SFLOAT) {
+		static TinyKtx2_DfdNumeric const numerics[] = {
+				TKTX2_DFD_UNORM, TKTX2_DFD_SNORM, TKTX2_DFD_UNORM, TKTX2_DFD_SNORM,
+				TKTX2_DFD_UINT, TKTX2_DFD_SINT, TKTX2_DFD_SFLOAT };
+		static char const *const orders[] = { "R", "RG", "RGB", "RGBA" };
+		uint32_t const index = format - TKTX_R16_UNORM;
+		order = orders[index / 7];
+		numeric = numerics[index % 7];
+		channelBits = 16;
+	} else if (format >= TKTX_R32_UINT && format <= TKTX_R32G32B32A32_SFLOAT) {
+		static TinyKtx2_DfdNumeric const numerics[] = { TKTX2_DFD_UINT, TKTX2_DFD_SINT, TKTX2_DFD_SFLOAT };
+		static char const *const orders[] = { "R", "RG", "RGB", "RGBA" };
+		uint32_t const index = format - TKTX_R32_UINT;
+		order = orders[index / 3];
+		numeric = numerics[index % 3];
+		channelBits = 32;
+	} else {
+		return 0;
+	}
+
+	channelCount = 0;
+	for (char const *c = order; *c; ++c, ++channelCount) {
+		channels[channelCount].channel = (*c == 'R') ? TKTX2_DFD_CH_R :
+																		 (*c == 'G') ? TKTX2_DFD_CH_G :
+																		 (*c == 'B') ? TKTX2_DFD_CH_B : TKTX2_DFD_CH_A;
+		channels[channelCount].bitOffset = (uint16_t) (channelCount * channelBits);
+		channels[channelCount].bitLength = (uint8_t) channelBits;
+	}
+	return TinyKtx2_dfdBasicBlock(dfd, TKTX2_DFD_MODEL_RGBSDA, numeric, 1, 1, bytes, channels, channelCount);
+}
+
+static uint32_t TinyKtx2_layoutImageCount(TinyKtx2_WriteLayout const *layout) {
+	return ((layout->slices == 0) ? 1 : layout->slices) * layout->faces;
+}
+
+bool TinyKtx2_ComputeWriteLayout(TinyKtx2_WriteCallbacks const *callbacks,
+																 void *user,
+																 uint32_t width,
+																 uint32_t height,
+																 uint32_t depth,
+																 uint32_t slices,
+																 uint32_t mipmaplevels,
+																 TinyKtx_Format format,
+																 bool cubemap,
+																 uint32_t const *mipmapsizes,
+																 TinyKtx2_WriteLayout *layout) {
+	uint64_t sizes[TINYKTX2_MAX_MIPMAPLEVELS];
+	if (mipmapsizes != NULL) {
+		for (uint32_t i = 0u; i < mipmaplevels && i < TINYKTX2_MAX_MIPMAPLEVELS; ++i) {
+			sizes[i] = mipmapsizes[i];
+		}
+	}
+	return TinyKtx2_ComputeWriteLayout64(callbacks, user, width, height, depth, slices, mipmaplevels,
+																			 format, cubemap, mipmapsizes ? sizes : NULL, layout);
+}
+
+bool TinyKtx2_ComputeWriteLayout64(TinyKtx2_WriteCallbacks const *callbacks,
+																	 void *user,
+																	 uint32_t width,
+																	 uint32_t height,
+																	 uint32_t depth,
+																	 uint32_t slices,
+																	 uint32_t mipmaplevels,
+																	 TinyKtx_Format format,
+																	 bool cubemap,
+																	 uint64_t const *mipmapsizes,
+																	 TinyKtx2_WriteLayout *layout) {
+	if (layout == NULL)
+		return false;
+	memset(layout, 0, sizeof(TinyKtx2_WriteLayout));
+
+	if (mipmaplevels == 0 || mipmaplevels > TINYKTX2_MAX_MIPMAPLEVELS) {
+		callbacks->error(user, "Invalid number of mipmap levels");
+		return false;
+	}
+
+	uint64_t computedsizes[TINYKTX2_MAX_MIPMAPLEVELS];
+	if (!TinyKtx_ComputeMipmapSizes64(width, height, depth, slices, mipmaplevels, format, cubemap, computedsizes)) {
+		callbacks->error(user, "Format not supported by the KTX v2 writer");
+		return false;
+	}
+	if (mipmapsizes == NULL)
+		mipmapsizes = computedsizes;
+
+	uint32_t blockByteSize;
+	uint32_t dfd[TINYKTX2_DFD_MAX_WORDS];
+	uint32_t const dfdByteLength = TinyKtx2_BuildDfd(format, dfd);
+	if (dfdByteLength == 0 || !TinyKtx_FormatBlockInfo(format, NULL, NULL, NULL, &blockByteSize)) {
+		callbacks->error(user, "Format not supported by the KTX v2 writer");
+		return false;
+	}
+
+	layout->format = format;
+	layout->width = width;
+	layout->height = height;
+	layout->depth = depth;
+	layout->slices = slices;
+	layout->faces = cubemap ? 6 : 1;
+	layout->mipmaplevels = mipmaplevels;
+
+	uint32_t const images = TinyKtx2_layoutImageCount(layout);
+
+	// header, level index then the dfd. Level data follows smallest level first, each
+	// aligned to lcm(texel block size, 4)
+	uint64_t offset = sizeof(TinyKtx2_Header) + sizeof(TinyKtx2_Level) * mipmaplevels;
+	layout->dfdByteOffset = (uint32_t) offset;
+	layout->dfdByteLength = dfdByteLength;
+	offset += dfdByteLength;
+
+	uint64_t const alignment = (blockByteSize % 4 == 0) ? blockByteSize :
+														 (blockByteSize % 2 == 0) ? blockByteSize * 2 : blockByteSize * 4;
+
+	for (uint32_t i = mipmaplevels; i-- > 0;) {
+		TinyKtx2_WriteLevelLayout *lvl = &layout->levels[i];
+		if (mipmapsizes[i] != computedsizes[i]) {
+			callbacks->error(user, "Mipmap size doesn't match the format and dimensions");
+			return false;
+		}
+		offset = ((offset + alignment - 1) / alignment) * alignment;
+		lvl->byteOffset = offset;
+		lvl->byteLength = mipmapsizes[i];
+		lvl->faceByteLength = mipmapsizes[i] / images;
+		offset += lvl->byteLength;
+	}
+	layout->totalByteLength = offset;
+
+	return true;
+}
+
+// size of the data type for endian conversion, 1 for block compressed formats
+static uint32_t TinyKtx2_typeSize(TinyKtx_Format format) {
+	uint32_t glformat, gltype, glinternalformat, typesize;
+	if (!TinyKtx_CrackFormatToGL(format, &glformat, &gltype, &glinternalformat, &typesize) || typesize == 0)
+		return 1;
+	return typesize;
+}
+
+static void TinyKtx2_fillHeaderFromLayout(TinyKtx2_WriteLayout const *layout,
+																					TinyKtx2_Header *header,
+																					TinyKtx2_Level *levels) {
+	memset(header, 0, sizeof(TinyKtx2_Header));
+	memcpy(header->identifier, TinyKtx2_fileIdentifier, 12);
+	header->vkFormat = layout->format;
+	header->typeSize = TinyKtx2_typeSize(layout->format);
+	header->pixelWidth = layout->width;
+	header->pixelHeight = (layout->height == 1) ? 0 : layout->height;
+	header->pixelDepth = (layout->depth == 1) ? 0 : layout->depth;
+	header->arrayElementCount = (layout->slices == 1) ? 0 : layout->slices;
+	header->faceCount = layout->faces;
+	header->levelCount = layout->mipmaplevels;
+	header->supercompressionScheme = TKTX2_SUPERCOMPRESSION_NONE;
+	header->dfdByteOffset = layout->dfdByteOffset;
+	header->dfdByteLength = layout->dfdByteLength;
+	// no key/value data, kvdByteOffset and kvdByteLength stay 0
+
+	for (uint32_t i = 0u; i < layout->mipmaplevels; ++i) {
+		levels[i].byteOffset = layout->levels[i].byteOffset;
+		levels[i].byteLength = layout->levels[i].byteLength;
+		levels[i].uncompressedByteLength = layout->levels[i].byteLength;
+	}
+}
+
+bool TinyKtx2_WriteHeaderPositional(TinyKtx2_WriteCallbacks const *callbacks,
+																		void *user,
+																		TinyKtx2_WriteLayout const *layout) {
+	if (callbacks->pwrite == NULL) {
+		callbacks->error(user, "Positional writer requires pwrite");
+		return false;
+	}
+
+	TinyKtx2_Header header;
+	TinyKtx2_Level levels[TINYKTX2_MAX_MIPMAPLEVELS];
+	uint32_t dfd[TINYKTX2_DFD_MAX_WORDS];
+	TinyKtx2_fillHeaderFromLayout(layout, &header, levels);
+	TinyKtx2_BuildDfd(layout->format, dfd);
+
+	callbacks->pwrite(user, 0, &header, sizeof(TinyKtx2_Header));
+	callbacks->pwrite(user, sizeof(TinyKtx2_Header), levels, sizeof(TinyKtx2_Level) * layout->mipmaplevels);
+	callbacks->pwrite(user, layout->dfdByteOffset, dfd, layout->dfdByteLength);
+
+	// zero the alignment padding before each level
+	static uint8_t const padding[16] = {0};
+	uint64_t end = layout->dfdByteOffset + layout->dfdByteLength;
+	for (uint32_t i = layout->mipmaplevels; i-- > 0;) {
+		TinyKtx2_WriteLevelLayout const *lvl = &layout->levels[i];
+		if (lvl->byteOffset > end) {
+			callbacks->pwrite(user, end, padding, (size_t) (lvl->byteOffset - end));
+		}
+		end = lvl->byteOffset + lvl->byteLength;
+	}
+	return true;
+}
+
+bool TinyKtx2_WriteFacePositional(TinyKtx2_WriteCallbacks const *callbacks,
+																	void *user,
+																	TinyKtx2_WriteLayout const *layout,
+																	uint32_t mipmaplevel,
+																	uint32_t slice,
+																	uint32_t face,
+																	void const *data) {
+	if (callbacks->pwrite == NULL) {
+		callbacks->error(user, "Positional writer requires pwrite");
+		return false;
+	}
+	if (mipmaplevel >= layout->mipmaplevels) {
+		callbacks->error(user, "Invalid mipmap level");
+		return false;
+	}
+	if (face >= layout->faces || slice >= ((layout->slices == 0) ? 1 : layout->slices)) {
+		callbacks->error(user, "Invalid slice or face");
+		return false;
+	}
+
+	TinyKtx2_WriteLevelLayout const *lvl = &layout->levels[mipmaplevel];
+	uint64_t const offset = lvl->byteOffset + (uint64_t) (slice * layout->faces + face) * lvl->faceByteLength;
+	callbacks->pwrite(user, offset, data, (size_t) lvl->faceByteLength);
+	return true;
+}
+
+bool TinyKtx2_WriteLevelPositional(TinyKtx2_WriteCallbacks const *callbacks,
+																	 void *user,
+																	 TinyKtx2_WriteLayout const *layout,
+																	 uint32_t mipmaplevel,
+																	 void const *data) {
+	if (callbacks->pwrite == NULL) {
+		callbacks->error(user, "Positional writer requires pwrite");
+		return false;
+	}
+	if (mipmaplevel >= layout->mipmaplevels) {
+		callbacks->error(user, "Invalid mipmap level");
+		return false;
+	}
+	TinyKtx2_WriteLevelLayout const *lvl = &layout->levels[mipmaplevel];
+	callbacks->pwrite(user, lvl->byteOffset, data, (size_t) lvl->byteLength);
+	return true;
+}
+
+// serial writer for a computed layout, source data is either one pointer per level
+// or (if faces isn't NULL) one per slice/face
+static bool TinyKtx2_writeSerial(TinyKtx2_WriteCallbacks const *callbacks,
+																 void *user,
+																 TinyKtx2_WriteLayout const *layout,
+																 void const **mipmaps,
+																 void const **faces) {
+	uint32_t const images = TinyKtx2_layoutImageCount(layout);
+
+	// check all the data is there before writing anything
+	void const **table = faces ? faces : mipmaps;
+	uint32_t const count = faces ? layout->mipmaplevels * images : layout->mipmaplevels;
+	for (uint32_t i = 0u; i < count; ++i) {
+		if (table == NULL || table[i] == NULL) {
+			callbacks->error(user, faces ? "Missing slice/face data" : "Missing mipmap data");
+			return false;
+		}
+	}
+
+	TinyKtx2_Header header;
+	TinyKtx2_Level levels[TINYKTX2_MAX_MIPMAPLEVELS];
+	uint32_t dfd[TINYKTX2_DFD_MAX_WORDS];
+	TinyKtx2_fillHeaderFromLayout(layout, &header, levels);
+	TinyKtx2_BuildDfd(layout->format, dfd);
+
+	callbacks->write(user, &header, sizeof(TinyKtx2_Header));
+	callbacks->write(user, levels, sizeof(TinyKtx2_Level) * layout->mipmaplevels);
+	callbacks->write(user, dfd, layout->dfdByteLength);
+
+	static uint8_t const padding[16] = {0};
+	uint64_t end = layout->dfdByteOffset + layout->dfdByteLength;
+	for (uint32_t i = layout->mipmaplevels; i-- > 0;) {
+		TinyKtx2_WriteLevelLayout const *lvl = &layout->levels[i];
+		callbacks->write(user, padding, (size_t) (lvl->byteOffset - end));
+		if (faces) {
+			for (uint32_t j = 0u; j < images; ++j) {
+				callbacks->write(user, faces[i * images + j], (size_t) lvl->faceByteLength);
+			}
+		} else {
+			callbacks->write(user, mipmaps[i], (size_t) lvl->byteLength);
+		}
+		end = lvl->byteOffset + lvl->byteLength;
+	}
+	return true;
+}
+
+bool TinyKtx2_WriteImage(TinyKtx2_WriteCallbacks const *callbacks,
+												 void *user,
+												 uint32_t width,
+												 uint32_t height,
+												 uint32_t depth,
+												 uint32_t slices,
+												 uint32_t mipmaplevels,
+												 TinyKtx_Format format,
+												 bool cubemap,
+												 uint32_t const *mipmapsizes,
+												 void const **mipmaps) {
+	TinyKtx2_WriteLayout layout;
+	if (!TinyKtx2_ComputeWriteLayout(callbacks, user, width, height, depth, slices, mipmaplevels,
+																	 format, cubemap, mipmapsizes, &layout)) {
+		return false;
+	}
+	return TinyKtx2_writeSerial(callbacks, user, &layout, mipmaps, NULL);
+}
+
+bool TinyKtx2_WriteImageFaces(TinyKtx2_WriteCallbacks const *callbacks,
+															void *user,
+															uint32_t width,
+															uint32_t height,
+															uint32_t depth,
+															uint32_t slices,
+															uint32_t mipmaplevels,
+															TinyKtx_Format format,
+															bool cubemap,
+															uint32_t const *mipmapsizes,
+															void const **faces) {
+	TinyKtx2_WriteLayout layout;
+	if (!TinyKtx2_ComputeWriteLayout(callbacks, user, width, height, depth, slices, mipmaplevels,
+																	 format, cubemap, mipmapsizes, &layout)) {
+		return false;
+	}
+	return TinyKtx2_writeSerial(callbacks, user, &layout, NULL, faces);
+}
+
+bool TinyKtx2_WriteImageGL(TinyKtx2_WriteCallbacks const *callbacks,
+													 void *user,
+													 uint32_t width,
+													 uint32_t height,
+													 uint32_t depth,
+													 uint32_t slices,
+													 uint32_t mipmaplevels,
+													 uint32_t format,
+													 uint32_t internalFormat,
+													 uint32_t baseFormat,
+													 uint32_t type,
+													 uint32_t typeSize,
+													 bool cubemap,
+													 uint32_t const *mipmapsizes,
+													 void const **mipmaps) {
+	(void) baseFormat;
+	TinyKtx_Format const fmt = TinyKtx_CrackFormatFromGL(format, type, internalFormat, typeSize);
+	if (fmt == TKTX_UNDEFINED) {
+		callbacks->error(user, "GL format has no KTX v2 equivalent");
+		return false;
+	}
+	return TinyKtx2_WriteImage(callbacks, user, width, height, depth, slices, mipmaplevels,
+														 fmt, cubemap, mipmapsizes, mipmaps);
+}
+
+static bool TinyKtx2_updateCheck(TinyKtx2_Context *ctx,
+																 TinyKtx2_WriteCallbacks const *callbacks,
+																 void *user,
+																 uint32_t mipmaplevel) {
+	if (ctx->headerValid == false) {
+		callbacks->error(user, "Header data hasn't been read yet or its invalid");
+		return false;
+	}
+	uint32_t const levelCount = ctx->header.levelCount ? ctx->header.levelCount : 1;
+	if (mipmaplevel >= levelCount) {
+		callbacks->error(user, "Invalid mipmap level");
+		return false;
+	}
+	return true;
+}
+
+// copy a range of the source file to the write callback, offset is from the start of the KTX
+static bool TinyKtx2_copyRange(TinyKtx2_Context *ctx,
+															 TinyKtx2_WriteCallbacks const *callbacks,
+															 void *user,
+															 uint64_t offset,
+															 uint64_t size) {
+	static uint64_t const chunkSize = 1024 * 1024;
+	if (size == 0)
+		return true;
+
+	uint64_t const bufferSize = size < chunkSize ? size : chunkSize;
+	void *buffer = ctx->callbacks.alloc(ctx->user, (size_t) bufferSize);
+	if (buffer == NULL)
+		return false;
+
+	if (!TinyKtx2_seek(ctx, ctx->headerPos + offset)) {
+		ctx->callbacks.free(ctx->user, buffer);
+		return false;
+	}
+	while (size > 0) {
+		size_t const count = (size_t) (size < bufferSize ? size : bufferSize);
+		if (TinyKtx2_read(ctx, buffer, count) != count) {
+			callbacks->error(user, "Reading source file error");
+			ctx->callbacks.free(ctx->user, buffer);
+			return false;
+		}
+		callbacks->write(user, buffer, count);
+		size -= count;
+	}
+	ctx->callbacks.free(ctx->user, buffer);
+	return true;
+}
+
+bool TinyKtx2_UpdateFace(TinyKtx2_ContextHandle handle,
+												 TinyKtx2_WriteCallbacks const *callbacks,
+												 void *user,
+												 uint32_t mipmaplevel,
+												 uint32_t slice,
+												 uint32_t face,
+												 void const *data,
+												 uint64_t byteLength) {
+	TinyKtx2_Context *ctx = (TinyKtx2_Context *) handle;
+	if (ctx == NULL)
+		return false;
+	if (!TinyKtx2_updateCheck(ctx, callbacks, user, mipmaplevel))
+		return false;
+	if (ctx->header.supercompressionScheme != TKTX2_SUPERCOMPRESSION_NONE) {
+		callbacks->error(user, "Supercompressed files can only be updated a level at a time");
+		return false;
+	}
+	if (callbacks->pwrite == NULL) {
+		callbacks->error(user, "Updating in place requires pwrite");
+		return false;
+	}
+
+	uint32_t const slices = ctx->header.arrayElementCount ? ctx->header.arrayElementCount : 1;
+	if (face >= ctx->header.faceCount || slice >= slices) {
+		callbacks->error(user, "Invalid slice or face");
+		return false;
+	}
+
+	TinyKtx2_Level const *lvl = &ctx->levels[mipmaplevel];
+	uint64_t const faceByteLength = lvl->byteLength / (slices * ctx->header.faceCount);
+	if (byteLength != faceByteLength) {
+		callbacks->error(user, "Update data size doesn't match the existing data");
+		return false;
+	}
+
+	TinyKtx2_ReleaseImageRawData(ctx, mipmaplevel);
+	callbacks->pwrite(user, ctx->headerPos + lvl->byteOffset + (slice * ctx->header.faceCount + face) * faceByteLength,
+										data, (size_t) byteLength);
+	return true;
+}
+
+bool TinyKtx2_UpdateLevel(TinyKtx2_ContextHandle handle,
+													TinyKtx2_WriteCallbacks const *callbacks,
+													void *user,
+													uint32_t mipmaplevel,
+													void const *data,
+													uint64_t byteLength,
+													uint64_t uncompressedByteLength) {
+	TinyKtx2_Context *ctx = (TinyKtx2_Context *) handle;
+	if (ctx == NULL)
+		return false;
+	if (!TinyKtx2_updateCheck(ctx, callbacks, user, mipmaplevel))
+		return false;
+
+	bool const supercompressed = ctx->header.supercompressionScheme != TKTX2_SUPERCOMPRESSION_NONE;
+	TinyKtx2_Level *lvl = &ctx->levels[mipmaplevel];
+	if (!supercompressed && (byteLength != lvl->byteLength || uncompressedByteLength != lvl->byteLength)) {
+		callbacks->error(user, "Update data size doesn't match the existing data");
+		return false;
+	}
+
+	if (byteLength == lvl->byteLength) {
+		if (callbacks->pwrite == NULL) {
+			callbacks->error(user, "Updating in place requires pwrite");
+			return false;
+		}
+		TinyKtx2_ReleaseImageRawData(ctx, mipmaplevel);
+		callbacks->pwrite(user, ctx->headerPos + lvl->byteOffset, data, (size_t) byteLength);
+		if (uncompressedByteLength != lvl->uncompressedByteLength) {
+			lvl->uncompressedByteLength = uncompressedByteLength;
+			callbacks->pwrite(user, ctx->headerPos + sizeof(TinyKtx2_Header) + sizeof(TinyKtx2_Level) * mipmaplevel,
+												lvl, sizeof(TinyKtx2_Level));
+		}
+		return true;
+	}
+
+	// size has changed so stream a new file, only the level index and the data after
+	// the changed level move. Supercompressed levels have no alignment requirement
+	if (callbacks->write == NULL) {
+		callbacks->error(user, "Updating with a different size requires write");
+		return false;
+	}
+
+	uint32_t const levelCount = ctx->header.levelCount ? ctx->header.levelCount : 1;
+	uint64_t metaEnd = sizeof(TinyKtx2_Header) + sizeof(TinyKtx2_Level) * levelCount;
+	if (ctx->header.dfdByteOffset + ctx->header.dfdByteLength > metaEnd)
+		metaEnd = ctx->header.dfdByteOffset + ctx->header.dfdByteLength;
+	if (ctx->header.kvdByteOffset + ctx->header.kvdByteLength > metaEnd)
+		metaEnd = ctx->header.kvdByteOffset + ctx->header.kvdByteLength;
+	if (ctx->header.sgdByteOffset + ctx->header.sgdByteLength > metaEnd)
+		metaEnd = ctx->header.sgdByteOffset + ctx->header.sgdByteLength;
+
+	TinyKtx2_Level levels[TINYKTX2_MAX_MIPMAPLEVELS];
+	uint64_t offset = metaEnd;
+	for (uint32_t i = levelCount; i-- > 0;) {
+		levels[i] = ctx->levels[i];
+		if (i == mipmaplevel) {
+			levels[i].byteLength = byteLength;
+			levels[i].uncompressedByteLength = uncompressedByteLength;
+		}
+		levels[i].byteOffset = offset;
+		offset += levels[i].byteLength;
+	}
+
+	callbacks->write(user, &ctx->header, sizeof(TinyKtx2_Header));
+	callbacks->write(user, levels, sizeof(TinyKtx2_Level) * levelCount);
+	uint64_t const indexEnd = sizeof(TinyKtx2_Header) + sizeof(TinyKtx2_Level) * levelCount;
+	if (!TinyKtx2_copyRange(ctx, callbacks, user, indexEnd, metaEnd - indexEnd))
+		return false;
+
+	for (uint32_t i = levelCount; i-- > 0;) {
+		if (i == mipmaplevel) {
+			callbacks->write(user, data, (size_t) byteLength);
+		} else if (!TinyKtx2_copyRange(ctx, callbacks, user, ctx->levels[i].byteOffset, ctx->levels[i].byteLength)) {
+			return false;
+		}
+	}
+	return true;
+}
+
+bool TinyKtx2_ConvertFromKtx1(TinyKtx_ContextHandle ktx1,
+															TinyKtx2_WriteCallbacks const *callbacks,
+															void *user,
+															TinyKtx2_SuperCompressionScheme scheme,
+															TinyKtx2_SuperCompress compressor) {
+	if (callbacks->pwrite == NULL) {
+		callbacks->error(user, "Converting requires pwrite");
+		return false;
+	}
+	if (compressor && (scheme == TKTX2_SUPERCOMPRESSION_NONE || callbacks->alloc == NULL || callbacks->free == NULL)) {
+		callbacks->error(user, "Supercompression requires a scheme and alloc/free callbacks");
+		return false;
+	}
+
+	TinyKtx_Format const format = TinyKtx_GetFormat(ktx1);
+	if (format == TKTX_UNDEFINED) {
+		callbacks->error(user, "KTX v1 format has no KTX v2 equivalent");
+		return false;
+	}
+
+	uint32_t width, height, depth, slices;
+	TinyKtx_Dimensions(ktx1, &width, &height, &depth, &slices);
+	bool const cubemap = TinyKtx_IsCubemap(ktx1);
+	uint32_t const levelCount = TinyKtx_NumberOfMipmaps(ktx1);
+	if (levelCount > TINYKTX2_MAX_MIPMAPLEVELS) {
+		callbacks->error(user, "Too many mipmap levels");
+		return false;
+	}
+	uint32_t const faces = cubemap ? 6 : 1;
+	uint32_t const images = ((slices == 0) ? 1 : slices) * faces;
+	bool const cubePadding = cubemap && slices == 0;
+
+	TinyKtx2_WriteLayout layout;
+	if (!TinyKtx2_ComputeWriteLayout(callbacks, user, width, height, depth, slices, levelCount,
+																	 format, cubemap, NULL, &layout)) {
+		return false;
+	}
+
+	TinyKtx2_Header header;
+	TinyKtx2_Level levels[TINYKTX2_MAX_MIPMAPLEVELS];
+	uint32_t dfd[TINYKTX2_DFD_MAX_WORDS];
+	TinyKtx2_fillHeaderFromLayout(&layout, &header, levels);
+	TinyKtx2_BuildDfd(format, dfd);
+	if (compressor) {
+		header.supercompressionScheme = scheme;
+	} else {
+		TinyKtx2_WriteHeaderPositional(callbacks, user, &layout);
+	}
+
+	// supercompressed levels are packed back to back (no alignment) smallest first as they come
+	uint64_t offset = layout.dfdByteOffset + layout.dfdByteLength;
+
+	for (uint32_t i = levelCount; i-- > 0;) {
+		uint8_t const *src = (uint8_t const *) TinyKtx_ImageRawData(ktx1, i);
+		if (src == NULL)
+			return false;
+
+		// strip any v1 row and cube padding
+		uint64_t const faceSize = layout.levels[i].faceByteLength;
+		uint32_t const rowStride = TinyKtx_IsMipMapLevelUnpacked(ktx1, i) ? TinyKtx_UnpackedRowStride(ktx1, i) : 0;
+		uint32_t const rowCount = TinyKtx2_MipMapReduce(height, i) * TinyKtx2_MipMapReduce(depth, i);
+		uint64_t const srcFaceSize = rowStride ? (uint64_t) rowStride * rowCount : faceSize;
+		uint64_t const srcFaceStride = cubePadding ? ((srcFaceSize + 3u) & ~(uint64_t) 3u) : srcFaceSize;
+
+		if (TinyKtx_ImageSize64(ktx1, i) < srcFaceStride * (images - 1) + srcFaceSize) {
+			callbacks->error(user, "KTX v1 level is smaller than its format and dimensions need");
+			TinyKtx_ReleaseImageRawData(ktx1, i);
+			return false;
+		}
+
+		uint8_t *packed = NULL;
+		if (srcFaceStride != faceSize) {
+			packed = (uint8_t *) callbacks->alloc(user, (size_t) layout.levels[i].byteLength);
+			if (packed == NULL) {
+				TinyKtx_ReleaseImageRawData(ktx1, i);
+				return false;
+			}
+			uint32_t const rowSize = rowStride ? (uint32_t) (faceSize / rowCount) : 0;
+			uint8_t *dst = packed;
+			for (uint32_t j = 0u; j < images; ++j) {
+				uint8_t const *face = src + j * srcFaceStride;
+				if (rowStride) {
+					for (uint32_t r = 0u; r < rowCount; ++r) {
+						memcpy(dst, face + r * rowStride, rowSize);
+						dst += rowSize;
+					}
+				} else {
+					memcpy(dst, face, (size_t) faceSize);
+					dst += faceSize;
+				}
+			}
+			src = packed;
+		}
+
+		if (compressor) {
+			void *compressed = NULL;
+			size_t compressedSize = 0;
+			bool const okay = compressor(user, src, (size_t) layout.levels[i].byteLength, &compressed, &compressedSize);
+			if (okay) {
+				callbacks->pwrite(user, offset, compressed, compressedSize);
+				levels[i].byteOffset = offset;
+				levels[i].byteLength = compressedSize;
+				offset += compressedSize;
+				callbacks->free(user, compressed);
+			} else {
+				callbacks->error(user, "Supercompression failed");
+			}
+			if (packed) callbacks->free(user, packed);
+			TinyKtx_ReleaseImageRawData(ktx1, i);
+			if (!okay)
+				return false;
+		} else {
+			TinyKtx2_WriteLevelPositional(callbacks, user, &layout, i, src);
+			if (packed) callbacks->free(user, packed);
+			TinyKtx_ReleaseImageRawData(ktx1, i);
+		}
+	}
+
+	// the level index is only known once everything has been compressed
+	if (compressor) {
+		callbacks->pwrite(user, 0, &header, sizeof(TinyKtx2_Header));
+		callbacks->pwrite(user, sizeof(TinyKtx2_Header), levels, sizeof(TinyKtx2_Level) * levelCount);
+		callbacks->pwrite(user, layout.dfdByteOffset, dfd, layout.dfdByteLength);
+	}
+	return true;
+}
+
+
 #endif
 
 #ifdef __cplusplus
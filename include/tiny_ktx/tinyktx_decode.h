@@ -0,0 +1,2549 @@
+// MIT license see full LICENSE text at end of file
+#pragma once
+#ifndef TINY_KTX_TINYKTX_DECODE_H
+#define TINY_KTX_TINYKTX_DECODE_H
+
+#include "tinyktx.h"	// for TinyKtx_Format and the format helpers
+#include "tinyktx2.h"	// for the KTX v2 load planner
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// CPU decoders for block compressed formats, for tools, thumbnails and GPUs without the format.
+// They work on memory so the blocks can come from TinyKtx_ImageRawData, TinyKtx2_ImageRawData or
+// anywhere else.
+
+// same shape as TinyKtx2's dispatch, decoding never creates threads. The dispatch function must
+// run task(taskData, i) for every i in [0, taskCount) and only return once they have all finished
+typedef void (*TinyKtx_DecodeTaskFunc)(void *taskData, uint32_t taskIndex);
+typedef void (*TinyKtx_DecodeDispatchFunc)(void *dispatchUser, TinyKtx_DecodeTaskFunc task, void *taskData, uint32_t taskCount);
+
+// true if format can be decoded to dstFormat
+// BC1, BC2, BC3 and BC7 decode to R8G8B8A8_UNORM or R8G8B8A8_SRGB (the bytes are the same, sRGB
+// isn't decoded). BC4 decodes to R8 or R8G8B8A8 and BC5 to R8G8 or R8G8B8A8, UNORM or SNORM as the
+// source. BC6H (signed or not) decodes to R16G16B16A16_SFLOAT. Missing channels are 0, alpha is 1.
+// ETC2 and ASTC (LDR, every 2D footprint) decode to R8G8B8A8_UNORM or R8G8B8A8_SRGB, EAC R11 to
+// R16 and EAC R11G11 to R16G16 (UNORM or SNORM as the source)
+bool TinyKtx_CanDecode(TinyKtx_Format format, TinyKtx_Format dstFormat);
+
+// decodes imageCount images of width x height pixels, each image tightly packed blocks straight
+// after the previous one (every layer, face and depth slice of a KTX v1 or v2 level is) to tightly
+// packed dstFormat pixels. Each block row of each image is a task on dispatch, which can be NULL to
+// decode on the calling thread. Returns false if the conversion isn't supported or the sizes are
+// too small; reserved or invalid blocks decode to 0 like GPUs do (magenta for ASTC, which also
+// marks HDR blocks)
+bool TinyKtx_DecodeImages(TinyKtx_Format format,
+													uint32_t width,
+													uint32_t height,
+													uint32_t imageCount,
+													void const *src,
+													size_t srcSize,
+													TinyKtx_Format dstFormat,
+													void *dst,
+													size_t dstSize,
+													TinyKtx_DecodeDispatchFunc dispatch,
+													void *dispatchUser);
+
+// mipmap generation for files that only have level 0 (TinyKtx_NeedsGenerationOfMipmaps and
+// TinyKtx2_NeedsGenerationOfMipmaps). Each level is filtered from the one above it in linear
+// space, *_SRGB formats are decoded before filtering and encoded after
+typedef enum TinyKtx_MipmapFilter {
+	TKTX_MIPMAP_FILTER_BOX,		// 2x2 (2x2x2 for volumes) average, area weighted where a size is odd
+	TKTX_MIPMAP_FILTER_CUBIC,	// separable Mitchell-Netravali cubic, sharper with little ringing
+} TinyKtx_MipmapFilter;
+
+// bytes of a whole mip chain, level 0 first and every level tightly packed straight after the
+// previous one (TinyKtx_ComputeMipmapSizes64 gives each level's size). 0 if the format can't have
+// mipmaps generated: 8 bit UNORM/SRGB formats that TinyKtx_DecodeColor takes and the float formats
+// TinyKtx_FormatToFloat takes. Sizes of 0 count as 1, mipmaplevels of 0 is the full chain to 1x1x1
+uint64_t TinyKtx_MipmapChainSize(TinyKtx_Format format,
+																 uint32_t width,
+																 uint32_t height,
+																 uint32_t depth,
+																 uint32_t imageCount,
+																 uint32_t mipmaplevels);
+
+// fills dst (TinyKtx_MipmapChainSize bytes) with the mip chain of imageCount tightly packed images
+// (layers and faces, as a level is stored) of width x height x depth pixels. level0 is copied to the
+// start of dst unless it already is dst. Levels are generated one after another, the rows and depth
+// slices of each are split into tasks on dispatch (NULL runs them on the calling thread)
+bool TinyKtx_GenerateMipmaps(TinyKtx_Format format,
+														 uint32_t width,
+														 uint32_t height,
+														 uint32_t depth,
+														 uint32_t imageCount,
+														 uint32_t mipmaplevels,
+														 TinyKtx_MipmapFilter filter,
+														 void const *level0,
+														 void *dst,
+														 size_t dstSize,
+														 TinyKtx_DecodeDispatchFunc dispatch,
+														 void *dispatchUser);
+
+// load planning, picks the cheapest way to get a file's levels into one of the formats the caller
+// (usually the GPU) takes and gives the exact size of every level so memory can be allocated first
+typedef enum TinyKtx_LoadPath {
+	TKTX_LOAD_NONE,				// none of the formats can be reached
+	TKTX_LOAD_NATIVE,			// the file's own format, a copy (KTX v1 row padding is dropped)
+	TKTX_LOAD_SWIZZLE,		// 8 bit channels shuffled to R8G8B8A8 while reading (TinyKtx_ReadLevelAs)
+	TKTX_LOAD_FLOAT,			// widened to float while reading (TinyKtx_ReadLevelAs)
+	TKTX_LOAD_DECODE,			// block compressed level decoded on the CPU (TinyKtx_DecodeImages)
+	TKTX_LOAD_TRANSCODE,	// universal KTX v2 level run through the transcoder table
+} TinyKtx_LoadPath;
+
+typedef struct TinyKtx_LoadPlan {
+	TinyKtx_LoadPath path;
+	TinyKtx_Format srcFormat;		// the file's format, TKTX_UNDEFINED for universal KTX v2 files
+	TinyKtx_Format dstFormat;		// the supported format that was picked
+	uint32_t levels;
+	uint64_t levelSize[TINYKTX_MAX_MIPMAPLEVELS];	// tightly packed bytes of each level once loaded
+	uint64_t totalSize;					// of every level
+} TinyKtx_LoadPlan;
+
+// fills plan with the cheapest path from the file (its header must have been read) to one of
+// supportedFormats. Paths cost in the order of TinyKtx_LoadPath, between formats on the same path
+// the smaller output wins and then the earlier format. False (TKTX_LOAD_NONE) if none can be reached
+bool TinyKtx_PlanLoad(TinyKtx_ContextHandle handle,
+											TinyKtx_Format const *supportedFormats,
+											uint32_t count,
+											TinyKtx_LoadPlan *plan);
+// KTX v2 files are copied, decoded or (universal ones only) transcoded, there is no swizzle or
+// float read for them
+bool TinyKtx2_PlanLoad(TinyKtx2_ContextHandle handle,
+											 TinyKtx_Format const *supportedFormats,
+											 uint32_t count,
+											 TinyKtx_LoadPlan *plan);
+
+// loads a level as planned into dst (at least plan->levelSize[mipmaplevel] bytes), images tightly
+// packed in the level's order. Decodes and transcodes split the level into tasks on dispatch (NULL
+// runs them on the calling thread), the other paths are one pass through a small buffer. Decoding
+// reads the level with ImageRawData so it stays in the context until released or reset, and only
+// the ReadLevelAs paths follow TinyKtx_SetReadOrigin
+bool TinyKtx_ExecuteLoad(TinyKtx_ContextHandle handle,
+												 TinyKtx_LoadPlan const *plan,
+												 uint32_t mipmaplevel,
+												 void *dst,
+												 size_t dstSize,
+												 TinyKtx_DecodeDispatchFunc dispatch,
+												 void *dispatchUser);
+bool TinyKtx2_ExecuteLoad(TinyKtx2_ContextHandle handle,
+													TinyKtx_LoadPlan const *plan,
+													uint32_t mipmaplevel,
+													void *dst,
+													size_t dstSize,
+													TinyKtx_DecodeDispatchFunc dispatch,
+													void *dispatchUser);
+
+#ifdef TINYKTX_DECODE_IMPLEMENTATION
+
+// mipmap filtering uses SSE2 or NEON when the compiler targets them, define TINYKTX_NO_SIMD to
+// always use the scalar code
+#ifndef TINYKTX_NO_SIMD
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define TINYKTX_DECODE_SSE2 1
+#include <emmintrin.h>
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+#define TINYKTX_DECODE_NEON 1
+#include <arm_neon.h>
+#endif
+#endif
+
+// 128 bits of a BC6H/BC7 block, read from bit 0 upwards
+typedef struct TinyKtx_BlockBits {
+	uint64_t lo;
+	uint64_t hi;
+	uint32_t pos;
+} TinyKtx_BlockBits;
+
+static void TinyKtx_blockBitsInit(TinyKtx_BlockBits *bits, uint8_t const *block) {
+	bits->lo = 0;
+	bits->hi = 0;
+	for (uint32_t i = 0; i < 8; ++i) {
+		bits->lo |= (uint64_t) block[i] << (i * 8);
+		bits->hi |= (uint64_t) block[i + 8] << (i * 8);
+	}
+	bits->pos = 0;
+}
+
+// count <= 16
+static uint32_t TinyKtx_blockBitsRead(TinyKtx_BlockBits *bits, uint32_t count) {
+	if (count == 0)
+		return 0;
+	uint32_t const pos = bits->pos;
+	uint64_t v;
+	if (pos >= 64) {
+		v = bits->hi >> (pos - 64);
+	} else if (pos + count <= 64) {
+		v = bits->lo >> pos;
+	} else {
+		v = (bits->lo >> pos) | (bits->hi << (64 - pos));
+	}
+	bits->pos = pos + count;
+	return (uint32_t) (v & ((1u << count) - 1u));
+}
+
+static void TinyKtx_rgb565ToRgba8(uint32_t c, uint8_t *rgba) {
+	uint32_t const r = (c >> 11) & 0x1F;
+	uint32_t const g = (c >> 5) & 0x3F;
+	uint32_t const b = c & 0x1F;
+	rgba[0] = (uint8_t) ((r << 3) | (r >> 2));
+	rgba[1] = (uint8_t) ((g << 2) | (g >> 4));
+	rgba[2] = (uint8_t) ((b << 3) | (b >> 2));
+	rgba[3] = 255;
+}
+
+// the colour half of BC1/2/3, BC2 and BC3 always use 4 colours. Alpha is only written by BC1
+static void TinyKtx_decodeBc1Color(uint8_t const *block, uint8_t *rgba, bool bc1, bool punchThrough) {
+	uint32_t const c0 = block[0] | (block[1] << 8);
+	uint32_t const c1 = block[2] | (block[3] << 8);
+	uint8_t palette[4][4];
+	TinyKtx_rgb565ToRgba8(c0, palette[0]);
+	TinyKtx_rgb565ToRgba8(c1, palette[1]);
+	if (!bc1 || c0 > c1) {
+		for (uint32_t c = 0; c < 3; ++c) {
+			palette[2][c] = (uint8_t) ((2 * palette[0][c] + palette[1][c] + 1) / 3);
+			palette[3][c] = (uint8_t) ((palette[0][c] + 2 * palette[1][c] + 1) / 3);
+		}
+		palette[2][3] = palette[3][3] = 255;
+	} else {
+		for (uint32_t c = 0; c < 3; ++c) {
+			palette[2][c] = (uint8_t) ((palette[0][c] + palette[1][c] + 1) / 2);
+			palette[3][c] = 0;
+		}
+		palette[2][3] = 255;
+		palette[3][3] = punchThrough ? 0 : 255;
+	}
+
+	uint32_t const indices = block[4] | (block[5] << 8) | (block[6] << 16) | ((uint32_t) block[7] << 24);
+	for (uint32_t i = 0; i < 16; ++i) {
+		uint8_t const *p = palette[(indices >> (i * 2)) & 0x3];
+		rgba[i * 4 + 0] = p[0];
+		rgba[i * 4 + 1] = p[1];
+		rgba[i * 4 + 2] = p[2];
+		if (bc1) {
+			rgba[i * 4 + 3] = p[3];
+		}
+	}
+}
+
+// BC4 style 8 value ramps (BC3 alpha, BC4 and each BC5 channel), stride is in bytes.
+// Signed values are written as int8_t
+static void TinyKtx_decodeBc4Channel(uint8_t const *block, uint8_t *out, uint32_t stride, bool isSigned) {
+	int32_t palette[8];
+	if (isSigned) {
+		int32_t const a0 = (int8_t) block[0] < -127 ? -127 : (int8_t) block[0];
+		int32_t const a1 = (int8_t) block[1] < -127 ? -127 : (int8_t) block[1];
+		palette[0] = a0;
+		palette[1] = a1;
+		// integer division truncates towards 0, so bias away from 0 to round
+		if (a0 > a1) {
+			for (int32_t k = 2; k < 8; ++k) {
+				int32_t const v = (8 - k) * a0 + (k - 1) * a1;
+				palette[k] = (v + (v < 0 ? -3 : 3)) / 7;
+			}
+		} else {
+			for (int32_t k = 2; k < 6; ++k) {
+				int32_t const v = (6 - k) * a0 + (k - 1) * a1;
+				palette[k] = (v + (v < 0 ? -2 : 2)) / 5;
+			}
+			palette[6] = -127;
+			palette[7] = 127;
+		}
+	} else {
+		int32_t const a0 = block[0];
+		int32_t const a1 = block[1];
+		palette[0] = a0;
+		palette[1] = a1;
+		if (a0 > a1) {
+			for (int32_t k = 2; k < 8; ++k) {
+				palette[k] = ((8 - k) * a0 + (k - 1) * a1 + 3) / 7;
+			}
+		} else {
+			for (int32_t k = 2; k < 6; ++k) {
+				palette[k] = ((6 - k) * a0 + (k - 1) * a1 + 2) / 5;
+			}
+			palette[6] = 0;
+			palette[7] = 255;
+		}
+	}
+
+	uint64_t indices = 0;
+	for (uint32_t i = 0; i < 6; ++i) {
+		indices |= (uint64_t) block[2 + i] << (i * 8);
+	}
+	for (uint32_t i = 0; i < 16; ++i) {
+		out[i * stride] = (uint8_t) palette[(indices >> (i * 3)) & 0x7];
+	}
+}
+
+static void TinyKtx_decodeBc2Alpha(uint8_t const *block, uint8_t *rgba) {
+	for (uint32_t i = 0; i < 16; ++i) {
+		uint32_t const a = (block[i / 2] >> ((i & 1) * 4)) & 0xF;
+		rgba[i * 4 + 3] = (uint8_t) (a * 17);
+	}
+}
+
+// BC7 and BC6H partition tables. Two subset partitions are a bit per pixel (set = subset 1),
+// three subset partitions are a subset per pixel
+static uint16_t const TinyKtx_bptcPartitions2[64] = {
+	0xCCCC, 0x8888, 0xEEEE, 0xECC8, 0xC880, 0xFEEC, 0xFEC8, 0xEC80,
+	0xC800, 0xFFEC, 0xFE80, 0xE800, 0xFFE8, 0xFF00, 0xFFF0, 0xF000,
+	0xF710, 0x008E, 0x7100, 0x08CE, 0x008C, 0x7310, 0x3100, 0x8CCE,
+	0x088C, 0x3110, 0x6666, 0x366C, 0x17E8, 0x0FF0, 0x718E, 0x399C,
+	0xAAAA, 0xF0F0, 0x5A5A, 0x33CC, 0x3C3C, 0x55AA, 0x9696, 0xA55A,
+	0x73CE, 0x13C8, 0x324C, 0x3BDC, 0x6996, 0xC33C, 0x9966, 0x0660,
+	0x0272, 0x04E4, 0x4E40, 0x2720, 0xC936, 0x936C, 0x39C6, 0x639C,
+	0x9336, 0x9CC6, 0x817E, 0xE718, 0xCCF0, 0x0FCC, 0x7744, 0xEE22,
+};
+
+static uint8_t const TinyKtx_bptcPartitions3[64][16] = {
+	{0, 0, 1, 1, 0, 0, 1, 1, 0, 2, 2, 1, 2, 2, 2, 2}, {0, 0, 0, 1, 0, 0, 1, 1, 2, 2, 1, 1, 2, 2, 2, 1},
+	{0, 0, 0, 0, 2, 0, 0, 1, 2, 2, 1, 1, 2, 2, 1, 1}, {0, 2, 2, 2, 0, 0, 2, 2, 0, 0, 1, 1, 0, 1, 1, 1},
+	{0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 2, 2, 1, 1, 2, 2}, {0, 0, 1, 1, 0, 0, 1, 1, 0, 0, 2, 2, 0, 0, 2, 2},
+	{0, 0, 2, 2, 0, 0, 2, 2, 1, 1, 1, 1, 1, 1, 1, 1}, {0, 0, 1, 1, 0, 0, 1, 1, 2, 2, 1, 1, 2, 2, 1, 1},
+	{0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2, 2}, {0, 0, 0, 0, 1, 1, 1, 1, 1, 1, 1, 1, 2, 2, 2, 2},
+	{0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2, 2, 2, 2, 2, 2}, {0, 0, 1, 2, 0, 0, 1, 2, 0, 0, 1, 2, 0, 0, 1, 2},
+	{0, 1, 1, 2, 0, 1, 1, 2, 0, 1, 1, 2, 0, 1, 1, 2}, {0, 1, 2, 2, 0, 1, 2, 2, 0, 1, 2, 2, 0, 1, 2, 2},
+	{0, 0, 1, 1, 0, 1, 1, 2, 1, 1, 2, 2, 1, 2, 2, 2}, {0, 0, 1, 1, 2, 0, 0, 1, 2, 2, 0, 0, 2, 2, 2, 0},
+	{0, 0, 0, 1, 0, 0, 1, 1, 0, 1, 1, 2, 1, 1, 2, 2}, {0, 1, 1, 1, 0, 0, 1, 1, 2, 0, 0, 1, 2, 2, 0, 0},
+	{0, 0, 0, 0, 1, 1, 2, 2, 1, 1, 2, 2, 1, 1, 2, 2}, {0, 0, 2, 2, 0, 0, 2, 2, 0, 0, 2, 2, 1, 1, 1, 1},
+	{0, 1, 1, 1, 0, 1, 1, 1, 0, 2, 2, 2, 0, 2, 2, 2}, {0, 0, 0, 1, 0, 0, 0, 1, 2, 2, 2, 1, 2, 2, 2, 1},
+	{0, 0, 0, 0, 0, 0, 1, 1, 0, 1, 2, 2, 0, 1, 2, 2}, {0, 0, 0, 0, 1, 1, 0, 0, 2, 2, 1, 0, 2, 2, 1, 0},
+	{0, 1, 2, 2, 0, 1, 2, 2, 0, 0, 1, 1, 0, 0, 0, 0}, {0, 0, 1, 2, 0, 0, 1, 2, 1, 1, 2, 2, 2, 2, 2, 2},
+	{0, 1, 1, 0, 1, 2, 2, 1, 1, 2, 2, 1, 0, 1, 1, 0}, {0, 0, 0, 0, 0, 1, 1, 0, 1, 2, 2, 1, 1, 2, 2, 1},
+	{0, 0, 2, 2, 1, 1, 0, 2, 1, 1, 0, 2, 0, 0, 2, 2}, {0, 1, 1, 0, 0, 1, 1, 0, 2, 0, 0, 2, 2, 2, 2, 2},
+	{0, 0, 1, 1, 0, 1, 2, 2, 0, 1, 2, 2, 0, 0, 1, 1}, {0, 0, 0, 0, 2, 0, 0, 0, 2, 2, 1, 1, 2, 2, 2, 1},
+	{0, 0, 0, 0, 0, 0, 0, 2, 1, 1, 2, 2, 1, 2, 2, 2}, {0, 2, 2, 2, 0, 0, 2, 2, 0, 0, 1, 2, 0, 0, 1, 1},
+	{0, 0, 1, 1, 0, 0, 1, 2, 0, 0, 2, 2, 0, 2, 2, 2}, {0, 1, 2, 0, 0, 1, 2, 0, 0, 1, 2, 0, 0, 1, 2, 0},
+	{0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2, 2, 0, 0, 0, 0}, {0, 1, 2, 0, 1, 2, 0, 1, 2, 0, 1, 2, 0, 1, 2, 0},
+	{0, 1, 2, 0, 2, 0, 1, 2, 1, 2, 0, 1, 0, 1, 2, 0}, {0, 0, 1, 1, 2, 2, 0, 0, 1, 1, 2, 2, 0, 0, 1, 1},
+	{0, 0, 1, 1, 1, 1, 2, 2, 2, 2, 0, 0, 0, 0, 1, 1}, {0, 1, 0, 1, 0, 1, 0, 1, 2, 2, 2, 2, 2, 2, 2, 2},
+	{0, 0, 0, 0, 0, 0, 0, 0, 2, 1, 2, 1, 2, 1, 2, 1}, {0, 0, 2, 2, 1, 1, 2, 2, 0, 0, 2, 2, 1, 1, 2, 2},
+	{0, 0, 2, 2, 0, 0, 1, 1, 0, 0, 2, 2, 0, 0, 1, 1}, {0, 2, 2, 0, 1, 2, 2, 1, 0, 2, 2, 0, 1, 2, 2, 1},
+	{0, 1, 0, 1, 2, 2, 2, 2, 2, 2, 2, 2, 0, 1, 0, 1}, {0, 0, 0, 0, 2, 1, 2, 1, 2, 1, 2, 1, 2, 1, 2, 1},
+	{0, 1, 0, 1, 0, 1, 0, 1, 0, 1, 0, 1, 2, 2, 2, 2}, {0, 2, 2, 2, 0, 1, 1, 1, 0, 2, 2, 2, 0, 1, 1, 1},
+	{0, 0, 0, 2, 1, 1, 1, 2, 0, 0, 0, 2, 1, 1, 1, 2}, {0, 0, 0, 0, 2, 1, 1, 2, 2, 1, 1, 2, 2, 1, 1, 2},
+	{0, 2, 2, 2, 0, 1, 1, 1, 0, 1, 1, 1, 0, 2, 2, 2}, {0, 0, 0, 2, 1, 1, 1, 2, 1, 1, 1, 2, 0, 0, 0, 2},
+	{0, 1, 1, 0, 0, 1, 1, 0, 0, 1, 1, 0, 2, 2, 2, 2}, {0, 0, 0, 0, 0, 0, 0, 0, 2, 1, 1, 2, 2, 1, 1, 2},
+	{0, 1, 1, 0, 0, 1, 1, 0, 2, 2, 2, 2, 2, 2, 2, 2}, {0, 0, 2, 2, 0, 0, 1, 1, 0, 0, 1, 1, 0, 0, 2, 2},
+	{0, 0, 2, 2, 1, 1, 2, 2, 1, 1, 2, 2, 0, 0, 2, 2}, {0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 2, 1, 1, 2},
+	{0, 0, 0, 2, 0, 0, 0, 1, 0, 0, 0, 2, 0, 0, 0, 1}, {0, 2, 2, 2, 1, 2, 2, 2, 0, 2, 2, 2, 1, 2, 2, 2},
+	{0, 1, 0, 1, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2}, {0, 1, 1, 1, 2, 0, 1, 1, 2, 2, 0, 1, 2, 2, 2, 0},
+};
+
+// the pixel holding each subset's implicit index MSB (subset 0's is always pixel 0)
+static uint8_t const TinyKtx_bptcAnchors2[64] = {
+	15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15,
+	15, 2, 8, 2, 2, 8, 8, 15, 2, 8, 2, 2, 8, 8, 2, 2,
+	15, 15, 6, 8, 2, 8, 15, 15, 2, 8, 2, 2, 2, 15, 15, 6,
+	6, 2, 6, 8, 15, 15, 2, 2, 15, 15, 15, 15, 15, 2, 2, 15,
+};
+static uint8_t const TinyKtx_bptcAnchors3[2][64] = {
+	{
+		3, 3, 15, 15, 8, 3, 15, 15, 8, 8, 6, 6, 6, 5, 3, 3,
+		3, 3, 8, 15, 3, 3, 6, 10, 5, 8, 8, 6, 8, 5, 15, 15,
+		8, 15, 3, 5, 6, 10, 8, 15, 15, 3, 15, 5, 15, 15, 15, 15,
+		3, 15, 5, 5, 5, 8, 5, 10, 5, 10, 8, 13, 15, 12, 3, 3,
+	},
+	{
+		15, 8, 8, 3, 15, 15, 3, 8, 15, 15, 15, 15, 15, 15, 15, 8,
+		15, 8, 15, 3, 15, 8, 15, 8, 3, 15, 6, 10, 15, 15, 10, 8,
+		15, 3, 15, 10, 10, 8, 9, 10, 6, 15, 8, 15, 3, 6, 6, 8,
+		15, 3, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 3, 15, 15, 8,
+	},
+};
+
+static uint8_t const TinyKtx_bptcWeights2[4] = {0, 21, 43, 64};
+static uint8_t const TinyKtx_bptcWeights3[8] = {0, 9, 18, 27, 37, 46, 55, 64};
+static uint8_t const TinyKtx_bptcWeights4[16] = {0, 4, 9, 13, 17, 21, 26, 30, 34, 38, 43, 47, 51, 55, 60, 64};
+
+static uint8_t const *TinyKtx_bptcWeights(uint32_t indexBits) {
+	switch (indexBits) {
+	case 2: return TinyKtx_bptcWeights2;
+	case 3: return TinyKtx_bptcWeights3;
+	default: return TinyKtx_bptcWeights4;
+	}
+}
+
+// subset of pixel i and whether it is an anchor (its index has one less bit)
+static uint32_t TinyKtx_bptcSubset(uint32_t subsets, uint32_t partition, uint32_t i, bool *anchor) {
+	switch (subsets) {
+	case 2: *anchor = i == 0 || i == TinyKtx_bptcAnchors2[partition];
+		return (TinyKtx_bptcPartitions2[partition] >> i) & 1;
+	case 3: *anchor = i == 0 || i == TinyKtx_bptcAnchors3[0][partition] || i == TinyKtx_bptcAnchors3[1][partition];
+		return TinyKtx_bptcPartitions3[partition][i];
+	default: *anchor = i == 0;
+		return 0;
+	}
+}
+
+typedef struct TinyKtx_Bc7Mode {
+	uint8_t subsets;
+	uint8_t partitionBits;
+	uint8_t rotationBits;
+	uint8_t indexSelectionBits;
+	uint8_t colorBits;
+	uint8_t alphaBits;
+	uint8_t endpointPBits;
+	uint8_t sharedPBits;
+	uint8_t indexBits;
+	uint8_t index2Bits;
+} TinyKtx_Bc7Mode;
+
+static TinyKtx_Bc7Mode const TinyKtx_bc7Modes[8] = {
+	{3, 4, 0, 0, 4, 0, 1, 0, 3, 0},
+	{2, 6, 0, 0, 6, 0, 0, 1, 3, 0},
+	{3, 6, 0, 0, 5, 0, 0, 0, 2, 0},
+	{2, 6, 0, 0, 7, 0, 1, 0, 2, 0},
+	{1, 0, 2, 1, 5, 6, 0, 0, 2, 3},
+	{1, 0, 2, 0, 7, 8, 0, 0, 2, 2},
+	{1, 0, 0, 0, 7, 7, 1, 0, 4, 0},
+	{2, 6, 0, 0, 5, 5, 1, 0, 2, 0},
+};
+
+static void TinyKtx_decodeBc7(uint8_t const *block, uint8_t *rgba) {
+	TinyKtx_BlockBits bits;
+	TinyKtx_blockBitsInit(&bits, block);
+
+	uint32_t modeIndex = 0;
+	while (modeIndex < 8 && TinyKtx_blockBitsRead(&bits, 1) == 0) {
+		modeIndex++;
+	}
+	if (modeIndex == 8) {
+		memset(rgba, 0, 64);
+		return;
+	}
+	TinyKtx_Bc7Mode const *mode = &TinyKtx_bc7Modes[modeIndex];
+	uint32_t const partition = TinyKtx_blockBitsRead(&bits, mode->partitionBits);
+	uint32_t const rotation = TinyKtx_blockBitsRead(&bits, mode->rotationBits);
+	uint32_t const indexSelection = TinyKtx_blockBitsRead(&bits, mode->indexSelectionBits);
+
+	// endpoints[subset * 2 + end][channel]
+	uint32_t endpoints[6][4];
+	uint32_t const endpointCount = mode->subsets * 2u;
+	for (uint32_t c = 0; c < 3; ++c) {
+		for (uint32_t e = 0; e < endpointCount; ++e) {
+			endpoints[e][c] = TinyKtx_blockBitsRead(&bits, mode->colorBits);
+		}
+	}
+	for (uint32_t e = 0; e < endpointCount; ++e) {
+		endpoints[e][3] = TinyKtx_blockBitsRead(&bits, mode->alphaBits);
+	}
+
+	// p bits become the LSB of every channel, then each channel is widened to 8 bits
+	uint32_t colorBits = mode->colorBits;
+	uint32_t alphaBits = mode->alphaBits;
+	if (mode->endpointPBits || mode->sharedPBits) {
+		uint32_t pbits[6];
+		for (uint32_t e = 0; e < endpointCount; ++e) {
+			if (mode->endpointPBits || (e & 1) == 0) {
+				pbits[e] = TinyKtx_blockBitsRead(&bits, 1);
+			} else {
+				pbits[e] = pbits[e - 1];
+			}
+		}
+		for (uint32_t e = 0; e < endpointCount; ++e) {
+			for (uint32_t c = 0; c < 4; ++c) {
+				endpoints[e][c] = (endpoints[e][c] << 1) | pbits[e];
+			}
+		}
+		colorBits++;
+		if (alphaBits) {
+			alphaBits++;
+		}
+	}
+	for (uint32_t e = 0; e < endpointCount; ++e) {
+		for (uint32_t c = 0; c < 3; ++c) {
+			uint32_t const v = endpoints[e][c] << (8 - colorBits);
+			endpoints[e][c] = v | (v >> colorBits);
+		}
+		if (alphaBits) {
+			uint32_t const v = endpoints[e][3] << (8 - alphaBits);
+			endpoints[e][3] = v | (v >> alphaBits);
+		} else {
+			endpoints[e][3] = 255;
+		}
+	}
+
+	uint8_t subset[16];
+	uint8_t index[16];
+	uint8_t index2[16];
+	for (uint32_t i = 0; i < 16; ++i) {
+		bool anchor;
+		subset[i] = (uint8_t) TinyKtx_bptcSubset(mode->subsets, partition, i, &anchor);
+		index[i] = (uint8_t) TinyKtx_blockBitsRead(&bits, mode->indexBits - (anchor ? 1 : 0));
+	}
+	if (mode->index2Bits) {
+		for (uint32_t i = 0; i < 16; ++i) {
+			index2[i] = (uint8_t) TinyKtx_blockBitsRead(&bits, mode->index2Bits - (i == 0 ? 1 : 0));
+		}
+	}
+
+	uint8_t const *colorWeights = TinyKtx_bptcWeights(mode->indexBits);
+	uint8_t const *alphaWeights = colorWeights;
+	uint8_t const *colorIndex = index;
+	uint8_t const *alphaIndex = index;
+	if (mode->index2Bits) {
+		alphaWeights = TinyKtx_bptcWeights(mode->index2Bits);
+		alphaIndex = index2;
+		if (indexSelection) {
+			colorWeights = alphaWeights;
+			alphaWeights = TinyKtx_bptcWeights(mode->indexBits);
+			colorIndex = index2;
+			alphaIndex = index;
+		}
+	}
+
+	for (uint32_t i = 0; i < 16; ++i) {
+		uint32_t const *e0 = endpoints[subset[i] * 2];
+		uint32_t const *e1 = endpoints[subset[i] * 2 + 1];
+		uint32_t const wc = colorWeights[colorIndex[i]];
+		uint32_t const wa = alphaWeights[alphaIndex[i]];
+		uint8_t *p = rgba + i * 4;
+		for (uint32_t c = 0; c < 3; ++c) {
+			p[c] = (uint8_t) ((e0[c] * (64 - wc) + e1[c] * wc + 32) >> 6);
+		}
+		p[3] = (uint8_t) ((e0[3] * (64 - wa) + e1[3] * wa + 32) >> 6);
+		if (rotation) {
+			uint8_t const t = p[3];
+			p[3] = p[rotation - 1];
+			p[rotation - 1] = t;
+		}
+	}
+}
+
+// BC6H modes in the order of the spec (mode 1 to 14)
+typedef struct TinyKtx_Bc6hMode {
+	uint8_t transformed;
+	uint8_t regions;
+	uint8_t endpointBits;
+	uint8_t deltaBits[3];
+} TinyKtx_Bc6hMode;
+
+static TinyKtx_Bc6hMode const TinyKtx_bc6hModes[14] = {
+	{1, 2, 10, {5, 5, 5}},
+	{1, 2, 7, {6, 6, 6}},
+	{1, 2, 11, {5, 4, 4}},
+	{1, 2, 11, {4, 5, 4}},
+	{1, 2, 11, {4, 4, 5}},
+	{1, 2, 9, {5, 5, 5}},
+	{1, 2, 8, {6, 5, 5}},
+	{1, 2, 8, {5, 6, 5}},
+	{1, 2, 8, {5, 5, 6}},
+	{0, 2, 6, {6, 6, 6}},
+	{0, 1, 10, {10, 10, 10}},
+	{1, 1, 11, {9, 9, 9}},
+	{1, 1, 12, {8, 8, 8}},
+	{1, 1, 16, {4, 4, 4}},
+};
+
+// 5 bit mode field to mode, the 2 bit modes (1 and 2) repeat. 0xFF is reserved
+static uint8_t const TinyKtx_bc6hModeFromBits[32] = {
+	0, 1, 2, 10, 0, 1, 3, 11, 0, 1, 4, 12, 0, 1, 5, 13,
+	0, 1, 6, 0xFF, 0, 1, 7, 0xFF, 0, 1, 8, 0xFF, 0, 1, 9, 0xFF,
+};
+
+// where every bit after the mode goes, {endpoint value, first bit, bit count}.
+// Endpoint values are r0, g0, b0, r1, g1, b1, r2... a count with 0x80 set is stored reversed
+#define TKTX_R0 0
+#define TKTX_G0 1
+#define TKTX_B0 2
+#define TKTX_R1 3
+#define TKTX_G1 4
+#define TKTX_B1 5
+#define TKTX_R2 6
+#define TKTX_G2 7
+#define TKTX_B2 8
+#define TKTX_R3 9
+#define TKTX_G3 10
+#define TKTX_B3 11
+static uint8_t const TinyKtx_bc6hLayouts[14][24][3] = {
+	{{TKTX_G2, 4, 1}, {TKTX_B2, 4, 1}, {TKTX_B3, 4, 1}, {TKTX_R0, 0, 10}, {TKTX_G0, 0, 10}, {TKTX_B0, 0, 10},
+	 {TKTX_R1, 0, 5}, {TKTX_G3, 4, 1}, {TKTX_G2, 0, 4}, {TKTX_G1, 0, 5}, {TKTX_B3, 0, 1}, {TKTX_G3, 0, 4},
+	 {TKTX_B1, 0, 5}, {TKTX_B3, 1, 1}, {TKTX_B2, 0, 4}, {TKTX_R2, 0, 5}, {TKTX_B3, 2, 1}, {TKTX_R3, 0, 5},
+	 {TKTX_B3, 3, 1}},
+	{{TKTX_G2, 5, 1}, {TKTX_G3, 4, 1}, {TKTX_G3, 5, 1}, {TKTX_R0, 0, 7}, {TKTX_B3, 0, 1}, {TKTX_B3, 1, 1},
+	 {TKTX_B2, 4, 1}, {TKTX_G0, 0, 7}, {TKTX_B2, 5, 1}, {TKTX_B3, 2, 1}, {TKTX_G2, 4, 1}, {TKTX_B0, 0, 7},
+	 {TKTX_B3, 3, 1}, {TKTX_B3, 5, 1}, {TKTX_B3, 4, 1}, {TKTX_R1, 0, 6}, {TKTX_G2, 0, 4}, {TKTX_G1, 0, 6},
+	 {TKTX_G3, 0, 4}, {TKTX_B1, 0, 6}, {TKTX_B2, 0, 4}, {TKTX_R2, 0, 6}, {TKTX_R3, 0, 6}},
+	{{TKTX_R0, 0, 10}, {TKTX_G0, 0, 10}, {TKTX_B0, 0, 10}, {TKTX_R1, 0, 5}, {TKTX_R0, 10, 1}, {TKTX_G2, 0, 4},
+	 {TKTX_G1, 0, 4}, {TKTX_G0, 10, 1}, {TKTX_B3, 0, 1}, {TKTX_G3, 0, 4}, {TKTX_B1, 0, 4}, {TKTX_B0, 10, 1},
+	 {TKTX_B3, 1, 1}, {TKTX_B2, 0, 4}, {TKTX_R2, 0, 5}, {TKTX_B3, 2, 1}, {TKTX_R3, 0, 5}, {TKTX_B3, 3, 1}},
+	{{TKTX_R0, 0, 10}, {TKTX_G0, 0, 10}, {TKTX_B0, 0, 10}, {TKTX_R1, 0, 4}, {TKTX_R0, 10, 1}, {TKTX_G3, 4, 1},
+	 {TKTX_G2, 0, 4}, {TKTX_G1, 0, 5}, {TKTX_G0, 10, 1}, {TKTX_G3, 0, 4}, {TKTX_B1, 0, 4}, {TKTX_B0, 10, 1},
+	 {TKTX_B3, 1, 1}, {TKTX_B2, 0, 4}, {TKTX_R2, 0, 4}, {TKTX_B3, 0, 1}, {TKTX_B3, 2, 1}, {TKTX_R3, 0, 4},
+	 {TKTX_G2, 4, 1}, {TKTX_B3, 3, 1}},
+	{{TKTX_R0, 0, 10}, {TKTX_G0, 0, 10}, {TKTX_B0, 0, 10}, {TKTX_R1, 0, 4}, {TKTX_R0, 10, 1}, {TKTX_B2, 4, 1},
+	 {TKTX_G2, 0, 4}, {TKTX_G1, 0, 4}, {TKTX_G0, 10, 1}, {TKTX_B3, 0, 1}, {TKTX_G3, 0, 4}, {TKTX_B1, 0, 5},
+	 {TKTX_B0, 10, 1}, {TKTX_B2, 0, 4}, {TKTX_R2, 0, 4}, {TKTX_B3, 1, 1}, {TKTX_B3, 2, 1}, {TKTX_R3, 0, 4},
+	 {TKTX_B3, 4, 1}, {TKTX_B3, 3, 1}},
+	{{TKTX_R0, 0, 9}, {TKTX_B2, 4, 1}, {TKTX_G0, 0, 9}, {TKTX_G2, 4, 1}, {TKTX_B0, 0, 9}, {TKTX_B3, 4, 1},
+	 {TKTX_R1, 0, 5}, {TKTX_G3, 4, 1}, {TKTX_G2, 0, 4}, {TKTX_G1, 0, 5}, {TKTX_B3, 0, 1}, {TKTX_G3, 0, 4},
+	 {TKTX_B1, 0, 5}, {TKTX_B3, 1, 1}, {TKTX_B2, 0, 4}, {TKTX_R2, 0, 5}, {TKTX_B3, 2, 1}, {TKTX_R3, 0, 5},
+	 {TKTX_B3, 3, 1}},
+	{{TKTX_R0, 0, 8}, {TKTX_G3, 4, 1}, {TKTX_B2, 4, 1}, {TKTX_G0, 0, 8}, {TKTX_B3, 2, 1}, {TKTX_G2, 4, 1},
+	 {TKTX_B0, 0, 8}, {TKTX_B3, 3, 1}, {TKTX_B3, 4, 1}, {TKTX_R1, 0, 6}, {TKTX_G2, 0, 4}, {TKTX_G1, 0, 5},
+	 {TKTX_B3, 0, 1}, {TKTX_G3, 0, 4}, {TKTX_B1, 0, 5}, {TKTX_B3, 1, 1}, {TKTX_B2, 0, 4}, {TKTX_R2, 0, 6},
+	 {TKTX_R3, 0, 6}},
+	{{TKTX_R0, 0, 8}, {TKTX_B3, 0, 1}, {TKTX_B2, 4, 1}, {TKTX_G0, 0, 8}, {TKTX_G2, 5, 1}, {TKTX_G2, 4, 1},
+	 {TKTX_B0, 0, 8}, {TKTX_G3, 5, 1}, {TKTX_B3, 4, 1}, {TKTX_R1, 0, 5}, {TKTX_G3, 4, 1}, {TKTX_G2, 0, 4},
+	 {TKTX_G1, 0, 6}, {TKTX_G3, 0, 4}, {TKTX_B1, 0, 5}, {TKTX_B3, 1, 1}, {TKTX_B2, 0, 4}, {TKTX_R2, 0, 5},
+	 {TKTX_B3, 2, 1}, {TKTX_R3, 0, 5}, {TKTX_B3, 3, 1}},
+	{{TKTX_R0, 0, 8}, {TKTX_B3, 1, 1}, {TKTX_B2, 4, 1}, {TKTX_G0, 0, 8}, {TKTX_B2, 5, 1}, {TKTX_G2, 4, 1},
+	 {TKTX_B0, 0, 8}, {TKTX_B3, 5, 1}, {TKTX_B3, 4, 1}, {TKTX_R1, 0, 5}, {TKTX_G3, 4, 1}, {TKTX_G2, 0, 4},
+	 {TKTX_G1, 0, 5}, {TKTX_B3, 0, 1}, {TKTX_G3, 0, 4}, {TKTX_B1, 0, 6}, {TKTX_B2, 0, 4}, {TKTX_R2, 0, 5},
+	 {TKTX_B3, 2, 1}, {TKTX_R3, 0, 5}, {TKTX_B3, 3, 1}},
+	{{TKTX_R0, 0, 6}, {TKTX_G3, 4, 1}, {TKTX_B3, 0, 1}, {TKTX_B3, 1, 1}, {TKTX_B2, 4, 1}, {TKTX_G0, 0, 6},
+	 {TKTX_G2, 5, 1}, {TKTX_B2, 5, 1}, {TKTX_B3, 2, 1}, {TKTX_G2, 4, 1}, {TKTX_B0, 0, 6}, {TKTX_G3, 5, 1},
+	 {TKTX_B3, 3, 1}, {TKTX_B3, 5, 1}, {TKTX_B3, 4, 1}, {TKTX_R1, 0, 6}, {TKTX_G2, 0, 4}, {TKTX_G1, 0, 6},
+	 {TKTX_G3, 0, 4}, {TKTX_B1, 0, 6}, {TKTX_B2, 0, 4}, {TKTX_R2, 0, 6}, {TKTX_R3, 0, 6}},
+	{{TKTX_R0, 0, 10}, {TKTX_G0, 0, 10}, {TKTX_B0, 0, 10}, {TKTX_R1, 0, 10}, {TKTX_G1, 0, 10}, {TKTX_B1, 0, 10}},
+	{{TKTX_R0, 0, 10}, {TKTX_G0, 0, 10}, {TKTX_B0, 0, 10}, {TKTX_R1, 0, 9}, {TKTX_R0, 10, 1}, {TKTX_G1, 0, 9},
+	 {TKTX_G0, 10, 1}, {TKTX_B1, 0, 9}, {TKTX_B0, 10, 1}},
+	{{TKTX_R0, 0, 10}, {TKTX_G0, 0, 10}, {TKTX_B0, 0, 10}, {TKTX_R1, 0, 8}, {TKTX_R0, 10, 0x82}, {TKTX_G1, 0, 8},
+	 {TKTX_G0, 10, 0x82}, {TKTX_B1, 0, 8}, {TKTX_B0, 10, 0x82}},
+	{{TKTX_R0, 0, 10}, {TKTX_G0, 0, 10}, {TKTX_B0, 0, 10}, {TKTX_R1, 0, 4}, {TKTX_R0, 10, 0x86}, {TKTX_G1, 0, 4},
+	 {TKTX_G0, 10, 0x86}, {TKTX_B1, 0, 4}, {TKTX_B0, 10, 0x86}},
+};
+#undef TKTX_R0
+#undef TKTX_G0
+#undef TKTX_B0
+#undef TKTX_R1
+#undef TKTX_G1
+#undef TKTX_B1
+#undef TKTX_R2
+#undef TKTX_G2
+#undef TKTX_B2
+#undef TKTX_R3
+#undef TKTX_G3
+#undef TKTX_B3
+
+static int32_t TinyKtx_signExtend(uint32_t v, uint32_t bits) {
+	uint32_t const sign = 1u << (bits - 1);
+	return (int32_t) ((v ^ sign) - sign);
+}
+
+static int32_t TinyKtx_bc6hUnquantize(int32_t v, uint32_t bits, bool isSigned) {
+	if (!isSigned) {
+		if (bits >= 15 || v == 0)
+			return v;
+		if (v == (1 << bits) - 1)
+			return 0xFFFF;
+		return ((v << 16) + 0x8000) >> bits;
+	}
+	if (bits >= 16)
+		return v;
+	bool const negative = v < 0;
+	int32_t const m = negative ? -v : v;
+	int32_t q;
+	if (m == 0) {
+		q = 0;
+	} else if (m >= (1 << (bits - 1)) - 1) {
+		q = 0x7FFF;
+	} else {
+		q = ((m << 15) + 0x4000) >> (bits - 1);
+	}
+	return negative ? -q : q;
+}
+
+// the final 31/64 scale of unquantized values gives half float bits
+static uint16_t TinyKtx_bc6hToHalf(int32_t v, bool isSigned) {
+	if (!isSigned)
+		return (uint16_t) ((v * 31) >> 6);
+	if (v < 0)
+		return (uint16_t) (0x8000 | (((-v) * 31) >> 5));
+	return (uint16_t) ((v * 31) >> 5);
+}
+
+static void TinyKtx_decodeBc6h(uint8_t const *block, uint16_t *rgba, bool isSigned) {
+	TinyKtx_BlockBits bits;
+	TinyKtx_blockBitsInit(&bits, block);
+
+	uint32_t modeIndex = TinyKtx_blockBitsRead(&bits, 2);
+	if (modeIndex < 2) {
+		modeIndex = TinyKtx_bc6hModeFromBits[modeIndex];
+	} else {
+		modeIndex = TinyKtx_bc6hModeFromBits[modeIndex | (TinyKtx_blockBitsRead(&bits, 3) << 2)];
+	}
+	if (modeIndex == 0xFF) {
+		memset(rgba, 0, 16 * 4 * sizeof(uint16_t));
+		return;
+	}
+	TinyKtx_Bc6hMode const *mode = &TinyKtx_bc6hModes[modeIndex];
+
+	// endpoints[endpoint][channel]
+	int32_t endpoints[4][3];
+	memset(endpoints, 0, sizeof(endpoints));
+	for (uint32_t i = 0; i < 24; ++i) {
+		uint8_t const *field = TinyKtx_bc6hLayouts[modeIndex][i];
+		uint32_t const count = field[2] & 0x7Fu;
+		if (count == 0)
+			break;
+		uint32_t v = TinyKtx_blockBitsRead(&bits, count);
+		if (field[2] & 0x80) {
+			uint32_t r = 0;
+			for (uint32_t b = 0; b < count; ++b) {
+				r |= ((v >> b) & 1) << (count - 1 - b);
+			}
+			v = r;
+		}
+		endpoints[field[0] / 3][field[0] % 3] |= (int32_t) (v << field[1]);
+	}
+	uint32_t const partition = mode->regions == 2 ? TinyKtx_blockBitsRead(&bits, 5) : 0;
+
+	uint32_t const endpointCount = mode->regions * 2u;
+	uint32_t const epBits = mode->endpointBits;
+	uint32_t const epMask = (1u << epBits) - 1u;
+	for (uint32_t c = 0; c < 3; ++c) {
+		if (isSigned) {
+			endpoints[0][c] = TinyKtx_signExtend((uint32_t) endpoints[0][c], epBits);
+		}
+		for (uint32_t e = 1; e < endpointCount; ++e) {
+			uint32_t v = (uint32_t) endpoints[e][c];
+			if (mode->transformed) {
+				v = ((uint32_t) TinyKtx_signExtend(v, mode->deltaBits[c]) + (uint32_t) endpoints[0][c]) & epMask;
+			}
+			endpoints[e][c] = isSigned ? TinyKtx_signExtend(v, epBits) : (int32_t) v;
+		}
+	}
+	for (uint32_t e = 0; e < endpointCount; ++e) {
+		for (uint32_t c = 0; c < 3; ++c) {
+			endpoints[e][c] = TinyKtx_bc6hUnquantize(endpoints[e][c], epBits, isSigned);
+		}
+	}
+
+	uint32_t const indexBits = mode->regions == 2 ? 3 : 4;
+	uint8_t const *weights = TinyKtx_bptcWeights(indexBits);
+	for (uint32_t i = 0; i < 16; ++i) {
+		bool anchor;
+		uint32_t const subset = TinyKtx_bptcSubset(mode->regions, partition, i, &anchor);
+		int32_t const w = weights[TinyKtx_blockBitsRead(&bits, indexBits - (anchor ? 1 : 0))];
+		int32_t const *e0 = endpoints[subset * 2];
+		int32_t const *e1 = endpoints[subset * 2 + 1];
+		for (uint32_t c = 0; c < 3; ++c) {
+			// arithmetic shift, the spec's rounding for signed values
+			int32_t const v = (e0[c] * (64 - w) + e1[c] * w + 32) >> 6;
+			rgba[i * 4 + c] = TinyKtx_bc6hToHalf(v, isSigned);
+		}
+		rgba[i * 4 + 3] = 0x3C00;
+	}
+}
+
+static uint8_t TinyKtx_clampByte(int32_t v) {
+	return (uint8_t) (v < 0 ? 0 : (v > 255 ? 255 : v));
+}
+
+// ETC1/ETC2 intensity modifiers by table codeword and pixel index (msb << 1 | lsb)
+static int32_t const TinyKtx_etcModifiers[8][4] = {
+	{2, 8, -2, -8}, {5, 17, -5, -17}, {9, 29, -9, -29}, {13, 42, -13, -42},
+	{18, 60, -18, -60}, {24, 80, -24, -80}, {33, 106, -33, -106}, {47, 183, -47, -183},
+};
+// T and H mode paint colour distances
+static int32_t const TinyKtx_etcDistances[8] = {3, 6, 11, 16, 23, 32, 41, 64};
+
+// EAC modifiers by table index and 3 bit pixel index
+static int32_t const TinyKtx_eacModifiers[16][8] = {
+	{-3, -6, -9, -15, 2, 5, 8, 14}, {-3, -7, -10, -13, 2, 6, 9, 12},
+	{-2, -5, -8, -13, 1, 4, 7, 12}, {-2, -4, -6, -13, 1, 3, 5, 12},
+	{-3, -6, -8, -12, 2, 5, 7, 11}, {-3, -7, -9, -11, 2, 6, 8, 10},
+	{-4, -7, -8, -11, 3, 6, 7, 10}, {-3, -5, -8, -11, 2, 4, 7, 10},
+	{-2, -6, -8, -10, 1, 5, 7, 9}, {-2, -5, -8, -10, 1, 4, 7, 9},
+	{-2, -4, -8, -10, 1, 3, 7, 9}, {-2, -5, -7, -10, 1, 4, 6, 9},
+	{-3, -4, -7, -10, 2, 3, 6, 9}, {-1, -2, -3, -10, 0, 1, 2, 9},
+	{-4, -6, -8, -9, 3, 5, 7, 8}, {-3, -5, -7, -9, 2, 4, 6, 8},
+};
+
+// ETC and EAC blocks are big endian 64 bit values
+static uint64_t TinyKtx_etcBlockBits(uint8_t const *block) {
+	uint64_t v = 0;
+	for (uint32_t i = 0; i < 8; ++i) {
+		v = (v << 8) | block[i];
+	}
+	return v;
+}
+
+// ETC2 RGB and RGB A1 (where the diff bit is the opaque bit and index 2 is transparent when
+// it is clear). Pixel indices are column major
+static void TinyKtx_decodeEtc2Color(uint8_t const *block, uint8_t *rgba, bool punchThrough) {
+	uint64_t const bits = TinyKtx_etcBlockBits(block);
+	bool const diff = (bits >> 33) & 1;
+	bool const flip = (bits >> 32) & 1;
+	bool const opaque = !punchThrough || diff;
+	uint32_t const lsbs = (uint32_t) bits & 0xFFFF;
+	uint32_t const msbs = (uint32_t) (bits >> 16) & 0xFFFF;
+
+	int32_t base[2][3];
+	int32_t paint[4][3];
+	bool paintMode = false;
+	if (!punchThrough && !diff) {
+		// individual, two 4 bit colours
+		for (uint32_t c = 0; c < 3; ++c) {
+			base[0][c] = (int32_t) ((bits >> (60 - c * 8)) & 0xF) * 17;
+			base[1][c] = (int32_t) ((bits >> (56 - c * 8)) & 0xF) * 17;
+		}
+	} else {
+		// differential, unless a 5 bit base plus 3 bit delta overflows which picks T, H or planar
+		int32_t full[3];
+		bool overflow[3];
+		for (uint32_t c = 0; c < 3; ++c) {
+			int32_t const v = (int32_t) ((bits >> (59 - c * 8)) & 0x1F);
+			int32_t const d = TinyKtx_signExtend((uint32_t) (bits >> (56 - c * 8)) & 0x7, 3);
+			full[c] = v + d;
+			overflow[c] = full[c] < 0 || full[c] > 31;
+			base[0][c] = (v << 3) | (v >> 2);
+			base[1][c] = overflow[c] ? 0 : (full[c] << 3) | (full[c] >> 2);
+		}
+		if (overflow[0]) {
+			// T mode
+			int32_t const c0[3] = {
+				(int32_t) ((((bits >> 59) & 0x3) << 2) | ((bits >> 56) & 0x3)),
+				(int32_t) ((bits >> 52) & 0xF),
+				(int32_t) ((bits >> 48) & 0xF),
+			};
+			int32_t const d = TinyKtx_etcDistances[(((bits >> 34) & 0x3) << 1) | ((bits >> 32) & 1)];
+			for (uint32_t c = 0; c < 3; ++c) {
+				int32_t const c1 = (int32_t) ((bits >> (44 - c * 4)) & 0xF) * 17;
+				paint[0][c] = c0[c] * 17;
+				paint[1][c] = c1 + d;
+				paint[2][c] = c1;
+				paint[3][c] = c1 - d;
+			}
+			paintMode = true;
+		} else if (overflow[1]) {
+			// H mode, the order of the two colours is the distance LSB
+			int32_t const c0[3] = {
+				(int32_t) ((bits >> 59) & 0xF),
+				(int32_t) ((((bits >> 56) & 0x7) << 1) | ((bits >> 52) & 1)),
+				(int32_t) ((((bits >> 51) & 1) << 3) | ((bits >> 47) & 0x7)),
+			};
+			int32_t const c1[3] = {
+				(int32_t) ((bits >> 43) & 0xF),
+				(int32_t) ((bits >> 39) & 0xF),
+				(int32_t) ((bits >> 35) & 0xF),
+			};
+			uint32_t const order = ((c0[0] << 8) | (c0[1] << 4) | c0[2]) >= ((c1[0] << 8) | (c1[1] << 4) | c1[2]) ? 1 : 0;
+			int32_t const d = TinyKtx_etcDistances[(((bits >> 34) & 1) << 2) | (((bits >> 32) & 1) << 1) | order];
+			for (uint32_t c = 0; c < 3; ++c) {
+				paint[0][c] = c0[c] * 17 + d;
+				paint[1][c] = c0[c] * 17 - d;
+				paint[2][c] = c1[c] * 17 + d;
+				paint[3][c] = c1[c] * 17 - d;
+			}
+			paintMode = true;
+		} else if (overflow[2]) {
+			// planar, a colour at (0,0), (4,0) and (0,4) extrapolated. Always opaque
+			int32_t const o[3] = {
+				(int32_t) ((bits >> 57) & 0x3F),
+				(int32_t) ((((bits >> 56) & 1) << 6) | ((bits >> 49) & 0x3F)),
+				(int32_t) ((((bits >> 48) & 1) << 5) | (((bits >> 43) & 0x3) << 3) | ((bits >> 39) & 0x7)),
+			};
+			int32_t const h[3] = {
+				(int32_t) ((((bits >> 34) & 0x1F) << 1) | ((bits >> 32) & 1)),
+				(int32_t) ((bits >> 25) & 0x7F),
+				(int32_t) ((bits >> 19) & 0x3F),
+			};
+			int32_t const v[3] = {
+				(int32_t) ((bits >> 13) & 0x3F),
+				(int32_t) ((bits >> 6) & 0x7F),
+				(int32_t) (bits & 0x3F),
+			};
+			int32_t O[3], H[3], V[3];
+			for (uint32_t c = 0; c < 3; ++c) {
+				// R and B are 6 bit, G 7 bit
+				uint32_t const b = c == 1 ? 7 : 6;
+				O[c] = (o[c] << (8 - b)) | (o[c] >> (2 * b - 8));
+				H[c] = (h[c] << (8 - b)) | (h[c] >> (2 * b - 8));
+				V[c] = (v[c] << (8 - b)) | (v[c] >> (2 * b - 8));
+			}
+			for (uint32_t y = 0; y < 4; ++y) {
+				for (uint32_t x = 0; x < 4; ++x) {
+					uint8_t *p = rgba + (y * 4 + x) * 4;
+					for (uint32_t c = 0; c < 3; ++c) {
+						p[c] = TinyKtx_clampByte(((int32_t) x * (H[c] - O[c]) + (int32_t) y * (V[c] - O[c]) + 4 * O[c] + 2) >> 2);
+					}
+					p[3] = 255;
+				}
+			}
+			return;
+		}
+	}
+
+	uint32_t const table[2] = {(uint32_t) (bits >> 37) & 0x7, (uint32_t) (bits >> 34) & 0x7};
+	for (uint32_t y = 0; y < 4; ++y) {
+		for (uint32_t x = 0; x < 4; ++x) {
+			uint32_t const i = x * 4 + y;
+			uint32_t const index = (((msbs >> i) & 1) << 1) | ((lsbs >> i) & 1);
+			uint8_t *p = rgba + (y * 4 + x) * 4;
+			if (!opaque && index == 2) {
+				p[0] = p[1] = p[2] = p[3] = 0;
+				continue;
+			}
+			if (paintMode) {
+				for (uint32_t c = 0; c < 3; ++c) {
+					p[c] = TinyKtx_clampByte(paint[index][c]);
+				}
+			} else {
+				uint32_t const sub = flip ? (y >= 2) : (x >= 2);
+				// without the opaque bit index 0 has no modifier
+				int32_t const modifier = (!opaque && index == 0) ? 0 : TinyKtx_etcModifiers[table[sub]][index];
+				for (uint32_t c = 0; c < 3; ++c) {
+					p[c] = TinyKtx_clampByte(base[sub][c] + modifier);
+				}
+			}
+			p[3] = 255;
+		}
+	}
+}
+
+// the 8 bit alpha block of ETC2 RGBA8, stride is in bytes
+static void TinyKtx_decodeEacAlpha(uint8_t const *block, uint8_t *out, uint32_t stride) {
+	uint64_t const bits = TinyKtx_etcBlockBits(block);
+	int32_t const base = block[0];
+	int32_t const multiplier = block[1] >> 4;
+	int32_t const *modifiers = TinyKtx_eacModifiers[block[1] & 0xF];
+	for (uint32_t y = 0; y < 4; ++y) {
+		for (uint32_t x = 0; x < 4; ++x) {
+			uint32_t const index = (uint32_t) (bits >> (45 - (x * 4 + y) * 3)) & 0x7;
+			out[(y * 4 + x) * stride] = TinyKtx_clampByte(base + modifiers[index] * multiplier);
+		}
+	}
+}
+
+// an 11 bit EAC channel widened to 16 bit UNORM/SNORM, stride is in uint16_t's.
+// Signed values are written as int16_t
+static void TinyKtx_decodeEac11(uint8_t const *block, uint16_t *out, uint32_t stride, bool isSigned) {
+	uint64_t const bits = TinyKtx_etcBlockBits(block);
+	int32_t const multiplier = block[1] >> 4;
+	int32_t const *modifiers = TinyKtx_eacModifiers[block[1] & 0xF];
+	int32_t base = isSigned ? (int8_t) block[0] : block[0];
+	if (base < -127) {
+		base = -127;
+	}
+	for (uint32_t y = 0; y < 4; ++y) {
+		for (uint32_t x = 0; x < 4; ++x) {
+			uint32_t const index = (uint32_t) (bits >> (45 - (x * 4 + y) * 3)) & 0x7;
+			// a multiplier of 0 uses the modifier unscaled
+			int32_t const modifier = multiplier ? modifiers[index] * multiplier * 8 : modifiers[index];
+			int32_t v;
+			if (isSigned) {
+				v = base * 8 + modifier;
+				v = v < -1023 ? -1023 : (v > 1023 ? 1023 : v);
+				int32_t const m = v < 0 ? -v : v;
+				int32_t const wide = (m << 5) | (m >> 5);
+				v = v < 0 ? -wide : wide;
+			} else {
+				v = base * 8 + 4 + modifier;
+				v = v < 0 ? 0 : (v > 2047 ? 2047 : v);
+				v = (v << 5) | (v >> 6);
+			}
+			out[(y * 4 + x) * stride] = (uint16_t) v;
+		}
+	}
+}
+
+// ASTC integer sequence encoding ranges, in quantization level order (2, 3, 4, 5, 6, 8 ... 256)
+typedef struct TinyKtx_AstcRange {
+	uint8_t trits;
+	uint8_t quints;
+	uint8_t bits;
+} TinyKtx_AstcRange;
+
+static TinyKtx_AstcRange const TinyKtx_astcRanges[21] = {
+	{0, 0, 1}, {1, 0, 0}, {0, 0, 2}, {0, 1, 0}, {1, 0, 1}, {0, 0, 3}, {0, 1, 1},
+	{1, 0, 2}, {0, 0, 4}, {0, 1, 2}, {1, 0, 3}, {0, 0, 5}, {0, 1, 3}, {1, 0, 4},
+	{0, 0, 6}, {0, 1, 4}, {1, 0, 5}, {0, 0, 7}, {0, 1, 5}, {1, 0, 6}, {0, 0, 8},
+};
+
+static uint32_t TinyKtx_astcIseBitCount(uint32_t count, uint32_t range) {
+	TinyKtx_AstcRange const *r = &TinyKtx_astcRanges[range];
+	uint32_t bits = r->bits * count;
+	if (r->trits) {
+		bits += (8 * count + 4) / 5;
+	}
+	if (r->quints) {
+		bits += (7 * count + 2) / 3;
+	}
+	return bits;
+}
+
+// reads count bits, those at or past end read as 0
+static uint32_t TinyKtx_blockBitsReadTo(TinyKtx_BlockBits *bits, uint32_t count, uint32_t end) {
+	if (bits->pos >= end) {
+		bits->pos += count;
+		return 0;
+	}
+	if (bits->pos + count > end) {
+		uint32_t const n = end - bits->pos;
+		uint32_t const v = TinyKtx_blockBitsRead(bits, n);
+		bits->pos += count - n;
+		return v;
+	}
+	return TinyKtx_blockBitsRead(bits, count);
+}
+
+static uint32_t TinyKtx_blockBitsAt(TinyKtx_BlockBits *bits, uint32_t pos, uint32_t count) {
+	bits->pos = pos;
+	return TinyKtx_blockBitsRead(bits, count);
+}
+
+// 5 trits packed in 8 bits
+static void TinyKtx_astcDecodeTrits(uint32_t T, uint8_t *t) {
+	uint32_t C;
+	if (((T >> 2) & 0x7) == 0x7) {
+		C = (((T >> 5) & 0x7) << 2) | (T & 0x3);
+		t[4] = 2;
+		t[3] = 2;
+	} else {
+		C = T & 0x1F;
+		if (((T >> 5) & 0x3) == 0x3) {
+			t[4] = 2;
+			t[3] = (uint8_t) ((T >> 7) & 1);
+		} else {
+			t[4] = (uint8_t) ((T >> 7) & 1);
+			t[3] = (uint8_t) ((T >> 5) & 0x3);
+		}
+	}
+	if ((C & 0x3) == 0x3) {
+		t[2] = 2;
+		t[1] = (uint8_t) ((C >> 4) & 1);
+		t[0] = (uint8_t) ((((C >> 3) & 1) << 1) | ((C >> 2) & ~(C >> 3) & 1));
+	} else if (((C >> 2) & 0x3) == 0x3) {
+		t[2] = 2;
+		t[1] = 2;
+		t[0] = (uint8_t) (C & 0x3);
+	} else {
+		t[2] = (uint8_t) ((C >> 4) & 1);
+		t[1] = (uint8_t) ((C >> 2) & 0x3);
+		t[0] = (uint8_t) ((((C >> 1) & 1) << 1) | (C & ~(C >> 1) & 1));
+	}
+}
+
+// 3 quints packed in 7 bits
+static void TinyKtx_astcDecodeQuints(uint32_t Q, uint8_t *q) {
+	if (((Q >> 1) & 0x3) == 0x3 && ((Q >> 5) & 0x3) == 0) {
+		q[2] = (uint8_t) (((Q & 1) << 2) | (((Q >> 4) & ~Q & 1) << 1) | ((Q >> 3) & ~Q & 1));
+		q[1] = 4;
+		q[0] = 4;
+		return;
+	}
+	uint32_t C;
+	if (((Q >> 1) & 0x3) == 0x3) {
+		q[2] = 4;
+		C = (((Q >> 3) & 0x3) << 3) | ((~Q >> 5 & 0x3) << 1) | (Q & 1);
+	} else {
+		q[2] = (uint8_t) ((Q >> 5) & 0x3);
+		C = Q & 0x1F;
+	}
+	if ((C & 0x7) == 0x5) {
+		q[1] = 4;
+		q[0] = (uint8_t) ((C >> 3) & 0x3);
+	} else {
+		q[1] = (uint8_t) ((C >> 3) & 0x3);
+		q[0] = (uint8_t) (C & 0x7);
+	}
+}
+
+// decodes count values from bits->pos, each as its low bits and its trit or quint
+static void TinyKtx_astcDecodeIse(TinyKtx_BlockBits *bits, uint32_t range, uint32_t count, uint8_t *low, uint8_t *high) {
+	TinyKtx_AstcRange const *r = &TinyKtx_astcRanges[range];
+	uint32_t const end = bits->pos + TinyKtx_astcIseBitCount(count, range);
+	// trits come 5 to a block with 8 packed bits, quints 3 with 7, split between the values
+	static uint8_t const tritBits[5] = {2, 2, 1, 2, 1};
+	static uint8_t const quintBits[3] = {3, 2, 2};
+	uint32_t const groupSize = r->trits ? 5 : (r->quints ? 3 : 1);
+	uint8_t const *packedBits = r->trits ? tritBits : quintBits;
+	for (uint32_t i = 0; i < count; i += groupSize) {
+		uint8_t groupLow[5];
+		uint8_t groupHigh[5] = {0, 0, 0, 0, 0};
+		uint32_t packed = 0;
+		uint32_t shift = 0;
+		for (uint32_t k = 0; k < groupSize; ++k) {
+			groupLow[k] = (uint8_t) TinyKtx_blockBitsReadTo(bits, r->bits, end);
+			if (groupSize > 1) {
+				packed |= TinyKtx_blockBitsReadTo(bits, packedBits[k], end) << shift;
+				shift += packedBits[k];
+			}
+		}
+		if (r->trits) {
+			TinyKtx_astcDecodeTrits(packed, groupHigh);
+		} else if (r->quints) {
+			TinyKtx_astcDecodeQuints(packed, groupHigh);
+		}
+		for (uint32_t k = 0; k < groupSize && i + k < count; ++k) {
+			low[i + k] = groupLow[k];
+			high[i + k] = groupHigh[k];
+		}
+	}
+	bits->pos = end;
+}
+
+// replicates the low bits of v to fill bits
+static uint32_t TinyKtx_replicateBits(uint32_t v, uint32_t from, uint32_t to) {
+	uint32_t r = 0;
+	for (int32_t s = (int32_t) (to - from); s > -(int32_t) from; s -= (int32_t) from) {
+		r |= s >= 0 ? v << s : v >> -s;
+	}
+	return r & ((1u << to) - 1u);
+}
+
+// colour endpoint values to 0-255
+static int32_t TinyKtx_astcUnquantizeColor(uint32_t range, uint32_t low, uint32_t high) {
+	TinyKtx_AstcRange const *r = &TinyKtx_astcRanges[range];
+	if (!r->trits && !r->quints)
+		return (int32_t) TinyKtx_replicateBits(low, r->bits, 8);
+
+	uint32_t const A = (low & 1) ? 0x1FF : 0;
+	uint32_t const h = low >> 1;
+	uint32_t B;
+	uint32_t C;
+	if (r->trits) {
+		switch (r->bits) {
+		case 1: B = 0; C = 204;
+			break;
+		case 2: B = h * 0x116; C = 93;
+			break;
+		case 3: B = (h << 7) | (h << 2) | h; C = 44;
+			break;
+		case 4: B = (h << 6) | h; C = 22;
+			break;
+		case 5: B = (h << 5) | (h >> 2); C = 11;
+			break;
+		default: B = (h << 4) | (h >> 4); C = 5;
+			break;
+		}
+	} else {
+		switch (r->bits) {
+		case 1: B = 0; C = 113;
+			break;
+		case 2: B = h * 0x10C; C = 54;
+			break;
+		case 3: B = (h << 7) | (h << 1) | (h >> 1); C = 26;
+			break;
+		case 4: B = (h << 6) | (h >> 1); C = 13;
+			break;
+		default: B = (h << 5) | (h >> 3); C = 6;
+			break;
+		}
+	}
+	uint32_t const T = (high * C + B) ^ A;
+	return (int32_t) ((A & 0x80) | (T >> 2));
+}
+
+// weights to 0-64
+static uint32_t TinyKtx_astcUnquantizeWeight(uint32_t range, uint32_t low, uint32_t high) {
+	TinyKtx_AstcRange const *r = &TinyKtx_astcRanges[range];
+	uint32_t v;
+	if (!r->trits && !r->quints) {
+		v = TinyKtx_replicateBits(low, r->bits, 6);
+	} else if (r->bits == 0) {
+		return high * (r->trits ? 32 : 16);
+	} else {
+		uint32_t const A = (low & 1) ? 0x7F : 0;
+		uint32_t const h = low >> 1;
+		uint32_t B;
+		uint32_t C;
+		if (r->trits) {
+			switch (r->bits) {
+			case 1: B = 0; C = 50;
+				break;
+			case 2: B = h * 0x45; C = 23;
+				break;
+			default: B = (h << 5) | h; C = 11;
+				break;
+			}
+		} else if (r->bits == 1) {
+			B = 0;
+			C = 28;
+		} else {
+			B = h * 0x42;
+			C = 13;
+		}
+		uint32_t const T = (high * C + B) ^ A;
+		v = (A & 0x20) | (T >> 2);
+	}
+	return v > 32 ? v + 1 : v;
+}
+
+static uint32_t TinyKtx_astcHash52(uint32_t v) {
+	v ^= v >> 15;
+	v *= 0xEEDE0891;
+	v ^= v >> 5;
+	v += v << 16;
+	v ^= v >> 7;
+	v ^= v >> 3;
+	v ^= v << 6;
+	v ^= v >> 17;
+	return v;
+}
+
+static uint32_t TinyKtx_astcSelectPartition(uint32_t seed, uint32_t x, uint32_t y, uint32_t partitions, bool smallBlock) {
+	if (smallBlock) {
+		x <<= 1;
+		y <<= 1;
+	}
+	seed += (partitions - 1) * 1024;
+	uint32_t const rnum = TinyKtx_astcHash52(seed);
+	uint32_t s[8];
+	for (uint32_t i = 0; i < 8; ++i) {
+		s[i] = (rnum >> (i * 4)) & 0xF;
+		s[i] *= s[i];
+	}
+	uint32_t sh1, sh2;
+	if (seed & 1) {
+		sh1 = (seed & 2) ? 4 : 5;
+		sh2 = partitions == 3 ? 6 : 5;
+	} else {
+		sh1 = partitions == 3 ? 6 : 5;
+		sh2 = (seed & 2) ? 4 : 5;
+	}
+	// 2D only, the z seeds (9 to 12) would multiply 0
+	uint32_t const a = ((s[0] >> sh1) * x + (s[1] >> sh2) * y + (rnum >> 14)) & 0x3F;
+	uint32_t const b = ((s[2] >> sh1) * x + (s[3] >> sh2) * y + (rnum >> 10)) & 0x3F;
+	uint32_t c = ((s[4] >> sh1) * x + (s[5] >> sh2) * y + (rnum >> 6)) & 0x3F;
+	uint32_t d = ((s[6] >> sh1) * x + (s[7] >> sh2) * y + (rnum >> 2)) & 0x3F;
+	if (partitions < 4) {
+		d = 0;
+	}
+	if (partitions < 3) {
+		c = 0;
+	}
+	if (a >= b && a >= c && a >= d)
+		return 0;
+	if (b >= c && b >= d)
+		return 1;
+	return c >= d ? 2 : 3;
+}
+
+static void TinyKtx_astcBitTransferSigned(int32_t *a, int32_t *b) {
+	*b >>= 1;
+	*b |= *a & 0x80;
+	*a >>= 1;
+	*a &= 0x3F;
+	if (*a & 0x20) {
+		*a -= 0x40;
+	}
+}
+
+static void TinyKtx_astcBlueContract(int32_t *e, int32_t r, int32_t g, int32_t b, int32_t a) {
+	e[0] = (r + b) >> 1;
+	e[1] = (g + b) >> 1;
+	e[2] = b;
+	e[3] = a;
+}
+
+static void TinyKtx_astcSet(int32_t *e, int32_t r, int32_t g, int32_t b, int32_t a) {
+	e[0] = r;
+	e[1] = g;
+	e[2] = b;
+	e[3] = a;
+}
+
+// LDR colour endpoint modes, false for HDR ones
+static bool TinyKtx_astcEndpoints(uint32_t cem, int32_t *v, int32_t *e0, int32_t *e1) {
+	switch (cem) {
+	case 0: TinyKtx_astcSet(e0, v[0], v[0], v[0], 0xFF);
+		TinyKtx_astcSet(e1, v[1], v[1], v[1], 0xFF);
+		break;
+	case 1: {
+		int32_t const l0 = (v[0] >> 2) | (v[1] & 0xC0);
+		int32_t const l1 = l0 + (v[1] & 0x3F);
+		TinyKtx_astcSet(e0, l0, l0, l0, 0xFF);
+		TinyKtx_astcSet(e1, l1, l1, l1, 0xFF);
+		break;
+	}
+	case 4: TinyKtx_astcSet(e0, v[0], v[0], v[0], v[2]);
+		TinyKtx_astcSet(e1, v[1], v[1], v[1], v[3]);
+		break;
+	case 5: TinyKtx_astcBitTransferSigned(&v[1], &v[0]);
+		TinyKtx_astcBitTransferSigned(&v[3], &v[2]);
+		TinyKtx_astcSet(e0, v[0], v[0], v[0], v[2]);
+		TinyKtx_astcSet(e1, v[0] + v[1], v[0] + v[1], v[0] + v[1], v[2] + v[3]);
+		break;
+	case 6: TinyKtx_astcSet(e0, (v[0] * v[3]) >> 8, (v[1] * v[3]) >> 8, (v[2] * v[3]) >> 8, 0xFF);
+		TinyKtx_astcSet(e1, v[0], v[1], v[2], 0xFF);
+		break;
+	case 8:
+	case 12: {
+		int32_t const a0 = cem == 12 ? v[6] : 0xFF;
+		int32_t const a1 = cem == 12 ? v[7] : 0xFF;
+		if (v[1] + v[3] + v[5] >= v[0] + v[2] + v[4]) {
+			TinyKtx_astcSet(e0, v[0], v[2], v[4], a0);
+			TinyKtx_astcSet(e1, v[1], v[3], v[5], a1);
+		} else {
+			TinyKtx_astcBlueContract(e0, v[1], v[3], v[5], a1);
+			TinyKtx_astcBlueContract(e1, v[0], v[2], v[4], a0);
+		}
+		break;
+	}
+	case 9:
+	case 13: {
+		TinyKtx_astcBitTransferSigned(&v[1], &v[0]);
+		TinyKtx_astcBitTransferSigned(&v[3], &v[2]);
+		TinyKtx_astcBitTransferSigned(&v[5], &v[4]);
+		int32_t a0 = 0xFF;
+		int32_t a1 = 0xFF;
+		if (cem == 13) {
+			TinyKtx_astcBitTransferSigned(&v[7], &v[6]);
+			a0 = v[6];
+			a1 = v[6] + v[7];
+		}
+		if (v[1] + v[3] + v[5] >= 0) {
+			TinyKtx_astcSet(e0, v[0], v[2], v[4], a0);
+			TinyKtx_astcSet(e1, v[0] + v[1], v[2] + v[3], v[4] + v[5], a1);
+		} else {
+			TinyKtx_astcBlueContract(e0, v[0] + v[1], v[2] + v[3], v[4] + v[5], a1);
+			TinyKtx_astcBlueContract(e1, v[0], v[2], v[4], a0);
+		}
+		break;
+	}
+	case 10: TinyKtx_astcSet(e0, (v[0] * v[3]) >> 8, (v[1] * v[3]) >> 8, (v[2] * v[3]) >> 8, v[4]);
+		TinyKtx_astcSet(e1, v[0], v[1], v[2], v[5]);
+		break;
+	default: return false;
+	}
+	for (uint32_t c = 0; c < 4; ++c) {
+		e0[c] = TinyKtx_clampByte(e0[c]);
+		e1[c] = TinyKtx_clampByte(e1[c]);
+	}
+	return true;
+}
+
+// weight grid size, dual plane and weight range from the 11 bit block mode, false if reserved
+static bool TinyKtx_astcBlockMode(uint32_t mode, uint32_t *gridWidth, uint32_t *gridHeight, bool *dualPlane, uint32_t *weightRange) {
+	uint32_t const a = (mode >> 5) & 0x3;
+	uint32_t r = (mode >> 4) & 1;
+	bool high = (mode >> 9) & 1;
+	bool dual = (mode >> 10) & 1;
+	if (mode & 0x3) {
+		r |= (mode & 0x3) << 1;
+		uint32_t b = (mode >> 7) & 0x3;
+		switch ((mode >> 2) & 0x3) {
+		case 0: *gridWidth = b + 4; *gridHeight = a + 2;
+			break;
+		case 1: *gridWidth = b + 8; *gridHeight = a + 2;
+			break;
+		case 2: *gridWidth = a + 2; *gridHeight = b + 8;
+			break;
+		default: b &= 1;
+			if (mode & 0x100) {
+				*gridWidth = b + 2;
+				*gridHeight = a + 2;
+			} else {
+				*gridWidth = a + 2;
+				*gridHeight = b + 6;
+			}
+			break;
+		}
+	} else {
+		r |= ((mode >> 2) & 0x3) << 1;
+		if (((mode >> 2) & 0x3) == 0)
+			return false;
+		uint32_t const b = (mode >> 9) & 0x3;
+		switch ((mode >> 7) & 0x3) {
+		case 0: *gridWidth = 12; *gridHeight = a + 2;
+			break;
+		case 1: *gridWidth = a + 2; *gridHeight = 12;
+			break;
+		case 2: *gridWidth = a + 6; *gridHeight = b + 6;
+			high = false;
+			dual = false;
+			break;
+		default:
+			if (a > 1)
+				return false;
+			*gridWidth = a ? 10 : 6;
+			*gridHeight = a ? 6 : 10;
+			break;
+		}
+	}
+	*dualPlane = dual;
+	// r is 2 to 7, the high bit picks the upper 6 of the 12 weight ranges
+	*weightRange = r - 2 + (high ? 6 : 0);
+	return true;
+}
+
+static void TinyKtx_astcErrorBlock(uint8_t *rgba, uint32_t texelCount) {
+	for (uint32_t i = 0; i < texelCount; ++i) {
+		rgba[i * 4 + 0] = 0xFF;
+		rgba[i * 4 + 1] = 0;
+		rgba[i * 4 + 2] = 0xFF;
+		rgba[i * 4 + 3] = 0xFF;
+	}
+}
+
+// ASTC LDR to 8 bit per channel, HDR and invalid blocks decode to the magenta error colour
+static void TinyKtx_decodeAstc(uint8_t const *block, uint32_t blockWidth, uint32_t blockHeight, bool srgb, uint8_t *rgba) {
+	uint32_t const texelCount = blockWidth * blockHeight;
+	TinyKtx_BlockBits bits;
+	TinyKtx_blockBitsInit(&bits, block);
+	uint32_t const blockMode = TinyKtx_blockBitsRead(&bits, 11);
+
+	// void extent, a constant 16 bit UNORM colour in the top 64 bits
+	if ((blockMode & 0x1FF) == 0x1FC) {
+		if (blockMode & 0x200) {
+			TinyKtx_astcErrorBlock(rgba, texelCount);
+			return;
+		}
+		for (uint32_t i = 0; i < texelCount; ++i) {
+			for (uint32_t c = 0; c < 4; ++c) {
+				rgba[i * 4 + c] = block[9 + c * 2];
+			}
+		}
+		return;
+	}
+
+	uint32_t gridWidth, gridHeight, weightRange;
+	bool dualPlane;
+	if (!TinyKtx_astcBlockMode(blockMode, &gridWidth, &gridHeight, &dualPlane, &weightRange) ||
+			gridWidth > blockWidth || gridHeight > blockHeight) {
+		TinyKtx_astcErrorBlock(rgba, texelCount);
+		return;
+	}
+	uint32_t const planes = dualPlane ? 2 : 1;
+	uint32_t const weightCount = gridWidth * gridHeight * planes;
+	uint32_t const weightBits = TinyKtx_astcIseBitCount(weightCount, weightRange);
+	uint32_t const partitions = TinyKtx_blockBitsRead(&bits, 2) + 1;
+	if (weightCount > 64 || weightBits < 24 || weightBits > 96 || (partitions == 4 && dualPlane)) {
+		TinyKtx_astcErrorBlock(rgba, texelCount);
+		return;
+	}
+
+	// colour endpoint modes, for more than one partition either a shared mode or a class plus
+	// per partition bits, some of which are just below the weights
+	uint32_t cem[4];
+	uint32_t partitionIndex = 0;
+	uint32_t colorStart = 17;
+	uint32_t belowWeights = 128 - weightBits;
+	if (partitions == 1) {
+		cem[0] = TinyKtx_blockBitsAt(&bits, 13, 4);
+	} else {
+		colorStart = 29;
+		partitionIndex = TinyKtx_blockBitsAt(&bits, 13, 10);
+		uint32_t encoded = TinyKtx_blockBitsAt(&bits, 23, 6);
+		if ((encoded & 0x3) == 0) {
+			for (uint32_t i = 0; i < partitions; ++i) {
+				cem[i] = encoded >> 2;
+			}
+		} else {
+			uint32_t const extraBits = 3 * partitions - 4;
+			belowWeights -= extraBits;
+			encoded |= TinyKtx_blockBitsAt(&bits, belowWeights, extraBits) << 6;
+			uint32_t const baseClass = (encoded & 0x3) - 1;
+			for (uint32_t i = 0; i < partitions; ++i) {
+				uint32_t const cemClass = baseClass + ((encoded >> (2 + i)) & 1);
+				cem[i] = (cemClass << 2) | ((encoded >> (2 + partitions + i * 2)) & 0x3);
+			}
+		}
+	}
+	uint32_t plane2Component = 4;
+	if (dualPlane) {
+		belowWeights -= 2;
+		plane2Component = TinyKtx_blockBitsAt(&bits, belowWeights, 2);
+	}
+
+	// the colour values get the finest range that fits in the bits left
+	uint32_t colorCount = 0;
+	for (uint32_t i = 0; i < partitions; ++i) {
+		colorCount += ((cem[i] >> 2) + 1) * 2;
+	}
+	if (colorCount > 18 || belowWeights <= colorStart) {
+		TinyKtx_astcErrorBlock(rgba, texelCount);
+		return;
+	}
+	int32_t colorRange = 20;
+	while (colorRange >= 0 && TinyKtx_astcIseBitCount(colorCount, (uint32_t) colorRange) > belowWeights - colorStart) {
+		colorRange--;
+	}
+	// below 6 levels is an error
+	if (colorRange < 4) {
+		TinyKtx_astcErrorBlock(rgba, texelCount);
+		return;
+	}
+	uint8_t low[64];
+	uint8_t high[64];
+	int32_t colors[18];
+	bits.pos = colorStart;
+	TinyKtx_astcDecodeIse(&bits, (uint32_t) colorRange, colorCount, low, high);
+	for (uint32_t i = 0; i < colorCount; ++i) {
+		colors[i] = TinyKtx_astcUnquantizeColor((uint32_t) colorRange, low[i], high[i]);
+	}
+	int32_t endpoints[4][2][4];
+	uint32_t colorIndex = 0;
+	for (uint32_t i = 0; i < partitions; ++i) {
+		if (!TinyKtx_astcEndpoints(cem[i], colors + colorIndex, endpoints[i][0], endpoints[i][1])) {
+			TinyKtx_astcErrorBlock(rgba, texelCount);
+			return;
+		}
+		colorIndex += ((cem[i] >> 2) + 1) * 2;
+	}
+
+	// weights are stored bit reversed from the top of the block
+	uint8_t reversed[16];
+	for (uint32_t i = 0; i < 16; ++i) {
+		uint8_t b = block[15 - i];
+		b = (uint8_t) (((b & 0xF0) >> 4) | ((b & 0x0F) << 4));
+		b = (uint8_t) (((b & 0xCC) >> 2) | ((b & 0x33) << 2));
+		b = (uint8_t) (((b & 0xAA) >> 1) | ((b & 0x55) << 1));
+		reversed[i] = b;
+	}
+	TinyKtx_BlockBits weightStream;
+	TinyKtx_blockBitsInit(&weightStream, reversed);
+	TinyKtx_astcDecodeIse(&weightStream, weightRange, weightCount, low, high);
+	// the grid is padded so the bilinear infill can read one past the edges (with 0 weight)
+	uint8_t grid[2][64 + 16];
+	memset(grid, 0, sizeof(grid));
+	for (uint32_t i = 0; i < weightCount; ++i) {
+		grid[i % planes][i / planes] = (uint8_t) TinyKtx_astcUnquantizeWeight(weightRange, low[i], high[i]);
+	}
+
+	// infill to the block (fixed point, as the spec) then interpolate the endpoints
+	uint32_t const ds = (1024 + blockWidth / 2) / (blockWidth - 1);
+	uint32_t const dt = (1024 + blockHeight / 2) / (blockHeight - 1);
+	bool const smallBlock = texelCount < 31;
+	for (uint32_t y = 0; y < blockHeight; ++y) {
+		uint32_t const gt = (dt * y * (gridHeight - 1) + 32) >> 6;
+		uint32_t const jt = gt >> 4;
+		uint32_t const ft = gt & 0xF;
+		for (uint32_t x = 0; x < blockWidth; ++x) {
+			uint32_t const gs = (ds * x * (gridWidth - 1) + 32) >> 6;
+			uint32_t const js = gs >> 4;
+			uint32_t const fs = gs & 0xF;
+			uint32_t const w11 = (fs * ft + 8) >> 4;
+			uint32_t const w10 = ft - w11;
+			uint32_t const w01 = fs - w11;
+			uint32_t const w00 = 16 - fs - ft + w11;
+			uint32_t const v0 = js + jt * gridWidth;
+			uint32_t weights[2];
+			for (uint32_t p = 0; p < planes; ++p) {
+				uint8_t const *g = grid[p];
+				weights[p] = (g[v0] * w00 + g[v0 + 1] * w01 + g[v0 + gridWidth] * w10 + g[v0 + gridWidth + 1] * w11 + 8) >> 4;
+			}
+
+			uint32_t const partition = partitions > 1 ?
+					TinyKtx_astcSelectPartition(partitionIndex, x, y, partitions, smallBlock) : 0;
+			int32_t const *e0 = endpoints[partition][0];
+			int32_t const *e1 = endpoints[partition][1];
+			uint8_t *p = rgba + (y * blockWidth + x) * 4;
+			for (uint32_t c = 0; c < 4; ++c) {
+				int32_t const w = (int32_t) weights[c == plane2Component ? 1 : 0];
+				// widened to 16 bits, sRGB with 0x80 in the low byte rather than replicated
+				int32_t const c0 = (e0[c] << 8) | (srgb ? 0x80 : e0[c]);
+				int32_t const c1 = (e1[c] << 8) | (srgb ? 0x80 : e1[c]);
+				p[c] = (uint8_t) (((c0 * (64 - w) + c1 * w + 32) >> 6) >> 8);
+			}
+		}
+	}
+}
+
+// UASTC is a subset of ASTC 4x4 with its own packing. The mode is a prefix code from bit 0, then
+// transcoding hints (not needed to decode), the partition pattern, the dual plane channel, the
+// endpoints and the weights. Endpoint ranges are ASTC ISE ranges, weights are plain bits
+typedef struct TinyKtx_UastcMode {
+	uint8_t code;
+	uint8_t codeBits;
+	uint8_t components;		// 2 is luminance alpha
+	uint8_t subsets;
+	uint8_t planes;
+	uint8_t weightBits;
+	uint8_t endpointRange;
+	uint8_t hintBits;
+} TinyKtx_UastcMode;
+
+#define TKTX_UASTC_MODE_COUNT 19
+#define TKTX_UASTC_SOLID_MODE 8
+#define TKTX_UASTC_MODE7 7
+static TinyKtx_UastcMode const TinyKtx_uastcModes[TKTX_UASTC_MODE_COUNT] = {
+	{0x01, 4, 3, 1, 1, 4, 19, 15},
+	{0x35, 6, 3, 1, 1, 2, 20, 15},
+	{0x1D, 5, 3, 2, 1, 3, 8, 15},
+	{0x03, 5, 3, 3, 1, 2, 7, 15},
+	{0x13, 5, 3, 2, 1, 2, 12, 15},
+	{0x0B, 5, 3, 1, 1, 3, 20, 15},
+	{0x1B, 5, 3, 1, 2, 2, 18, 15},
+	{0x07, 5, 3, 2, 1, 2, 12, 15},
+	{0x17, 5, 4, 1, 1, 0, 0, 0},		// a solid RGBA8 colour
+	{0x0F, 5, 4, 2, 1, 2, 8, 23},
+	{0x02, 3, 4, 1, 1, 4, 13, 17},
+	{0x00, 2, 4, 1, 2, 2, 13, 17},
+	{0x06, 3, 4, 1, 1, 3, 19, 17},
+	{0x1F, 5, 4, 1, 2, 1, 20, 23},
+	{0x0D, 5, 4, 1, 1, 2, 20, 23},
+	{0x05, 7, 2, 1, 1, 4, 20, 23},
+	{0x15, 6, 2, 2, 1, 2, 20, 23},
+	{0x25, 6, 2, 1, 2, 2, 20, 23},
+	{0x09, 4, 3, 1, 1, 5, 11, 15},
+};
+
+// ASTC partition seeds of the patterns UASTC shares with BC7 and the BC7 pattern each one is
+// (which gives the anchor texels). Mode 7 has its own two subset patterns, BC7 three subset
+// ones with two subsets merged
+static uint16_t const TinyKtx_uastcSeeds2[30] = {
+	28, 20, 16, 29, 91, 9, 107, 72, 149, 204, 50, 114, 496, 17, 78,
+	39, 252, 828, 43, 156, 116, 210, 476, 273, 684, 359, 246, 195, 694, 524,
+};
+static uint8_t const TinyKtx_uastcBc7Patterns2[30] = {
+	0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14,
+	15, 17, 18, 19, 20, 21, 22, 23, 24, 25, 26, 29, 32, 33, 52,
+};
+static uint16_t const TinyKtx_uastcSeeds3[11] = {260, 74, 32, 156, 183, 15, 745, 0, 335, 902, 254};
+static uint8_t const TinyKtx_uastcBc7Patterns3[11] = {4, 8, 9, 10, 11, 12, 13, 20, 35, 36, 57};
+static uint16_t const TinyKtx_uastcSeedsMode7[19] = {
+	36, 48, 61, 137, 161, 183, 226, 281, 302, 307, 479, 495, 593, 594, 605, 799, 812, 988, 993,
+};
+static uint8_t const TinyKtx_uastcBc7PatternsMode7[19] = {
+	10, 11, 0, 2, 8, 13, 1, 33, 40, 20, 21, 58, 3, 32, 59, 34, 20, 14, 31,
+};
+
+// UASTC to 8 bit per channel, invalid blocks decode to the ASTC magenta error colour
+static void TinyKtx_decodeUastc(uint8_t const *block, bool srgb, uint8_t *rgba) {
+	uint32_t modeIndex = 0;
+	while (modeIndex < TKTX_UASTC_MODE_COUNT &&
+			(block[0] & ((1u << TinyKtx_uastcModes[modeIndex].codeBits) - 1u)) != TinyKtx_uastcModes[modeIndex].code) {
+		modeIndex++;
+	}
+	if (modeIndex == TKTX_UASTC_MODE_COUNT) {
+		TinyKtx_astcErrorBlock(rgba, 16);
+		return;
+	}
+	TinyKtx_UastcMode const *mode = &TinyKtx_uastcModes[modeIndex];
+	TinyKtx_BlockBits bits;
+	TinyKtx_blockBitsInit(&bits, block);
+	bits.pos = mode->codeBits;
+
+	if (modeIndex == TKTX_UASTC_SOLID_MODE) {
+		uint8_t color[4];
+		for (uint32_t c = 0; c < 4; ++c) {
+			color[c] = (uint8_t) TinyKtx_blockBitsRead(&bits, 8);
+		}
+		for (uint32_t i = 0; i < 16; ++i) {
+			memcpy(rgba + i * 4, color, 4);
+		}
+		return;
+	}
+	bits.pos += mode->hintBits;
+
+	// texels whose weights have one less bit (the top bit is 0), texel 0 and the BC7 anchors
+	uint32_t seed = 0;
+	uint32_t anchors = 1;
+	if (mode->subsets > 1) {
+		uint16_t const *seeds = TinyKtx_uastcSeeds2;
+		uint8_t const *bc7Patterns = TinyKtx_uastcBc7Patterns2;
+		uint32_t seedCount = 30;
+		if (mode->subsets == 3) {
+			seeds = TinyKtx_uastcSeeds3;
+			bc7Patterns = TinyKtx_uastcBc7Patterns3;
+			seedCount = 11;
+		} else if (modeIndex == TKTX_UASTC_MODE7) {
+			seeds = TinyKtx_uastcSeedsMode7;
+			bc7Patterns = TinyKtx_uastcBc7PatternsMode7;
+			seedCount = 19;
+		}
+		uint32_t const pattern = TinyKtx_blockBitsRead(&bits, mode->subsets == 3 ? 4 : 5);
+		if (pattern >= seedCount) {
+			TinyKtx_astcErrorBlock(rgba, 16);
+			return;
+		}
+		seed = seeds[pattern];
+		uint32_t const bc7Pattern = bc7Patterns[pattern];
+		if (mode->subsets == 3) {
+			anchors |= (1u << TinyKtx_bptcAnchors3[0][bc7Pattern]) | (1u << TinyKtx_bptcAnchors3[1][bc7Pattern]);
+		} else if (modeIndex == TKTX_UASTC_MODE7) {
+			// one of the merged BC7 subsets shares texel 0's, the first anchor outside it is the other's
+			uint32_t const subset0 = TinyKtx_astcSelectPartition(seed, 0, 0, 2, true);
+			for (uint32_t k = 0; k < 2; ++k) {
+				uint32_t const a = TinyKtx_bptcAnchors3[k][bc7Pattern];
+				if (TinyKtx_astcSelectPartition(seed, a & 3, a >> 2, 2, true) != subset0) {
+					anchors |= 1u << a;
+					break;
+				}
+			}
+		} else {
+			anchors |= 1u << TinyKtx_bptcAnchors2[bc7Pattern];
+		}
+	}
+	uint32_t plane2Component = 4;
+	if (mode->planes == 2) {
+		plane2Component = TinyKtx_blockBitsRead(&bits, 2);
+	}
+
+	// the trits or quints of every endpoint value come first, 5 trits in 8 bits or 3 quints in
+	// 7 as base 3 or 5 digits (the last group in fewer bits), then the low bits of every value
+	TinyKtx_AstcRange const *range = &TinyKtx_astcRanges[mode->endpointRange];
+	uint32_t const valueCount = mode->components * 2u * mode->subsets;
+	uint8_t low[18];
+	uint8_t high[18];
+	memset(high, 0, sizeof(high));
+	if (range->trits || range->quints) {
+		static uint8_t const tritGroupBits[6] = {0, 2, 4, 5, 7, 8};
+		static uint8_t const quintGroupBits[4] = {0, 3, 5, 7};
+		uint32_t const base = range->trits ? 3 : 5;
+		uint32_t const groupSize = range->trits ? 5 : 3;
+		for (uint32_t i = 0; i < valueCount; i += groupSize) {
+			uint32_t const n = valueCount - i < groupSize ? valueCount - i : groupSize;
+			uint32_t packed = TinyKtx_blockBitsRead(&bits, range->trits ? tritGroupBits[n] : quintGroupBits[n]);
+			for (uint32_t k = 0; k < n; ++k) {
+				high[i + k] = (uint8_t) (packed % base);
+				packed /= base;
+			}
+		}
+	}
+	for (uint32_t i = 0; i < valueCount; ++i) {
+		low[i] = (uint8_t) TinyKtx_blockBitsRead(&bits, range->bits);
+	}
+
+	// values are in ASTC order (r0 r1 g0 g1 b0 b1 a0 a1 or l0 l1 a0 a1) per subset
+	int32_t endpoints[3][2][4];
+	for (uint32_t s = 0; s < mode->subsets; ++s) {
+		uint32_t const first = s * mode->components * 2u;
+		for (uint32_t e = 0; e < 2; ++e) {
+			int32_t v[4] = {0, 0, 0, 255};
+			for (uint32_t c = 0; c < mode->components; ++c) {
+				v[c] = TinyKtx_astcUnquantizeColor(mode->endpointRange, low[first + c * 2 + e], high[first + c * 2 + e]);
+			}
+			if (mode->components == 2) {
+				TinyKtx_astcSet(endpoints[s][e], v[0], v[0], v[0], v[1]);
+			} else {
+				TinyKtx_astcSet(endpoints[s][e], v[0], v[1], v[2], v[3]);
+			}
+		}
+	}
+
+	// weights by texel with dual plane ones interleaved, with dual planes both weights of
+	// texel 0 are a bit short
+	static uint8_t const weightRanges[6] = {0, 0, 2, 5, 8, 11};
+	uint32_t const weightRange = weightRanges[mode->weightBits];
+	for (uint32_t i = 0; i < 16; ++i) {
+		uint32_t const subset = mode->subsets > 1 ?
+				TinyKtx_astcSelectPartition(seed, i & 3, i >> 2, mode->subsets, true) : 0;
+		uint32_t const weightBits = mode->weightBits - ((anchors >> i) & 1u);
+		uint32_t weights[2] = {0, 0};
+		for (uint32_t p = 0; p < mode->planes; ++p) {
+			weights[p] = TinyKtx_astcUnquantizeWeight(weightRange, TinyKtx_blockBitsRead(&bits, weightBits), 0);
+		}
+		int32_t const *e0 = endpoints[subset][0];
+		int32_t const *e1 = endpoints[subset][1];
+		uint8_t *p = rgba + i * 4;
+		for (uint32_t c = 0; c < 4; ++c) {
+			int32_t const w = (int32_t) weights[c == plane2Component ? 1 : 0];
+			// as ASTC, widened to 16 bits with sRGB getting 0x80 in the low byte
+			int32_t const c0 = (e0[c] << 8) | (srgb ? 0x80 : e0[c]);
+			int32_t const c1 = (e1[c] << 8) | (srgb ? 0x80 : e1[c]);
+			p[c] = (uint8_t) (((c0 * (64 - w) + c1 * w + 32) >> 6) >> 8);
+		}
+	}
+}
+
+// an image of a UASTC level is 4x4 blocks of 16 bytes, decoded a block at a time
+static bool TinyKtx2_transcodeUastc(TinyKtx2_TranscodeImage const *image, TinyKtx_Format format) {
+	uint32_t const blocksX = (image->width + 3) / 4;
+	uint32_t const blocksY = (image->height + 3) / 4;
+	size_t const imageBytes = (size_t) blocksX * blocksY * 16;
+	if (image->levelDataSize < imageBytes * image->imageCount)
+		return false;
+	bool const srgb = format == TKTX_R8G8B8A8_SRGB;
+	if (image->dstSize != (size_t) image->width * image->height * 4)
+		return false;
+
+	uint8_t const *src = (uint8_t const *) image->levelData + imageBytes * image->imageIndex;
+	uint8_t *dst = (uint8_t *) image->dst;
+	for (uint32_t by = 0; by < blocksY; ++by) {
+		for (uint32_t bx = 0; bx < blocksX; ++bx) {
+			size_t const blockIndex = (size_t) by * blocksX + bx;
+			uint8_t pixels[16 * 4];
+			TinyKtx_decodeUastc(src + blockIndex * 16, srgb, pixels);
+			// edge blocks are clipped to the image
+			uint32_t const w = image->width - bx * 4 < 4 ? image->width - bx * 4 : 4;
+			uint32_t const h = image->height - by * 4 < 4 ? image->height - by * 4 : 4;
+			for (uint32_t y = 0; y < h; ++y) {
+				memcpy(dst + (((size_t) by * 4 + y) * image->width + bx * 4) * 4, pixels + y * 16, w * 4);
+			}
+		}
+	}
+	return true;
+}
+
+static bool TinyKtx2_uastcToRgba8(void *user, void *const sgdData, TinyKtx2_TranscodeImage const *image) {
+	(void) user;
+	(void) sgdData;
+	return TinyKtx2_transcodeUastc(image, TKTX_R8G8B8A8_UNORM);
+}
+
+static bool TinyKtx2_uastcToRgba8Srgb(void *user, void *const sgdData, TinyKtx2_TranscodeImage const *image) {
+	(void) user;
+	(void) sgdData;
+	return TinyKtx2_transcodeUastc(image, TKTX_R8G8B8A8_SRGB);
+}
+
+TinyKtx2_TranscoderTableEntry const TinyKtx2_UastcTranscoders[TINYKTX2_UASTC_TRANSCODER_COUNT] = {
+	{TKTX2_UNIVERSAL_UASTC, TKTX_R8G8B8A8_UNORM, &TinyKtx2_uastcToRgba8},
+	{TKTX2_UNIVERSAL_UASTC, TKTX_R8G8B8A8_SRGB, &TinyKtx2_uastcToRgba8Srgb},
+};
+
+typedef enum TinyKtx_DecodeKind {
+	TKTX_DECODE_BC1_RGB,
+	TKTX_DECODE_BC1_RGBA,
+	TKTX_DECODE_BC2,
+	TKTX_DECODE_BC3,
+	TKTX_DECODE_BC4,
+	TKTX_DECODE_BC5,
+	TKTX_DECODE_BC6H,
+	TKTX_DECODE_BC7,
+	TKTX_DECODE_ETC2_RGB,
+	TKTX_DECODE_ETC2_RGBA1,
+	TKTX_DECODE_ETC2_RGBA,
+	TKTX_DECODE_EAC_R11,
+	TKTX_DECODE_EAC_RG11,
+	TKTX_DECODE_ASTC,
+} TinyKtx_DecodeKind;
+
+typedef struct TinyKtx_DecodeTasks {
+	TinyKtx_DecodeKind kind;
+	bool isSigned;
+	bool srgb;
+	uint32_t width;
+	uint32_t height;
+	uint32_t blockWidth;
+	uint32_t blockHeight;
+	uint32_t blocksX;
+	uint32_t blocksY;
+	uint32_t blockBytes;
+	uint32_t dstPixelBytes;
+	uint8_t const *src;
+	uint8_t *dst;
+} TinyKtx_DecodeTasks;
+
+static bool TinyKtx_decodeKind(TinyKtx_Format format, TinyKtx_DecodeKind *kind, bool *isSigned, bool *srgb) {
+	*isSigned = false;
+	*srgb = false;
+	// ASTC formats are UNORM/SRGB pairs from 4x4 to 12x12
+	if (format >= TKTX_ASTC_4x4_UNORM_BLOCK && format <= TKTX_ASTC_12x12_SRGB_BLOCK) {
+		*kind = TKTX_DECODE_ASTC;
+		*srgb = ((format - TKTX_ASTC_4x4_UNORM_BLOCK) & 1) != 0;
+		return true;
+	}
+	switch (format) {
+	case TKTX_BC1_RGB_UNORM_BLOCK:
+	case TKTX_BC1_RGB_SRGB_BLOCK: *kind = TKTX_DECODE_BC1_RGB;
+		return true;
+	case TKTX_BC1_RGBA_UNORM_BLOCK:
+	case TKTX_BC1_RGBA_SRGB_BLOCK: *kind = TKTX_DECODE_BC1_RGBA;
+		return true;
+	case TKTX_BC2_UNORM_BLOCK:
+	case TKTX_BC2_SRGB_BLOCK: *kind = TKTX_DECODE_BC2;
+		return true;
+	case TKTX_BC3_UNORM_BLOCK:
+	case TKTX_BC3_SRGB_BLOCK: *kind = TKTX_DECODE_BC3;
+		return true;
+	case TKTX_BC4_UNORM_BLOCK:
+	case TKTX_BC4_SNORM_BLOCK: *kind = TKTX_DECODE_BC4;
+		*isSigned = format == TKTX_BC4_SNORM_BLOCK;
+		return true;
+	case TKTX_BC5_UNORM_BLOCK:
+	case TKTX_BC5_SNORM_BLOCK: *kind = TKTX_DECODE_BC5;
+		*isSigned = format == TKTX_BC5_SNORM_BLOCK;
+		return true;
+	case TKTX_BC6H_UFLOAT_BLOCK:
+	case TKTX_BC6H_SFLOAT_BLOCK: *kind = TKTX_DECODE_BC6H;
+		*isSigned = format == TKTX_BC6H_SFLOAT_BLOCK;
+		return true;
+	case TKTX_BC7_UNORM_BLOCK:
+	case TKTX_BC7_SRGB_BLOCK: *kind = TKTX_DECODE_BC7;
+		return true;
+	case TKTX_ETC2_R8G8B8_UNORM_BLOCK:
+	case TKTX_ETC2_R8G8B8_SRGB_BLOCK: *kind = TKTX_DECODE_ETC2_RGB;
+		return true;
+	case TKTX_ETC2_R8G8B8A1_UNORM_BLOCK:
+	case TKTX_ETC2_R8G8B8A1_SRGB_BLOCK: *kind = TKTX_DECODE_ETC2_RGBA1;
+		return true;
+	case TKTX_ETC2_R8G8B8A8_UNORM_BLOCK:
+	case TKTX_ETC2_R8G8B8A8_SRGB_BLOCK: *kind = TKTX_DECODE_ETC2_RGBA;
+		return true;
+	case TKTX_EAC_R11_UNORM_BLOCK:
+	case TKTX_EAC_R11_SNORM_BLOCK: *kind = TKTX_DECODE_EAC_R11;
+		*isSigned = format == TKTX_EAC_R11_SNORM_BLOCK;
+		return true;
+	case TKTX_EAC_R11G11_UNORM_BLOCK:
+	case TKTX_EAC_R11G11_SNORM_BLOCK: *kind = TKTX_DECODE_EAC_RG11;
+		*isSigned = format == TKTX_EAC_R11G11_SNORM_BLOCK;
+		return true;
+	default: return false;
+	}
+}
+
+bool TinyKtx_CanDecode(TinyKtx_Format format, TinyKtx_Format dstFormat) {
+	TinyKtx_DecodeKind kind;
+	bool isSigned;
+	bool srgb;
+	if (!TinyKtx_decodeKind(format, &kind, &isSigned, &srgb))
+		return false;
+
+	switch (kind) {
+	case TKTX_DECODE_BC4:
+		return isSigned ? (dstFormat == TKTX_R8_SNORM || dstFormat == TKTX_R8G8B8A8_SNORM) :
+					 (dstFormat == TKTX_R8_UNORM || dstFormat == TKTX_R8G8B8A8_UNORM);
+	case TKTX_DECODE_BC5:
+		return isSigned ? (dstFormat == TKTX_R8G8_SNORM || dstFormat == TKTX_R8G8B8A8_SNORM) :
+					 (dstFormat == TKTX_R8G8_UNORM || dstFormat == TKTX_R8G8B8A8_UNORM);
+	case TKTX_DECODE_BC6H: return dstFormat == TKTX_R16G16B16A16_SFLOAT;
+	case TKTX_DECODE_EAC_R11: return dstFormat == (isSigned ? TKTX_R16_SNORM : TKTX_R16_UNORM);
+	case TKTX_DECODE_EAC_RG11: return dstFormat == (isSigned ? TKTX_R16G16_SNORM : TKTX_R16G16_UNORM);
+	default: return dstFormat == TKTX_R8G8B8A8_UNORM || dstFormat == TKTX_R8G8B8A8_SRGB;
+	}
+}
+
+// decodes one block to blockWidth x blockHeight pixels of the destination format
+static void TinyKtx_decodeBlock(TinyKtx_DecodeTasks const *tasks, uint8_t const *block, uint8_t *pixels) {
+	uint32_t const stride = tasks->dstPixelBytes;
+	switch (tasks->kind) {
+	case TKTX_DECODE_BC1_RGB: TinyKtx_decodeBc1Color(block, pixels, true, false);
+		break;
+	case TKTX_DECODE_BC1_RGBA: TinyKtx_decodeBc1Color(block, pixels, true, true);
+		break;
+	case TKTX_DECODE_BC2: TinyKtx_decodeBc1Color(block + 8, pixels, false, false);
+		TinyKtx_decodeBc2Alpha(block, pixels);
+		break;
+	case TKTX_DECODE_BC3: TinyKtx_decodeBc1Color(block + 8, pixels, false, false);
+		TinyKtx_decodeBc4Channel(block, pixels + 3, 4, false);
+		break;
+	case TKTX_DECODE_BC4:
+	case TKTX_DECODE_BC5: TinyKtx_decodeBc4Channel(block, pixels, stride, tasks->isSigned);
+		if (tasks->kind == TKTX_DECODE_BC5) {
+			TinyKtx_decodeBc4Channel(block + 8, pixels + 1, stride, tasks->isSigned);
+		}
+		if (stride == 4) {
+			for (uint32_t i = 0; i < 16; ++i) {
+				if (tasks->kind == TKTX_DECODE_BC4) {
+					pixels[i * 4 + 1] = 0;
+				}
+				pixels[i * 4 + 2] = 0;
+				pixels[i * 4 + 3] = tasks->isSigned ? 127 : 255;
+			}
+		}
+		break;
+	case TKTX_DECODE_BC6H: {
+		uint16_t halfs[16 * 4];
+		TinyKtx_decodeBc6h(block, halfs, tasks->isSigned);
+		memcpy(pixels, halfs, sizeof(halfs));
+		break;
+	}
+	case TKTX_DECODE_BC7: TinyKtx_decodeBc7(block, pixels);
+		break;
+	case TKTX_DECODE_ETC2_RGB: TinyKtx_decodeEtc2Color(block, pixels, false);
+		break;
+	case TKTX_DECODE_ETC2_RGBA1: TinyKtx_decodeEtc2Color(block, pixels, true);
+		break;
+	case TKTX_DECODE_ETC2_RGBA: TinyKtx_decodeEtc2Color(block + 8, pixels, false);
+		TinyKtx_decodeEacAlpha(block, pixels + 3, 4);
+		break;
+	case TKTX_DECODE_EAC_R11:
+	case TKTX_DECODE_EAC_RG11: {
+		uint16_t channels[16 * 2];
+		uint32_t const channelCount = tasks->kind == TKTX_DECODE_EAC_RG11 ? 2 : 1;
+		TinyKtx_decodeEac11(block, channels, channelCount, tasks->isSigned);
+		if (channelCount == 2) {
+			TinyKtx_decodeEac11(block + 8, channels + 1, 2, tasks->isSigned);
+		}
+		memcpy(pixels, channels, 16 * channelCount * sizeof(uint16_t));
+		break;
+	}
+	case TKTX_DECODE_ASTC: TinyKtx_decodeAstc(block, tasks->blockWidth, tasks->blockHeight, tasks->srgb, pixels);
+		break;
+	}
+}
+
+// a task is one block row of one image
+static void TinyKtx_decodeBlockRowTask(void *taskData, uint32_t taskIndex) {
+	TinyKtx_DecodeTasks const *tasks = (TinyKtx_DecodeTasks const *) taskData;
+	uint32_t const image = taskIndex / tasks->blocksY;
+	uint32_t const by = taskIndex % tasks->blocksY;
+	size_t const srcImageBytes = (size_t) tasks->blocksX * tasks->blocksY * tasks->blockBytes;
+	size_t const dstRowBytes = (size_t) tasks->width * tasks->dstPixelBytes;
+	uint8_t const *src = tasks->src + image * srcImageBytes + (size_t) by * tasks->blocksX * tasks->blockBytes;
+	uint32_t const bw = tasks->blockWidth;
+	uint32_t const bh = tasks->blockHeight;
+	uint8_t *dst = tasks->dst + (image * (size_t) tasks->height + by * bh) * dstRowBytes;
+	uint32_t const rows = tasks->height - by * bh < bh ? tasks->height - by * bh : bh;
+
+	// the largest block is 12x12 ASTC
+	uint8_t pixels[12 * 12 * 4];
+	for (uint32_t bx = 0; bx < tasks->blocksX; ++bx) {
+		TinyKtx_decodeBlock(tasks, src + (size_t) bx * tasks->blockBytes, pixels);
+		uint32_t const columns = tasks->width - bx * bw < bw ? tasks->width - bx * bw : bw;
+		for (uint32_t y = 0; y < rows; ++y) {
+			memcpy(dst + y * dstRowBytes + (size_t) bx * bw * tasks->dstPixelBytes,
+						 pixels + y * bw * tasks->dstPixelBytes,
+						 columns * tasks->dstPixelBytes);
+		}
+	}
+}
+
+bool TinyKtx_DecodeImages(TinyKtx_Format format,
+													uint32_t width,
+													uint32_t height,
+													uint32_t imageCount,
+													void const *src,
+													size_t srcSize,
+													TinyKtx_Format dstFormat,
+													void *dst,
+													size_t dstSize,
+													TinyKtx_DecodeDispatchFunc dispatch,
+													void *dispatchUser) {
+	if (src == NULL || dst == NULL || width == 0 || height == 0 || imageCount == 0)
+		return false;
+	if (!TinyKtx_CanDecode(format, dstFormat))
+		return false;
+
+	TinyKtx_FormatTraits srcTraits;
+	TinyKtx_FormatTraits dstTraits;
+	if (!TinyKtx_GetFormatTraits(format, &srcTraits) || !TinyKtx_GetFormatTraits(dstFormat, &dstTraits))
+		return false;
+
+	TinyKtx_DecodeTasks tasks;
+	memset(&tasks, 0, sizeof(TinyKtx_DecodeTasks));
+	TinyKtx_decodeKind(format, &tasks.kind, &tasks.isSigned, &tasks.srgb);
+	tasks.width = width;
+	tasks.height = height;
+	tasks.blockWidth = srcTraits.blockWidth;
+	tasks.blockHeight = srcTraits.blockHeight;
+	tasks.blocksX = (width + tasks.blockWidth - 1) / tasks.blockWidth;
+	tasks.blocksY = (height + tasks.blockHeight - 1) / tasks.blockHeight;
+	tasks.blockBytes = srcTraits.blockByteSize;
+	tasks.dstPixelBytes = dstTraits.blockByteSize;
+	tasks.src = (uint8_t const *) src;
+	tasks.dst = (uint8_t *) dst;
+
+	uint64_t const srcBytes = (uint64_t) tasks.blocksX * tasks.blocksY * tasks.blockBytes * imageCount;
+	uint64_t const dstBytes = (uint64_t) width * height * tasks.dstPixelBytes * imageCount;
+	if (srcSize < srcBytes || dstSize < dstBytes)
+		return false;
+	uint64_t const taskCount = (uint64_t) tasks.blocksY * imageCount;
+	if (taskCount > 0xFFFFFFFFu)
+		return false;
+
+	if (dispatch == NULL) {
+		for (uint32_t i = 0; i < (uint32_t) taskCount; ++i) {
+			TinyKtx_decodeBlockRowTask(&tasks, i);
+		}
+	} else {
+		dispatch(dispatchUser, &TinyKtx_decodeBlockRowTask, &tasks, (uint32_t) taskCount);
+	}
+	return true;
+}
+
+// output pixels per chunk of a row and the most source pixels a chunk can cover. A size at most
+// shrinks by 3 (3 -> 1) so that is 63 * 3 plus the 13 taps the cubic can have at that scale
+#define TINYKTX_MIPMAP_CHUNK 64
+#define TINYKTX_MIPMAP_SPAN 256
+#define TINYKTX_MIPMAP_MAX_TAPS 16
+// output rows per task
+#define TINYKTX_MIPMAP_BAND 16
+
+typedef struct TinyKtx_MipmapTaps {
+	uint32_t first;
+	uint32_t count;
+	float weights[TINYKTX_MIPMAP_MAX_TAPS];
+} TinyKtx_MipmapTaps;
+
+// Mitchell-Netravali with B = C = 1/3
+static float TinyKtx_mitchell(float x) {
+	x = x < 0.0f ? -x : x;
+	if (x < 1.0f)
+		return (7.0f * x * x * x - 12.0f * x * x + 16.0f / 3.0f) / 6.0f;
+	if (x < 2.0f)
+		return ((-7.0f / 3.0f) * x * x * x + 12.0f * x * x - 20.0f * x + 32.0f / 3.0f) / 6.0f;
+	return 0.0f;
+}
+
+// the source pixels and weights of output pixel i of an axis reduced from n to m pixels
+static void TinyKtx_mipmapTaps(TinyKtx_MipmapFilter filter, uint32_t n, uint32_t m, uint32_t i, TinyKtx_MipmapTaps *taps) {
+	if (filter == TKTX_MIPMAP_FILTER_BOX) {
+		// in 1/m of a source pixel so odd sizes are exact
+		uint64_t const lo = (uint64_t) i * n;
+		uint64_t const hi = lo + n;
+		taps->first = (uint32_t) (lo / m);
+		taps->count = (uint32_t) ((hi + m - 1) / m) - taps->first;
+		for (uint32_t t = 0; t < taps->count; ++t) {
+			uint64_t const j = (uint64_t) (taps->first + t) * m;
+			uint64_t const start = j > lo ? j : lo;
+			uint64_t const end = j + m < hi ? j + m : hi;
+			taps->weights[t] = (float) (end - start) / (float) n;
+		}
+		return;
+	}
+
+	// the kernel is stretched over scale source pixels (at most 3), off the edges is the edge pixel
+	float const scale = (float) n / (float) m;
+	float const centre = ((float) i + 0.5f) * scale - 0.5f;
+	int64_t const c = (int64_t) centre;
+	uint32_t last = 0;
+	taps->first = n;
+	for (int64_t j = c - 6; j <= c + 7; ++j) {
+		if (TinyKtx_mitchell(((float) j - centre) / scale) == 0.0f)
+			continue;
+		uint32_t const cj = j < 0 ? 0 : (j >= (int64_t) n ? n - 1 : (uint32_t) j);
+		taps->first = cj < taps->first ? cj : taps->first;
+		last = cj > last ? cj : last;
+	}
+	taps->count = last - taps->first + 1;
+	float sum = 0.0f;
+	memset(taps->weights, 0, sizeof(taps->weights));
+	for (int64_t j = c - 6; j <= c + 7; ++j) {
+		float const w = TinyKtx_mitchell(((float) j - centre) / scale);
+		uint32_t const cj = j < 0 ? 0 : (j >= (int64_t) n ? n - 1 : (uint32_t) j);
+		if (w != 0.0f) {
+			taps->weights[cj - taps->first] += w;
+			sum += w;
+		}
+	}
+	for (uint32_t t = 0; t < taps->count; ++t) {
+		taps->weights[t] /= sum;
+	}
+}
+
+// acc[x] += weight * the x taps of the span, for count output pixels
+static void TinyKtx_mipmapAccumulate(TinyKtx_MipmapTaps const *xTaps, uint32_t count, float const *span, uint32_t spanStart,
+																		 uint32_t channels, float weight, float *acc) {
+#if defined(TINYKTX_DECODE_SSE2) || defined(TINYKTX_DECODE_NEON)
+	if (channels == 4) {
+		// a pixel is a vector, the weights are broadcast
+		for (uint32_t x = 0; x < count; ++x) {
+			float const *s = span + (xTaps[x].first - spanStart) * 4;
+#if defined(TINYKTX_DECODE_SSE2)
+			__m128 sum = _mm_setzero_ps();
+			for (uint32_t t = 0; t < xTaps[x].count; ++t) {
+				sum = _mm_add_ps(sum, _mm_mul_ps(_mm_loadu_ps(s + t * 4), _mm_set1_ps(xTaps[x].weights[t])));
+			}
+			_mm_storeu_ps(acc + x * 4, _mm_add_ps(_mm_loadu_ps(acc + x * 4), _mm_mul_ps(sum, _mm_set1_ps(weight))));
+#else
+			float32x4_t sum = vdupq_n_f32(0.0f);
+			for (uint32_t t = 0; t < xTaps[x].count; ++t) {
+				sum = vmlaq_n_f32(sum, vld1q_f32(s + t * 4), xTaps[x].weights[t]);
+			}
+			vst1q_f32(acc + x * 4, vmlaq_n_f32(vld1q_f32(acc + x * 4), sum, weight));
+#endif
+		}
+		return;
+	}
+#endif
+	for (uint32_t x = 0; x < count; ++x) {
+		float const *s = span + (xTaps[x].first - spanStart) * channels;
+		for (uint32_t ch = 0; ch < channels; ++ch) {
+			float sum = 0.0f;
+			for (uint32_t t = 0; t < xTaps[x].count; ++t) {
+				sum += s[t * channels + ch] * xTaps[x].weights[t];
+			}
+			acc[x * channels + ch] += sum * weight;
+		}
+	}
+}
+
+typedef struct TinyKtx_MipmapTasks {
+	TinyKtx_Format format;
+	TinyKtx_MipmapFilter filter;
+	bool color;						// 8 bit formats go through the colour pass, the rest TinyKtx_FormatToFloat
+	uint32_t channels;		// floats per pixel
+	uint32_t pixelBytes;
+	uint32_t srcWidth;
+	uint32_t srcHeight;
+	uint32_t srcDepth;
+	uint32_t width;
+	uint32_t height;
+	uint32_t depth;
+	uint32_t bands;				// tasks per depth slice
+	uint8_t const *src;
+	uint8_t *dst;
+} TinyKtx_MipmapTasks;
+
+// a task is a band of rows of one depth slice of one image, filtered a chunk of columns at a time
+// from the source rows converted to float
+static void TinyKtx_mipmapTask(void *taskData, uint32_t taskIndex) {
+	TinyKtx_MipmapTasks const *tasks = (TinyKtx_MipmapTasks const *) taskData;
+	uint32_t const band = taskIndex % tasks->bands;
+	uint32_t const z = (taskIndex / tasks->bands) % tasks->depth;
+	uint32_t const image = taskIndex / tasks->bands / tasks->depth;
+	uint32_t const y0 = band * TINYKTX_MIPMAP_BAND;
+	uint32_t const rows = tasks->height - y0 < TINYKTX_MIPMAP_BAND ? tasks->height - y0 : TINYKTX_MIPMAP_BAND;
+	uint32_t const channels = tasks->channels;
+	size_t const srcRowBytes = (size_t) tasks->srcWidth * tasks->pixelBytes;
+	size_t const dstRowBytes = (size_t) tasks->width * tasks->pixelBytes;
+	uint8_t const *srcImage = tasks->src + (size_t) image * tasks->srcDepth * tasks->srcHeight * srcRowBytes;
+	uint8_t *dst = tasks->dst + (((size_t) image * tasks->depth + z) * tasks->height + y0) * dstRowBytes;
+
+	TinyKtx_MipmapTaps zTaps;
+	TinyKtx_MipmapTaps yTaps[TINYKTX_MIPMAP_BAND];
+	TinyKtx_MipmapTaps xTaps[TINYKTX_MIPMAP_CHUNK];
+	TinyKtx_mipmapTaps(tasks->filter, tasks->srcDepth, tasks->depth, z, &zTaps);
+	for (uint32_t r = 0; r < rows; ++r) {
+		TinyKtx_mipmapTaps(tasks->filter, tasks->srcHeight, tasks->height, y0 + r, &yTaps[r]);
+	}
+
+	float span[TINYKTX_MIPMAP_SPAN * 4];
+	float acc[TINYKTX_MIPMAP_CHUNK * 4];
+	for (uint32_t x0 = 0; x0 < tasks->width; x0 += TINYKTX_MIPMAP_CHUNK) {
+		uint32_t const count = tasks->width - x0 < TINYKTX_MIPMAP_CHUNK ? tasks->width - x0 : TINYKTX_MIPMAP_CHUNK;
+		for (uint32_t x = 0; x < count; ++x) {
+			TinyKtx_mipmapTaps(tasks->filter, tasks->srcWidth, tasks->width, x0 + x, &xTaps[x]);
+		}
+		uint32_t const spanStart = xTaps[0].first;
+		uint32_t const spanCount = xTaps[count - 1].first + xTaps[count - 1].count - spanStart;
+
+		for (uint32_t r = 0; r < rows; ++r) {
+			memset(acc, 0, sizeof(float) * count * channels);
+			for (uint32_t zt = 0; zt < zTaps.count; ++zt) {
+				for (uint32_t yt = 0; yt < yTaps[r].count; ++yt) {
+					size_t const row = (size_t) (zTaps.first + zt) * tasks->srcHeight + yTaps[r].first + yt;
+					uint8_t const *src = srcImage + row * srcRowBytes + (size_t) spanStart * tasks->pixelBytes;
+					if (tasks->color) {
+						TinyKtx_DecodeColor(tasks->format, TKTX_COLOR_LINEAR, src, span, spanCount);
+					} else {
+						TinyKtx_FormatToFloat(tasks->format, src, span, spanCount);
+					}
+					TinyKtx_mipmapAccumulate(xTaps, count, span, spanStart, channels,
+																	 zTaps.weights[zt] * yTaps[r].weights[yt], acc);
+				}
+			}
+			uint8_t *out = dst + r * dstRowBytes + (size_t) x0 * tasks->pixelBytes;
+			if (tasks->color) {
+				TinyKtx_EncodeColor(tasks->format, TKTX_COLOR_LINEAR, acc, out, count);
+			} else {
+				TinyKtx_FormatFromFloat(tasks->format, acc, out, count);
+			}
+		}
+	}
+}
+
+static bool TinyKtx_mipmapFormat(TinyKtx_Format format, bool *color, uint32_t *channels, uint32_t *pixelBytes) {
+	TinyKtx_FormatTraits traits;
+	if (!TinyKtx_GetFormatTraits(format, &traits) || traits.compressed)
+		return false;
+	// zero pixel conversions just check the format
+	uint8_t const probe = 0;
+	float floats[4];
+	if (TinyKtx_DecodeColor(format, 0, &probe, floats, 0)) {
+		*color = true;
+		*channels = 4;
+	} else if (TinyKtx_FormatToFloat(format, &probe, floats, 0)) {
+		*color = false;
+		*channels = traits.channelCount;
+	} else {
+		return false;
+	}
+	*pixelBytes = traits.blockByteSize;
+	return true;
+}
+
+// level count and sizes of the chain, returns its total size or 0
+static uint64_t TinyKtx_mipmapChain(TinyKtx_Format format, uint32_t width, uint32_t height, uint32_t depth,
+																		uint32_t imageCount, uint32_t mipmaplevels, uint32_t *levels, uint64_t *sizes) {
+	// the full chain, no more than a file can hold
+	uint32_t largest = width > height ? width : height;
+	largest = largest > depth ? largest : depth;
+	uint32_t full = 1;
+	for (; largest > 1; largest >>= 1) {
+		full++;
+	}
+	full = full < TINYKTX_MAX_MIPMAPLEVELS ? full : TINYKTX_MAX_MIPMAPLEVELS;
+	*levels = mipmaplevels ? mipmaplevels : full;
+	if (*levels > full)
+		return 0;
+	if (!TinyKtx_ComputeMipmapSizes64(width, height, depth, imageCount, *levels, format, false, sizes))
+		return 0;
+	uint64_t total = 0;
+	for (uint32_t i = 0; i < *levels; ++i) {
+		if (total + sizes[i] < total)
+			return 0;
+		total += sizes[i];
+	}
+	return total;
+}
+
+uint64_t TinyKtx_MipmapChainSize(TinyKtx_Format format,
+																 uint32_t width,
+																 uint32_t height,
+																 uint32_t depth,
+																 uint32_t imageCount,
+																 uint32_t mipmaplevels) {
+	bool color;
+	uint32_t channels, pixelBytes, levels;
+	uint64_t sizes[TINYKTX_MAX_MIPMAPLEVELS];
+	if (!TinyKtx_mipmapFormat(format, &color, &channels, &pixelBytes))
+		return 0;
+	return TinyKtx_mipmapChain(format, width ? width : 1, height ? height : 1, depth ? depth : 1,
+														 imageCount ? imageCount : 1, mipmaplevels, &levels, sizes);
+}
+
+bool TinyKtx_GenerateMipmaps(TinyKtx_Format format,
+														 uint32_t width,
+														 uint32_t height,
+														 uint32_t depth,
+														 uint32_t imageCount,
+														 uint32_t mipmaplevels,
+														 TinyKtx_MipmapFilter filter,
+														 void const *level0,
+														 void *dst,
+														 size_t dstSize,
+														 TinyKtx_DecodeDispatchFunc dispatch,
+														 void *dispatchUser) {
+	TinyKtx_MipmapTasks tasks;
+	memset(&tasks, 0, sizeof(TinyKtx_MipmapTasks));
+	if (level0 == NULL || dst == NULL || (filter != TKTX_MIPMAP_FILTER_BOX && filter != TKTX_MIPMAP_FILTER_CUBIC))
+		return false;
+	if (!TinyKtx_mipmapFormat(format, &tasks.color, &tasks.channels, &tasks.pixelBytes))
+		return false;
+
+	width = width ? width : 1;
+	height = height ? height : 1;
+	depth = depth ? depth : 1;
+	imageCount = imageCount ? imageCount : 1;
+	uint32_t levels;
+	uint64_t sizes[TINYKTX_MAX_MIPMAPLEVELS];
+	uint64_t const total = TinyKtx_mipmapChain(format, width, height, depth, imageCount, mipmaplevels, &levels, sizes);
+	if (total == 0 || dstSize < total)
+		return false;
+
+	uint8_t *out = (uint8_t *) dst;
+	if (level0 != dst) {
+		memcpy(out, level0, (size_t) sizes[0]);
+	}
+	tasks.format = format;
+	tasks.filter = filter;
+	tasks.width = width;
+	tasks.height = height;
+	tasks.depth = depth;
+	// each level needs the one before it finished, so a dispatch per level
+	for (uint32_t level = 1; level < levels; ++level) {
+		tasks.srcWidth = tasks.width;
+		tasks.srcHeight = tasks.height;
+		tasks.srcDepth = tasks.depth;
+		tasks.width = tasks.width > 1 ? tasks.width >> 1 : 1;
+		tasks.height = tasks.height > 1 ? tasks.height >> 1 : 1;
+		tasks.depth = tasks.depth > 1 ? tasks.depth >> 1 : 1;
+		tasks.bands = (tasks.height + TINYKTX_MIPMAP_BAND - 1) / TINYKTX_MIPMAP_BAND;
+		tasks.src = out;
+		out += sizes[level - 1];
+		tasks.dst = out;
+
+		uint64_t const taskCount = (uint64_t) tasks.bands * tasks.depth * imageCount;
+		if (taskCount > 0xFFFFFFFFu)
+			return false;
+		if (dispatch == NULL) {
+			for (uint32_t i = 0; i < (uint32_t) taskCount; ++i) {
+				TinyKtx_mipmapTask(&tasks, i);
+			}
+		} else {
+			dispatch(dispatchUser, &TinyKtx_mipmapTask, &tasks, (uint32_t) taskCount);
+		}
+	}
+	return true;
+}
+
+typedef TinyKtx_LoadPath (*TinyKtx_LoadPathFunc)(void *handle, TinyKtx_Format format);
+
+static bool TinyKtx_isFloatFormat(TinyKtx_Format format) {
+	switch (format) {
+	case TKTX_R32_SFLOAT:
+	case TKTX_R32G32_SFLOAT:
+	case TKTX_R32G32B32_SFLOAT:
+	case TKTX_R32G32B32A32_SFLOAT:
+	case TKTX_R16G16B16A16_SFLOAT: return true;
+	default: return false;
+	}
+}
+
+static TinyKtx_LoadPath TinyKtx_loadPath(void *handle, TinyKtx_Format format) {
+	TinyKtx_Format const srcFormat = TinyKtx_GetFormat((TinyKtx_ContextHandle) handle);
+	if (format == TKTX_UNDEFINED)
+		return TKTX_LOAD_NONE;
+	if (format == srcFormat)
+		return TKTX_LOAD_NATIVE;
+	if (TinyKtx_LevelSizeAs((TinyKtx_ContextHandle) handle, 0, format) != 0)
+		return TinyKtx_isFloatFormat(format) ? TKTX_LOAD_FLOAT : TKTX_LOAD_SWIZZLE;
+	if (TinyKtx_CanDecode(srcFormat, format))
+		return TKTX_LOAD_DECODE;
+	return TKTX_LOAD_NONE;
+}
+
+static TinyKtx_LoadPath TinyKtx2_loadPath(void *handle, TinyKtx_Format format) {
+	TinyKtx_Format const srcFormat = TinyKtx2_GetFormat((TinyKtx2_ContextHandle) handle);
+	if (TinyKtx2_CanTranscode((TinyKtx2_ContextHandle) handle, format))
+		return format == srcFormat ? TKTX_LOAD_NATIVE : TKTX_LOAD_TRANSCODE;
+	if (TinyKtx2_GetUniversalFormat((TinyKtx2_ContextHandle) handle) == TKTX2_UNIVERSAL_NONE &&
+			TinyKtx_CanDecode(srcFormat, format))
+		return TKTX_LOAD_DECODE;
+	return TKTX_LOAD_NONE;
+}
+
+static bool TinyKtx_planLoad(TinyKtx_LoadPathFunc pathOf,
+														 void *handle,
+														 TinyKtx_Format srcFormat,
+														 uint32_t width,
+														 uint32_t height,
+														 uint32_t depth,
+														 uint32_t slices,
+														 bool cubemap,
+														 uint32_t levels,
+														 TinyKtx_Format const *supportedFormats,
+														 uint32_t count,
+														 TinyKtx_LoadPlan *plan) {
+	if (plan == NULL)
+		return false;
+	memset(plan, 0, sizeof(TinyKtx_LoadPlan));
+	plan->srcFormat = srcFormat;
+	if (supportedFormats == NULL || levels == 0 || levels > TINYKTX_MAX_MIPMAPLEVELS)
+		return false;
+
+	uint64_t sizes[TINYKTX_MAX_MIPMAPLEVELS];
+	for (uint32_t i = 0; i < count; ++i) {
+		TinyKtx_LoadPath const path = pathOf(handle, supportedFormats[i]);
+		if (path == TKTX_LOAD_NONE)
+			continue;
+		if (!TinyKtx_ComputeMipmapSizes64(width, height, depth, slices, levels, supportedFormats[i], cubemap, sizes))
+			continue;
+		uint64_t total = 0;
+		for (uint32_t l = 0; l < levels; ++l) {
+			total += sizes[l];
+		}
+		if (plan->path != TKTX_LOAD_NONE &&
+				(path > plan->path || (path == plan->path && total >= plan->totalSize)))
+			continue;
+		plan->path = path;
+		plan->dstFormat = supportedFormats[i];
+		plan->levels = levels;
+		memcpy(plan->levelSize, sizes, sizeof(uint64_t) * levels);
+		plan->totalSize = total;
+	}
+	return plan->path != TKTX_LOAD_NONE;
+}
+
+bool TinyKtx_PlanLoad(TinyKtx_ContextHandle handle,
+											TinyKtx_Format const *supportedFormats,
+											uint32_t count,
+											TinyKtx_LoadPlan *plan) {
+	if (handle == NULL)
+		return false;
+	return TinyKtx_planLoad(&TinyKtx_loadPath, handle, TinyKtx_GetFormat(handle),
+													TinyKtx_Width(handle), TinyKtx_Height(handle), TinyKtx_Depth(handle),
+													TinyKtx_ArraySlices(handle), TinyKtx_IsCubemap(handle), TinyKtx_NumberOfMipmaps(handle),
+													supportedFormats, count, plan);
+}
+
+bool TinyKtx2_PlanLoad(TinyKtx2_ContextHandle handle,
+											 TinyKtx_Format const *supportedFormats,
+											 uint32_t count,
+											 TinyKtx_LoadPlan *plan) {
+	if (handle == NULL)
+		return false;
+	return TinyKtx_planLoad(&TinyKtx2_loadPath, handle, TinyKtx2_GetFormat(handle),
+													TinyKtx2_Width(handle), TinyKtx2_Height(handle), TinyKtx2_Depth(handle),
+													TinyKtx2_ArraySlices(handle), TinyKtx2_IsCubemap(handle), TinyKtx2_NumberOfMipmaps(handle),
+													supportedFormats, count, plan);
+}
+
+static uint32_t TinyKtx_loadLevelSize(uint32_t size, uint32_t mipmaplevel) {
+	size >>= mipmaplevel;
+	return size ? size : 1;
+}
+
+// every layer, face and depth slice of a level
+static uint32_t TinyKtx_loadImageCount(uint32_t depth, uint32_t slices, bool cubemap, uint32_t mipmaplevel) {
+	return TinyKtx_loadLevelSize(depth, mipmaplevel) * (slices ? slices : 1) * (cubemap ? 6 : 1);
+}
+
+static bool TinyKtx_loadChecks(TinyKtx_LoadPlan const *plan, TinyKtx_Format srcFormat, uint32_t mipmaplevel, void *dst, size_t dstSize) {
+	return plan != NULL && dst != NULL && plan->path != TKTX_LOAD_NONE && plan->srcFormat == srcFormat &&
+				 mipmaplevel < plan->levels && dstSize >= plan->levelSize[mipmaplevel];
+}
+
+bool TinyKtx_ExecuteLoad(TinyKtx_ContextHandle handle,
+												 TinyKtx_LoadPlan const *plan,
+												 uint32_t mipmaplevel,
+												 void *dst,
+												 size_t dstSize,
+												 TinyKtx_DecodeDispatchFunc dispatch,
+												 void *dispatchUser) {
+	if (handle == NULL || !TinyKtx_loadChecks(plan, TinyKtx_GetFormat(handle), mipmaplevel, dst, dstSize))
+		return false;
+
+	switch (plan->path) {
+	case TKTX_LOAD_NATIVE:
+	case TKTX_LOAD_SWIZZLE:
+	case TKTX_LOAD_FLOAT: return TinyKtx_ReadLevelAs(handle, mipmaplevel, plan->dstFormat, dst, dstSize);
+	case TKTX_LOAD_DECODE: {
+		void const *src = TinyKtx_ImageRawData(handle, mipmaplevel);
+		if (src == NULL)
+			return false;
+		return TinyKtx_DecodeImages(plan->srcFormat,
+																TinyKtx_loadLevelSize(TinyKtx_Width(handle), mipmaplevel),
+																TinyKtx_loadLevelSize(TinyKtx_Height(handle), mipmaplevel),
+																TinyKtx_loadImageCount(TinyKtx_Depth(handle), TinyKtx_ArraySlices(handle),
+																											 TinyKtx_IsCubemap(handle), mipmaplevel),
+																src, (size_t) TinyKtx_ImageSize64(handle, mipmaplevel),
+																plan->dstFormat, dst, dstSize, dispatch, dispatchUser);
+	}
+	default: return false;
+	}
+}
+
+bool TinyKtx2_ExecuteLoad(TinyKtx2_ContextHandle handle,
+													TinyKtx_LoadPlan const *plan,
+													uint32_t mipmaplevel,
+													void *dst,
+													size_t dstSize,
+													TinyKtx_DecodeDispatchFunc dispatch,
+													void *dispatchUser) {
+	if (handle == NULL || !TinyKtx_loadChecks(plan, TinyKtx2_GetFormat(handle), mipmaplevel, dst, dstSize))
+		return false;
+
+	switch (plan->path) {
+	case TKTX_LOAD_NATIVE:
+	case TKTX_LOAD_TRANSCODE:
+		// the transcoder wants the level's exact size
+		return TinyKtx2_TranscodeLevel(handle, mipmaplevel, plan->dstFormat, dst, (size_t) plan->levelSize[mipmaplevel],
+																	 dispatch, dispatchUser);
+	case TKTX_LOAD_DECODE: {
+		void const *src = TinyKtx2_ImageRawData(handle, mipmaplevel);
+		if (src == NULL)
+			return false;
+		return TinyKtx_DecodeImages(plan->srcFormat,
+																TinyKtx_loadLevelSize(TinyKtx2_Width(handle), mipmaplevel),
+																TinyKtx_loadLevelSize(TinyKtx2_Height(handle), mipmaplevel),
+																TinyKtx_loadImageCount(TinyKtx2_Depth(handle), TinyKtx2_ArraySlices(handle),
+																											 TinyKtx2_IsCubemap(handle), mipmaplevel),
+																src, (size_t) TinyKtx2_ImageSize64(handle, mipmaplevel),
+																plan->dstFormat, dst, dstSize, dispatch, dispatchUser);
+	}
+	default: return false;
+	}
+}
+
+#endif // end implementation
+
+#ifdef __cplusplus
+};
+#endif
+
+#endif // end header
+/*
+MIT License
+
+Copyright (c) 2019 DeanoC
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
@@ -0,0 +1,4 @@
+#define TINYKTX2_IMPLEMENTATION
+#define TINYKTX2_HAVE_DECODE	// tinyktx_decode.c is part of the library
+#include "tiny_imageformat/tinyimageformat_base.h"
+#include "tiny_ktx/tinyktx2.h"
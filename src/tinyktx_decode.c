@@ -0,0 +1,3 @@
+#define TINYKTX_DECODE_IMPLEMENTATION
+#include "tiny_imageformat/tinyimageformat_base.h"
+#include "tiny_ktx/tinyktx_decode.h"
@@ -1,10 +1,20 @@
-#include "tiny_ktx/tinyktx.h"
+#include "tiny_ktx/tinyktx2.h"
+#include "tiny_ktx/tinyktx_decode.h"
 #include "al2o3_platform/platform.h"
 #include "al2o3_memory/memory.h"
 #include "al2o3_catch2/catch2.hpp"
 #include "al2o3_vfile/vfile.hpp"
 #include "al2o3_stb/stb_image.h"
 #include "al2o3_os/filesystem.h"
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <map>
+#include <thread>
+#include <vector>
+#ifdef TINYKTX2_HAVE_ZLIB
+#include <zlib.h>
+#endif
 
 static const char* gBasePath = "input/testimages";
 
@@ -83,7 +93,8 @@ TEST_CASE("TinyKtx Create/Destroy Context", "[TinyKtx Loader]") {
 			&tinyktxCallbackFree,
 			tinyktxCallbackRead,
 			&tinyktxCallbackSeek,
-			&tinyktxCallbackTell
+			&tinyktxCallbackTell,
+			0
 	};
 
 	VFile::ScopedFile file = VFile::File::FromFile("rgb-reference.ktx", Os_FM_ReadBinary);
@@ -105,7 +116,8 @@ TEST_CASE("TinyKtx readheader & dimensions", "[TinyKtx Loader]") {
 			&tinyktxCallbackFree,
 			tinyktxCallbackRead,
 			&tinyktxCallbackSeek,
-			&tinyktxCallbackTell
+			&tinyktxCallbackTell,
+			0
 	};
 
 	VFile::ScopedFile file = VFile::File::FromFile("rgb-reference.ktx", Os_FM_ReadBinary);
@@ -199,7 +211,8 @@ TEST_CASE("TinyKtx rgb-reference okay", "[TinyKtx Loader]") {
 			&tinyktxCallbackFree,
 			tinyktxCallbackRead,
 			&tinyktxCallbackSeek,
-			&tinyktxCallbackTell
+			&tinyktxCallbackTell,
+			0
 	};
 
 	stbi_io_callbacks stbi_callbacks{
@@ -243,7 +256,8 @@ TEST_CASE("TinyKtx luminance-reference okay", "[TinyKtx Loader]") {
 			&tinyktxCallbackFree,
 			tinyktxCallbackRead,
 			&tinyktxCallbackSeek,
-			&tinyktxCallbackTell
+			&tinyktxCallbackTell,
+			0
 	};
 
 	stbi_io_callbacks stbi_callbacks{
@@ -288,7 +302,8 @@ TEST_CASE("TinyKtx git hub #2 (image size before image raw data broken) fix test
 			&tinyktxCallbackFree,
 			tinyktxCallbackRead,
 			&tinyktxCallbackSeek,
-			&tinyktxCallbackTell
+			&tinyktxCallbackTell,
+			0
 	};
 
 	stbi_io_callbacks stbi_callbacks{
@@ -334,7 +349,8 @@ TEST_CASE("TinyKtx mipmap reference check", "[TinyKtx Loader]") {
 			&tinyktxCallbackFree,
 			tinyktxCallbackRead,
 			&tinyktxCallbackSeek,
-			&tinyktxCallbackTell
+			&tinyktxCallbackTell,
+			0
 	};
 
 	stbi_io_callbacks stbi_callbacks{
@@ -392,4 +408,2047 @@ TEST_CASE("TinyKtx mipmap reference check", "[TinyKtx Loader]") {
 	}
 
 	TinyKtx_DestroyContext(ctx);
-}
\ No newline at end of file
+}
+static void tinyktxCallbackMemWrite(void *user, void const *data, size_t size) {
+	auto buffer = (std::vector<uint8_t> *) user;
+	buffer->insert(buffer->end(), (uint8_t const *) data, (uint8_t const *) data + size);
+}
+static void tinyktxCallbackMemPWrite(void *user, uint64_t offset, void const *data, size_t size) {
+	auto buffer = (std::vector<uint8_t> *) user;
+	if (buffer->size() < offset + size) buffer->resize(offset + size, 0xCD);
+	memcpy(buffer->data() + offset, data, size);
+}
+struct tinyktxMemReader {
+	std::vector<uint8_t> const *buffer;
+	size_t pos;
+};
+static size_t tinyktxCallbackMemRead(void *user, void *data, size_t size) {
+	auto reader = (tinyktxMemReader *) user;
+	size = std::min(size, reader->buffer->size() - reader->pos);
+	memcpy(data, reader->buffer->data() + reader->pos, size);
+	reader->pos += size;
+	return size;
+}
+static bool tinyktxCallbackMemSeek(void *user, int64_t offset) {
+	auto reader = (tinyktxMemReader *) user;
+	reader->pos = (size_t) offset;
+	return offset <= (int64_t) reader->buffer->size();
+}
+static int64_t tinyktxCallbackMemTell(void *user) {
+	return (int64_t) ((tinyktxMemReader *) user)->pos;
+}
+static TinyKtx_WriteCallbacks tinyktxMemWriteCallbacks() {
+	return TinyKtx_WriteCallbacks {
+			&tinyktxCallbackError,
+			&tinyktxCallbackAlloc,
+			&tinyktxCallbackFree,
+			&tinyktxCallbackMemWrite,
+			&tinyktxCallbackMemPWrite,
+	};
+}
+static TinyKtx2_WriteCallbacks tinyktx2MemWriteCallbacks() {
+	return TinyKtx2_WriteCallbacks {
+			&tinyktxCallbackError,
+			&tinyktxCallbackAlloc,
+			&tinyktxCallbackFree,
+			&tinyktxCallbackMemWrite,
+			&tinyktxCallbackMemPWrite,
+	};
+}
+static TinyKtx_Callbacks tinyktxMemReadCallbacks(size_t maxChunkSize = 0) {
+	return TinyKtx_Callbacks {
+			&tinyktxCallbackError,
+			&tinyktxCallbackAlloc,
+			&tinyktxCallbackFree,
+			&tinyktxCallbackMemRead,
+			&tinyktxCallbackMemSeek,
+			&tinyktxCallbackMemTell,
+			maxChunkSize,
+	};
+}
+// no decompressors or transcoders, tests that need them fill them in
+static TinyKtx2_Callbacks tinyktx2MemReadCallbacks() {
+	return TinyKtx2_Callbacks {
+			&tinyktxCallbackError,
+			&tinyktxCallbackAlloc,
+			&tinyktxCallbackFree,
+			&tinyktxCallbackMemRead,
+			&tinyktxCallbackMemSeek,
+			&tinyktxCallbackMemTell,
+			0, nullptr, // super decompressors
+			0, nullptr, 0, // stream decompressors
+			nullptr, // shareGlobalData
+			0, nullptr, // transcoders
+			0, // maxChunkSize
+	};
+}
+
+TEST_CASE("TinyKtx positional writer matches serial writer", "[TinyKtx Writer]") {
+	TinyKtx_WriteCallbacks callbacks = tinyktxMemWriteCallbacks();
+
+	// 5x3 RGB8 needs row padding and the cubemap needs per face padding
+	uint8_t src[5 * 3 * 3 * 6];
+	for (uint32_t i = 0; i < sizeof(src); ++i) src[i] = (uint8_t) i;
+	uint32_t const mipmapsizes[] = { 5 * 3 * 3 * 6, 2 * 1 * 3 * 6, 1 * 1 * 3 * 6 };
+	void const *mipmaps[] = { src, src, src };
+
+	std::vector<uint8_t> serial;
+	REQUIRE(TinyKtx_WriteImage(&callbacks, &serial, 5, 3, 1, 1, 3, TKTX_R8G8B8_UNORM, true, mipmapsizes, mipmaps));
+
+	TinyKtx_WriteLayout layout;
+	REQUIRE(TinyKtx_ComputeWriteLayout(&callbacks, nullptr, 5, 3, 1, 1, 3, TKTX_R8G8B8_UNORM, true, mipmapsizes, &layout));
+	REQUIRE(layout.totalByteLength == serial.size());
+	REQUIRE(layout.levels[0].rowStride == 16);
+
+	std::vector<uint8_t> positional;
+	for (uint32_t i = 3; i-- > 0;) {
+		REQUIRE(TinyKtx_WriteLevelPositional(&callbacks, &positional, &layout, i, mipmaps[i]));
+	}
+	REQUIRE(TinyKtx_WriteHeaderPositional(&callbacks, &positional, &layout));
+	REQUIRE(positional == serial);
+	// glBaseInternalFormat is the base of glFormat
+	uint32_t baseFormat;
+	memcpy(&baseFormat, serial.data() + 32, sizeof(uint32_t));
+	REQUIRE(baseFormat == TINYKTX_GL_FORMAT_RGB);
+}
+
+TEST_CASE("TinyKtx2 positional writer matches serial writer", "[TinyKtx2 Writer]") {
+	TinyKtx2_WriteCallbacks callbacks = tinyktx2MemWriteCallbacks();
+
+	// 5x3 RGB8 cubemap, levels are aligned to the texel size
+	uint8_t src[5 * 3 * 3 * 6];
+	for (uint32_t i = 0; i < sizeof(src); ++i) src[i] = (uint8_t) (i * 3 + 1);
+	uint32_t const mipmapsizes[] = { 5 * 3 * 3 * 6, 2 * 1 * 3 * 6, 1 * 1 * 3 * 6 };
+	void const *mipmaps[] = { src, src, src };
+
+	std::vector<uint8_t> serial;
+	REQUIRE(TinyKtx2_WriteImage(&callbacks, &serial, 5, 3, 1, 1, 3, TKTX_R8G8B8_UNORM, true, mipmapsizes, mipmaps));
+
+	TinyKtx2_WriteLayout layout;
+	REQUIRE(TinyKtx2_ComputeWriteLayout(&callbacks, nullptr, 5, 3, 1, 1, 3, TKTX_R8G8B8_UNORM, true, mipmapsizes, &layout));
+	REQUIRE(layout.totalByteLength == serial.size());
+	REQUIRE(layout.levels[0].faceByteLength == 5 * 3 * 3);
+
+	// level 0 a face at a time in reverse, the rest a level at a time
+	std::vector<uint8_t> positional;
+	for (uint32_t f = 6; f-- > 0;) {
+		REQUIRE(TinyKtx2_WriteFacePositional(&callbacks, &positional, &layout, 0, 0, f, src + f * 5 * 3 * 3));
+	}
+	for (uint32_t i = 3; i-- > 1;) {
+		REQUIRE(TinyKtx2_WriteLevelPositional(&callbacks, &positional, &layout, i, mipmaps[i]));
+	}
+	REQUIRE(TinyKtx2_WriteHeaderPositional(&callbacks, &positional, &layout));
+	REQUIRE(positional == serial);
+
+	REQUIRE(!TinyKtx2_WriteFacePositional(&callbacks, &positional, &layout, 0, 1, 0, src));
+	REQUIRE(!TinyKtx2_WriteFacePositional(&callbacks, &positional, &layout, 3, 0, 0, src));
+	TinyKtx2_WriteCallbacks serialOnly = callbacks;
+	serialOnly.pwrite = nullptr;
+	REQUIRE(!TinyKtx2_WriteHeaderPositional(&serialOnly, &positional, &layout));
+}
+
+TEST_CASE("TinyKtx and TinyKtx2 write faces from separate buffers", "[TinyKtx Writer]") {
+	TinyKtx_WriteCallbacks callbacks = tinyktxMemWriteCallbacks();
+	TinyKtx2_WriteCallbacks callbacks2 = tinyktx2MemWriteCallbacks();
+
+	// a 2 slice 5x3 RGB8 cubemap array with 2 levels, every slice/face its own buffer
+	uint32_t const faceSizes[] = { 5 * 3 * 3, 2 * 1 * 3 };
+	std::vector<std::vector<uint8_t>> buffers;
+	std::vector<void const *> faces;
+	std::vector<uint8_t> levels[2];
+	for (uint32_t l = 0; l < 2; ++l) {
+		for (uint32_t i = 0; i < 2 * 6; ++i) {
+			std::vector<uint8_t> face(faceSizes[l]);
+			for (size_t j = 0; j < face.size(); ++j) face[j] = (uint8_t) (l * 97 + i * 13 + j);
+			levels[l].insert(levels[l].end(), face.begin(), face.end());
+			buffers.push_back(face);
+		}
+	}
+	for (auto const &face : buffers) faces.push_back(face.data());
+	void const *mipmaps[] = { levels[0].data(), levels[1].data() };
+
+	// the same bytes as writing whole levels
+	std::vector<uint8_t> ktx;
+	REQUIRE(TinyKtx_WriteImageFaces(&callbacks, &ktx, 5, 3, 1, 2, 2, TKTX_R8G8B8_UNORM, true, nullptr, faces.data()));
+	std::vector<uint8_t> expected;
+	REQUIRE(TinyKtx_WriteImage(&callbacks, &expected, 5, 3, 1, 2, 2, TKTX_R8G8B8_UNORM, true, nullptr, mipmaps));
+	REQUIRE(ktx == expected);
+	uint32_t glformat, gltype, glinternalformat, gltypesize;
+	REQUIRE(TinyKtx_CrackFormatToGL(TKTX_R8G8B8_UNORM, &glformat, &gltype, &glinternalformat, &gltypesize));
+	std::vector<uint8_t> ktxGL;
+	REQUIRE(TinyKtx_WriteImageFacesGL(&callbacks, &ktxGL, 5, 3, 1, 2, 2, glformat, glinternalformat, TINYKTX_GL_FORMAT_RGB,
+																		gltype, gltypesize, true, nullptr, faces.data()));
+	REQUIRE(ktxGL == ktx);
+
+	// each face reads back from the padded file
+	TinyKtx_Callbacks readCallbacks = tinyktxMemReadCallbacks();
+	tinyktxMemReader reader { &ktx, 0 };
+	auto ctx = TinyKtx_CreateContext(&readCallbacks, &reader);
+	REQUIRE(TinyKtx_ReadHeader(ctx));
+	REQUIRE(TinyKtx_IsCubemap(ctx));
+	REQUIRE(TinyKtx_ArraySlices(ctx) == 2);
+	for (uint32_t l = 0; l < 2; ++l) {
+		std::vector<uint8_t> level(TinyKtx_LevelSizeAs(ctx, l, TKTX_R8G8B8_UNORM));
+		REQUIRE(level.size() == faceSizes[l] * 2 * 6);
+		REQUIRE(TinyKtx_ReadLevelAs(ctx, l, TKTX_R8G8B8_UNORM, level.data(), level.size()));
+		for (uint32_t i = 0; i < 2 * 6; ++i) {
+			REQUIRE(memcmp(level.data() + i * faceSizes[l], faces[l * 2 * 6 + i], faceSizes[l]) == 0);
+		}
+	}
+	TinyKtx_DestroyContext(ctx);
+
+	std::vector<uint8_t> ktx2;
+	REQUIRE(TinyKtx2_WriteImageFaces(&callbacks2, &ktx2, 5, 3, 1, 2, 2, TKTX_R8G8B8_UNORM, true, nullptr, faces.data()));
+	std::vector<uint8_t> expected2;
+	REQUIRE(TinyKtx2_WriteImage(&callbacks2, &expected2, 5, 3, 1, 2, 2, TKTX_R8G8B8_UNORM, true, nullptr, mipmaps));
+	REQUIRE(ktx2 == expected2);
+	TinyKtx2_Callbacks readCallbacks2 = tinyktx2MemReadCallbacks();
+	tinyktxMemReader reader2 { &ktx2, 0 };
+	auto ctx2 = TinyKtx2_CreateContext(&readCallbacks2, &reader2);
+	REQUIRE(TinyKtx2_ReadHeader(ctx2));
+	for (uint32_t l = 0; l < 2; ++l) {
+		REQUIRE(TinyKtx2_ImageSize64(ctx2, l) == faceSizes[l] * 2 * 6);
+		auto level = (uint8_t const *) TinyKtx2_ImageRawData(ctx2, l);
+		REQUIRE(level != nullptr);
+		for (uint32_t i = 0; i < 2 * 6; ++i) {
+			REQUIRE(memcmp(level + i * faceSizes[l], faces[l * 2 * 6 + i], faceSizes[l]) == 0);
+		}
+	}
+	TinyKtx2_DestroyContext(ctx2);
+
+	// a missing face is an error before anything is written
+	faces[7] = nullptr;
+	ktx.clear();
+	REQUIRE(!TinyKtx_WriteImageFaces(&callbacks, &ktx, 5, 3, 1, 2, 2, TKTX_R8G8B8_UNORM, true, nullptr, faces.data()));
+	REQUIRE(ktx.empty());
+	ktx2.clear();
+	REQUIRE(!TinyKtx2_WriteImageFaces(&callbacks2, &ktx2, 5, 3, 1, 2, 2, TKTX_R8G8B8_UNORM, true, nullptr, faces.data()));
+	REQUIRE(ktx2.empty());
+}
+
+TEST_CASE("TinyKtx and TinyKtx2 update levels and faces in place", "[TinyKtx Writer]") {
+	TinyKtx_WriteCallbacks callbacks = tinyktxMemWriteCallbacks();
+	TinyKtx2_WriteCallbacks callbacks2 = tinyktx2MemWriteCallbacks();
+	TinyKtx_Callbacks readCallbacks = tinyktxMemReadCallbacks();
+	TinyKtx2_Callbacks readCallbacks2 = tinyktx2MemReadCallbacks();
+
+	// a 2 slice 5x3 RGB8 cubemap array, KTX v1 pads its rows. Both files start 16 bytes into the
+	// stream so the updates have to land relative to where the reader found the header
+	uint32_t const faceSize = 5 * 3 * 3;
+	uint32_t mipmapsizes[2];
+	REQUIRE(TinyKtx_ComputeMipmapSizes(5, 3, 1, 2, 2, TKTX_R8G8B8_UNORM, true, mipmapsizes));
+	std::vector<uint8_t> src(mipmapsizes[0] + mipmapsizes[1]);
+	for (size_t i = 0; i < src.size(); ++i) src[i] = (uint8_t) (i * 11 + 3);
+	void const *mipmaps[] = { src.data(), src.data() + mipmapsizes[0] };
+	std::vector<uint8_t> level1(mipmapsizes[1]);
+	for (size_t i = 0; i < level1.size(); ++i) level1[i] = (uint8_t) (0xA0 + i);
+	std::vector<uint8_t> face(faceSize, 0x77);
+
+	std::vector<uint8_t> ktx;
+	REQUIRE(TinyKtx_WriteImage(&callbacks, &ktx, 5, 3, 1, 2, 2, TKTX_R8G8B8_UNORM, true, nullptr, mipmaps));
+	ktx.insert(ktx.begin(), 16, 0xEE);
+	tinyktxMemReader reader { &ktx, 16 };
+	auto ctx = TinyKtx_CreateContext(&readCallbacks, &reader);
+	REQUIRE(TinyKtx_ReadHeader(ctx));
+	REQUIRE(TinyKtx_ImageRawData(ctx, 1));
+	REQUIRE(TinyKtx_UpdateLevel(ctx, &callbacks, &ktx, 1, level1.data(), (uint32_t) level1.size()));
+	REQUIRE(TinyKtx_UpdateFace(ctx, &callbacks, &ktx, 0, 1, 3, face.data(), faceSize));
+	std::vector<uint8_t> read(mipmapsizes[0]);
+	REQUIRE(TinyKtx_ReadLevelAs(ctx, 1, TKTX_R8G8B8_UNORM, read.data(), mipmapsizes[1]));
+	REQUIRE(memcmp(read.data(), level1.data(), mipmapsizes[1]) == 0);
+	REQUIRE(TinyKtx_ReadLevelAs(ctx, 0, TKTX_R8G8B8_UNORM, read.data(), read.size()));
+	for (uint32_t i = 0; i < 2 * 6; ++i) {
+		void const *expected = (i == 1 * 6 + 3) ? face.data() : src.data() + i * faceSize;
+		REQUIRE(memcmp(read.data() + i * faceSize, expected, faceSize) == 0);
+	}
+	REQUIRE(std::all_of(ktx.begin(), ktx.begin() + 16, [](uint8_t b) { return b == 0xEE; }));
+
+	// nothing is written when the update doesn't fit
+	std::vector<uint8_t> const before = ktx;
+	REQUIRE(!TinyKtx_UpdateLevel(ctx, &callbacks, &ktx, 1, level1.data(), (uint32_t) level1.size() - 1));
+	REQUIRE(!TinyKtx_UpdateFace(ctx, &callbacks, &ktx, 0, 2, 0, face.data(), faceSize));
+	REQUIRE(!TinyKtx_UpdateFace(ctx, &callbacks, &ktx, 0, 0, 0, face.data(), faceSize - 1));
+	REQUIRE(!TinyKtx_UpdateLevel(ctx, &callbacks, &ktx, 2, level1.data(), (uint32_t) level1.size()));
+	TinyKtx_WriteCallbacks serialOnly = callbacks;
+	serialOnly.pwriteFn = nullptr;
+	REQUIRE(!TinyKtx_UpdateLevel(ctx, &serialOnly, &ktx, 1, level1.data(), (uint32_t) level1.size()));
+	REQUIRE(ktx == before);
+	TinyKtx_DestroyContext(ctx);
+
+	std::vector<uint8_t> ktx2;
+	REQUIRE(TinyKtx2_WriteImage(&callbacks2, &ktx2, 5, 3, 1, 2, 2, TKTX_R8G8B8_UNORM, true, nullptr, mipmaps));
+	ktx2.insert(ktx2.begin(), 16, 0xEE);
+	tinyktxMemReader reader2 { &ktx2, 16 };
+	auto ctx2 = TinyKtx2_CreateContext(&readCallbacks2, &reader2);
+	REQUIRE(TinyKtx2_ReadHeader(ctx2));
+	REQUIRE(TinyKtx2_ImageRawData(ctx2, 1));
+	REQUIRE(TinyKtx2_UpdateLevel(ctx2, &callbacks2, &ktx2, 1, level1.data(), level1.size(), level1.size()));
+	REQUIRE(TinyKtx2_UpdateFace(ctx2, &callbacks2, &ktx2, 0, 1, 3, face.data(), faceSize));
+	REQUIRE(memcmp(TinyKtx2_ImageRawData(ctx2, 1), level1.data(), level1.size()) == 0);
+	auto level0 = (uint8_t const *) TinyKtx2_ImageRawData(ctx2, 0);
+	for (uint32_t i = 0; i < 2 * 6; ++i) {
+		void const *expected = (i == 1 * 6 + 3) ? face.data() : src.data() + i * faceSize;
+		REQUIRE(memcmp(level0 + i * faceSize, expected, faceSize) == 0);
+	}
+	REQUIRE(std::all_of(ktx2.begin(), ktx2.begin() + 16, [](uint8_t b) { return b == 0xEE; }));
+
+	std::vector<uint8_t> const before2 = ktx2;
+	REQUIRE(!TinyKtx2_UpdateLevel(ctx2, &callbacks2, &ktx2, 1, level1.data(), level1.size() + 1, level1.size() + 1));
+	REQUIRE(!TinyKtx2_UpdateLevel(ctx2, &callbacks2, &ktx2, 1, level1.data(), level1.size(), level1.size() + 1));
+	REQUIRE(!TinyKtx2_UpdateFace(ctx2, &callbacks2, &ktx2, 0, 0, 6, face.data(), faceSize));
+	REQUIRE(!TinyKtx2_UpdateFace(ctx2, &callbacks2, &ktx2, 0, 0, 0, face.data(), faceSize + 1));
+	TinyKtx2_WriteCallbacks serialOnly2 = callbacks2;
+	serialOnly2.pwrite = nullptr;
+	REQUIRE(!TinyKtx2_UpdateLevel(ctx2, &serialOnly2, &ktx2, 1, level1.data(), level1.size(), level1.size()));
+	REQUIRE(!TinyKtx2_UpdateFace(ctx2, &serialOnly2, &ktx2, 0, 0, 0, face.data(), faceSize));
+	REQUIRE(ktx2 == before2);
+	TinyKtx2_DestroyContext(ctx2);
+}
+
+// stand in supercompression, xor with a trailing byte so the sizes differ
+static bool tinyktxTestCompress(void *user, void const *src, size_t srcSize, void **dst, size_t *dstSize) {
+	*dstSize = srcSize + 1;
+	*dst = MEMORY_MALLOC(*dstSize);
+	for (size_t i = 0; i < srcSize; ++i) ((uint8_t *) *dst)[i] = ((uint8_t const *) src)[i] ^ 0x5A;
+	((uint8_t *) *dst)[srcSize] = 0x5A;
+	return true;
+}
+// stand in supercompression with any number of trailing bytes
+static bool tinyktxTestCompressTrailer(uint8_t const *src, size_t srcSize, size_t trailer, std::vector<uint8_t> &dst) {
+	dst.resize(srcSize + trailer, 0x5A);
+	for (size_t i = 0; i < srcSize; ++i) dst[i] = src[i] ^ 0x5A;
+	return true;
+}
+static bool tinyktxTestDecompressTrailer(void *user, void *const sgdData, void const *src, size_t srcSize, void *dst, size_t dstSize) {
+	if (srcSize <= dstSize) return false;
+	for (size_t i = 0; i < dstSize; ++i) ((uint8_t *) dst)[i] = ((uint8_t const *) src)[i] ^ 0x5A;
+	return true;
+}
+
+TEST_CASE("TinyKtx2 rewrites a supercompressed level of a different size", "[TinyKtx2 Writer]") {
+	TinyKtx_WriteCallbacks callbacks = tinyktxMemWriteCallbacks();
+	TinyKtx2_WriteCallbacks callbacks2 = tinyktx2MemWriteCallbacks();
+	TinyKtx_Callbacks readCallbacks = tinyktxMemReadCallbacks();
+	TinyKtx2_SuperDecompressTableEntry decompressors[] = {
+			{ TKTX2_SUPERCOMPRESSION_ZSTD, &tinyktxTestDecompressTrailer }
+	};
+	TinyKtx2_Callbacks readCallbacks2 = tinyktx2MemReadCallbacks();
+	readCallbacks2.numSuperDecompressors = 1;
+	readCallbacks2.superDecompressors = decompressors;
+
+	uint32_t mipmapsizes[3];
+	REQUIRE(TinyKtx_ComputeMipmapSizes(8, 8, 1, 1, 3, TKTX_R8G8B8A8_UNORM, false, mipmapsizes));
+	std::vector<uint8_t> src(mipmapsizes[0]);
+	for (size_t i = 0; i < src.size(); ++i) src[i] = (uint8_t) (i * 5);
+	void const *mipmaps[] = { src.data(), src.data() + 4, src.data() + 8 };
+	std::vector<uint8_t> ktx1;
+	REQUIRE(TinyKtx_WriteImage(&callbacks, &ktx1, 8, 8, 1, 1, 3, TKTX_R8G8B8A8_UNORM, false, nullptr, mipmaps));
+	tinyktxMemReader reader { &ktx1, 0 };
+	auto ctx = TinyKtx_CreateContext(&readCallbacks, &reader);
+	REQUIRE(TinyKtx_ReadHeader(ctx));
+	std::vector<uint8_t> ktx2;
+	REQUIRE(TinyKtx2_ConvertFromKtx1(ctx, &callbacks2, &ktx2, TKTX2_SUPERCOMPRESSION_ZSTD, &tinyktxTestCompress));
+	TinyKtx_DestroyContext(ctx);
+
+	// the source starts 16 bytes into its stream, the rewrite is a whole new file
+	ktx2.insert(ktx2.begin(), 16, 0xEE);
+	tinyktxMemReader reader2 { &ktx2, 16 };
+	auto ctx2 = TinyKtx2_CreateContext(&readCallbacks2, &reader2);
+	REQUIRE(TinyKtx2_ReadHeader(ctx2));
+	std::vector<uint8_t> level1(mipmapsizes[1]);
+	for (size_t i = 0; i < level1.size(); ++i) level1[i] = (uint8_t) (0xC0 + i);
+	std::vector<uint8_t> packed;
+	tinyktxTestCompressTrailer(level1.data(), level1.size(), 7, packed);
+
+	TinyKtx2_WriteCallbacks positionalOnly = callbacks2;
+	positionalOnly.write = nullptr;
+	std::vector<uint8_t> rewritten;
+	REQUIRE(!TinyKtx2_UpdateLevel(ctx2, &positionalOnly, &rewritten, 1, packed.data(), packed.size(), level1.size()));
+	REQUIRE(!TinyKtx2_UpdateFace(ctx2, &callbacks2, &ktx2, 1, 0, 0, packed.data(), packed.size()));
+	REQUIRE(TinyKtx2_UpdateLevel(ctx2, &callbacks2, &rewritten, 1, packed.data(), packed.size(), level1.size()));
+	TinyKtx2_DestroyContext(ctx2);
+
+	tinyktxMemReader reader3 { &rewritten, 0 };
+	auto ctx3 = TinyKtx2_CreateContext(&readCallbacks2, &reader3);
+	REQUIRE(TinyKtx2_ReadHeader(ctx3));
+	REQUIRE(TinyKtx2_NumberOfMipmaps(ctx3) == 3);
+	uint64_t byteOffset[3], byteLength[3], uncompressedByteLength[3];
+	for (uint32_t i = 0; i < 3; ++i) {
+		REQUIRE(TinyKtx2_LevelIndex(ctx3, i, &byteOffset[i], &byteLength[i], &uncompressedByteLength[i]));
+		REQUIRE(uncompressedByteLength[i] == mipmapsizes[i]);
+	}
+	// smallest level first, packed back to back to the end of the file
+	REQUIRE(byteLength[1] == packed.size());
+	REQUIRE(byteLength[0] == mipmapsizes[0] + 1);
+	REQUIRE(byteOffset[1] == byteOffset[2] + byteLength[2]);
+	REQUIRE(byteOffset[0] == byteOffset[1] + byteLength[1]);
+	REQUIRE(byteOffset[0] + byteLength[0] == rewritten.size());
+	REQUIRE(memcmp(TinyKtx2_ImageRawData(ctx3, 0), mipmaps[0], mipmapsizes[0]) == 0);
+	REQUIRE(memcmp(TinyKtx2_ImageRawData(ctx3, 1), level1.data(), level1.size()) == 0);
+	REQUIRE(memcmp(TinyKtx2_ImageRawData(ctx3, 2), mipmaps[2], mipmapsizes[2]) == 0);
+
+	// the same compressed size goes in place, the uncompressed size in the index is patched too
+	std::vector<uint8_t> level2(mipmapsizes[2], 0x42);
+	tinyktxTestCompressTrailer(level2.data(), level2.size(), 1, packed);
+	REQUIRE(TinyKtx2_UpdateLevel(ctx3, &callbacks2, &rewritten, 2, packed.data(), packed.size(), level2.size()));
+	REQUIRE(memcmp(TinyKtx2_ImageRawData(ctx3, 2), level2.data(), level2.size()) == 0);
+	TinyKtx2_DestroyContext(ctx3);
+}
+
+TEST_CASE("TinyKtx2 convert from KTX v1 matches writing KTX v2", "[TinyKtx2 Convert]") {
+	TinyKtx_WriteCallbacks callbacks = tinyktxMemWriteCallbacks();
+	TinyKtx2_WriteCallbacks callbacks2 = tinyktx2MemWriteCallbacks();
+
+	// KTX v1 pads the rows and cube faces, KTX v2 doesn't
+	uint8_t src[5 * 3 * 3 * 6];
+	for (uint32_t i = 0; i < sizeof(src); ++i) src[i] = (uint8_t) i;
+	uint32_t const mipmapsizes[] = { 5 * 3 * 3 * 6, 2 * 1 * 3 * 6, 1 * 1 * 3 * 6 };
+	void const *mipmaps[] = { src, src, src };
+
+	std::vector<uint8_t> ktx1;
+	REQUIRE(TinyKtx_WriteImage(&callbacks, &ktx1, 5, 3, 1, 1, 3, TKTX_R8G8B8_UNORM, true, mipmapsizes, mipmaps));
+	std::vector<uint8_t> ktx2;
+	REQUIRE(TinyKtx2_WriteImage(&callbacks2, &ktx2, 5, 3, 1, 1, 3, TKTX_R8G8B8_UNORM, true, mipmapsizes, mipmaps));
+
+	TinyKtx_Callbacks readCallbacks = tinyktxMemReadCallbacks();
+	tinyktxMemReader reader { &ktx1, 0 };
+	auto ctx = TinyKtx_CreateContext(&readCallbacks, &reader);
+	REQUIRE(TinyKtx_ReadHeader(ctx));
+
+	std::vector<uint8_t> converted;
+	REQUIRE(TinyKtx2_ConvertFromKtx1(ctx, &callbacks2, &converted, TKTX2_SUPERCOMPRESSION_NONE, nullptr));
+	REQUIRE(converted == ktx2);
+
+	TinyKtx_DestroyContext(ctx);
+}
+
+TEST_CASE("TinyKtx writer computes and validates mipmap sizes", "[TinyKtx Writer]") {
+	TinyKtx_WriteCallbacks callbacks = tinyktxMemWriteCallbacks();
+
+	uint32_t mipmapsizes[3];
+	REQUIRE(TinyKtx_ComputeMipmapSizes(13, 9, 1, 4, 3, TKTX_BC7_UNORM_BLOCK, false, mipmapsizes));
+	REQUIRE(mipmapsizes[0] == 4 * 3 * 16 * 4);
+	REQUIRE(mipmapsizes[1] == 2 * 1 * 16 * 4);
+	REQUIRE(mipmapsizes[2] == 1 * 1 * 16 * 4);
+
+	std::vector<uint8_t> src(mipmapsizes[0]);
+	void const *mipmaps[] = { src.data(), src.data(), src.data() };
+
+	std::vector<uint8_t> given;
+	REQUIRE(TinyKtx_WriteImage(&callbacks, &given, 13, 9, 1, 4, 3, TKTX_BC7_UNORM_BLOCK, false, mipmapsizes, mipmaps));
+	std::vector<uint8_t> computed;
+	REQUIRE(TinyKtx_WriteImage(&callbacks, &computed, 13, 9, 1, 4, 3, TKTX_BC7_UNORM_BLOCK, false, nullptr, mipmaps));
+	REQUIRE(given == computed);
+
+	TinyKtx_WriteLayout layout;
+	REQUIRE(TinyKtx_ComputeWriteLayout(&callbacks, nullptr, 13, 9, 1, 4, 3, TKTX_BC7_UNORM_BLOCK, false, nullptr, &layout));
+	REQUIRE(layout.totalByteLength == computed.size());
+
+	// bad sizes or missing data are caught before anything is written
+	std::vector<uint8_t> failed;
+	mipmapsizes[1] += 16;
+	REQUIRE(!TinyKtx_WriteImage(&callbacks, &failed, 13, 9, 1, 4, 3, TKTX_BC7_UNORM_BLOCK, false, mipmapsizes, mipmaps));
+	mipmaps[2] = nullptr;
+	REQUIRE(!TinyKtx_WriteImage(&callbacks, &failed, 13, 9, 1, 4, 3, TKTX_BC7_UNORM_BLOCK, false, nullptr, mipmaps));
+	REQUIRE(failed.empty());
+}
+
+TEST_CASE("TinyKtx2 reads back what the writer wrote", "[TinyKtx2 Loader]") {
+	TinyKtx2_WriteCallbacks callbacks = tinyktx2MemWriteCallbacks();
+
+	uint32_t mipmapsizes[3];
+	REQUIRE(TinyKtx_ComputeMipmapSizes(13, 9, 1, 4, 3, TKTX_BC7_UNORM_BLOCK, false, mipmapsizes));
+	std::vector<uint8_t> src(mipmapsizes[0]);
+	for (size_t i = 0; i < src.size(); ++i) src[i] = (uint8_t) (i * 7);
+	void const *mipmaps[] = { src.data(), src.data() + 16, src.data() + 32 };
+
+	std::vector<uint8_t> file;
+	REQUIRE(TinyKtx2_WriteImage(&callbacks, &file, 13, 9, 1, 4, 3, TKTX_BC7_UNORM_BLOCK, false, nullptr, mipmaps));
+
+	TinyKtx2_Callbacks readCallbacks = tinyktx2MemReadCallbacks();
+	tinyktxMemReader reader { &file, 0 };
+	auto ctx = TinyKtx2_CreateContext(&readCallbacks, &reader);
+	REQUIRE(TinyKtx2_ReadHeader(ctx));
+	REQUIRE(TinyKtx2_GetFormat(ctx) == TKTX_BC7_UNORM_BLOCK);
+	REQUIRE(TinyKtx2_Width(ctx) == 13);
+	REQUIRE(TinyKtx2_Height(ctx) == 9);
+	REQUIRE(TinyKtx2_ArraySlices(ctx) == 4);
+	REQUIRE(TinyKtx2_NumberOfMipmaps(ctx) == 3);
+
+	uint32_t dfdByteLength = 0;
+	auto dfd = (uint32_t const *) TinyKtx2_DataFormatDescriptor(ctx, &dfdByteLength);
+	REQUIRE(dfd);
+	REQUIRE(dfd[0] == dfdByteLength);
+
+	// read the smallest level first, levels are independent
+	for (uint32_t i = 3; i-- > 0;) {
+		uint64_t byteOffset, byteLength, uncompressedByteLength;
+		REQUIRE(TinyKtx2_LevelIndex(ctx, i, &byteOffset, &byteLength, &uncompressedByteLength));
+		REQUIRE(byteLength == mipmapsizes[i]);
+		REQUIRE(TinyKtx2_ImageSize(ctx, i) == mipmapsizes[i]);
+		REQUIRE(memcmp(TinyKtx2_ImageRawData(ctx, i), mipmaps[i], mipmapsizes[i]) == 0);
+	}
+	TinyKtx2_DestroyContext(ctx);
+
+	// a level index that doesn't match the format is rejected
+	uint64_t levelOneLength;
+	memcpy(&levelOneLength, file.data() + 80 + 24 + 8, sizeof(uint64_t));
+	levelOneLength += 16;
+	memcpy(file.data() + 80 + 24 + 8, &levelOneLength, sizeof(uint64_t));
+	memcpy(file.data() + 80 + 24 + 16, &levelOneLength, sizeof(uint64_t));
+	reader.pos = 0;
+	ctx = TinyKtx2_CreateContext(&readCallbacks, &reader);
+	REQUIRE(!TinyKtx2_ReadHeader(ctx));
+	TinyKtx2_DestroyContext(ctx);
+
+	// a seek past the end of a truncated file fails instead of reading from the wrong place
+	levelOneLength -= 16;
+	memcpy(file.data() + 80 + 24 + 8, &levelOneLength, sizeof(uint64_t));
+	memcpy(file.data() + 80 + 24 + 16, &levelOneLength, sizeof(uint64_t));
+	uint64_t levelZeroOffset;
+	memcpy(&levelZeroOffset, file.data() + 80, sizeof(uint64_t));
+	file.resize((size_t) levelZeroOffset - 1);
+	reader.pos = 0;
+	ctx = TinyKtx2_CreateContext(&readCallbacks, &reader);
+	REQUIRE(TinyKtx2_ReadHeader(ctx));
+	REQUIRE(TinyKtx2_ImageRawData(ctx, 0) == nullptr);
+	REQUIRE(memcmp(TinyKtx2_ImageRawData(ctx, 2), mipmaps[2], mipmapsizes[2]) == 0);
+	TinyKtx2_DestroyContext(ctx);
+}
+
+static bool tinyktxTestDecompress(void *user, void *const sgdData, void const *src, size_t srcSize, void *dst, size_t dstSize) {
+	if (srcSize != dstSize + 1) return false;
+	for (size_t i = 0; i < dstSize; ++i) ((uint8_t *) dst)[i] = ((uint8_t const *) src)[i] ^ 0x5A;
+	return true;
+}
+static void tinyktxTestDispatch(void *user, TinyKtx2_TaskFunc task, void *taskData, uint32_t taskCount) {
+	std::atomic<uint32_t> next{0};
+	std::vector<std::thread> threads;
+	for (int i = 0; i < 3; ++i) {
+		threads.emplace_back([&]() {
+			for (uint32_t j = next++; j < taskCount; j = next++) task(taskData, j);
+		});
+	}
+	for (auto &t : threads) t.join();
+	*(uint32_t *) user += taskCount;
+}
+
+TEST_CASE("TinyKtx2 decodes supercompressed levels in parallel", "[TinyKtx2 Loader]") {
+	TinyKtx_WriteCallbacks callbacks = tinyktxMemWriteCallbacks();
+	TinyKtx2_WriteCallbacks callbacks2 = tinyktx2MemWriteCallbacks();
+
+	uint32_t mipmapsizes[6];
+	REQUIRE(TinyKtx_ComputeMipmapSizes(32, 32, 1, 1, 6, TKTX_R8G8B8A8_UNORM, false, mipmapsizes));
+	std::vector<uint8_t> src(mipmapsizes[0]);
+	for (size_t i = 0; i < src.size(); ++i) src[i] = (uint8_t) (i * 3);
+	void const *mipmaps[6];
+	for (int i = 0; i < 6; ++i) mipmaps[i] = src.data() + i * 4;
+
+	// only the converter writes supercompressed files
+	std::vector<uint8_t> ktx1;
+	REQUIRE(TinyKtx_WriteImage(&callbacks, &ktx1, 32, 32, 1, 1, 6, TKTX_R8G8B8A8_UNORM, false, nullptr, mipmaps));
+	TinyKtx_Callbacks readCallbacks = tinyktxMemReadCallbacks();
+	tinyktxMemReader reader { &ktx1, 0 };
+	auto ctx = TinyKtx_CreateContext(&readCallbacks, &reader);
+	REQUIRE(TinyKtx_ReadHeader(ctx));
+	std::vector<uint8_t> ktx2;
+	REQUIRE(TinyKtx2_ConvertFromKtx1(ctx, &callbacks2, &ktx2, TKTX2_SUPERCOMPRESSION_ZSTD, &tinyktxTestCompress));
+	TinyKtx_DestroyContext(ctx);
+
+	TinyKtx2_SuperDecompressTableEntry decompressors[] = {
+			{ TKTX2_SUPERCOMPRESSION_ZSTD, &tinyktxTestDecompress }
+	};
+	TinyKtx2_Callbacks readCallbacks2 = tinyktx2MemReadCallbacks();
+	readCallbacks2.numSuperDecompressors = 1;
+	readCallbacks2.superDecompressors = decompressors;
+	tinyktxMemReader reader2 { &ktx2, 0 };
+	auto ctx2 = TinyKtx2_CreateContext(&readCallbacks2, &reader2);
+	REQUIRE(TinyKtx2_ReadHeader(ctx2));
+
+	// level 1 decoded on its own first isn't decoded again
+	REQUIRE(TinyKtx2_ImageRawData(ctx2, 1));
+	uint32_t dispatched = 0;
+	REQUIRE(TinyKtx2_DecodeLevels(ctx2, 0x3F, &tinyktxTestDispatch, &dispatched));
+	REQUIRE(dispatched == 5);
+	for (uint32_t i = 0; i < 6; ++i) {
+		REQUIRE(memcmp(TinyKtx2_ImageRawData(ctx2, i), mipmaps[i], mipmapsizes[i]) == 0);
+	}
+	TinyKtx2_DestroyContext(ctx2);
+}
+
+#ifdef TINYKTX2_HAVE_ZLIB
+
+static bool tinyktxTestZlibCompress(void *user, void const *src, size_t srcSize, void **dst, size_t *dstSize) {
+	uLongf size = compressBound((uLong) srcSize);
+	*dst = MEMORY_MALLOC(size);
+	if (compress((Bytef *) *dst, &size, (Bytef const *) src, (uLong) srcSize) != Z_OK) return false;
+	*dstSize = size;
+	return true;
+}
+
+TEST_CASE("TinyKtx2 built in zlib decoder", "[TinyKtx2 Loader]") {
+	TinyKtx_WriteCallbacks callbacks = tinyktxMemWriteCallbacks();
+	TinyKtx2_WriteCallbacks callbacks2 = tinyktx2MemWriteCallbacks();
+
+	uint32_t mipmapsizes[4];
+	REQUIRE(TinyKtx_ComputeMipmapSizes(16, 16, 1, 1, 4, TKTX_R8G8B8A8_UNORM, false, mipmapsizes));
+	std::vector<uint8_t> src(mipmapsizes[0]);
+	for (size_t i = 0; i < src.size(); ++i) src[i] = (uint8_t) (i / 5);
+	void const *mipmaps[] = { src.data(), src.data(), src.data(), src.data() };
+
+	std::vector<uint8_t> ktx1;
+	REQUIRE(TinyKtx_WriteImage(&callbacks, &ktx1, 16, 16, 1, 1, 4, TKTX_R8G8B8A8_UNORM, false, nullptr, mipmaps));
+	TinyKtx_Callbacks readCallbacks = tinyktxMemReadCallbacks();
+	tinyktxMemReader reader { &ktx1, 0 };
+	auto ctx = TinyKtx_CreateContext(&readCallbacks, &reader);
+	REQUIRE(TinyKtx_ReadHeader(ctx));
+	std::vector<uint8_t> ktx2;
+	REQUIRE(TinyKtx2_ConvertFromKtx1(ctx, &callbacks2, &ktx2, TKTX2_SUPERCOMPRESSION_ZLIB, &tinyktxTestZlibCompress));
+	TinyKtx_DestroyContext(ctx);
+
+	TinyKtx2_Callbacks readCallbacks2 = tinyktx2MemReadCallbacks();
+	tinyktxMemReader reader2 { &ktx2, 0 };
+	auto ctx2 = TinyKtx2_CreateContext(&readCallbacks2, &reader2);
+	// twice to reuse the decoders after a reset
+	for (int pass = 0; pass < 2; ++pass) {
+		reader2.pos = 0;
+		TinyKtx2_Reset(ctx2);
+		REQUIRE(TinyKtx2_ReadHeader(ctx2));
+		REQUIRE(TinyKtx2_GetSuperCompressionScheme(ctx2) == TKTX2_SUPERCOMPRESSION_ZLIB);
+		REQUIRE(TinyKtx2_DecodeLevels(ctx2, 0xF, nullptr, nullptr));
+		for (uint32_t i = 0; i < 4; ++i) {
+			REQUIRE(memcmp(TinyKtx2_ImageRawData(ctx2, i), mipmaps[i], mipmapsizes[i]) == 0);
+		}
+	}
+	TinyKtx2_DestroyContext(ctx2);
+}
+
+#endif
+
+struct tinyktxTestStream {
+	uint8_t *dst;
+	size_t size;
+	size_t pos;
+	bool trailer;
+};
+static uint32_t tinyktxTestStreamCount = 0;
+static void *tinyktxTestStreamInit(void *user, void *const sgdData, void *dst, size_t dstSize) {
+	++tinyktxTestStreamCount;
+	return new tinyktxTestStream { (uint8_t *) dst, dstSize, 0, false };
+}
+static bool tinyktxTestStreamFeed(void *user, void *state, void const *src, size_t srcSize) {
+	auto stream = (tinyktxTestStream *) state;
+	for (size_t i = 0; i < srcSize; ++i) {
+		uint8_t const c = ((uint8_t const *) src)[i];
+		if (stream->pos < stream->size) stream->dst[stream->pos++] = c ^ 0x5A;
+		else if (!stream->trailer && c == 0x5A) stream->trailer = true;
+		else return false;
+	}
+	return true;
+}
+static bool tinyktxTestStreamFinish(void *user, void *state) {
+	auto stream = (tinyktxTestStream *) state;
+	bool const okay = stream->pos == stream->size && stream->trailer;
+	delete stream;
+	return okay;
+}
+
+TEST_CASE("TinyKtx2 streams supercompressed levels in chunks", "[TinyKtx2 Loader]") {
+	TinyKtx_WriteCallbacks callbacks = tinyktxMemWriteCallbacks();
+	TinyKtx2_WriteCallbacks callbacks2 = tinyktx2MemWriteCallbacks();
+
+	uint32_t mipmapsizes[6];
+	REQUIRE(TinyKtx_ComputeMipmapSizes(32, 32, 1, 1, 6, TKTX_R8G8B8A8_UNORM, false, mipmapsizes));
+	std::vector<uint8_t> src(mipmapsizes[0]);
+	for (size_t i = 0; i < src.size(); ++i) src[i] = (uint8_t) (i * 5);
+	void const *mipmaps[6];
+	for (int i = 0; i < 6; ++i) mipmaps[i] = src.data() + i * 4;
+
+	std::vector<uint8_t> ktx1;
+	REQUIRE(TinyKtx_WriteImage(&callbacks, &ktx1, 32, 32, 1, 1, 6, TKTX_R8G8B8A8_UNORM, false, nullptr, mipmaps));
+	TinyKtx_Callbacks readCallbacks = tinyktxMemReadCallbacks();
+	tinyktxMemReader reader { &ktx1, 0 };
+	auto ctx = TinyKtx_CreateContext(&readCallbacks, &reader);
+	REQUIRE(TinyKtx_ReadHeader(ctx));
+	std::vector<uint8_t> ktx2;
+	REQUIRE(TinyKtx2_ConvertFromKtx1(ctx, &callbacks2, &ktx2, TKTX2_SUPERCOMPRESSION_ZSTD, &tinyktxTestCompress));
+	TinyKtx_DestroyContext(ctx);
+
+	TinyKtx2_SuperDecompressTableEntry decompressors[] = {
+			{ TKTX2_SUPERCOMPRESSION_ZSTD, &tinyktxTestDecompress }
+	};
+	TinyKtx2_StreamDecompressTableEntry streamDecompressors[] = {
+			{ TKTX2_SUPERCOMPRESSION_ZSTD, &tinyktxTestStreamInit, &tinyktxTestStreamFeed, &tinyktxTestStreamFinish }
+	};
+	TinyKtx2_Callbacks readCallbacks2 = tinyktx2MemReadCallbacks();
+	readCallbacks2.numSuperDecompressors = 1;
+	readCallbacks2.superDecompressors = decompressors;
+	readCallbacks2.numStreamDecompressors = 1;
+	readCallbacks2.streamDecompressors = streamDecompressors;
+	readCallbacks2.streamChunkSize = 7;
+	tinyktxMemReader reader2 { &ktx2, 0 };
+	tinyktxTestStreamCount = 0;
+
+	// serial decodes stream, more than one level with a dispatcher uses whole level tasks
+	auto ctx2 = TinyKtx2_CreateContext(&readCallbacks2, &reader2);
+	REQUIRE(TinyKtx2_ReadHeader(ctx2));
+	REQUIRE(TinyKtx2_ImageRawData(ctx2, 0));
+	REQUIRE(tinyktxTestStreamCount == 1);
+	uint32_t dispatched = 0;
+	REQUIRE(TinyKtx2_DecodeLevels(ctx2, 0x3F, &tinyktxTestDispatch, &dispatched));
+	REQUIRE(dispatched == 5);
+	REQUIRE(tinyktxTestStreamCount == 1);
+	for (uint32_t i = 0; i < 6; ++i) {
+		REQUIRE(memcmp(TinyKtx2_ImageRawData(ctx2, i), mipmaps[i], mipmapsizes[i]) == 0);
+	}
+
+	// truncated data fails the stream
+	TinyKtx2_Reset(ctx2);
+	reader2.pos = 0;
+	REQUIRE(TinyKtx2_ReadHeader(ctx2));
+	ktx2.resize(ktx2.size() - 1);
+	REQUIRE(TinyKtx2_ImageRawData(ctx2, 0) == nullptr);
+	TinyKtx2_DestroyContext(ctx2);
+}
+
+// the writers don't write supercompression global data, insert it in front of the levels
+static void tinyktxTestInsertSgd(std::vector<uint8_t> &ktx2, uint32_t levelCount, std::vector<uint8_t> const &sgd) {
+	uint64_t insertAt = ktx2.size();
+	for (uint32_t i = 0; i < levelCount; ++i) {
+		uint64_t byteOffset;
+		memcpy(&byteOffset, ktx2.data() + 80 + i * 24, 8);
+		insertAt = std::min(insertAt, byteOffset);
+	}
+	for (uint32_t i = 0; i < levelCount; ++i) {
+		uint64_t byteOffset;
+		memcpy(&byteOffset, ktx2.data() + 80 + i * 24, 8);
+		byteOffset += sgd.size();
+		memcpy(ktx2.data() + 80 + i * 24, &byteOffset, 8);
+	}
+	uint64_t const sgdByteLength = sgd.size();
+	memcpy(ktx2.data() + 64, &insertAt, 8);
+	memcpy(ktx2.data() + 72, &sgdByteLength, 8);
+	ktx2.insert(ktx2.begin() + insertAt, sgd.begin(), sgd.end());
+}
+static bool tinyktxTestSgdDecompress(void *user, void *const sgdData, void const *src, size_t srcSize, void *dst, size_t dstSize) {
+	if (sgdData == nullptr || ((uint8_t const *) sgdData)[0] != 0xC3) return false;
+	return tinyktxTestDecompress(user, sgdData, src, srcSize, dst, dstSize);
+}
+static std::map<uint64_t, std::vector<uint8_t>> tinyktxTestSgdCache;
+static void const *tinyktxTestShareSgd(void *user, uint64_t key, void const *sgd, uint64_t byteLength) {
+	auto it = tinyktxTestSgdCache.find(key);
+	if (it == tinyktxTestSgdCache.end()) {
+		it = tinyktxTestSgdCache.emplace(key, std::vector<uint8_t>((uint8_t const *) sgd, (uint8_t const *) sgd + byteLength)).first;
+	}
+	return it->second.data();
+}
+
+TEST_CASE("TinyKtx2 reads supercompression global data lazily and shares it", "[TinyKtx2 Loader]") {
+	TinyKtx_WriteCallbacks callbacks = tinyktxMemWriteCallbacks();
+	TinyKtx2_WriteCallbacks callbacks2 = tinyktx2MemWriteCallbacks();
+
+	uint32_t mipmapsizes[3];
+	REQUIRE(TinyKtx_ComputeMipmapSizes(8, 8, 1, 1, 3, TKTX_R8G8B8A8_UNORM, false, mipmapsizes));
+	std::vector<uint8_t> src(mipmapsizes[0]);
+	for (size_t i = 0; i < src.size(); ++i) src[i] = (uint8_t) (i * 11);
+	void const *mipmaps[3] = { src.data(), src.data() + 4, src.data() + 8 };
+
+	std::vector<uint8_t> ktx1;
+	REQUIRE(TinyKtx_WriteImage(&callbacks, &ktx1, 8, 8, 1, 1, 3, TKTX_R8G8B8A8_UNORM, false, nullptr, mipmaps));
+	TinyKtx_Callbacks readCallbacks = tinyktxMemReadCallbacks();
+	tinyktxMemReader reader { &ktx1, 0 };
+	auto ctx = TinyKtx_CreateContext(&readCallbacks, &reader);
+	REQUIRE(TinyKtx_ReadHeader(ctx));
+	std::vector<uint8_t> ktx2;
+	REQUIRE(TinyKtx2_ConvertFromKtx1(ctx, &callbacks2, &ktx2, TKTX2_SUPERCOMPRESSION_ZSTD, &tinyktxTestCompress));
+	TinyKtx_DestroyContext(ctx);
+
+	std::vector<uint8_t> sgd(64);
+	for (size_t i = 0; i < sgd.size(); ++i) sgd[i] = (uint8_t) (0xC3 + i);
+	tinyktxTestInsertSgd(ktx2, 3, sgd);
+	uint64_t sgdByteOffset;
+	memcpy(&sgdByteOffset, ktx2.data() + 64, 8);
+
+	TinyKtx2_SuperDecompressTableEntry decompressors[] = {
+			{ TKTX2_SUPERCOMPRESSION_ZSTD, &tinyktxTestSgdDecompress }
+	};
+	TinyKtx2_Callbacks readCallbacks2 = tinyktx2MemReadCallbacks();
+	readCallbacks2.numSuperDecompressors = 1;
+	readCallbacks2.superDecompressors = decompressors;
+	readCallbacks2.shareGlobalData = &tinyktxTestShareSgd;
+	tinyktxTestSgdCache.clear();
+	tinyktxMemReader readerA { &ktx2, 0 };
+	tinyktxMemReader readerB { &ktx2, 0 };
+	auto ctxA = TinyKtx2_CreateContext(&readCallbacks2, &readerA);
+	auto ctxB = TinyKtx2_CreateContext(&readCallbacks2, &readerB);
+
+	// the header doesn't touch the global data
+	REQUIRE(TinyKtx2_ReadHeader(ctxA));
+	REQUIRE(readerA.pos <= sgdByteOffset);
+	REQUIRE(TinyKtx2_ReadHeader(ctxB));
+	REQUIRE(memcmp(TinyKtx2_ImageRawData(ctxA, 0), mipmaps[0], mipmapsizes[0]) == 0);
+	REQUIRE(memcmp(TinyKtx2_ImageRawData(ctxB, 2), mipmaps[2], mipmapsizes[2]) == 0);
+
+	// both contexts use the one shared copy
+	uint64_t byteLength, keyA, keyB;
+	void const *sgdA = TinyKtx2_SuperCompressionGlobalData(ctxA, &byteLength, &keyA);
+	REQUIRE(byteLength == sgd.size());
+	void const *sgdB = TinyKtx2_SuperCompressionGlobalData(ctxB, nullptr, &keyB);
+	REQUIRE(sgdA == sgdB);
+	REQUIRE(keyA == keyB);
+	REQUIRE(keyA == TinyKtx2_HashGlobalData(sgd.data(), sgd.size()));
+	REQUIRE(tinyktxTestSgdCache.size() == 1);
+
+	// or provided up front so it isn't read at all
+	TinyKtx2_Reset(ctxB);
+	readerB.pos = 0;
+	REQUIRE(TinyKtx2_ReadHeader(ctxB));
+	REQUIRE(!TinyKtx2_SetSuperCompressionGlobalData(ctxB, sgd.data(), sgd.size() - 1));
+	REQUIRE(TinyKtx2_SetSuperCompressionGlobalData(ctxB, sgd.data(), sgd.size()));
+	REQUIRE(memcmp(TinyKtx2_ImageRawData(ctxB, 1), mipmaps[1], mipmapsizes[1]) == 0);
+	REQUIRE(TinyKtx2_SuperCompressionGlobalData(ctxB, nullptr, nullptr) == sgd.data());
+
+	TinyKtx2_DestroyContext(ctxB);
+	TinyKtx2_DestroyContext(ctxA);
+}
+
+// stand in transcoder, the 'universal' data is RGBA8 inverted
+static bool tinyktxTestTranscode(void *user, void *const sgdData, TinyKtx2_TranscodeImage const *image) {
+	size_t const srcSize = image->levelDataSize / image->imageCount;
+	if (srcSize != image->dstSize) return false;
+	auto src = (uint8_t const *) image->levelData + srcSize * image->imageIndex;
+	for (size_t i = 0; i < srcSize; ++i) ((uint8_t *) image->dst)[i] = src[i] ^ 0xFF;
+	return true;
+}
+
+TEST_CASE("TinyKtx2 transcodes universal textures per image", "[TinyKtx2 Loader]") {
+	TinyKtx2_WriteCallbacks callbacks = tinyktx2MemWriteCallbacks();
+
+	uint32_t mipmapsizes[2];
+	REQUIRE(TinyKtx_ComputeMipmapSizes(8, 8, 1, 3, 2, TKTX_R8G8B8A8_UNORM, false, mipmapsizes));
+	std::vector<uint8_t> src(mipmapsizes[0]);
+	for (size_t i = 0; i < src.size(); ++i) src[i] = (uint8_t) (i * 13);
+	void const *mipmaps[] = { src.data(), src.data() + 4 };
+	std::vector<uint8_t> file;
+	REQUIRE(TinyKtx2_WriteImage(&callbacks, &file, 8, 8, 1, 3, 2, TKTX_R8G8B8A8_UNORM, false, nullptr, mipmaps));
+
+	TinyKtx2_TranscoderTableEntry transcoders[] = {
+			{ TKTX2_UNIVERSAL_UASTC, TKTX_R8G8B8A8_UNORM, &tinyktxTestTranscode }
+	};
+	TinyKtx2_Callbacks readCallbacks = tinyktx2MemReadCallbacks();
+	readCallbacks.numTranscoders = 1;
+	readCallbacks.transcoders = transcoders;
+
+	// a normal texture can only be 'transcoded' to its own format
+	tinyktxMemReader reader { &file, 0 };
+	auto ctx = TinyKtx2_CreateContext(&readCallbacks, &reader);
+	REQUIRE(TinyKtx2_ReadHeader(ctx));
+	REQUIRE(TinyKtx2_GetUniversalFormat(ctx) == TKTX2_UNIVERSAL_NONE);
+	std::vector<uint8_t> dst(TinyKtx2_TranscodedLevelSize(ctx, 0, TKTX_R8G8B8A8_UNORM));
+	REQUIRE(dst.size() == mipmapsizes[0]);
+	REQUIRE(TinyKtx2_TranscodeLevel(ctx, 0, TKTX_R8G8B8A8_UNORM, dst.data(), dst.size(), nullptr, nullptr));
+	REQUIRE(memcmp(dst.data(), mipmaps[0], mipmapsizes[0]) == 0);
+	REQUIRE(!TinyKtx2_TranscodeLevel(ctx, 0, TKTX_B8G8R8A8_UNORM, dst.data(), dst.size(), nullptr, nullptr));
+
+	// turn it into a UASTC file by changing the format and the DFD colour model
+	uint32_t dfdByteLength;
+	auto dfd = (uint8_t const *) TinyKtx2_DataFormatDescriptor(ctx, &dfdByteLength);
+	size_t const dfdOffset = std::search(file.begin(), file.end(), dfd, dfd + dfdByteLength) - file.begin();
+	TinyKtx2_DestroyContext(ctx);
+	memset(file.data() + 12, 0, 4);
+	file[dfdOffset + 12] = 166;
+	for (size_t i = 0; i < src.size(); ++i) src[i] ^= 0xFF;
+
+	reader.pos = 0;
+	ctx = TinyKtx2_CreateContext(&readCallbacks, &reader);
+	REQUIRE(TinyKtx2_ReadHeader(ctx));
+	REQUIRE(TinyKtx2_GetUniversalFormat(ctx) == TKTX2_UNIVERSAL_UASTC);
+	std::vector<uint8_t> bc1(TinyKtx2_TranscodedLevelSize(ctx, 0, TKTX_BC1_RGB_UNORM_BLOCK));
+	REQUIRE(bc1.size() == 3 * 4 * 8);
+	REQUIRE(!TinyKtx2_TranscodeLevel(ctx, 0, TKTX_BC1_RGB_UNORM_BLOCK, bc1.data(), bc1.size(), nullptr, nullptr));
+	uint32_t dispatched = 0;
+	for (uint32_t i = 0; i < 2; ++i) {
+		std::vector<uint8_t> level(TinyKtx2_TranscodedLevelSize(ctx, i, TKTX_R8G8B8A8_UNORM));
+		REQUIRE(level.size() == mipmapsizes[i]);
+		REQUIRE(TinyKtx2_TranscodeLevel(ctx, i, TKTX_R8G8B8A8_UNORM, level.data(), level.size(), &tinyktxTestDispatch, &dispatched));
+		REQUIRE(memcmp(level.data(), mipmaps[i], mipmapsizes[i]) == 0);
+	}
+	// one task per array slice
+	REQUIRE(dispatched == 6);
+	TinyKtx2_DestroyContext(ctx);
+}
+
+struct tinyktxTestBlockBits {
+	uint8_t block[16];
+	uint32_t pos;
+};
+static void tinyktxTestPutBits(tinyktxTestBlockBits &bits, uint32_t value, uint32_t count) {
+	for (uint32_t i = 0; i < count; ++i, ++bits.pos) {
+		bits.block[bits.pos / 8] |= (uint8_t) (((value >> i) & 1) << (bits.pos % 8));
+	}
+}
+// ASTC interpolation of 8 bit endpoints with a 0-64 weight
+static uint8_t tinyktxTestAstcLerp(uint32_t e0, uint32_t e1, uint32_t w) {
+	return (uint8_t) (((((e0 << 8) | e0) * (64 - w) + ((e1 << 8) | e1) * w + 32) >> 6) >> 8);
+}
+
+TEST_CASE("TinyKtx2 built in UASTC transcoders", "[TinyKtx2 Loader]") {
+	// mode 18: RGB, 5 bit endpoints and weights
+	tinyktxTestBlockBits gradient {};
+	tinyktxTestPutBits(gradient, 0x09, 4);
+	tinyktxTestPutBits(gradient, 0, 15);
+	uint32_t const rgb[6] = { 0, 31, 31, 0, 8, 24 };
+	for (uint32_t v : rgb) tinyktxTestPutBits(gradient, v, 5);
+	for (uint32_t i = 0; i < 16; ++i) tinyktxTestPutBits(gradient, i * 2, i ? 5 : 4);
+	REQUIRE(gradient.pos == 128);
+	// mode 16: luminance alpha, 2 subsets split down the middle (BC7 pattern 0), the anchors
+	// (texels 0 and 15) have 1 bit weights. Endpoints are (100, 200) (255, 55) and (10, 250) (128, 0)
+	tinyktxTestBlockBits split {};
+	tinyktxTestPutBits(split, 0x15, 6);
+	tinyktxTestPutBits(split, 0, 23);
+	tinyktxTestPutBits(split, 0, 5);
+	for (uint32_t v : { 100, 200, 255, 55, 10, 250, 128, 0 }) tinyktxTestPutBits(split, v, 8);
+	for (uint32_t i = 0; i < 16; ++i) tinyktxTestPutBits(split, (i == 0 || i == 15) ? 1 : (i & 3), (i == 0 || i == 15) ? 1 : 2);
+	REQUIRE(split.pos == 128);
+	static uint8_t const splitDecoded[16][2] = {
+		{ 133, 190 }, { 133, 190 }, { 171, 42 }, { 250, 0 },
+		{ 100, 255 }, { 133, 190 }, { 171, 42 }, { 250, 0 },
+		{ 100, 255 }, { 133, 190 }, { 171, 42 }, { 250, 0 },
+		{ 100, 255 }, { 133, 190 }, { 171, 42 }, { 89, 86 },
+	};
+	// mode 8: a solid colour
+	tinyktxTestBlockBits solid {};
+	tinyktxTestPutBits(solid, 0x17, 5);
+	for (uint32_t v : { 10, 20, 30, 40 }) tinyktxTestPutBits(solid, v, 8);
+
+	// a 10x4 image of the 3 blocks, the last clipped
+	uint8_t expected[10 * 4 * 4];
+	for (uint32_t i = 0; i < 16; ++i) {
+		uint32_t const v = i * 2;
+		uint32_t w = (v << 1) | (v >> 4);
+		w += w > 32 ? 1 : 0;
+		uint8_t *p = expected + ((i / 4) * 10 + i % 4) * 4;
+		p[0] = tinyktxTestAstcLerp(0, 255, w);
+		p[1] = tinyktxTestAstcLerp(255, 0, w);
+		p[2] = tinyktxTestAstcLerp(66, 198, w);
+		p[3] = 255;
+
+		p = expected + ((i / 4) * 10 + 4 + i % 4) * 4;
+		p[0] = p[1] = p[2] = splitDecoded[i][0];
+		p[3] = splitDecoded[i][1];
+
+		if (i % 4 < 2) {
+			p = expected + ((i / 4) * 10 + 8 + i % 4) * 4;
+			p[0] = 10;
+			p[1] = 20;
+			p[2] = 30;
+			p[3] = 40;
+		}
+	}
+
+	// write the blocks as BC7 (16 byte 4x4 blocks too) then make it a UASTC file
+	std::vector<uint8_t> blocks;
+	for (auto const *b : { &gradient, &split, &solid }) blocks.insert(blocks.end(), b->block, b->block + 16);
+	void const *mipmaps[] = { blocks.data() };
+	TinyKtx2_WriteCallbacks callbacks = tinyktx2MemWriteCallbacks();
+	std::vector<uint8_t> file;
+	REQUIRE(TinyKtx2_WriteImage(&callbacks, &file, 10, 4, 1, 0, 1, TKTX_BC7_UNORM_BLOCK, false, nullptr, mipmaps));
+	TinyKtx2_Callbacks readCallbacks = tinyktx2MemReadCallbacks();
+	tinyktxMemReader reader { &file, 0 };
+	auto ctx = TinyKtx2_CreateContext(&readCallbacks, &reader);
+	REQUIRE(TinyKtx2_ReadHeader(ctx));
+	uint32_t dfdByteLength;
+	auto dfd = (uint8_t const *) TinyKtx2_DataFormatDescriptor(ctx, &dfdByteLength);
+	size_t const dfdOffset = std::search(file.begin(), file.end(), dfd, dfd + dfdByteLength) - file.begin();
+	TinyKtx2_DestroyContext(ctx);
+	memset(file.data() + 12, 0, 4);
+	file[dfdOffset + 12] = 166;
+
+	// no table, the built in transcoders are used
+	reader.pos = 0;
+	ctx = TinyKtx2_CreateContext(&readCallbacks, &reader);
+	REQUIRE(TinyKtx2_ReadHeader(ctx));
+	REQUIRE(TinyKtx2_GetUniversalFormat(ctx) == TKTX2_UNIVERSAL_UASTC);
+	REQUIRE(TinyKtx2_CanTranscode(ctx, TKTX_R8G8B8A8_SRGB));
+	REQUIRE(!TinyKtx2_CanTranscode(ctx, TKTX_BC7_SRGB_BLOCK));
+	REQUIRE(!TinyKtx2_CanTranscode(ctx, TKTX_BC1_RGB_UNORM_BLOCK));
+	std::vector<uint8_t> rgba(TinyKtx2_TranscodedLevelSize(ctx, 0, TKTX_R8G8B8A8_UNORM));
+	REQUIRE(rgba.size() == sizeof(expected));
+	REQUIRE(TinyKtx2_TranscodeLevel(ctx, 0, TKTX_R8G8B8A8_UNORM, rgba.data(), rgba.size(), nullptr, nullptr));
+	REQUIRE(memcmp(rgba.data(), expected, sizeof(expected)) == 0);
+
+	// there is no built in BC7 target, a planner that would take BC7 falls back to R8G8B8A8
+	TinyKtx_LoadPlan plan;
+	TinyKtx_Format const planFormats[] = { TKTX_BC7_UNORM_BLOCK, TKTX_R8G8B8A8_UNORM };
+	REQUIRE(TinyKtx2_PlanLoad(ctx, planFormats, 2, &plan));
+	REQUIRE(plan.path == TKTX_LOAD_TRANSCODE);
+	REQUIRE(plan.dstFormat == TKTX_R8G8B8A8_UNORM);
+	std::vector<uint8_t> planned(plan.levelSize[0]);
+	REQUIRE(planned.size() == rgba.size());
+	REQUIRE(TinyKtx2_ExecuteLoad(ctx, &plan, 0, planned.data(), planned.size(), nullptr, nullptr));
+	REQUIRE(planned == rgba);
+	TinyKtx2_DestroyContext(ctx);
+
+	// an invalid block is the ASTC error colour
+	uint8_t const reserved[16] = { 0x45 };
+	blocks.assign(reserved, reserved + 16);
+	blocks.resize(3 * 16);
+	std::copy(blocks.begin(), blocks.end(), file.end() - 3 * 16);
+	reader.pos = 0;
+	ctx = TinyKtx2_CreateContext(&readCallbacks, &reader);
+	REQUIRE(TinyKtx2_ReadHeader(ctx));
+	REQUIRE(TinyKtx2_TranscodeLevel(ctx, 0, TKTX_R8G8B8A8_UNORM, rgba.data(), rgba.size(), nullptr, nullptr));
+	uint8_t const magenta[4] = { 255, 0, 255, 255 };
+	REQUIRE(memcmp(rgba.data(), magenta, 4) == 0);
+	TinyKtx2_DestroyContext(ctx);
+}
+
+TEST_CASE("TinyKtx2 describes the texel layout from the DFD", "[TinyKtx2 Loader]") {
+	TinyKtx2_WriteCallbacks callbacks = tinyktx2MemWriteCallbacks();
+	TinyKtx2_Callbacks readCallbacks = tinyktx2MemReadCallbacks();
+
+	std::vector<uint8_t> src(16 * 16 * 8);
+	void const *mipmaps[] = { src.data() };
+	std::vector<uint8_t> file;
+	REQUIRE(TinyKtx2_WriteImage(&callbacks, &file, 16, 16, 1, 1, 1, TKTX_R16G16B16A16_SFLOAT, false, nullptr, mipmaps));
+	uint32_t typeSize;
+	memcpy(&typeSize, file.data() + 16, 4);
+	REQUIRE(typeSize == 2);
+
+	// without the vkFormat the DFD still describes the format
+	memset(file.data() + 12, 0, 4);
+	tinyktxMemReader reader { &file, 0 };
+	auto ctx = TinyKtx2_CreateContext(&readCallbacks, &reader);
+	REQUIRE(TinyKtx2_ReadHeader(ctx));
+	REQUIRE(TinyKtx2_GetFormat(ctx) == TKTX_R16G16B16A16_SFLOAT);
+	auto layout = TinyKtx2_GetTexelLayout(ctx);
+	REQUIRE(layout->colorModel == 1);
+	REQUIRE(layout->transferFunction == 1);
+	REQUIRE(!layout->premultiplied);
+	REQUIRE(layout->blockWidth == 1);
+	REQUIRE(layout->bytesPerBlock == 8);
+	REQUIRE(layout->channelCount == 4);
+	REQUIRE(layout->channels[3].channelType == 15);
+	REQUIRE(layout->channels[3].bitOffset == 48);
+	REQUIRE(layout->channels[3].bitLength == 16);
+	REQUIRE(layout->channels[3].qualifiers == 0xC0);
+	TinyKtx2_DestroyContext(ctx);
+
+	file.clear();
+	src.resize(16);
+	REQUIRE(TinyKtx2_WriteImage(&callbacks, &file, 4, 4, 1, 1, 1, TKTX_BC7_SRGB_BLOCK, false, nullptr, mipmaps));
+	memset(file.data() + 12, 0, 4);
+	reader.pos = 0;
+	ctx = TinyKtx2_CreateContext(&readCallbacks, &reader);
+	REQUIRE(TinyKtx2_ReadHeader(ctx));
+	REQUIRE(TinyKtx2_GetFormat(ctx) == TKTX_BC7_SRGB_BLOCK);
+	layout = TinyKtx2_GetTexelLayout(ctx);
+	REQUIRE(layout->transferFunction == 2);
+	REQUIRE(layout->blockWidth == 4);
+	REQUIRE(layout->blockHeight == 4);
+	REQUIRE(layout->blockDepth == 1);
+	REQUIRE(layout->bytesPerBlock == 16);
+	REQUIRE(memcmp(TinyKtx2_ImageRawData(ctx, 0), src.data(), 16) == 0);
+	TinyKtx2_DestroyContext(ctx);
+}
+
+struct tinyktxTestLevelsReady {
+	TinyKtx2_ContextHandle ctx;
+	std::vector<uint32_t> order;
+	void const **mipmaps;
+	uint32_t const *mipmapsizes;
+	bool matched;
+};
+static void tinyktxTestLevelReady(void *user, uint32_t mipmaplevel, void const *data, size_t byteLength) {
+	auto ready = (tinyktxTestLevelsReady *) user;
+	ready->order.push_back(mipmaplevel);
+	ready->matched = ready->matched && byteLength == ready->mipmapsizes[mipmaplevel] &&
+			memcmp(data, ready->mipmaps[mipmaplevel], byteLength) == 0;
+	TinyKtx2_ReleaseImageRawData(ready->ctx, mipmaplevel);
+}
+
+TEST_CASE("TinyKtx2 streams levels from a forward only stream", "[TinyKtx2 Loader]") {
+	TinyKtx_WriteCallbacks callbacks = tinyktxMemWriteCallbacks();
+	TinyKtx2_WriteCallbacks callbacks2 = tinyktx2MemWriteCallbacks();
+
+	uint32_t mipmapsizes[3];
+	REQUIRE(TinyKtx_ComputeMipmapSizes(16, 16, 1, 1, 3, TKTX_R8G8B8A8_UNORM, false, mipmapsizes));
+	std::vector<uint8_t> src(mipmapsizes[0]);
+	for (size_t i = 0; i < src.size(); ++i) src[i] = (uint8_t) (i * 17);
+	void const *mipmaps[] = { src.data(), src.data() + 4, src.data() + 8 };
+
+	std::vector<uint8_t> files[2];
+	REQUIRE(TinyKtx2_WriteImage(&callbacks2, &files[0], 16, 16, 1, 1, 3, TKTX_R8G8B8A8_UNORM, false, nullptr, mipmaps));
+	std::vector<uint8_t> ktx1;
+	REQUIRE(TinyKtx_WriteImage(&callbacks, &ktx1, 16, 16, 1, 1, 3, TKTX_R8G8B8A8_UNORM, false, nullptr, mipmaps));
+	TinyKtx_Callbacks readCallbacks = tinyktxMemReadCallbacks();
+	tinyktxMemReader reader { &ktx1, 0 };
+	auto ctx = TinyKtx_CreateContext(&readCallbacks, &reader);
+	REQUIRE(TinyKtx_ReadHeader(ctx));
+	REQUIRE(TinyKtx2_ConvertFromKtx1(ctx, &callbacks2, &files[1], TKTX2_SUPERCOMPRESSION_ZSTD, &tinyktxTestCompress));
+	TinyKtx_DestroyContext(ctx);
+
+	// no seek or tell, the context can only read forward
+	TinyKtx2_SuperDecompressTableEntry decompressors[] = {
+			{ TKTX2_SUPERCOMPRESSION_ZSTD, &tinyktxTestDecompress }
+	};
+	TinyKtx2_Callbacks streamCallbacks = tinyktx2MemReadCallbacks();
+	streamCallbacks.seek = nullptr;
+	streamCallbacks.tell = nullptr;
+	streamCallbacks.numSuperDecompressors = 1;
+	streamCallbacks.superDecompressors = decompressors;
+	for (auto const &file : files) {
+		tinyktxMemReader stream { &file, 0 };
+		auto ctx2 = TinyKtx2_CreateContext(&streamCallbacks, &stream);
+		REQUIRE(ctx2);
+		REQUIRE(TinyKtx2_ReadHeader(ctx2));
+		tinyktxTestLevelsReady ready { ctx2, {}, mipmaps, mipmapsizes, true };
+		REQUIRE(TinyKtx2_StreamLevels(ctx2, &tinyktxTestLevelReady, &ready));
+		REQUIRE(ready.matched);
+		REQUIRE(ready.order == std::vector<uint32_t>({ 2, 1, 0 }));
+		REQUIRE(stream.pos == file.size());
+		TinyKtx2_DestroyContext(ctx2);
+
+		// going back to a smaller level isn't possible
+		stream.pos = 0;
+		ctx2 = TinyKtx2_CreateContext(&streamCallbacks, &stream);
+		REQUIRE(TinyKtx2_ReadHeader(ctx2));
+		REQUIRE(TinyKtx2_ImageRawData(ctx2, 0));
+		REQUIRE(TinyKtx2_ImageRawData(ctx2, 1) == nullptr);
+		TinyKtx2_DestroyContext(ctx2);
+	}
+}
+
+struct tinyktxTestChunkReader {
+	tinyktxMemReader mem;	// first so the mem seek and tell callbacks work
+	size_t largestRead;
+	std::vector<uint8_t> level;
+};
+static size_t tinyktxTestChunkRead(void *user, void *data, size_t size) {
+	auto reader = (tinyktxTestChunkReader *) user;
+	reader->largestRead = std::max(reader->largestRead, size);
+	return tinyktxCallbackMemRead(&reader->mem, data, size);
+}
+static bool tinyktxTestLevelChunk(void *user, uint32_t mipmaplevel, uint64_t byteOffset, void const *data, size_t byteCount) {
+	auto reader = (tinyktxTestChunkReader *) user;
+	if (byteOffset != reader->level.size())
+		return false;
+	reader->level.insert(reader->level.end(), (uint8_t const *) data, (uint8_t const *) data + byteCount);
+	return true;
+}
+
+TEST_CASE("TinyKtx and TinyKtx2 read large levels in bounded chunks", "[TinyKtx2 Loader]") {
+	// a 4096x4096x256 RGBA8 volume is 16GB in its top level
+	uint64_t sizes64[2];
+	uint32_t sizes32[2];
+	REQUIRE(TinyKtx_ComputeMipmapSizes64(4096, 4096, 256, 1, 2, TKTX_R8G8B8A8_UNORM, false, sizes64));
+	REQUIRE(sizes64[0] == 4096ull * 4096ull * 256ull * 4ull);
+	REQUIRE(sizes64[1] == sizes64[0] / 8);
+	REQUIRE(!TinyKtx_ComputeMipmapSizes(4096, 4096, 256, 1, 2, TKTX_R8G8B8A8_UNORM, false, sizes32));
+	TinyKtx2_WriteCallbacks callbacks2 = tinyktx2MemWriteCallbacks();
+	TinyKtx2_WriteLayout layout;
+	REQUIRE(TinyKtx2_ComputeWriteLayout64(&callbacks2, nullptr, 4096, 4096, 256, 1, 2, TKTX_R8G8B8A8_UNORM, false,
+																				sizes64, &layout));
+	REQUIRE(layout.levels[0].byteLength == sizes64[0]);
+	REQUIRE(layout.totalByteLength > sizes64[0]);
+
+	TinyKtx_WriteCallbacks callbacks = tinyktxMemWriteCallbacks();
+	uint32_t mipmapsizes[2];
+	REQUIRE(TinyKtx_ComputeMipmapSizes(16, 16, 1, 1, 2, TKTX_R8G8B8A8_UNORM, false, mipmapsizes));
+	std::vector<uint8_t> src(mipmapsizes[0]);
+	for (size_t i = 0; i < src.size(); ++i) src[i] = (uint8_t) (i * 13);
+	void const *mipmaps[] = { src.data(), src.data() + 8 };
+	std::vector<uint8_t> ktx1, ktx2;
+	REQUIRE(TinyKtx_WriteImage(&callbacks, &ktx1, 16, 16, 1, 1, 2, TKTX_R8G8B8A8_UNORM, false, nullptr, mipmaps));
+	REQUIRE(TinyKtx2_WriteImage(&callbacks2, &ktx2, 16, 16, 1, 1, 2, TKTX_R8G8B8A8_UNORM, false, nullptr, mipmaps));
+
+	// the 1KB top level is over the limit so can only be read in chunks
+	size_t const maxChunkSize = 300;
+	TinyKtx_Callbacks readCallbacks = tinyktxMemReadCallbacks(maxChunkSize);
+	readCallbacks.readFn = &tinyktxTestChunkRead;
+	tinyktxTestChunkReader reader { { &ktx1, 0 }, 0, {} };
+	auto ctx = TinyKtx_CreateContext(&readCallbacks, &reader);
+	REQUIRE(TinyKtx_ReadHeader(ctx));
+	REQUIRE(TinyKtx_ImageSize64(ctx, 0) == mipmapsizes[0]);
+	REQUIRE(TinyKtx_ImageRawData(ctx, 0) == nullptr);
+	REQUIRE(TinyKtx_ReadLevelChunks(ctx, 0, &tinyktxTestLevelChunk, &reader));
+	REQUIRE(reader.level == src);
+	REQUIRE(reader.largestRead <= maxChunkSize);
+	REQUIRE(memcmp(TinyKtx_ImageRawData(ctx, 1), src.data() + 8, mipmapsizes[1]) == 0);
+	TinyKtx_DestroyContext(ctx);
+
+	TinyKtx2_Callbacks readCallbacks2 = tinyktx2MemReadCallbacks();
+	readCallbacks2.read = &tinyktxTestChunkRead;
+	readCallbacks2.maxChunkSize = maxChunkSize;
+	tinyktxTestChunkReader reader2 { { &ktx2, 0 }, 0, {} };
+	auto ctx2 = TinyKtx2_CreateContext(&readCallbacks2, &reader2);
+	REQUIRE(TinyKtx2_ReadHeader(ctx2));
+	REQUIRE(TinyKtx2_ImageSize64(ctx2, 0) == mipmapsizes[0]);
+	REQUIRE(TinyKtx2_ImageRawData(ctx2, 0) == nullptr);
+	REQUIRE(TinyKtx2_ReadLevelChunks(ctx2, 0, &tinyktxTestLevelChunk, &reader2));
+	REQUIRE(reader2.level == src);
+	REQUIRE(memcmp(TinyKtx2_ImageRawData(ctx2, 1), src.data() + 8, mipmapsizes[1]) == 0);
+	// including the header and level index reads
+	REQUIRE(reader2.largestRead <= maxChunkSize);
+	TinyKtx2_DestroyContext(ctx2);
+}
+
+TEST_CASE("TinyKtx and TinyKtx2 read ranges of depth slices", "[TinyKtx2 Loader]") {
+	TinyKtx_WriteCallbacks callbacks = tinyktxMemWriteCallbacks();
+	TinyKtx2_WriteCallbacks callbacks2 = tinyktx2MemWriteCallbacks();
+
+	// 5 RGB8 pixels is 15 bytes, so KTX v1 pads each row to 16
+	uint32_t mipmapsizes[2];
+	REQUIRE(TinyKtx_ComputeMipmapSizes(5, 3, 8, 1, 2, TKTX_R8G8B8_UNORM, false, mipmapsizes));
+	std::vector<uint8_t> src(mipmapsizes[0] + mipmapsizes[1]);
+	for (size_t i = 0; i < src.size(); ++i) src[i] = (uint8_t) (i * 7 + 1);
+	void const *mipmaps[] = { src.data(), src.data() + mipmapsizes[0] };
+	std::vector<uint8_t> ktx1, ktx2;
+	REQUIRE(TinyKtx_WriteImage(&callbacks, &ktx1, 5, 3, 8, 1, 2, TKTX_R8G8B8_UNORM, false, nullptr, mipmaps));
+	REQUIRE(TinyKtx2_WriteImage(&callbacks2, &ktx2, 5, 3, 8, 1, 2, TKTX_R8G8B8_UNORM, false, nullptr, mipmaps));
+
+	TinyKtx_Callbacks readCallbacks = tinyktxMemReadCallbacks();
+	tinyktxMemReader reader { &ktx1, 0 };
+	auto ctx = TinyKtx_CreateContext(&readCallbacks, &reader);
+	REQUIRE(TinyKtx_ReadHeader(ctx));
+	REQUIRE(TinyKtx_DepthSliceSize(ctx, 0) == 16 * 3);
+	std::vector<uint8_t> slices(16 * 3 * 3);
+	REQUIRE(TinyKtx_ReadDepthSlices(ctx, 0, 2, 5, slices.data(), slices.size()));
+	for (uint32_t row = 0; row < 3 * 3; ++row) {
+		REQUIRE(memcmp(slices.data() + row * 16, src.data() + (2 * 3 + row) * 15, 15) == 0);
+	}
+	REQUIRE(TinyKtx_ReadDepthSlices(ctx, 1, 3, 4, slices.data(), slices.size()));
+	REQUIRE(memcmp(slices.data(), (uint8_t const *) mipmaps[1] + 3 * 6, 6) == 0);
+	REQUIRE(!TinyKtx_ReadDepthSlices(ctx, 0, 5, 9, slices.data(), slices.size()));
+	REQUIRE(!TinyKtx_ReadDepthSlices(ctx, 0, 0, 4, slices.data(), slices.size()));
+	TinyKtx_DestroyContext(ctx);
+
+	TinyKtx2_Callbacks readCallbacks2 = tinyktx2MemReadCallbacks();
+	tinyktxMemReader reader2 { &ktx2, 0 };
+	auto ctx2 = TinyKtx2_CreateContext(&readCallbacks2, &reader2);
+	REQUIRE(TinyKtx2_ReadHeader(ctx2));
+	REQUIRE(TinyKtx2_DepthSliceSize(ctx2, 0) == 15 * 3);
+	REQUIRE(TinyKtx2_ReadDepthSlices(ctx2, 0, 2, 5, slices.data(), slices.size()));
+	REQUIRE(memcmp(slices.data(), src.data() + 2 * 15 * 3, 15 * 3 * 3) == 0);
+	// only the requested slices are read
+	REQUIRE(reader2.pos == ktx2.size() - 3 * 15 * 3);
+	REQUIRE(TinyKtx2_ReadDepthSlices(ctx2, 1, 0, 4, slices.data(), slices.size()));
+	REQUIRE(memcmp(slices.data(), mipmaps[1], mipmapsizes[1]) == 0);
+	TinyKtx2_DestroyContext(ctx2);
+}
+
+TEST_CASE("TinyKtx GL format mapping round trips", "[TinyKtx Loader]") {
+	uint32_t const ranges[][2] = {
+			{ TKTX_R4G4_UNORM_PACK8, TKTX_ASTC_12x12_SRGB_BLOCK },
+			{ TKTX_PVR_2BPP_UNORM_BLOCK, TKTX_PVR_4BPPA_SRGB_BLOCK },
+	};
+	uint32_t count = 0;
+	for (auto const& range : ranges) {
+		for (uint32_t i = range[0]; i <= range[1]; ++i) {
+			uint32_t glformat, gltype, glinternalformat, typesize;
+			if (!TinyKtx_CrackFormatToGL((TinyKtx_Format) i, &glformat, &gltype, &glinternalformat, &typesize))
+				continue;
+			REQUIRE(TinyKtx_CrackFormatFromGL(glformat, gltype, glinternalformat, typesize) == (TinyKtx_Format) i);
+			count++;
+		}
+	}
+	REQUIRE(count == 143);
+
+	// legacy and alternative encodings
+	REQUIRE(TinyKtx_CrackFormatFromGL(0, 0, TINYKTX_GL_COMPRESSED_LUMINANCE_LATC1, 1) == TKTX_BC4_UNORM_BLOCK);
+	REQUIRE(TinyKtx_CrackFormatFromGL(TINYKTX_GL_FORMAT_RGBA, TINYKTX_GL_TYPE_BYTE, TINYKTX_GL_INTFORMAT_RGBA8, 1) == TKTX_R8G8B8A8_SNORM);
+	REQUIRE(TinyKtx_CrackFormatFromGL(TINYKTX_GL_FORMAT_BGRA, TINYKTX_GL_TYPE_BYTE, TINYKTX_GL_INTFORMAT_RGBA8I, 1) == TKTX_B8G8R8A8_SINT);
+	REQUIRE(TinyKtx_CrackFormatFromGL(TINYKTX_GL_FORMAT_SRGB_ALPHA, TINYKTX_GL_TYPE_UNSIGNED_BYTE, TINYKTX_GL_INTFORMAT_SRGB8, 1) == TKTX_R8G8B8A8_SRGB);
+	REQUIRE(TinyKtx_CrackFormatFromGL(TINYKTX_GL_FORMAT_RGBA, TINYKTX_GL_TYPE_UNSIGNED_BYTE, TINYKTX_GL_INTFORMAT_SRGB8_ALPHA8, 1) == TKTX_R8G8B8A8_SRGB);
+	REQUIRE(TinyKtx_CrackFormatFromGL(TINYKTX_GL_FORMAT_LUMINANCE, TINYKTX_GL_TYPE_UNSIGNED_SHORT, TINYKTX_GL_INTFORMAT_LUMINANCE16, 2) == TKTX_R16_UNORM);
+	// format in the internal format slot
+	REQUIRE(TinyKtx_CrackFormatFromGL(TINYKTX_GL_FORMAT_RED, TINYKTX_GL_TYPE_INT, TINYKTX_GL_FORMAT_RED, 4) == TKTX_R32_SINT);
+	REQUIRE(TinyKtx_CrackFormatFromGL(TINYKTX_GL_FORMAT_RGBA, TINYKTX_GL_TYPE_UNSIGNED_BYTE, TINYKTX_GL_FORMAT_RGBA, 1) == TKTX_R8G8B8A8_UNORM);
+	REQUIRE(TinyKtx_CrackFormatFromGL(TINYKTX_GL_FORMAT_RGBA, TINYKTX_GL_TYPE_DOUBLE, TINYKTX_GL_FORMAT_RGBA, 8) == TKTX_UNDEFINED);
+	REQUIRE(TinyKtx_CrackFormatFromGL(0, 0, TINYKTX_GL_COMPRESSED_ATC_RGB, 1) == TKTX_UNDEFINED);
+}
+
+TEST_CASE("TinyKtx format traits and layouts match the writers", "[TinyKtx Loader]") {
+	TinyKtx_FormatTraits traits;
+	REQUIRE(TinyKtx_GetFormatTraits(TKTX_R8G8B8_UNORM, &traits));
+	REQUIRE((traits.blockWidth == 1 && traits.blockByteSize == 3 && traits.channelCount == 3 && !traits.compressed));
+	REQUIRE(TinyKtx_GetFormatTraits(TKTX_ASTC_10x6_SRGB_BLOCK, &traits));
+	REQUIRE((traits.blockWidth == 10 && traits.blockHeight == 6 && traits.blockDepth == 1 && traits.blockByteSize == 16));
+	REQUIRE(traits.compressed);
+	REQUIRE(!TinyKtx_GetFormatTraits(TKTX_UNDEFINED, &traits));
+
+	TinyKtx_WriteCallbacks callbacks = tinyktxMemWriteCallbacks();
+	TinyKtx2_WriteCallbacks callbacks2 = tinyktx2MemWriteCallbacks();
+	// width, height, depth, layers, faces, levels
+	uint32_t const shapes[][6] = {
+			{ 13, 9, 1, 1, 1, 3 },
+			{ 5, 5, 1, 0, 6, 3 },
+			{ 8, 8, 1, 3, 6, 4 },
+			{ 7, 5, 3, 1, 1, 2 },
+			{ 3, 1, 1, 4, 1, 2 },
+	};
+	uint32_t const ranges[][2] = {
+			{ TKTX_R4G4_UNORM_PACK8, TKTX_ASTC_12x12_SRGB_BLOCK },
+			{ TKTX_PVR_2BPP_UNORM_BLOCK, TKTX_PVR_4BPPA_SRGB_BLOCK },
+	};
+	uint32_t count = 0;
+	for (auto const& range : ranges) {
+		for (uint32_t f = range[0]; f <= range[1]; ++f) {
+			TinyKtx_Format const format = (TinyKtx_Format) f;
+			if (!TinyKtx_GetFormatTraits(format, &traits))
+				continue;
+			count++;
+			for (auto const& s : shapes) {
+				bool const cubemap = s[4] == 6;
+				TinyKtx_Layout layout;
+				TinyKtx_WriteLayout ktx1;
+				REQUIRE(TinyKtx_ComputeLayout(format, s[0], s[1], s[2], s[3], s[4], s[5], TKTX_CONTAINER_KTX1, &layout));
+				REQUIRE(TinyKtx_ComputeWriteLayout(&callbacks, nullptr, s[0], s[1], s[2], s[3], s[5], format, cubemap, nullptr, &ktx1));
+				REQUIRE(layout.totalByteLength == ktx1.totalByteLength);
+				for (uint32_t i = 0; i < s[5]; ++i) {
+					REQUIRE(layout.level[i].byteOffset == ktx1.levels[i].dataOffset);
+					REQUIRE(layout.level[i].faceByteLength == ktx1.levels[i].faceByteLength);
+					REQUIRE(layout.level[i].faceStride == ktx1.levels[i].faceStride);
+				}
+
+				TinyKtx2_WriteLayout ktx2;
+				REQUIRE(TinyKtx_ComputeLayout(format, s[0], s[1], s[2], s[3], s[4], s[5], TKTX_CONTAINER_KTX2, &layout));
+				REQUIRE(TinyKtx2_ComputeWriteLayout64(&callbacks2, nullptr, s[0], s[1], s[2], s[3], s[5], format, cubemap, nullptr, &ktx2));
+				REQUIRE(layout.totalByteLength == ktx2.totalByteLength);
+				for (uint32_t i = 0; i < s[5]; ++i) {
+					REQUIRE(layout.level[i].byteOffset == ktx2.levels[i].byteOffset);
+					REQUIRE(layout.level[i].byteLength == ktx2.levels[i].byteLength);
+					REQUIRE(layout.level[i].faceByteLength == ktx2.levels[i].faceByteLength);
+				}
+			}
+		}
+	}
+	REQUIRE(count == 143);
+
+	// 13x9 BC7 cubemap array of 2, 4x3 blocks of 16 bytes per face
+	TinyKtx_Layout layout;
+	REQUIRE(TinyKtx_ComputeLayout(TKTX_BC7_UNORM_BLOCK, 13, 9, 1, 2, 6, 2, TKTX_CONTAINER_KTX1, &layout));
+	REQUIRE(layout.level[0].rowStride == 64);
+	REQUIRE(layout.level[0].packedByteLength == 12 * 12 * 16);
+	REQUIRE(TinyKtx_LayoutImageOffset(&layout, 0, 1, 2) == 68 + 8 * 192);
+	REQUIRE(TinyKtx_LayoutImageOffset(&layout, 1, 0, 0) == 68 + 12 * 192 + 4);
+	REQUIRE(TinyKtx_LayoutImageOffset(&layout, 0, 2, 0) == 0);
+	// RGB8 rows are padded to 4 bytes in KTX v1 but not KTX v2
+	REQUIRE(TinyKtx_ComputeLayout(TKTX_R8G8B8_UNORM, 5, 3, 1, 1, 1, 1, TKTX_CONTAINER_KTX1, &layout));
+	REQUIRE((layout.level[0].rowStride == 16 && layout.level[0].faceByteLength == 48));
+	REQUIRE(TinyKtx_ComputeLayout(TKTX_R8G8B8_UNORM, 5, 3, 1, 1, 1, 1, TKTX_CONTAINER_KTX2, &layout));
+	REQUIRE((layout.level[0].rowStride == 15 && layout.level[0].faceByteLength == 45));
+	REQUIRE(!TinyKtx_ComputeLayout(TKTX_R8G8B8_UNORM, 5, 3, 1, 1, 2, 1, TKTX_CONTAINER_KTX1, &layout));
+	REQUIRE(!TinyKtx_ComputeLayout(TKTX_R8G8B8_UNORM, 5, 3, 1, 1, 1, 0, TKTX_CONTAINER_KTX1, &layout));
+}
+
+TEST_CASE("TinyKtx read levels expanded to RGBA8", "[TinyKtx Loader]") {
+	TinyKtx_WriteCallbacks callbacks = tinyktxMemWriteCallbacks();
+	// 37 BGR pixels is 111 bytes, padded to 112 per row in the file
+	uint32_t const w = 37, h = 5;
+	std::vector<uint8_t> src(w * h * 3 + (w / 2) * (h / 2) * 3);
+	for (size_t i = 0; i < src.size(); ++i) src[i] = (uint8_t) (i * 7 + 1);
+	void const *mipmaps[] = { src.data(), src.data() + w * h * 3 };
+	std::vector<uint8_t> ktx;
+	REQUIRE(TinyKtx_WriteImage(&callbacks, &ktx, w, h, 1, 1, 2, TKTX_B8G8R8_UNORM, false, nullptr, mipmaps));
+
+	// whole rows per read and a limit smaller than a row
+	for (size_t maxChunkSize : { (size_t) 0, (size_t) 50 }) {
+		TinyKtx_Callbacks readCallbacks = tinyktxMemReadCallbacks(maxChunkSize);
+		tinyktxMemReader reader { &ktx, 0 };
+		auto ctx = TinyKtx_CreateContext(&readCallbacks, &reader);
+		REQUIRE(TinyKtx_ReadHeader(ctx));
+		REQUIRE(TinyKtx_LevelSizeAs(ctx, 0, TKTX_R8G8B8A8_UNORM) == w * h * 4);
+		REQUIRE(TinyKtx_LevelSizeAs(ctx, 0, TKTX_R8G8B8A8_UINT) == 0);
+		REQUIRE(TinyKtx_LevelSizeAs(ctx, 0, TKTX_R16G16B16A16_UNORM) == 0);
+		for (uint32_t level = 0; level < 2; ++level) {
+			uint32_t const lw = level ? w / 2 : w, lh = level ? h / 2 : h;
+			uint8_t const *expected = (uint8_t const *) mipmaps[level];
+			std::vector<uint8_t> rgba(lw * lh * 4);
+			REQUIRE(TinyKtx_ReadLevelAs(ctx, level, TKTX_R8G8B8A8_UNORM, rgba.data(), rgba.size()));
+			for (uint32_t i = 0; i < lw * lh; ++i) {
+				REQUIRE(rgba[i * 4 + 0] == expected[i * 3 + 2]);
+				REQUIRE(rgba[i * 4 + 1] == expected[i * 3 + 1]);
+				REQUIRE(rgba[i * 4 + 2] == expected[i * 3 + 0]);
+				REQUIRE(rgba[i * 4 + 3] == 0xFF);
+			}
+			// the file's own format just drops the row padding
+			std::vector<uint8_t> bgr(lw * lh * 3);
+			REQUIRE(TinyKtx_ReadLevelAs(ctx, level, TKTX_B8G8R8_UNORM, bgr.data(), bgr.size()));
+			REQUIRE(memcmp(bgr.data(), expected, bgr.size()) == 0);
+			REQUIRE(!TinyKtx_ReadLevelAs(ctx, level, TKTX_R8G8B8A8_UNORM, rgba.data(), rgba.size() - 1));
+		}
+		TinyKtx_DestroyContext(ctx);
+	}
+
+	// luminance alpha loads as R8G8 but expands to LLLA
+	std::vector<uint8_t> la(w * h * 2);
+	for (size_t i = 0; i < la.size(); ++i) la[i] = (uint8_t) (i * 3);
+	void const *laMipmaps[] = { la.data() };
+	std::vector<uint8_t> laKtx;
+	REQUIRE(TinyKtx_WriteImageGL(&callbacks, &laKtx, w, h, 1, 1, 1,
+															 TINYKTX_GL_FORMAT_LUMINANCE_ALPHA, TINYKTX_GL_INTFORMAT_LUMINANCE8_ALPHA8,
+															 TINYKTX_GL_FORMAT_LUMINANCE_ALPHA, TINYKTX_GL_TYPE_UNSIGNED_BYTE, 1, false,
+															 nullptr, laMipmaps));
+	TinyKtx_Callbacks readCallbacks = tinyktxMemReadCallbacks();
+	tinyktxMemReader reader { &laKtx, 0 };
+	auto ctx = TinyKtx_CreateContext(&readCallbacks, &reader);
+	REQUIRE(TinyKtx_ReadHeader(ctx));
+	REQUIRE(TinyKtx_GetFormat(ctx) == TKTX_R8G8_UNORM);
+	std::vector<uint8_t> rgba(w * h * 4);
+	REQUIRE(TinyKtx_ReadLevelAs(ctx, 0, TKTX_R8G8B8A8_UNORM, rgba.data(), rgba.size()));
+	for (uint32_t i = 0; i < w * h; ++i) {
+		REQUIRE(rgba[i * 4 + 0] == la[i * 2]);
+		REQUIRE(rgba[i * 4 + 1] == la[i * 2]);
+		REQUIRE(rgba[i * 4 + 2] == la[i * 2]);
+		REQUIRE(rgba[i * 4 + 3] == la[i * 2 + 1]);
+	}
+	TinyKtx_DestroyContext(ctx);
+}
+
+TEST_CASE("TinyKtx half and packed float conversions", "[TinyKtx Loader]") {
+	// every half survives a round trip, nans stay nans
+	std::vector<uint16_t> halfs(65536), back(65536);
+	std::vector<float> floats(65536);
+	for (uint32_t i = 0; i < 65536; ++i) halfs[i] = (uint16_t) i;
+	REQUIRE(TinyKtx_FormatToFloat(TKTX_R16G16B16A16_SFLOAT, halfs.data(), floats.data(), 65536 / 4));
+	REQUIRE(TinyKtx_FormatFromFloat(TKTX_R16G16B16A16_SFLOAT, floats.data(), back.data(), 65536 / 4));
+	for (uint32_t i = 0; i < 65536; ++i) {
+		if ((i & 0x7C00) == 0x7C00 && (i & 0x3FF)) {
+			REQUIRE(floats[i] != floats[i]);
+		} else {
+			REQUIRE(back[i] == halfs[i]);
+		}
+	}
+	REQUIRE(floats[0x3C00] == 1.0f);
+	REQUIRE(floats[0xC000] == -2.0f);
+	REQUIRE(floats[0x0001] == 1.0f / 16777216.0f);
+	REQUIRE(floats[0x7BFF] == 65504.0f);
+	float const odd[] = { 1.0f + 1.0f / 2048.0f, 1.0f + 3.0f / 2048.0f, 1e6f, -1e6f };
+	uint16_t oddHalfs[4];
+	REQUIRE(TinyKtx_FormatFromFloat(TKTX_R16_SFLOAT, odd, oddHalfs, 4));
+	REQUIRE(oddHalfs[0] == 0x3C00); // ties to even
+	REQUIRE(oddHalfs[1] == 0x3C02);
+	REQUIRE(oddHalfs[2] == 0x7C00);
+	REQUIRE(oddHalfs[3] == 0xFC00);
+
+	// every 11 and 10 bit value survives too
+	std::vector<uint32_t> packed(2048), packedBack(2048);
+	std::vector<float> rgb(2048 * 3);
+	for (uint32_t i = 0; i < 2048; ++i) {
+		uint32_t const r = i, g = 2047 - i, b = i & 0x3FF;
+		bool const nan = ((r >> 6) == 0x1F && (r & 0x3F)) || ((g >> 6) == 0x1F && (g & 0x3F)) || ((b >> 5) == 0x1F && (b & 0x1F));
+		packed[i] = nan ? 0 : r | (g << 11) | (b << 22);
+	}
+	REQUIRE(TinyKtx_FormatToFloat(TKTX_B10G11R11_UFLOAT_PACK32, packed.data(), rgb.data(), 2048));
+	REQUIRE(TinyKtx_FormatFromFloat(TKTX_B10G11R11_UFLOAT_PACK32, rgb.data(), packedBack.data(), 2048));
+	REQUIRE(packedBack == packed);
+	float const clamps[] = { -1.0f, 1e10f, 1.0f };
+	uint32_t clamped;
+	REQUIRE(TinyKtx_FormatFromFloat(TKTX_B10G11R11_UFLOAT_PACK32, clamps, &clamped, 1));
+	REQUIRE(clamped == (0u | (0x7BFu << 11) | (0x1E0u << 22)));
+
+	// shared exponent
+	float const colours[] = { 1.0f, 0.5f, 0.25f, 0.0f, 0.0f, 0.0f, 70000.0f, -3.0f, 65408.0f };
+	uint32_t e5[3];
+	float decoded[9];
+	REQUIRE(TinyKtx_FormatFromFloat(TKTX_E5B9G9R9_UFLOAT_PACK32, colours, e5, 3));
+	REQUIRE(e5[0] == ((16u << 27) | (64u << 18) | (128u << 9) | 256u));
+	REQUIRE(TinyKtx_FormatToFloat(TKTX_E5B9G9R9_UFLOAT_PACK32, e5, decoded, 3));
+	REQUIRE((decoded[0] == 1.0f && decoded[1] == 0.5f && decoded[2] == 0.25f));
+	REQUIRE((decoded[3] == 0.0f && decoded[4] == 0.0f && decoded[5] == 0.0f));
+	REQUIRE((decoded[6] == 65408.0f && decoded[7] == 0.0f && decoded[8] == 65408.0f));
+	REQUIRE(!TinyKtx_FormatToFloat(TKTX_R8G8B8A8_UNORM, e5, decoded, 1));
+
+	// and fused with the read
+	TinyKtx_WriteCallbacks callbacks = tinyktxMemWriteCallbacks();
+	void const *mipmaps[] = { halfs.data() };
+	std::vector<uint8_t> ktx;
+	REQUIRE(TinyKtx_WriteImage(&callbacks, &ktx, 64, 64, 1, 1, 1, TKTX_R16G16B16A16_SFLOAT, false, nullptr, mipmaps));
+	TinyKtx_Callbacks readCallbacks = tinyktxMemReadCallbacks(1000);
+	tinyktxMemReader reader { &ktx, 0 };
+	auto ctx = TinyKtx_CreateContext(&readCallbacks, &reader);
+	REQUIRE(TinyKtx_ReadHeader(ctx));
+	REQUIRE(TinyKtx_LevelSizeAs(ctx, 0, TKTX_R32G32B32_SFLOAT) == 0);
+	std::vector<float> loaded(64 * 64 * 4);
+	REQUIRE(TinyKtx_LevelSizeAs(ctx, 0, TKTX_R32G32B32A32_SFLOAT) == loaded.size() * sizeof(float));
+	REQUIRE(TinyKtx_ReadLevelAs(ctx, 0, TKTX_R32G32B32A32_SFLOAT, loaded.data(), loaded.size() * sizeof(float)));
+	REQUIRE(memcmp(loaded.data(), floats.data(), loaded.size() * sizeof(float)) == 0);
+	TinyKtx_DestroyContext(ctx);
+}
+
+TEST_CASE("TinyKtx sRGB decode and premultiply", "[TinyKtx Loader]") {
+	// every code decodes to the sRGB curve and encodes back to itself
+	uint8_t codes[256 * 4];
+	for (uint32_t i = 0; i < 256; ++i) {
+		codes[i * 4 + 0] = (uint8_t) i;
+		codes[i * 4 + 1] = (uint8_t) (255 - i);
+		codes[i * 4 + 2] = (uint8_t) (i * 3);
+		codes[i * 4 + 3] = (uint8_t) i;
+	}
+	float linear[256 * 4];
+	uint8_t back[256 * 4];
+	REQUIRE(TinyKtx_DecodeColor(TKTX_R8G8B8A8_SRGB, TKTX_COLOR_LINEAR, codes, linear, 256));
+	for (uint32_t i = 0; i < 256; ++i) {
+		double const s = i / 255.0;
+		double const l = (s <= 0.04045) ? s / 12.92 : pow((s + 0.055) / 1.055, 2.4);
+		REQUIRE(fabs(linear[i * 4] - l) < 1e-6);
+		REQUIRE(linear[i * 4 + 3] == i / 255.0f);
+	}
+	REQUIRE(TinyKtx_EncodeColor(TKTX_R8G8B8A8_SRGB, TKTX_COLOR_LINEAR, linear, back, 256));
+	REQUIRE(memcmp(back, codes, sizeof(codes)) == 0);
+	// without the linear flag sRGB data is just unorm
+	REQUIRE(TinyKtx_DecodeColor(TKTX_R8G8B8A8_SRGB, 0, codes, linear, 256));
+	REQUIRE(linear[188 * 4] == 188 / 255.0f);
+
+	// premultiplied in linear, BGRA in the file
+	uint8_t const bgra[] = { 0, 128, 255, 128, 200, 100, 50, 255, 10, 20, 30, 0 };
+	float premultiplied[3 * 4];
+	uint8_t bgraBack[12];
+	REQUIRE(TinyKtx_DecodeColor(TKTX_B8G8R8A8_SRGB, TKTX_COLOR_LINEAR | TKTX_COLOR_PREMULTIPLIED, bgra, premultiplied, 3));
+	REQUIRE(premultiplied[0] == 1.0f * (128 / 255.0f));
+	REQUIRE(premultiplied[2] == 0.0f);
+	REQUIRE((premultiplied[8] == 0.0f && premultiplied[11] == 0.0f));
+	REQUIRE(TinyKtx_EncodeColor(TKTX_B8G8R8A8_SRGB, TKTX_COLOR_LINEAR | TKTX_COLOR_PREMULTIPLIED, premultiplied, bgraBack, 3));
+	REQUIRE(memcmp(bgraBack, bgra, 8) == 0);
+	REQUIRE(bgraBack[11] == 0);
+	REQUIRE(!TinyKtx_DecodeColor(TKTX_R8G8B8A8_UINT, 0, codes, linear, 1));
+
+	// fused with the read, from an RGB file with row padding
+	TinyKtx_WriteCallbacks callbacks = tinyktxMemWriteCallbacks();
+	uint32_t const w = 19, h = 7;
+	std::vector<uint8_t> rgb(w * h * 3);
+	for (size_t i = 0; i < rgb.size(); ++i) rgb[i] = (uint8_t) (i * 11);
+	void const *mipmaps[] = { rgb.data() };
+	std::vector<uint8_t> ktx;
+	REQUIRE(TinyKtx_WriteImage(&callbacks, &ktx, w, h, 1, 1, 1, TKTX_R8G8B8_SRGB, false, nullptr, mipmaps));
+	std::vector<float> expected(w * h * 4);
+	REQUIRE(TinyKtx_DecodeColor(TKTX_R8G8B8_SRGB, TKTX_COLOR_LINEAR, rgb.data(), expected.data(), w * h));
+	std::vector<uint16_t> expectedHalfs(w * h * 4);
+	REQUIRE(TinyKtx_FormatFromFloat(TKTX_R16G16B16A16_SFLOAT, expected.data(), expectedHalfs.data(), w * h));
+
+	TinyKtx_Callbacks readCallbacks = tinyktxMemReadCallbacks();
+	tinyktxMemReader reader { &ktx, 0 };
+	auto ctx = TinyKtx_CreateContext(&readCallbacks, &reader);
+	REQUIRE(TinyKtx_ReadHeader(ctx));
+	std::vector<float> loaded(w * h * 4);
+	REQUIRE(TinyKtx_ReadLevelAsColor(ctx, 0, TKTX_R32G32B32A32_SFLOAT, TKTX_COLOR_LINEAR, loaded.data(), loaded.size() * sizeof(float)));
+	REQUIRE(loaded == expected);
+	std::vector<uint16_t> loadedHalfs(w * h * 4);
+	REQUIRE(TinyKtx_LevelSizeAs(ctx, 0, TKTX_R16G16B16A16_SFLOAT) == loadedHalfs.size() * 2);
+	REQUIRE(TinyKtx_ReadLevelAsColor(ctx, 0, TKTX_R16G16B16A16_SFLOAT, TKTX_COLOR_LINEAR, loadedHalfs.data(), loadedHalfs.size() * 2));
+	REQUIRE(loadedHalfs == expectedHalfs);
+	std::vector<uint8_t> rgba(w * h * 4);
+	REQUIRE(!TinyKtx_ReadLevelAsColor(ctx, 0, TKTX_R8G8B8A8_SRGB, TKTX_COLOR_LINEAR, rgba.data(), rgba.size()));
+	TinyKtx_DestroyContext(ctx);
+}
+
+// writes count bits of value at bit pos of a 128 bit block, LSB first like BC6H/BC7
+static void tinyktxTestPutBits(uint8_t *block, uint32_t &pos, uint32_t value, uint32_t count) {
+	for (uint32_t i = 0; i < count; ++i, ++pos) {
+		if ((value >> i) & 1) block[pos / 8] |= (uint8_t) (1u << (pos % 8));
+	}
+}
+
+TEST_CASE("TinyKtx decode BC1 to BC7 blocks", "[TinyKtx Decode]") {
+	// BC1 4 colour (red to blue) and 3 colour blocks, pixels 0-3 use indices 0-3
+	uint8_t const bc1[16] = { 0x00, 0xF8, 0x1F, 0x00, 0xE4, 0, 0, 0, 0x1F, 0x00, 0x00, 0xF8, 0xE4, 0, 0, 0 };
+	uint8_t rgba[16 * 4 * 2];
+	REQUIRE(TinyKtx_DecodeImages(TKTX_BC1_RGBA_UNORM_BLOCK, 4, 4, 2, bc1, sizeof(bc1), TKTX_R8G8B8A8_UNORM, rgba, sizeof(rgba), nullptr, nullptr));
+	uint8_t const fourColors[] = { 255, 0, 0, 255, 0, 0, 255, 255, 170, 0, 85, 255, 85, 0, 170, 255 };
+	REQUIRE(memcmp(rgba, fourColors, sizeof(fourColors)) == 0);
+	REQUIRE((rgba[4 * 4] == 255 && rgba[15 * 4 + 3] == 255));
+	uint8_t const threeColors[] = { 0, 0, 255, 255, 255, 0, 0, 255, 128, 0, 128, 255, 0, 0, 0, 0 };
+	REQUIRE(memcmp(rgba + 64, threeColors, sizeof(threeColors)) == 0);
+	// BC1 without alpha makes index 3 opaque black
+	REQUIRE(TinyKtx_DecodeImages(TKTX_BC1_RGB_SRGB_BLOCK, 4, 4, 2, bc1, sizeof(bc1), TKTX_R8G8B8A8_SRGB, rgba, sizeof(rgba), nullptr, nullptr));
+	REQUIRE((rgba[64 + 12] == 0 && rgba[64 + 15] == 255));
+
+	// BC3 alpha ramp 255 to 0 (index 2 = 219) and BC2 explicit alpha, both over the red block
+	uint8_t bc3[16] = { 255, 0, 0x88, 0, 0, 0, 0, 0 };
+	memcpy(bc3 + 8, bc1, 8);
+	REQUIRE(TinyKtx_DecodeImages(TKTX_BC3_UNORM_BLOCK, 4, 4, 1, bc3, sizeof(bc3), TKTX_R8G8B8A8_UNORM, rgba, sizeof(rgba), nullptr, nullptr));
+	REQUIRE((rgba[3] == 255 && rgba[7] == 0 && rgba[11] == 219 && rgba[15] == 255));
+	REQUIRE((rgba[8] == 170 && rgba[10] == 85));
+	uint8_t bc2[16] = { 0x3F, 0, 0, 0, 0, 0, 0, 0xF0 };
+	memcpy(bc2 + 8, bc1, 8);
+	REQUIRE(TinyKtx_DecodeImages(TKTX_BC2_UNORM_BLOCK, 4, 4, 1, bc2, sizeof(bc2), TKTX_R8G8B8A8_UNORM, rgba, sizeof(rgba), nullptr, nullptr));
+	REQUIRE((rgba[3] == 255 && rgba[7] == 51 && rgba[11] == 0 && rgba[63] == 255));
+
+	// BC4/BC5, the snorm endpoint -128 is clamped to -127
+	uint8_t const bc5[16] = { 255, 0, 0x88, 0, 0, 0, 0, 0, 0x80, 0x7F, 0x88, 0, 0, 0, 0, 0 };
+	uint8_t rg[16 * 2];
+	REQUIRE(TinyKtx_DecodeImages(TKTX_BC4_UNORM_BLOCK, 4, 4, 1, bc5, 8, TKTX_R8_UNORM, rg, 16, nullptr, nullptr));
+	REQUIRE((rg[0] == 255 && rg[1] == 0 && rg[2] == 219 && rg[3] == 255));
+	REQUIRE(TinyKtx_DecodeImages(TKTX_BC5_SNORM_BLOCK, 4, 4, 1, bc5, sizeof(bc5), TKTX_R8G8B8A8_SNORM, rgba, sizeof(rgba), nullptr, nullptr));
+	// 6 value signed ramp as a0 (-127) <= a1 (127): index 2 = (4 * -127 + 127) / 5
+	REQUIRE(((int8_t) rgba[1] == -127 && (int8_t) rgba[5] == 127 && (int8_t) rgba[9] == -76));
+	REQUIRE((rgba[2] == 0 && rgba[3] == 127));
+	REQUIRE(!TinyKtx_CanDecode(TKTX_BC5_SNORM_BLOCK, TKTX_R8G8_UNORM));
+	REQUIRE(TinyKtx_CanDecode(TKTX_BC5_UNORM_BLOCK, TKTX_R8G8_UNORM));
+
+	// BC7 mode 6, pixel i uses index i from endpoint (255, 1, 129, 255) to (0, 254, 128, 254)
+	uint8_t bc7[16] = {};
+	uint32_t pos = 0;
+	tinyktxTestPutBits(bc7, pos, 1u << 6, 7);
+	uint32_t const endpoints7[] = { 0x7F, 0, 0, 0x7F, 0x40, 0x40, 0x7F, 0x7F, 1, 0 };
+	for (uint32_t i = 0; i < 8; ++i) tinyktxTestPutBits(bc7, pos, endpoints7[i], 7);
+	tinyktxTestPutBits(bc7, pos, endpoints7[8], 1);
+	tinyktxTestPutBits(bc7, pos, endpoints7[9], 1);
+	for (uint32_t i = 0; i < 16; ++i) tinyktxTestPutBits(bc7, pos, i, i == 0 ? 3 : 4);
+	REQUIRE(pos == 128);
+	REQUIRE(TinyKtx_DecodeImages(TKTX_BC7_UNORM_BLOCK, 4, 4, 1, bc7, sizeof(bc7), TKTX_R8G8B8A8_UNORM, rgba, sizeof(rgba), nullptr, nullptr));
+	uint8_t const bc7First[] = { 255, 1, 129, 255 };
+	uint8_t const bc7Middle[] = { 120, 135, 128, 254 };
+	uint8_t const bc7Last[] = { 0, 254, 128, 254 };
+	REQUIRE(memcmp(rgba, bc7First, 4) == 0);
+	REQUIRE(memcmp(rgba + 8 * 4, bc7Middle, 4) == 0);
+	REQUIRE(memcmp(rgba + 15 * 4, bc7Last, 4) == 0);
+	// mode 8 (no mode bit set) is reserved and decodes to 0
+	memset(bc7, 0, sizeof(bc7));
+	REQUIRE(TinyKtx_DecodeImages(TKTX_BC7_SRGB_BLOCK, 4, 4, 1, bc7, sizeof(bc7), TKTX_R8G8B8A8_SRGB, rgba, sizeof(rgba), nullptr, nullptr));
+	REQUIRE((rgba[0] == 0 && rgba[63] == 0));
+
+	// BC6H mode 11 (10 bit endpoints, no deltas), 0 to the max 0x3FF (65504)
+	uint8_t bc6h[16] = {};
+	pos = 0;
+	tinyktxTestPutBits(bc6h, pos, 0x03, 5);
+	uint32_t const endpoints6[] = { 0, 0x200, 0x3FF, 0x3FF, 0x3FF, 0x3FF };
+	for (uint32_t i = 0; i < 6; ++i) tinyktxTestPutBits(bc6h, pos, endpoints6[i], 10);
+	for (uint32_t i = 0; i < 16; ++i) tinyktxTestPutBits(bc6h, pos, i, i == 0 ? 3 : 4);
+	REQUIRE(pos == 128);
+	uint16_t halfs[16 * 4];
+	REQUIRE(TinyKtx_DecodeImages(TKTX_BC6H_UFLOAT_BLOCK, 4, 4, 1, bc6h, sizeof(bc6h), TKTX_R16G16B16A16_SFLOAT, halfs, sizeof(halfs), nullptr, nullptr));
+	REQUIRE((halfs[0] == 0 && halfs[1] == 0x3E0F && halfs[2] == 0x7BFF && halfs[3] == 0x3C00));
+	REQUIRE((halfs[15 * 4 + 0] == 0x7BFF && halfs[15 * 4 + 1] == 0x7BFF && halfs[15 * 4 + 3] == 0x3C00));
+	REQUIRE(halfs[8 * 4] == 0x41DF);
+	// the same bits signed, 0x3FF is -1 which unquantizes to -96
+	REQUIRE(TinyKtx_DecodeImages(TKTX_BC6H_SFLOAT_BLOCK, 4, 4, 1, bc6h, sizeof(bc6h), TKTX_R16G16B16A16_SFLOAT, halfs, sizeof(halfs), nullptr, nullptr));
+	REQUIRE((halfs[2] == 0x805D && halfs[15 * 4] == 0x805D));
+	REQUIRE(!TinyKtx_CanDecode(TKTX_BC6H_UFLOAT_BLOCK, TKTX_R8G8B8A8_UNORM));
+}
+
+TEST_CASE("TinyKtx decode levels in parallel", "[TinyKtx Decode]") {
+	// 2 images of 10x6 pixels (3x2 blocks), edge blocks are clipped
+	uint32_t const w = 10, h = 6, images = 2;
+	std::vector<uint8_t> blocks(3 * 2 * 16 * images);
+	for (size_t i = 0; i < blocks.size(); ++i) blocks[i] = (uint8_t) (i * 37 + (i >> 4));
+	std::vector<uint8_t> serial(w * h * 4 * images);
+	std::vector<uint8_t> parallel(serial.size());
+	REQUIRE(TinyKtx_DecodeImages(TKTX_BC3_UNORM_BLOCK, w, h, images, blocks.data(), blocks.size(), TKTX_R8G8B8A8_UNORM, serial.data(), serial.size(), nullptr, nullptr));
+	uint32_t dispatched = 0;
+	REQUIRE(TinyKtx_DecodeImages(TKTX_BC3_UNORM_BLOCK, w, h, images, blocks.data(), blocks.size(), TKTX_R8G8B8A8_UNORM, parallel.data(), parallel.size(), &tinyktxTestDispatch, &dispatched));
+	REQUIRE(dispatched == 2 * images);
+	REQUIRE(serial == parallel);
+
+	// each pixel matches the full block it came from
+	for (uint32_t image = 0; image < images; ++image) {
+		for (uint32_t by = 0; by < 2; ++by) {
+			for (uint32_t bx = 0; bx < 3; ++bx) {
+				uint8_t block[16 * 4];
+				size_t const blockOffset = ((image * 2 + by) * 3 + bx) * 16;
+				REQUIRE(TinyKtx_DecodeImages(TKTX_BC3_UNORM_BLOCK, 4, 4, 1, blocks.data() + blockOffset, 16, TKTX_R8G8B8A8_UNORM, block, sizeof(block), nullptr, nullptr));
+				for (uint32_t y = 0; y < 4 && by * 4 + y < h; ++y) {
+					for (uint32_t x = 0; x < 4 && bx * 4 + x < w; ++x) {
+						size_t const p = ((size_t) image * h * w + (by * 4 + y) * w + bx * 4 + x) * 4;
+						REQUIRE(memcmp(&serial[p], &block[(y * 4 + x) * 4], 4) == 0);
+					}
+				}
+			}
+		}
+	}
+
+	// sizes are checked
+	REQUIRE(!TinyKtx_DecodeImages(TKTX_BC3_UNORM_BLOCK, w, h, images, blocks.data(), blocks.size() - 1, TKTX_R8G8B8A8_UNORM, serial.data(), serial.size(), nullptr, nullptr));
+	REQUIRE(!TinyKtx_DecodeImages(TKTX_BC3_UNORM_BLOCK, w, h, images, blocks.data(), blocks.size(), TKTX_R8G8B8A8_UNORM, serial.data(), serial.size() - 1, nullptr, nullptr));
+	REQUIRE(!TinyKtx_DecodeImages(TKTX_R8G8B8A8_UNORM, w, h, images, blocks.data(), blocks.size(), TKTX_R8G8B8A8_UNORM, serial.data(), serial.size(), nullptr, nullptr));
+}
+
+TEST_CASE("TinyKtx decode ETC2, EAC and ASTC blocks", "[TinyKtx Decode]") {
+	uint8_t rgba[12 * 12 * 4];
+	// ETC2 individual mode, red on the left, green on the right, every pixel index 0 (+2)
+	uint8_t const individual[8] = { 0xF0, 0x0F, 0x00, 0x00, 0, 0, 0, 0 };
+	REQUIRE(TinyKtx_DecodeImages(TKTX_ETC2_R8G8B8_UNORM_BLOCK, 4, 4, 1, individual, 8, TKTX_R8G8B8A8_UNORM, rgba, sizeof(rgba), nullptr, nullptr));
+	uint8_t const left[] = { 255, 2, 2, 255 };
+	uint8_t const right[] = { 2, 255, 2, 255 };
+	REQUIRE(memcmp(rgba + (1 * 4 + 1) * 4, left, 4) == 0);
+	REQUIRE(memcmp(rgba + (3 * 4 + 2) * 4, right, 4) == 0);
+
+	// differential and flipped (top and bottom halves), table 7 on top. Pixel (0,0) is index 1
+	// (+183), (0,3) index 3 (-8) and (1,0) index 2 (-47)
+	uint8_t differential[8] = { (16 << 3) | 1, 0, 31 << 3, 0xE3, 0x00, 0x18, 0x00, 0x09 };
+	REQUIRE(TinyKtx_DecodeImages(TKTX_ETC2_R8G8B8_SRGB_BLOCK, 4, 4, 1, differential, 8, TKTX_R8G8B8A8_SRGB, rgba, sizeof(rgba), nullptr, nullptr));
+	uint8_t const topLeft[] = { 255, 183, 255, 255 };
+	uint8_t const bottomLeft[] = { 132, 0, 247, 255 };
+	uint8_t const topSecond[] = { 85, 0, 208, 255 };
+	REQUIRE(memcmp(rgba, topLeft, 4) == 0);
+	REQUIRE(memcmp(rgba + 12 * 4, bottomLeft, 4) == 0);
+	REQUIRE(memcmp(rgba + 4, topSecond, 4) == 0);
+	// the same block as punch through alpha without the opaque bit, index 2 is transparent black
+	// and index 0 has no modifier
+	differential[3] = 0xE1;
+	REQUIRE(TinyKtx_DecodeImages(TKTX_ETC2_R8G8B8A1_UNORM_BLOCK, 4, 4, 1, differential, 8, TKTX_R8G8B8A8_UNORM, rgba, sizeof(rgba), nullptr, nullptr));
+	uint8_t const transparent[] = { 0, 0, 0, 0 };
+	uint8_t const unmodified[] = { 132, 0, 255, 255 };
+	REQUIRE(memcmp(rgba, topLeft, 4) == 0);
+	REQUIRE(memcmp(rgba + 4, transparent, 4) == 0);
+	REQUIRE(memcmp(rgba + 8, unmodified, 4) == 0);
+
+	// EAC, base 128, multiplier 1 and table 0 (-3 for index 0), pixel (0,0) uses index 7 (+14)
+	uint8_t const eac[16] = { 128, 0x10, 0xE0, 0, 0, 0, 0, 0, 128, 0x10, 0xE0, 0, 0, 0, 0, 0 };
+	uint8_t etcRgba[16];
+	memcpy(etcRgba, eac, 8);
+	memcpy(etcRgba + 8, individual, 8);
+	REQUIRE(TinyKtx_DecodeImages(TKTX_ETC2_R8G8B8A8_UNORM_BLOCK, 4, 4, 1, etcRgba, 16, TKTX_R8G8B8A8_UNORM, rgba, sizeof(rgba), nullptr, nullptr));
+	REQUIRE((rgba[3] == 142 && rgba[7] == 125 && rgba[0] == 255));
+	// R11 is base * 8 + 4 + modifier * multiplier * 8, widened to 16 bits
+	uint16_t channels[16 * 2];
+	REQUIRE(TinyKtx_DecodeImages(TKTX_EAC_R11G11_UNORM_BLOCK, 4, 4, 1, eac, 16, TKTX_R16G16_UNORM, channels, sizeof(channels), nullptr, nullptr));
+	REQUIRE((channels[0] == ((1140 << 5) | (1140 >> 6)) && channels[1] == channels[0]));
+	REQUIRE(channels[2] == ((1004 << 5) | (1004 >> 6)));
+	// signed has no + 4 and clamps to +-1023, so the base 0x80 (-128) and -3 saturate to -32767
+	REQUIRE(TinyKtx_DecodeImages(TKTX_EAC_R11_SNORM_BLOCK, 4, 4, 1, eac, 8, TKTX_R16_SNORM, channels, sizeof(channels), nullptr, nullptr));
+	REQUIRE((int16_t) channels[1] == -32767);
+	REQUIRE(!TinyKtx_CanDecode(TKTX_EAC_R11_SNORM_BLOCK, TKTX_R16_UNORM));
+
+	// ASTC 4x4, a 4x4 grid of 2 bit weights (block mode 0x42), 1 partition of RGB direct (mode 8)
+	// from black to (255, 128, 64) with 8 bit colour values. Pixel i has weight i % 4
+	uint8_t astc[16] = {};
+	uint32_t pos = 0;
+	tinyktxTestPutBits(astc, pos, 0x42, 11);
+	tinyktxTestPutBits(astc, pos, 0, 2);
+	tinyktxTestPutBits(astc, pos, 8, 4);
+	uint32_t const colorValues[] = { 0, 255, 0, 128, 0, 64 };
+	for (uint32_t i = 0; i < 6; ++i) tinyktxTestPutBits(astc, pos, colorValues[i], 8);
+	// weights are stored bit reversed from the top of the block
+	for (uint32_t i = 0; i < 16; ++i) {
+		for (uint32_t b = 0; b < 2; ++b) {
+			uint32_t const bit = 127 - (i * 2 + b);
+			if (((i % 4) >> b) & 1) astc[bit / 8] |= (uint8_t) (1u << (bit % 8));
+		}
+	}
+	REQUIRE(TinyKtx_DecodeImages(TKTX_ASTC_4x4_UNORM_BLOCK, 4, 4, 1, astc, 16, TKTX_R8G8B8A8_UNORM, rgba, sizeof(rgba), nullptr, nullptr));
+	uint8_t const astcFirst[] = { 0, 0, 0, 255 };
+	uint8_t const astcSecond[] = { 84, 42, 21, 255 };
+	uint8_t const astcLast[] = { 255, 128, 64, 255 };
+	REQUIRE(memcmp(rgba, astcFirst, 4) == 0);
+	REQUIRE(memcmp(rgba + 4, astcSecond, 4) == 0);
+	REQUIRE(memcmp(rgba + 15 * 4, astcLast, 4) == 0);
+	REQUIRE(memcmp(rgba + 11 * 4, astcLast, 4) == 0);
+
+	// void extent blocks are one 16 bit colour, here over a clipped 6x5 image of 12x12 blocks
+	uint8_t const voidExtent[16] = { 0xFC, 0xFD, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0x00, 0x10, 0x00, 0x20, 0x00, 0x30, 0xFF, 0xFF };
+	REQUIRE(TinyKtx_DecodeImages(TKTX_ASTC_12x12_SRGB_BLOCK, 6, 5, 1, voidExtent, 16, TKTX_R8G8B8A8_SRGB, rgba, 6 * 5 * 4, nullptr, nullptr));
+	uint8_t const constant[] = { 0x10, 0x20, 0x30, 0xFF };
+	REQUIRE(memcmp(rgba + 29 * 4, constant, 4) == 0);
+	// HDR void extent is an error in LDR and is magenta
+	uint8_t hdr[16];
+	memcpy(hdr, voidExtent, 16);
+	hdr[1] = 0xFF;
+	REQUIRE(TinyKtx_DecodeImages(TKTX_ASTC_12x12_SRGB_BLOCK, 6, 5, 1, hdr, 16, TKTX_R8G8B8A8_SRGB, rgba, 6 * 5 * 4, nullptr, nullptr));
+	uint8_t const magenta[] = { 0xFF, 0, 0xFF, 0xFF };
+	REQUIRE(memcmp(rgba, magenta, 4) == 0);
+}
+
+TEST_CASE("TinyKtx generate mipmaps", "[TinyKtx Decode]") {
+	// 4x4 RGBA8 is 64 + 16 + 4 bytes, compressed and formats without a float path can't be filtered
+	REQUIRE(TinyKtx_MipmapChainSize(TKTX_R8G8B8A8_UNORM, 4, 4, 1, 1, 0) == 84);
+	REQUIRE(TinyKtx_MipmapChainSize(TKTX_R8G8B8A8_UNORM, 4, 4, 0, 6, 2) == 6 * 80);
+	REQUIRE(TinyKtx_MipmapChainSize(TKTX_R8G8B8A8_UNORM, 4, 4, 1, 1, 4) == 0);
+	REQUIRE(TinyKtx_MipmapChainSize(TKTX_BC1_RGB_UNORM_BLOCK, 4, 4, 1, 1, 0) == 0);
+	REQUIRE(TinyKtx_MipmapChainSize(TKTX_R16_UNORM, 4, 4, 1, 1, 0) == 0);
+
+	// box averages 2x2 then the two that are left
+	uint8_t const level0[] = {
+			10, 0, 0, 255, 20, 0, 0, 255, 30, 0, 0, 255, 40, 0, 0, 255,
+			50, 0, 0, 255, 60, 0, 0, 255, 70, 0, 0, 255, 80, 0, 0, 255,
+	};
+	uint8_t chain[32 + 8 + 4];
+	REQUIRE(TinyKtx_MipmapChainSize(TKTX_R8G8B8A8_UNORM, 4, 2, 1, 1, 0) == sizeof(chain));
+	REQUIRE(TinyKtx_GenerateMipmaps(TKTX_R8G8B8A8_UNORM, 4, 2, 1, 1, 0, TKTX_MIPMAP_FILTER_BOX, level0, chain, sizeof(chain), nullptr, nullptr));
+	REQUIRE(memcmp(chain, level0, sizeof(level0)) == 0);
+	REQUIRE((chain[32] == 35 && chain[35] == 255 && chain[36] == 55 && chain[40] == 45));
+	REQUIRE(!TinyKtx_GenerateMipmaps(TKTX_R8G8B8A8_UNORM, 4, 2, 1, 1, 0, TKTX_MIPMAP_FILTER_BOX, level0, chain, sizeof(chain) - 1, nullptr, nullptr));
+
+	// sRGB is averaged in linear, black and white is linear 0.5
+	uint8_t srgb[8 + 4] = { 0, 0, 0, 255, 255, 255, 255, 255 };
+	REQUIRE(TinyKtx_GenerateMipmaps(TKTX_R8G8B8A8_SRGB, 2, 1, 1, 1, 0, TKTX_MIPMAP_FILTER_BOX, srgb, srgb, sizeof(srgb), nullptr, nullptr));
+	REQUIRE((srgb[8] == 188 && srgb[10] == 188 && srgb[11] == 255));
+
+	// odd sizes weight each pixel by its area
+	uint8_t odd[3 + 1] = { 0, 90, 180 };
+	REQUIRE(TinyKtx_GenerateMipmaps(TKTX_R8_UNORM, 3, 1, 1, 1, 0, TKTX_MIPMAP_FILTER_BOX, odd, odd, sizeof(odd), nullptr, nullptr));
+	REQUIRE(odd[3] == 90);
+
+	// volumes are filtered in depth too
+	float volume[8 + 1] = { 1, 2, 3, 4, 5, 6, 7, 8 };
+	REQUIRE(TinyKtx_GenerateMipmaps(TKTX_R32_SFLOAT, 2, 2, 2, 1, 0, TKTX_MIPMAP_FILTER_BOX, volume, volume, sizeof(volume), nullptr, nullptr));
+	REQUIRE(volume[8] == 4.5f);
+
+	// the cubic's weights add up to 1 so flat images stay flat, whatever the size
+	std::vector<uint8_t> flat(TinyKtx_MipmapChainSize(TKTX_R8G8B8A8_UNORM, 13, 7, 1, 1, 0));
+	for (uint32_t i = 0; i < 13 * 7; ++i) {
+		uint8_t const pixel[] = { 200, 100, 50, 128 };
+		memcpy(&flat[i * 4], pixel, 4);
+	}
+	REQUIRE(TinyKtx_GenerateMipmaps(TKTX_R8G8B8A8_UNORM, 13, 7, 1, 1, 0, TKTX_MIPMAP_FILTER_CUBIC, flat.data(), flat.data(), flat.size(), nullptr, nullptr));
+	for (size_t i = 0; i < flat.size(); i += 4) {
+		REQUIRE((flat[i] == 200 && flat[i + 1] == 100 && flat[i + 2] == 50 && flat[i + 3] == 128));
+	}
+}
+
+TEST_CASE("TinyKtx generate mipmaps in parallel", "[TinyKtx Decode]") {
+	// a cubemap with more than one band of rows at the top level
+	uint32_t const size = 40;
+	std::vector<uint8_t> level0(size * size * 4 * 6);
+	for (size_t i = 0; i < level0.size(); ++i) {
+		level0[i] = (uint8_t) ((i * 7919) >> 3);
+	}
+	for (uint32_t f = 0; f < 2; ++f) {
+		TinyKtx_MipmapFilter const filter = f ? TKTX_MIPMAP_FILTER_CUBIC : TKTX_MIPMAP_FILTER_BOX;
+		size_t const chainSize = (size_t) TinyKtx_MipmapChainSize(TKTX_R8G8B8A8_SRGB, size, size, 1, 6, 0);
+		std::vector<uint8_t> serial(chainSize);
+		std::vector<uint8_t> parallel(chainSize);
+		REQUIRE(TinyKtx_GenerateMipmaps(TKTX_R8G8B8A8_SRGB, size, size, 1, 6, 0, filter, level0.data(), serial.data(), serial.size(), nullptr, nullptr));
+		uint32_t dispatched = 0;
+		REQUIRE(TinyKtx_GenerateMipmaps(TKTX_R8G8B8A8_SRGB, size, size, 1, 6, 0, filter, level0.data(), parallel.data(), parallel.size(), &tinyktxTestDispatch, &dispatched));
+		// 20, 10, 5, 2 and 1 rows are 2, 1, 1, 1 and 1 bands per face
+		REQUIRE(dispatched == 6 * 6);
+		REQUIRE(serial == parallel);
+	}
+}
+
+// the writers don't write key/value data, adds an entry to a KTX v1 file
+static void tinyktxTestAddKeyValue(std::vector<uint8_t> &ktx, char const *key, char const *value) {
+	uint32_t const size = (uint32_t) (strlen(key) + 1 + strlen(value) + 1);
+	std::vector<uint8_t> kvd(4 + ((size + 3u) & ~3u));
+	memcpy(kvd.data(), &size, 4);
+	memcpy(kvd.data() + 4, key, strlen(key) + 1);
+	memcpy(kvd.data() + 4 + strlen(key) + 1, value, strlen(value) + 1);
+	uint32_t bytes;
+	memcpy(&bytes, ktx.data() + 60, 4);
+	ktx.insert(ktx.begin() + 64 + bytes, kvd.begin(), kvd.end());
+	bytes += (uint32_t) kvd.size();
+	memcpy(ktx.data() + 60, &bytes, 4);
+}
+
+TEST_CASE("TinyKtx reads levels flipped to the requested origin", "[TinyKtx Loader]") {
+	TinyKtx_WriteCallbacks callbacks = tinyktxMemWriteCallbacks();
+	// a volume of 2 slices so rows are mirrored within each slice, rows are padded in the file
+	uint32_t const w = 5, h = 3, d = 2;
+	std::vector<uint8_t> src(w * h * d * 3);
+	for (size_t i = 0; i < src.size(); ++i) src[i] = (uint8_t) (i * 7 + 1);
+	void const *mipmaps[] = { src.data() };
+	std::vector<uint8_t> ktx;
+	REQUIRE(TinyKtx_WriteImage(&callbacks, &ktx, w, h, d, 0, 1, TKTX_B8G8R8_UNORM, false, nullptr, mipmaps));
+	tinyktxTestAddKeyValue(ktx, "KTXwriter", "tiny_ktx");
+	tinyktxTestAddKeyValue(ktx, "KTXorientation", "S=r,T=u,R=i");
+
+	// whole rows per read and rows read in pieces
+	for (size_t maxChunkSize : { (size_t) 0, (size_t) 6 }) {
+		TinyKtx_Callbacks readCallbacks = tinyktxMemReadCallbacks(maxChunkSize);
+		tinyktxMemReader reader { &ktx, 0 };
+		auto ctx = TinyKtx_CreateContext(&readCallbacks, &reader);
+		REQUIRE(TinyKtx_ReadHeader(ctx));
+		void const *value;
+		REQUIRE(TinyKtx_GetValue(ctx, "KTXwriter", &value));
+		REQUIRE(strcmp((char const *) value, "tiny_ktx") == 0);
+		REQUIRE(TinyKtx_GetValue(ctx, "KTXorientation", &value));
+		REQUIRE(!TinyKtx_GetValue(ctx, "KTXorient", &value));
+		REQUIRE(TinyKtx_GetOrigin(ctx) == TKTX_ORIGIN_BOTTOM_LEFT);
+
+		std::vector<uint8_t> rgba(w * h * d * 4);
+		std::vector<uint8_t> bgr(w * h * d * 3);
+		for (TinyKtx_Origin origin : { TKTX_ORIGIN_FILE, TKTX_ORIGIN_BOTTOM_LEFT, TKTX_ORIGIN_TOP_LEFT }) {
+			TinyKtx_SetReadOrigin(ctx, origin);
+			REQUIRE(TinyKtx_ReadLevelAs(ctx, 0, TKTX_R8G8B8A8_UNORM, rgba.data(), rgba.size()));
+			REQUIRE(TinyKtx_ReadLevelAs(ctx, 0, TKTX_B8G8R8_UNORM, bgr.data(), bgr.size()));
+			for (uint32_t z = 0; z < d; ++z) {
+				for (uint32_t y = 0; y < h; ++y) {
+					uint32_t const fy = (origin == TKTX_ORIGIN_TOP_LEFT) ? h - 1 - y : y;
+					uint8_t const *expected = &src[((z * h + fy) * w) * 3];
+					REQUIRE(memcmp(&bgr[((z * h + y) * w) * 3], expected, w * 3) == 0);
+					REQUIRE(rgba[((z * h + y) * w) * 4] == expected[2]);
+				}
+			}
+		}
+		TinyKtx_DestroyContext(ctx);
+	}
+}
+
+TEST_CASE("TinyKtx flips BC1 to BC5 levels inside the blocks", "[TinyKtx Loader]") {
+	TinyKtx_WriteCallbacks callbacks = tinyktxMemWriteCallbacks();
+	TinyKtx_Callbacks readCallbacks = tinyktxMemReadCallbacks();
+	// 8x8, 4x4 and 2x2, the last is a single part used block row
+	TinyKtx_Format const formats[] = { TKTX_BC1_RGBA_UNORM_BLOCK, TKTX_BC2_UNORM_BLOCK, TKTX_BC3_SRGB_BLOCK, TKTX_BC4_UNORM_BLOCK, TKTX_BC5_SNORM_BLOCK };
+	for (TinyKtx_Format format : formats) {
+		uint32_t blockBytes;
+		TinyKtx_FormatBlockInfo(format, nullptr, nullptr, nullptr, &blockBytes);
+		std::vector<uint8_t> src(blockBytes * 6);
+		for (size_t i = 0; i < src.size(); ++i) src[i] = (uint8_t) ((i * 7919) >> 2);
+		void const *mipmaps[] = { src.data(), src.data() + blockBytes * 4, src.data() + blockBytes * 5 };
+		std::vector<uint8_t> ktx;
+		REQUIRE(TinyKtx_WriteImage(&callbacks, &ktx, 8, 8, 1, 0, 3, format, false, nullptr, mipmaps));
+		tinyktxTestAddKeyValue(ktx, "KTXorientation", "S=r,T=d");
+
+		tinyktxMemReader reader { &ktx, 0 };
+		auto ctx = TinyKtx_CreateContext(&readCallbacks, &reader);
+		REQUIRE(TinyKtx_ReadHeader(ctx));
+		REQUIRE(TinyKtx_GetOrigin(ctx) == TKTX_ORIGIN_TOP_LEFT);
+		TinyKtx_SetReadOrigin(ctx, TKTX_ORIGIN_BOTTOM_LEFT);
+		for (uint32_t level = 0; level < 3; ++level) {
+			uint32_t const size = 8 >> level;
+			uint32_t const blocks = level ? 1 : 4;
+			std::vector<uint8_t> flipped(blocks * blockBytes);
+			REQUIRE(TinyKtx_ReadLevelAs(ctx, level, format, flipped.data(), flipped.size()));
+			// decoded, each row is the mirrored row of the original
+			TinyKtx_Format const dstFormat = (format == TKTX_BC4_UNORM_BLOCK) ? TKTX_R8_UNORM : (format == TKTX_BC5_SNORM_BLOCK) ? TKTX_R8G8_SNORM : TKTX_R8G8B8A8_UNORM;
+			uint32_t pixelBytes;
+			TinyKtx_FormatBlockInfo(dstFormat, nullptr, nullptr, nullptr, &pixelBytes);
+			std::vector<uint8_t> expected(size * size * pixelBytes);
+			std::vector<uint8_t> actual(size * size * pixelBytes);
+			REQUIRE(TinyKtx_DecodeImages(format, size, size, 1, mipmaps[level], blocks * blockBytes, dstFormat, expected.data(), expected.size(), nullptr, nullptr));
+			REQUIRE(TinyKtx_DecodeImages(format, size, size, 1, flipped.data(), flipped.size(), dstFormat, actual.data(), actual.size(), nullptr, nullptr));
+			size_t const rowBytes = size * pixelBytes;
+			for (uint32_t y = 0; y < size; ++y) {
+				REQUIRE(memcmp(&actual[y * rowBytes], &expected[(size - 1 - y) * rowBytes], rowBytes) == 0);
+			}
+		}
+		TinyKtx_DestroyContext(ctx);
+	}
+
+	// formats whose blocks can't be flipped fail rather than load upside down
+	uint8_t bc7[16] = {};
+	void const *bc7Mipmaps[] = { bc7 };
+	std::vector<uint8_t> ktx;
+	REQUIRE(TinyKtx_WriteImage(&callbacks, &ktx, 4, 4, 1, 0, 1, TKTX_BC7_UNORM_BLOCK, false, nullptr, bc7Mipmaps));
+	std::vector<uint8_t> unannotated = ktx;
+	tinyktxTestAddKeyValue(ktx, "KTXorientation", "S=r,T=d");
+	tinyktxMemReader reader { &ktx, 0 };
+	auto ctx = TinyKtx_CreateContext(&readCallbacks, &reader);
+	REQUIRE(TinyKtx_ReadHeader(ctx));
+	uint8_t out[16];
+	REQUIRE(TinyKtx_ReadLevelAs(ctx, 0, TKTX_BC7_UNORM_BLOCK, out, sizeof(out)));
+	TinyKtx_SetReadOrigin(ctx, TKTX_ORIGIN_BOTTOM_LEFT);
+	REQUIRE(!TinyKtx_ReadLevelAs(ctx, 0, TKTX_BC7_UNORM_BLOCK, out, sizeof(out)));
+	TinyKtx_DestroyContext(ctx);
+
+	// without KTXorientation the origin is unknown, it can be read as stored but not to an origin
+	reader = { &unannotated, 0 };
+	ctx = TinyKtx_CreateContext(&readCallbacks, &reader);
+	REQUIRE(TinyKtx_ReadHeader(ctx));
+	REQUIRE(TinyKtx_GetOrigin(ctx) == TKTX_ORIGIN_UNKNOWN);
+	TinyKtx_SetReadOrigin(ctx, TKTX_ORIGIN_TOP_LEFT);
+	REQUIRE(!TinyKtx_ReadLevelAs(ctx, 0, TKTX_BC7_UNORM_BLOCK, out, sizeof(out)));
+	TinyKtx_SetReadOrigin(ctx, TKTX_ORIGIN_FILE);
+	REQUIRE(TinyKtx_ReadLevelAs(ctx, 0, TKTX_BC7_UNORM_BLOCK, out, sizeof(out)));
+	TinyKtx_DestroyContext(ctx);
+}
+
+TEST_CASE("TinyKtx plans the cheapest load into supported formats", "[TinyKtx Loader]") {
+	TinyKtx_WriteCallbacks callbacks = tinyktxMemWriteCallbacks();
+	TinyKtx_Callbacks readCallbacks = tinyktxMemReadCallbacks();
+
+	// BGR with padded rows, a swizzle beats the float read even though float is listed first
+	uint32_t const w = 6, h = 5;
+	std::vector<uint8_t> bgr(w * h * 3 + (w / 2) * (h / 2) * 3);
+	for (size_t i = 0; i < bgr.size(); ++i) bgr[i] = (uint8_t) (i * 7 + 1);
+	void const *bgrMipmaps[] = { bgr.data(), bgr.data() + w * h * 3 };
+	std::vector<uint8_t> ktx;
+	REQUIRE(TinyKtx_WriteImage(&callbacks, &ktx, w, h, 1, 0, 2, TKTX_B8G8R8_UNORM, false, nullptr, bgrMipmaps));
+	tinyktxMemReader reader { &ktx, 0 };
+	auto ctx = TinyKtx_CreateContext(&readCallbacks, &reader);
+	REQUIRE(TinyKtx_ReadHeader(ctx));
+	TinyKtx_Format const gpuFormats[] = { TKTX_R32G32B32A32_SFLOAT, TKTX_R8G8B8A8_UNORM };
+	TinyKtx_LoadPlan plan;
+	REQUIRE(TinyKtx_PlanLoad(ctx, gpuFormats, 2, &plan));
+	REQUIRE(plan.path == TKTX_LOAD_SWIZZLE);
+	REQUIRE(plan.srcFormat == TKTX_B8G8R8_UNORM);
+	REQUIRE(plan.dstFormat == TKTX_R8G8B8A8_UNORM);
+	REQUIRE(plan.levels == 2);
+	REQUIRE(plan.levelSize[0] == w * h * 4);
+	REQUIRE(plan.levelSize[1] == (w / 2) * (h / 2) * 4);
+	REQUIRE(plan.totalSize == plan.levelSize[0] + plan.levelSize[1]);
+	for (uint32_t level = 0; level < 2; ++level) {
+		std::vector<uint8_t> loaded(plan.levelSize[level]);
+		std::vector<uint8_t> expected(plan.levelSize[level]);
+		REQUIRE(TinyKtx_ExecuteLoad(ctx, &plan, level, loaded.data(), loaded.size(), nullptr, nullptr));
+		REQUIRE(TinyKtx_ReadLevelAs(ctx, level, TKTX_R8G8B8A8_UNORM, expected.data(), expected.size()));
+		REQUIRE(loaded == expected);
+	}
+	// the file's own format is just a copy
+	TinyKtx_Format const bgrFormats[] = { TKTX_R8G8B8A8_UNORM, TKTX_B8G8R8_UNORM };
+	REQUIRE(TinyKtx_PlanLoad(ctx, bgrFormats, 2, &plan));
+	REQUIRE(plan.path == TKTX_LOAD_NATIVE);
+	REQUIRE(plan.totalSize == bgr.size());
+	std::vector<uint8_t> level0(plan.levelSize[0]);
+	REQUIRE(TinyKtx_ExecuteLoad(ctx, &plan, 0, level0.data(), level0.size(), nullptr, nullptr));
+	REQUIRE(memcmp(level0.data(), bgr.data(), level0.size()) == 0);
+	REQUIRE(!TinyKtx_ExecuteLoad(ctx, &plan, 2, level0.data(), level0.size(), nullptr, nullptr));
+	REQUIRE(!TinyKtx_ExecuteLoad(ctx, &plan, 0, level0.data(), level0.size() - 1, nullptr, nullptr));
+	// nothing reachable
+	TinyKtx_Format const bcFormats[] = { TKTX_UNDEFINED, TKTX_BC7_UNORM_BLOCK };
+	REQUIRE(!TinyKtx_PlanLoad(ctx, bcFormats, 2, &plan));
+	REQUIRE(plan.path == TKTX_LOAD_NONE);
+	REQUIRE(plan.totalSize == 0);
+	REQUIRE(!TinyKtx_ExecuteLoad(ctx, &plan, 0, level0.data(), level0.size(), nullptr, nullptr));
+	TinyKtx_DestroyContext(ctx);
+
+	// BC4 array decoded on the CPU, R8 is smaller than R8G8B8A8 so it wins
+	std::vector<uint8_t> bc4(8 * (4 + 1) * 2);
+	for (size_t i = 0; i < bc4.size(); ++i) bc4[i] = (uint8_t) ((i * 7919) >> 3);
+	void const *bc4Mipmaps[] = { bc4.data(), bc4.data() + 8 * 4 * 2 };
+	ktx.clear();
+	REQUIRE(TinyKtx_WriteImage(&callbacks, &ktx, 8, 8, 1, 2, 2, TKTX_BC4_UNORM_BLOCK, false, nullptr, bc4Mipmaps));
+	reader.pos = 0;
+	ctx = TinyKtx_CreateContext(&readCallbacks, &reader);
+	REQUIRE(TinyKtx_ReadHeader(ctx));
+	TinyKtx_Format const decodeFormats[] = { TKTX_BC7_UNORM_BLOCK, TKTX_R8G8B8A8_UNORM, TKTX_R8_UNORM };
+	REQUIRE(TinyKtx_PlanLoad(ctx, decodeFormats, 3, &plan));
+	REQUIRE(plan.path == TKTX_LOAD_DECODE);
+	REQUIRE(plan.dstFormat == TKTX_R8_UNORM);
+	REQUIRE(plan.levelSize[0] == 8 * 8 * 2);
+	REQUIRE(plan.levelSize[1] == 4 * 4 * 2);
+	uint32_t dispatched = 0;
+	for (uint32_t level = 0; level < 2; ++level) {
+		uint32_t const size = 8 >> level;
+		std::vector<uint8_t> loaded(plan.levelSize[level]);
+		std::vector<uint8_t> expected(plan.levelSize[level]);
+		REQUIRE(TinyKtx_ExecuteLoad(ctx, &plan, level, loaded.data(), loaded.size(), &tinyktxTestDispatch, &dispatched));
+		REQUIRE(TinyKtx_DecodeImages(TKTX_BC4_UNORM_BLOCK, size, size, 2, bc4Mipmaps[level], 8 * (level ? 1 : 4) * 2,
+																 TKTX_R8_UNORM, expected.data(), expected.size(), nullptr, nullptr));
+		REQUIRE(loaded == expected);
+	}
+	// a task per block row of each layer
+	REQUIRE(dispatched == 2 * 2 + 2);
+	TinyKtx_DestroyContext(ctx);
+
+	// KTX v2 BC1 is copied or decoded
+	TinyKtx2_WriteCallbacks callbacks2 = tinyktx2MemWriteCallbacks();
+	TinyKtx2_Callbacks readCallbacks2 = tinyktx2MemReadCallbacks();
+	uint8_t bc1[8] = { 0x00, 0xF8, 0x1F, 0x00, 0x1B, 0x1B, 0xE4, 0xE4 };
+	void const *bc1Mipmaps[] = { bc1 };
+	ktx.clear();
+	REQUIRE(TinyKtx2_WriteImage(&callbacks2, &ktx, 4, 4, 1, 0, 1, TKTX_BC1_RGB_UNORM_BLOCK, false, nullptr, bc1Mipmaps));
+	reader.pos = 0;
+	auto ctx2 = TinyKtx2_CreateContext(&readCallbacks2, &reader);
+	REQUIRE(TinyKtx2_ReadHeader(ctx2));
+	REQUIRE(TinyKtx2_CanTranscode(ctx2, TKTX_BC1_RGB_UNORM_BLOCK));
+	REQUIRE(!TinyKtx2_CanTranscode(ctx2, TKTX_R8G8B8A8_UNORM));
+	TinyKtx_Format const bc1Formats[] = { TKTX_R8G8B8A8_SRGB, TKTX_BC1_RGB_UNORM_BLOCK };
+	REQUIRE(TinyKtx2_PlanLoad(ctx2, bc1Formats, 2, &plan));
+	REQUIRE(plan.path == TKTX_LOAD_NATIVE);
+	REQUIRE(plan.totalSize == 8);
+	uint8_t copied[8];
+	REQUIRE(TinyKtx2_ExecuteLoad(ctx2, &plan, 0, copied, sizeof(copied), nullptr, nullptr));
+	REQUIRE(memcmp(copied, bc1, 8) == 0);
+	REQUIRE(TinyKtx2_PlanLoad(ctx2, bc1Formats, 1, &plan));
+	REQUIRE(plan.path == TKTX_LOAD_DECODE);
+	REQUIRE(plan.totalSize == 4 * 4 * 4);
+	uint8_t decoded[4 * 4 * 4];
+	uint8_t expected[4 * 4 * 4];
+	REQUIRE(TinyKtx2_ExecuteLoad(ctx2, &plan, 0, decoded, sizeof(decoded), nullptr, nullptr));
+	REQUIRE(TinyKtx_DecodeImages(TKTX_BC1_RGB_UNORM_BLOCK, 4, 4, 1, bc1, 8, TKTX_R8G8B8A8_SRGB, expected, sizeof(expected), nullptr, nullptr));
+	REQUIRE(memcmp(decoded, expected, sizeof(decoded)) == 0);
+	TinyKtx2_DestroyContext(ctx2);
+}
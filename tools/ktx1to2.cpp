@@ -0,0 +1,207 @@
+// ktx1to2 converts every .ktx in a directory to .ktx2, a file per worker thread.
+// Only one level of each file is in memory at a time.
+// usage: ktx1to2 [--zlib] [--threads N] <input dir> <output dir>
+#if !defined(_WIN32) && !defined(_FILE_OFFSET_BITS)
+#define _FILE_OFFSET_BITS 64	// 64 bit off_t for fseeko/ftello on 32 bit systems
+#endif
+#include "tiny_ktx/tinyktx2.h"
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <string>
+#include <thread>
+#include <vector>
+#if KTX1TO2_HAVE_ZLIB
+#include <zlib.h>
+#endif
+
+namespace fs = std::filesystem;
+
+namespace {
+
+struct Job {
+	FILE *in;
+	FILE *out;
+	std::string name;
+	bool failed;
+};
+
+void ErrorFunc(void *user, char const *msg) {
+	Job *job = (Job *) user;
+	fprintf(stderr, "%s: %s\n", job->name.c_str(), msg);
+	job->failed = true;
+}
+void *AllocFunc(void *user, size_t size) {
+	(void) user;
+	return malloc(size);
+}
+void FreeFunc(void *user, void *memory) {
+	(void) user;
+	free(memory);
+}
+
+// long is 32 bit on Windows, levels of 2GB or more need the 64 bit calls
+bool Seek64(FILE *file, uint64_t offset) {
+#if defined(_WIN32)
+	return _fseeki64(file, (__int64) offset, SEEK_SET) == 0;
+#else
+	return fseeko(file, (off_t) offset, SEEK_SET) == 0;
+#endif
+}
+int64_t Tell64(FILE *file) {
+#if defined(_WIN32)
+	return (int64_t) _ftelli64(file);
+#else
+	return (int64_t) ftello(file);
+#endif
+}
+
+size_t ReadFunc(void *user, void *buffer, size_t byteCount) {
+	return fread(buffer, 1, byteCount, ((Job *) user)->in);
+}
+bool SeekFunc(void *user, int64_t offset) {
+	return Seek64(((Job *) user)->in, (uint64_t) offset);
+}
+int64_t TellFunc(void *user) {
+	return Tell64(((Job *) user)->in);
+}
+
+void WriteFunc(void *user, void const *buffer, size_t byteCount) {
+	fwrite(buffer, 1, byteCount, ((Job *) user)->out);
+}
+// each file has its own job so this is only ever called from one thread per FILE
+void PositionalWriteFunc(void *user, uint64_t offset, void const *buffer, size_t byteCount) {
+	Job *job = (Job *) user;
+	if (!Seek64(job->out, offset) ||
+			fwrite(buffer, 1, byteCount, job->out) != byteCount) {
+		ErrorFunc(user, "Write failed");
+	}
+}
+
+#if KTX1TO2_HAVE_ZLIB
+bool ZlibCompress(void *user, void const *src, size_t srcSize, void **dst, size_t *dstSize) {
+	(void) user;
+	uLongf size = compressBound((uLong) srcSize);
+	*dst = malloc(size);
+	if (*dst == nullptr)
+		return false;
+	if (compress2((Bytef *) *dst, &size, (Bytef const *) src, (uLong) srcSize, Z_BEST_COMPRESSION) != Z_OK) {
+		free(*dst);
+		*dst = nullptr;
+		return false;
+	}
+	*dstSize = size;
+	return true;
+}
+#endif
+
+bool Convert(fs::path const &src, fs::path const &dst, bool zlib) {
+#if !KTX1TO2_HAVE_ZLIB
+	(void) zlib;
+#endif
+	Job job{nullptr, nullptr, src.string(), false};
+	job.in = fopen(src.string().c_str(), "rb");
+	if (job.in == nullptr) {
+		ErrorFunc(&job, "Unable to open");
+		return false;
+	}
+	job.out = fopen(dst.string().c_str(), "wb");
+	if (job.out == nullptr) {
+		ErrorFunc(&job, "Unable to create output");
+		fclose(job.in);
+		return false;
+	}
+
+	// maxChunkSize 0, levels are read whole
+	TinyKtx_Callbacks readCallbacks{ErrorFunc, AllocFunc, FreeFunc, ReadFunc, SeekFunc, TellFunc, 0};
+	TinyKtx2_WriteCallbacks writeCallbacks{ErrorFunc, AllocFunc, FreeFunc, WriteFunc, PositionalWriteFunc};
+
+	TinyKtx_ContextHandle ctx = TinyKtx_CreateContext(&readCallbacks, &job);
+	bool okay = TinyKtx_ReadHeader(ctx);
+	if (okay) {
+#if KTX1TO2_HAVE_ZLIB
+		if (zlib) {
+			okay = TinyKtx2_ConvertFromKtx1(ctx, &writeCallbacks, &job, TKTX2_SUPERCOMPRESSION_ZLIB, &ZlibCompress);
+		} else
+#endif
+		okay = TinyKtx2_ConvertFromKtx1(ctx, &writeCallbacks, &job, TKTX2_SUPERCOMPRESSION_NONE, nullptr);
+	}
+	TinyKtx_DestroyContext(ctx);
+
+	fclose(job.in);
+	okay = (fclose(job.out) == 0) && okay && !job.failed;
+	if (!okay) {
+		std::error_code ec;
+		fs::remove(dst, ec);
+	}
+	return okay;
+}
+
+} // namespace
+
+int main(int argc, char const *argv[]) {
+	bool zlib = false;
+	unsigned threadCount = std::thread::hardware_concurrency();
+	std::vector<char const *> dirs;
+
+	for (int i = 1; i < argc; ++i) {
+		if (strcmp(argv[i], "--zlib") == 0) {
+#if KTX1TO2_HAVE_ZLIB
+			zlib = true;
+#else
+			fprintf(stderr, "Built without zlib, --zlib isn't available\n");
+			return 1;
+#endif
+		} else if (strcmp(argv[i], "--threads") == 0 && i + 1 < argc) {
+			threadCount = (unsigned) atoi(argv[++i]);
+		} else {
+			dirs.push_back(argv[i]);
+		}
+	}
+	if (dirs.size() != 2) {
+		fprintf(stderr, "usage: ktx1to2 [--zlib] [--threads N] <input dir> <output dir>\n");
+		return 1;
+	}
+
+	fs::path const outDir(dirs[1]);
+	std::error_code ec;
+	fs::create_directories(outDir, ec);
+
+	std::vector<fs::path> files;
+	for (auto const &entry : fs::directory_iterator(dirs[0], ec)) {
+		if (entry.is_regular_file() && entry.path().extension() == ".ktx")
+			files.push_back(entry.path());
+	}
+	if (ec) {
+		fprintf(stderr, "Unable to read %s\n", dirs[0]);
+		return 1;
+	}
+
+	// workers pull the next file until there are none left
+	std::atomic<size_t> next{0};
+	std::atomic<size_t> failures{0};
+	auto worker = [&]() {
+		for (size_t i = next++; i < files.size(); i = next++) {
+			fs::path dst = outDir / files[i].filename();
+			dst.replace_extension(".ktx2");
+			if (!Convert(files[i], dst, zlib))
+				failures++;
+		}
+	};
+
+	if (threadCount == 0)
+		threadCount = 1;
+	if (threadCount > files.size())
+		threadCount = (unsigned) files.size();
+	std::vector<std::thread> threads;
+	for (unsigned i = 1; i < threadCount; ++i)
+		threads.emplace_back(worker);
+	worker();
+	for (auto &t : threads)
+		t.join();
+
+	printf("converted %zu of %zu files\n", files.size() - failures, files.size());
+	return failures ? 1 : 0;
+}